@@ -0,0 +1,125 @@
+// mip 生成基准：生成整条 mip 链的耗时，比较以前逐纹素经 Color 往返的 Box 平均（单线程与按行并行）
+// 与 mip_generation 中打包 SWAR 的 Box、sRGB 线性空间 Box、Kaiser 与 Lanczos
+//
+// 用法：mip_generation_benchmark [纹理边长，默认 4096] [重复次数，默认 3]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "core/platform/parallel.h"
+#include "core/types/color.h"
+#include "core/types/mip_generation.h"
+
+using Core::Types::Color;
+using Core::Types::MipFilter;
+using Core::Types::MipLevelView;
+
+namespace {
+
+struct Level {
+    int width;
+    int height;
+    std::vector<uint32_t> pixels;
+    std::vector<uint32_t> xOffset;
+    std::vector<uint32_t> yOffset;
+
+    MipLevelView view() {
+        return {pixels.data(), xOffset.data(), yOffset.data(), width, height};
+    }
+};
+
+std::vector<Level> allocateChain(int size) {
+    std::vector<Level> levels;
+    for (int width = size, height = size;; width = std::max(1, width / 2), height = std::max(1, height / 2)) {
+        Level level{width, height, std::vector<uint32_t>(static_cast<std::size_t>(width) * height),
+                    std::vector<uint32_t>(width), std::vector<uint32_t>(height)};
+        for (int x = 0; x < width; ++x) level.xOffset[x] = static_cast<uint32_t>(x);
+        for (int y = 0; y < height; ++y) level.yOffset[y] = static_cast<uint32_t>(y * width);
+        levels.push_back(std::move(level));
+        if (width == 1 && height == 1) break;
+    }
+    return levels;
+}
+
+// 以前 Texture::rebuildRegion 的做法：每个源纹素转成 Color，浮点平均后 toUint32
+void legacyBox(const Level& prev, Level& current, int rowBegin, int rowEnd) {
+    auto read = [&prev](int x, int y) {
+        x = std::min(x, prev.width - 1);
+        y = std::min(y, prev.height - 1);
+        return Color::fromUint32(prev.pixels[static_cast<std::size_t>(y) * prev.width + x]);
+    };
+    for (int y = rowBegin; y < rowEnd; ++y) {
+        for (int x = 0; x < current.width; ++x) {
+            const Color avg = (read(2 * x, 2 * y) + read(2 * x + 1, 2 * y) +
+                               read(2 * x, 2 * y + 1) + read(2 * x + 1, 2 * y + 1)) * 0.25f;
+            current.pixels[static_cast<std::size_t>(y) * current.width + x] = avg.toUint32();
+        }
+    }
+}
+
+double timeChain(std::vector<Level>& levels, int repeats, const std::function<void(Level&, Level&)>& step) {
+    double best = 1e30;
+    for (int r = 0; r < repeats; ++r) {
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 1; i < levels.size(); ++i) {
+            step(levels[i - 1], levels[i]);
+        }
+        const auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int size = argc > 1 ? std::atoi(argv[1]) : 4096;
+    const int repeats = argc > 2 ? std::atoi(argv[2]) : 3;
+
+    std::vector<Level> levels = allocateChain(size);
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<uint32_t> dist;
+    for (uint32_t& texel : levels[0].pixels) {
+        texel = dist(rng);
+    }
+
+    std::printf("texture %dx%d, %zu levels, %d worker threads, best of %d\n",
+                size, size, levels.size(), Core::Platform::getWorkerCount(), repeats);
+    const double legacySerial = timeChain(levels, repeats, [](Level& prev, Level& current) {
+        legacyBox(prev, current, 0, current.height);
+    });
+    const double legacyParallel = timeChain(levels, repeats, [](Level& prev, Level& current) {
+        Core::Platform::parallelFor(0, current.height, [&](int begin, int end) {
+            legacyBox(prev, current, begin, end);
+        }, std::max(1, 4096 / current.width));
+    });
+    std::printf("%-34s %10.1f ms\n", "legacy Color box, single thread", legacySerial);
+    std::printf("%-34s %10.1f ms\n", "legacy Color box, parallel rows", legacyParallel);
+
+    struct Variant {
+        const char* name;
+        MipFilter filter;
+        bool srgb;
+    };
+    const Variant variants[] = {
+        {"box (SWAR)", MipFilter::Box, false},
+        {"box, sRGB linear", MipFilter::Box, true},
+        {"kaiser 8-tap", MipFilter::Kaiser, false},
+        {"kaiser 8-tap, sRGB linear", MipFilter::Kaiser, true},
+        {"lanczos2 8-tap", MipFilter::Lanczos, false},
+    };
+    for (const Variant& variant : variants) {
+        const double ms = timeChain(levels, repeats, [&variant](Level& prev, Level& current) {
+            Core::Types::downsampleMipRegion(prev.view(), current.view(), 0, 0, current.width, current.height,
+                                             variant.filter, variant.srgb);
+        });
+        std::printf("%-34s %10.1f ms  (%.1fx vs legacy parallel)\n", variant.name, ms, legacyParallel / ms);
+    }
+    return 0;
+}
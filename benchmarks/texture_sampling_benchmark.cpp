@@ -0,0 +1,184 @@
+// 纹理采样吞吐基准：比较行主序与 Z 序（Tiled）存储在不同访问模式下的每秒采样数，
+// 以及 Tiled 存储下 sample8 批量接口的吞吐；第二张表比较 RGBA8 与 BC1 / BC3 块压缩的吞吐与内存；
+// 第三张表比较普通纹理与页全部驻留的虚拟纹理（页表间接寻址 + 采样反馈的开销）
+//
+// 用法：texture_sampling_benchmark [纹理边长，默认 2048] [屏幕边长，默认 512] [重复次数，默认 5]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "core/types/texture.h"
+#include "core/types/virtual_texture.h"
+
+using Core::Types::Color;
+using Core::Types::Texture;
+using Core::Types::TextureFormat;
+using Core::Types::TextureLayout;
+
+namespace {
+
+struct Pattern {
+    const char* name;
+    float angle;     // 屏幕到纹理空间的旋转（弧度）
+    float scale;     // 每个屏幕像素覆盖的纹素数（> 1 为缩小）
+    bool useMipmaps; // false 时固定采样 level 0，模拟没有 mip 的缩小访问
+};
+
+// 按屏幕扫描线顺序生成纹理坐标，与光栅化的访问顺序一致；batched 时每 8 个像素调用一次 sample8
+float run(const Texture& texture, const Pattern& pattern, int screen, bool batched, double& checksum) {
+    const float texSize = static_cast<float>(texture.getWidth());
+    const float c = std::cos(pattern.angle) * pattern.scale / texSize;
+    const float s = std::sin(pattern.angle) * pattern.scale / texSize;
+    const float dudx = c, dvdx = s, dudy = -s, dvdy = c;
+
+    float sum = 0.0f;
+    const auto start = std::chrono::steady_clock::now();
+    for (int y = 0; y < screen; ++y) {
+        if (batched) {
+            for (int x = 0; x + 8 <= screen; x += 8) {
+                float u[8], v[8];
+                for (int i = 0; i < 8; ++i) {
+                    u[i] = 0.37f + (x + i) * dudx + y * dudy;
+                    v[i] = 0.11f + (x + i) * dvdx + y * dvdy;
+                }
+                Color colors[8];
+                texture.sample8(u, v, dudx, dudy, dvdx, dvdy, colors);
+                for (const Color& color : colors) {
+                    sum += color.r;
+                }
+            }
+            continue;
+        }
+        for (int x = 0; x < screen; ++x) {
+            const float u = 0.37f + x * dudx + y * dudy;
+            const float v = 0.11f + x * dvdx + y * dvdy;
+            const Color color = pattern.useMipmaps ? texture.sample(u, v, dudx, dudy, dvdx, dvdy)
+                                                   : texture.sampleLevel(u, v, 0);
+            sum += color.r;
+        }
+    }
+    const auto end = std::chrono::steady_clock::now();
+    checksum += sum;
+    const double seconds = std::chrono::duration<double>(end - start).count();
+    return static_cast<float>(static_cast<double>(screen) * screen / seconds / 1e6);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int texSize = argc > 1 ? std::atoi(argv[1]) : 2048;
+    const int screen = argc > 2 ? std::atoi(argv[2]) : 512;
+    const int repeats = argc > 3 ? std::atoi(argv[3]) : 5;
+
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<uint32_t> dist;
+    std::vector<uint32_t> pixels(static_cast<std::size_t>(texSize) * texSize);
+    for (uint32_t& p : pixels) {
+        p = dist(rng);
+    }
+    Texture linear(pixels, texSize, texSize, true);
+    Texture tiled(pixels, texSize, texSize, true);
+    tiled.setLayout(TextureLayout::Tiled);
+
+    const float kQuarterTurn = 1.5707963f;
+    const Pattern patterns[] = {
+        {"axis-aligned 1:1", 0.0f, 1.0f, true},
+        {"rotated 30deg 1:1", 0.5236f, 1.0f, true},
+        {"rotated 90deg 1:1", kQuarterTurn, 1.0f, true},
+        {"minified 4x, no mips", 0.0f, 4.0f, false},
+        {"rotated 90deg 4x, no mips", kQuarterTurn, 4.0f, false},
+        {"rotated 30deg 3x, mipmapped", 0.5236f, 3.0f, true},
+    };
+
+    double checksum = 0.0;
+    std::printf("texture %dx%d, %dx%d samples per pass, best of %d\n", texSize, texSize, screen, screen, repeats);
+    std::printf("%-30s %14s %14s %8s %16s\n", "pattern", "linear Ms/s", "tiled Ms/s", "ratio", "tiled x8 Ms/s");
+    for (const Pattern& pattern : patterns) {
+        float bestLinear = 0.0f;
+        float bestTiled = 0.0f;
+        float bestBatched = 0.0f;
+        for (int i = 0; i < repeats; ++i) {
+            bestLinear = std::max(bestLinear, run(linear, pattern, screen, false, checksum));
+            bestTiled = std::max(bestTiled, run(tiled, pattern, screen, false, checksum));
+            if (pattern.useMipmaps) {
+                bestBatched = std::max(bestBatched, run(tiled, pattern, screen, true, checksum));
+            }
+        }
+        std::printf("%-30s %14.1f %14.1f %8.2f", pattern.name, bestLinear, bestTiled, bestTiled / bestLinear);
+        if (pattern.useMipmaps) {
+            std::printf(" %16.1f", bestBatched);
+        }
+        std::printf("\n");
+    }
+
+    // 压缩格式用平滑图像（随机噪声是块压缩的最差情况，但不影响解码开销）
+    for (int y = 0; y < texSize; ++y) {
+        for (int x = 0; x < texSize; ++x) {
+            const uint32_t r = static_cast<uint32_t>(x * 255 / texSize);
+            const uint32_t g = static_cast<uint32_t>(127.5f + 127.5f * std::sin(y * 0.05f));
+            pixels[static_cast<std::size_t>(y) * texSize + x] = (r << 24) | (g << 16) | ((r ^ g) << 8) | 0xFFu;
+        }
+    }
+    Texture rgba(pixels, texSize, texSize, true);
+    Texture bc1(pixels, texSize, texSize, true);
+    Texture bc3(pixels, texSize, texSize, true);
+    const auto encodeStart = std::chrono::steady_clock::now();
+    bc1.setFormat(TextureFormat::BC1);
+    const auto encodeEnd = std::chrono::steady_clock::now();
+    bc3.setFormat(TextureFormat::BC3);
+    const double mb = 1.0 / (1024.0 * 1024.0);
+    std::printf("\nmemory incl. mips: RGBA8 %.1f MB, BC1 %.1f MB, BC3 %.1f MB; BC1 encode %.0f ms\n",
+                rgba.getMemoryUsage() * mb, bc1.getMemoryUsage() * mb, bc3.getMemoryUsage() * mb,
+                std::chrono::duration<double, std::milli>(encodeEnd - encodeStart).count());
+    std::printf("%-30s %14s %14s %14s\n", "pattern", "RGBA8 Ms/s", "BC1 Ms/s", "BC3 Ms/s");
+    for (const Pattern& pattern : patterns) {
+        float best[3] = {0.0f, 0.0f, 0.0f};
+        const Texture* textures[3] = {&rgba, &bc1, &bc3};
+        for (int i = 0; i < repeats; ++i) {
+            for (int k = 0; k < 3; ++k) {
+                best[k] = std::max(best[k], run(*textures[k], pattern, screen, false, checksum));
+            }
+        }
+        std::printf("%-30s %14.1f %14.1f %14.1f\n", pattern.name, best[0], best[1], best[2]);
+    }
+
+    // 虚拟纹理：容量足够容纳所有页，先按反馈读入再计时
+    const std::string vtexPath = (std::filesystem::temp_directory_path() / "texture_sampling_benchmark.vtex").string();
+    const int pageSize = Core::Types::VirtualPageCache::kDefaultPageSize;
+    int totalPages = 0;
+    for (int size = texSize; size > pageSize; size /= 2) {
+        totalPages += ((size + pageSize - 1) / pageSize) * ((size + pageSize - 1) / pageSize);
+    }
+    if (!Core::Types::writeVirtualTexture(vtexPath, pixels.data(), texSize, texSize, pageSize)) {
+        std::printf("cannot write %s\n", vtexPath.c_str());
+        return 1;
+    }
+    std::unique_ptr<Texture> paged(Texture::loadVirtual(vtexPath, std::max(1, totalPages)));
+    std::unique_ptr<Texture> bounded(Texture::loadVirtual(vtexPath));
+    std::printf("\nvirtual: %d pages of %d^2; memory all resident %.1f MB, default pool %.1f MB\n",
+                totalPages, pageSize, paged->getMemoryUsage() * mb, bounded->getMemoryUsage() * mb);
+    std::printf("%-30s %14s %14s %8s\n", "pattern", "RGBA8 Ms/s", "virtual Ms/s", "ratio");
+    for (const Pattern& pattern : patterns) {
+        do {
+            run(*paged, pattern, screen, false, checksum);
+        } while (paged->getVirtualPages()->update(totalPages) > 0);
+        float bestRegular = 0.0f;
+        float bestVirtual = 0.0f;
+        for (int i = 0; i < repeats; ++i) {
+            bestRegular = std::max(bestRegular, run(rgba, pattern, screen, false, checksum));
+            bestVirtual = std::max(bestVirtual, run(*paged, pattern, screen, false, checksum));
+        }
+        std::printf("%-30s %14.1f %14.1f %8.2f\n", pattern.name, bestRegular, bestVirtual, bestVirtual / bestRegular);
+    }
+    std::filesystem::remove(vtexPath);
+    std::printf("checksum %.3f\n", checksum);
+    return 0;
+}
@@ -0,0 +1,66 @@
+#include "frame_arena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace Core {
+namespace Platform {
+
+FrameArena::FrameArena(std::size_t blockSize)
+    : m_blockSize(std::max<std::size_t>(blockSize, 256)) {}
+
+void FrameArena::addBlock(std::size_t minSize) {
+    // 新块至少与现有容量相同，增长的帧只需要 O(log n) 个块
+    const std::size_t size = std::max({m_blockSize, minSize, getCapacity()});
+    Block block;
+    block.memory.reset(new unsigned char[size]);
+    block.size = size;
+    m_blocks.push_back(std::move(block));
+}
+
+void* FrameArena::allocate(std::size_t bytes, std::size_t alignment) {
+    for (;;) {
+        if (m_current < m_blocks.size()) {
+            const Block& block = m_blocks[m_current];
+            const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(block.memory.get());
+            const std::uintptr_t aligned = (base + m_offset + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+            const std::size_t begin = static_cast<std::size_t>(aligned - base);
+            if (begin <= block.size && bytes <= block.size - begin) {
+                m_offset = begin + bytes;
+                return block.memory.get() + begin;
+            }
+            // 当前块放不下：剩余部分留空，换到下一块
+            m_usedBefore += block.size;
+            m_offset = 0;
+            ++m_current;
+            continue;
+        }
+        addBlock(bytes + alignment);
+    }
+}
+
+void FrameArena::reset() {
+    if (m_blocks.size() > 1) {
+        const std::size_t capacity = getCapacity();
+        m_blocks.clear();
+        addBlock(capacity);
+    }
+    m_current = 0;
+    m_offset = 0;
+    m_usedBefore = 0;
+}
+
+std::size_t FrameArena::getUsed() const {
+    return m_usedBefore + m_offset;
+}
+
+std::size_t FrameArena::getCapacity() const {
+    std::size_t capacity = 0;
+    for (const Block& block : m_blocks) {
+        capacity += block.size;
+    }
+    return capacity;
+}
+
+} // namespace Platform
+} // namespace Core
@@ -0,0 +1,72 @@
+#ifndef CORE_PLATFORM_FRAME_ARENA_H
+#define CORE_PLATFORM_FRAME_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace Core {
+namespace Platform {
+
+/**
+ * @brief 帧内线性分配器：按指针递增分配，reset 一次性释放本帧的全部分配
+ *
+ * 存储由若干块组成，当前块放不下时追加一块；reset 时若本帧用到了多块，就按总容量合并成一块，
+ * 因此只要每帧的用量不再增长，稳定后的帧内分配与 reset 都不再调用 malloc / free。
+ * 只提供无需析构的类型的数组；不是线程安全的，应在单个线程上分配（分配出的内存可以被多个线程读写）。
+ */
+class FrameArena {
+public:
+    static constexpr std::size_t kDefaultBlockSize = 64 * 1024;
+
+    explicit FrameArena(std::size_t blockSize = kDefaultBlockSize);
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+    FrameArena(FrameArena&&) = default;
+    FrameArena& operator=(FrameArena&&) = default;
+
+    /**
+     * @brief 分配 bytes 字节、按 alignment（2 的幂）对齐的未初始化内存，在下一次 reset 之前有效
+     */
+    void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t));
+
+    // count 个未初始化的 T；T 必须可按字节复制且无需析构（reset 不调用析构函数）
+    template <typename T>
+    T* allocateArray(std::size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value && std::is_trivially_destructible<T>::value,
+                      "FrameArena only holds trivially copyable types");
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    /**
+     * @brief 释放本帧的全部分配；之前返回的指针全部失效
+     */
+    void reset();
+
+    // 自上次 reset 以来分配的字节数（含对齐填充与块尾未用的部分）
+    std::size_t getUsed() const;
+    // 所有块的总字节数
+    std::size_t getCapacity() const;
+    std::size_t getBlockCount() const { return m_blocks.size(); }
+
+private:
+    struct Block {
+        std::unique_ptr<unsigned char[]> memory;
+        std::size_t size = 0;
+    };
+
+    void addBlock(std::size_t minSize);
+
+    std::vector<Block> m_blocks;
+    std::size_t m_blockSize;
+    std::size_t m_current = 0;      // 正在分配的块
+    std::size_t m_offset = 0;       // 当前块内已分配的字节数
+    std::size_t m_usedBefore = 0;   // 当前块之前各块的字节数
+};
+
+} // namespace Platform
+} // namespace Core
+
+#endif // CORE_PLATFORM_FRAME_ARENA_H
@@ -0,0 +1,162 @@
+#include "parallel.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Core {
+namespace Platform {
+
+namespace {
+
+// 当前线程是否已处在并行区域内（常驻工作线程始终为 true）；嵌套调用直接在本线程执行
+thread_local bool t_inParallelRegion = false;
+
+class ScopedParallelRegion {
+public:
+    ScopedParallelRegion() : m_previous(t_inParallelRegion) { t_inParallelRegion = true; }
+    ~ScopedParallelRegion() { t_inParallelRegion = m_previous; }
+
+private:
+    bool m_previous;
+};
+
+/**
+ * @brief 常驻工作线程池：首次使用时创建 getWorkerCount() - 1 个线程，进程退出时回收
+ *
+ * 同一时刻只执行一个并行区域；分段数不超过线程数，领取分段与完成计数都在互斥锁下进行。
+ */
+class WorkerPool {
+public:
+    static WorkerPool& instance() {
+        static WorkerPool pool;
+        return pool;
+    }
+
+    /**
+     * @brief 尝试在线程池上执行分段任务
+     * @return 线程池正被其他线程的并行区域占用时返回 false，由调用方自行执行
+     */
+    bool run(int begin, int end, int chunkSize, int chunkCount, const std::function<void(int, int)>& fn) {
+        std::unique_lock<std::mutex> region(m_regionMutex, std::try_to_lock);
+        if (!region.owns_lock()) {
+            return false;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_fn = &fn;
+        m_begin = begin;
+        m_end = end;
+        m_chunkSize = chunkSize;
+        m_chunkCount = chunkCount;
+        m_nextChunk = 0;
+        m_pendingChunks = chunkCount;
+        m_wake.notify_all();
+
+        // 调用线程同样领取分段，再等待其余分段完成
+        runChunks(lock);
+        m_done.wait(lock, [this]() { return m_pendingChunks == 0; });
+        m_fn = nullptr;
+        return true;
+    }
+
+private:
+    WorkerPool() {
+        const int threadCount = getWorkerCount() - 1;
+        m_threads.reserve(static_cast<std::size_t>(std::max(0, threadCount)));
+        for (int i = 0; i < threadCount; ++i) {
+            m_threads.emplace_back([this]() { workerLoop(); });
+        }
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+        for (auto& thread : m_threads) {
+            thread.join();
+        }
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    void workerLoop() {
+        t_inParallelRegion = true;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (;;) {
+            m_wake.wait(lock, [this]() { return m_stopping || m_nextChunk < m_chunkCount; });
+            if (m_stopping) {
+                return;
+            }
+            runChunks(lock);
+        }
+    }
+
+    // 在持有 m_mutex 的前提下逐个领取分段，执行分段时释放锁
+    void runChunks(std::unique_lock<std::mutex>& lock) {
+        while (m_nextChunk < m_chunkCount) {
+            const int chunk = m_nextChunk++;
+            const int chunkBegin = m_begin + chunk * m_chunkSize;
+            const int chunkEnd = std::min(m_end, chunkBegin + m_chunkSize);
+            const std::function<void(int, int)>& fn = *m_fn;
+            lock.unlock();
+            if (chunkBegin < chunkEnd) {
+                fn(chunkBegin, chunkEnd);
+            }
+            lock.lock();
+            if (--m_pendingChunks == 0) {
+                m_done.notify_all();
+            }
+        }
+    }
+
+    std::mutex m_regionMutex;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    std::vector<std::thread> m_threads;
+    bool m_stopping = false;
+
+    const std::function<void(int, int)>* m_fn = nullptr;
+    int m_begin = 0;
+    int m_end = 0;
+    int m_chunkSize = 0;
+    int m_chunkCount = 0;
+    int m_nextChunk = 0;
+    int m_pendingChunks = 0;
+};
+
+} // namespace
+
+int getWorkerCount() {
+    static const int count = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    return count;
+}
+
+void parallelFor(int begin, int end, const std::function<void(int, int)>& fn, int minChunk) {
+    const int total = end - begin;
+    if (total <= 0) {
+        return;
+    }
+
+    minChunk = std::max(1, minChunk);
+    const int chunkCount = std::min(getWorkerCount(), total / minChunk);
+    if (chunkCount <= 1 || t_inParallelRegion) {
+        fn(begin, end);
+        return;
+    }
+
+    const int chunkSize = (total + chunkCount - 1) / chunkCount;
+    ScopedParallelRegion region;
+    if (!WorkerPool::instance().run(begin, end, chunkSize, chunkCount, fn)) {
+        fn(begin, end);
+    }
+}
+
+} // namespace Platform
+} // namespace Core
@@ -0,0 +1,30 @@
+#ifndef CORE_PLATFORM_PARALLEL_H
+#define CORE_PLATFORM_PARALLEL_H
+
+#include <functional>
+
+namespace Core {
+namespace Platform {
+
+/**
+ * @brief 获取可用的工作线程数（至少为 1）
+ */
+int getWorkerCount();
+
+/**
+ * @brief 把区间 [begin, end) 切成连续的若干段，在多个线程上并行执行 fn(rangeBegin, rangeEnd)
+ *
+ * 分段交给常驻的工作线程池，调用线程自身也会领取分段；函数返回时所有分段均已完成。
+ * 区间很短（不足 2 * minChunk）、只有一个工作线程、已处在并行区域内（嵌套调用），
+ * 或线程池正被其他线程占用时，直接在当前线程执行整个区间。
+ * @param begin 起始下标
+ * @param end 结束下标（不含）
+ * @param fn 分段回调，各分段互不重叠
+ * @param minChunk 每段最少元素数，避免为过小的任务创建线程
+ */
+void parallelFor(int begin, int end, const std::function<void(int, int)>& fn, int minChunk = 16);
+
+} // namespace Platform
+} // namespace Core
+
+#endif // CORE_PLATFORM_PARALLEL_H
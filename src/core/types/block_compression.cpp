@@ -0,0 +1,299 @@
+#include "block_compression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace Core {
+namespace Types {
+
+namespace {
+
+struct Rgb8 {
+    int r, g, b;
+};
+
+inline Rgb8 expand565(uint32_t c) {
+    const int r = static_cast<int>((c >> 11) & 31u);
+    const int g = static_cast<int>((c >> 5) & 63u);
+    const int b = static_cast<int>(c & 31u);
+    return {(r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)};
+}
+
+inline uint32_t quantize565(const float color[3]) {
+    auto quantize = [](float value, int maxValue) {
+        return static_cast<uint32_t>(std::clamp(static_cast<int>(value * maxValue / 255.0f + 0.5f), 0, maxValue));
+    };
+    return (quantize(color[0], 31) << 11) | (quantize(color[1], 63) << 5) | quantize(color[2], 31);
+}
+
+inline uint32_t packRgba(const Rgb8& c, uint32_t alpha) {
+    return (static_cast<uint32_t>(c.r) << 24) | (static_cast<uint32_t>(c.g) << 16) |
+           (static_cast<uint32_t>(c.b) << 8) | alpha;
+}
+
+// 颜色块调色板，编码器用它评估误差，保证与解码结果完全一致
+void colorPalette(uint32_t c0, uint32_t c1, bool fourColor, Rgb8 palette[4]) {
+    const Rgb8 a = expand565(c0);
+    const Rgb8 b = expand565(c1);
+    palette[0] = a;
+    palette[1] = b;
+    if (fourColor) {
+        palette[2] = {(2 * a.r + b.r + 1) / 3, (2 * a.g + b.g + 1) / 3, (2 * a.b + b.b + 1) / 3};
+        palette[3] = {(a.r + 2 * b.r + 1) / 3, (a.g + 2 * b.g + 1) / 3, (a.b + 2 * b.b + 1) / 3};
+    } else {
+        palette[2] = {(a.r + b.r + 1) / 2, (a.g + b.g + 1) / 2, (a.b + b.b + 1) / 2};
+        palette[3] = {0, 0, 0};
+    }
+}
+
+void decodeColorBlock(uint64_t block, bool forceFourColor, uint32_t texels[16]) {
+    const uint32_t c0 = static_cast<uint32_t>(block & 0xFFFFu);
+    const uint32_t c1 = static_cast<uint32_t>((block >> 16) & 0xFFFFu);
+    const uint32_t indices = static_cast<uint32_t>(block >> 32);
+    const bool fourColor = forceFourColor || c0 > c1;
+    Rgb8 palette[4];
+    colorPalette(c0, c1, fourColor, palette);
+    uint32_t packed[4];
+    for (int i = 0; i < 4; ++i) {
+        packed[i] = packRgba(palette[i], 255u);
+    }
+    if (!fourColor) {
+        packed[3] = 0u; // 透明黑色
+    }
+    for (int i = 0; i < 16; ++i) {
+        texels[i] = packed[(indices >> (2 * i)) & 3u];
+    }
+}
+
+struct ColorFit {
+    uint64_t block;
+    int error;
+};
+
+// 按端点与模式为每个纹素选最近的调色板项；opaqueMask 之外的纹素固定为索引 3（三色模式的透明项）
+ColorFit fitIndices(uint32_t c0, uint32_t c1, bool fourColor, const float colors[16][3], uint32_t opaqueMask) {
+    // 四色模式要求 c0 > c1，三色模式要求 c0 <= c1
+    if (fourColor ? c0 < c1 : c0 > c1) {
+        std::swap(c0, c1);
+    }
+    // 端点相同时无法表示四色模式（BC1 会按三色解释），所有不透明纹素取索引 0
+    const bool equal = c0 == c1;
+    Rgb8 palette[4];
+    colorPalette(c0, c1, fourColor && !equal, palette);
+    const int candidates = equal ? 1 : (fourColor ? 4 : 3);
+
+    uint32_t indices = 0;
+    int error = 0;
+    for (int i = 0; i < 16; ++i) {
+        if (!(opaqueMask & (1u << i))) {
+            indices |= 3u << (2 * i);
+            continue;
+        }
+        int bestIndex = 0;
+        int bestError = 1 << 30;
+        for (int k = 0; k < candidates; ++k) {
+            const int dr = palette[k].r - static_cast<int>(colors[i][0]);
+            const int dg = palette[k].g - static_cast<int>(colors[i][1]);
+            const int db = palette[k].b - static_cast<int>(colors[i][2]);
+            const int e = dr * dr + dg * dg + db * db;
+            if (e < bestError) {
+                bestError = e;
+                bestIndex = k;
+            }
+        }
+        indices |= static_cast<uint32_t>(bestIndex) << (2 * i);
+        error += bestError;
+    }
+    return {static_cast<uint64_t>(c0) | (static_cast<uint64_t>(c1) << 16) | (static_cast<uint64_t>(indices) << 32),
+            error};
+}
+
+uint64_t encodeColorBlock(const uint32_t texels[16], uint32_t opaqueMask, bool fourColor) {
+    if (opaqueMask == 0) {
+        return 0xFFFFFFFF00000000ull; // 端点都为 0（三色模式），全部透明
+    }
+
+    float colors[16][3];
+    float mean[3] = {0.0f, 0.0f, 0.0f};
+    float lo[3] = {255.0f, 255.0f, 255.0f};
+    float hi[3] = {0.0f, 0.0f, 0.0f};
+    int count = 0;
+    for (int i = 0; i < 16; ++i) {
+        colors[i][0] = static_cast<float>(texels[i] >> 24);
+        colors[i][1] = static_cast<float>((texels[i] >> 16) & 0xFFu);
+        colors[i][2] = static_cast<float>((texels[i] >> 8) & 0xFFu);
+        if (!(opaqueMask & (1u << i))) continue;
+        for (int c = 0; c < 3; ++c) {
+            mean[c] += colors[i][c];
+            lo[c] = std::min(lo[c], colors[i][c]);
+            hi[c] = std::max(hi[c], colors[i][c]);
+        }
+        ++count;
+    }
+    for (float& m : mean) {
+        m /= static_cast<float>(count);
+    }
+
+    // 协方差矩阵（对称，存上三角）的主特征向量：从包围盒对角线出发做几次幂迭代
+    float cov[6] = {};
+    for (int i = 0; i < 16; ++i) {
+        if (!(opaqueMask & (1u << i))) continue;
+        const float d[3] = {colors[i][0] - mean[0], colors[i][1] - mean[1], colors[i][2] - mean[2]};
+        cov[0] += d[0] * d[0];
+        cov[1] += d[0] * d[1];
+        cov[2] += d[0] * d[2];
+        cov[3] += d[1] * d[1];
+        cov[4] += d[1] * d[2];
+        cov[5] += d[2] * d[2];
+    }
+    float axis[3] = {hi[0] - lo[0], hi[1] - lo[1], hi[2] - lo[2]};
+    for (int iteration = 0; iteration < 4; ++iteration) {
+        const float next[3] = {cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2],
+                               cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2],
+                               cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2]};
+        const float length = std::sqrt(next[0] * next[0] + next[1] * next[1] + next[2] * next[2]);
+        if (!(length > 1e-6f)) break;
+        for (int c = 0; c < 3; ++c) {
+            axis[c] = next[c] / length;
+        }
+    }
+    const float axisLength = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+
+    float end0[3] = {mean[0], mean[1], mean[2]};
+    float end1[3] = {mean[0], mean[1], mean[2]};
+    if (axisLength > 1e-6f) {
+        for (float& a : axis) {
+            a /= axisLength;
+        }
+        float minT = 1e30f, maxT = -1e30f;
+        for (int i = 0; i < 16; ++i) {
+            if (!(opaqueMask & (1u << i))) continue;
+            const float t = (colors[i][0] - mean[0]) * axis[0] + (colors[i][1] - mean[1]) * axis[1] +
+                            (colors[i][2] - mean[2]) * axis[2];
+            minT = std::min(minT, t);
+            maxT = std::max(maxT, t);
+        }
+        // 两端向内收缩 1/16：极值点多为孤立噪声，收缩后插值点落在更密集的区域
+        const float inset = (maxT - minT) / 16.0f;
+        for (int c = 0; c < 3; ++c) {
+            end0[c] = mean[c] + axis[c] * (maxT - inset);
+            end1[c] = mean[c] + axis[c] * (minT + inset);
+        }
+    }
+    ColorFit best = fitIndices(quantize565(end0), quantize565(end1), fourColor, colors, opaqueMask);
+
+    // 固定索引后端点的最小二乘解：纹素 ≈ w·c0 + (1 - w)·c1，w 由索引决定
+    const float fourWeights[4] = {1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f};
+    const float threeWeights[4] = {1.0f, 0.0f, 0.5f, 0.0f};
+    for (int iteration = 0; iteration < 2 && best.error > 0; ++iteration) {
+        const uint32_t c0 = static_cast<uint32_t>(best.block & 0xFFFFu);
+        const uint32_t c1 = static_cast<uint32_t>((best.block >> 16) & 0xFFFFu);
+        if (c0 == c1) break;
+        const float* weights = c0 > c1 ? fourWeights : threeWeights;
+        float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+        float ax[3] = {}, bx[3] = {};
+        for (int i = 0; i < 16; ++i) {
+            if (!(opaqueMask & (1u << i))) continue;
+            const float w = weights[(best.block >> (32 + 2 * i)) & 3u];
+            const float v = 1.0f - w;
+            aa += w * w;
+            ab += w * v;
+            bb += v * v;
+            for (int c = 0; c < 3; ++c) {
+                ax[c] += w * colors[i][c];
+                bx[c] += v * colors[i][c];
+            }
+        }
+        const float det = aa * bb - ab * ab;
+        if (std::fabs(det) < 1e-6f) break;
+        float refined0[3], refined1[3];
+        for (int c = 0; c < 3; ++c) {
+            refined0[c] = (ax[c] * bb - bx[c] * ab) / det;
+            refined1[c] = (bx[c] * aa - ax[c] * ab) / det;
+        }
+        const ColorFit candidate =
+            fitIndices(quantize565(refined0), quantize565(refined1), fourColor, colors, opaqueMask);
+        if (candidate.error >= best.error) break;
+        best = candidate;
+    }
+    return best.block;
+}
+
+void alphaPalette(uint32_t a0, uint32_t a1, uint32_t palette[8]) {
+    palette[0] = a0;
+    palette[1] = a1;
+    if (a0 > a1) {
+        for (uint32_t i = 1; i <= 6; ++i) {
+            palette[i + 1] = ((7 - i) * a0 + i * a1 + 3) / 7;
+        }
+    } else {
+        for (uint32_t i = 1; i <= 4; ++i) {
+            palette[i + 1] = ((5 - i) * a0 + i * a1 + 2) / 5;
+        }
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+}
+
+uint64_t encodeAlphaBlock(const uint32_t texels[16]) {
+    uint32_t lo = 255, hi = 0;
+    for (int i = 0; i < 16; ++i) {
+        const uint32_t a = texels[i] & 0xFFu;
+        lo = std::min(lo, a);
+        hi = std::max(hi, a);
+    }
+    uint64_t block = hi | (static_cast<uint64_t>(lo) << 8);
+    if (hi == lo) {
+        return block; // 索引全为 0
+    }
+    uint32_t palette[8];
+    alphaPalette(hi, lo, palette);
+    for (int i = 0; i < 16; ++i) {
+        const int a = static_cast<int>(texels[i] & 0xFFu);
+        uint64_t bestIndex = 0;
+        int bestError = 256;
+        for (int k = 0; k < 8; ++k) {
+            const int e = std::abs(static_cast<int>(palette[k]) - a);
+            if (e < bestError) {
+                bestError = e;
+                bestIndex = static_cast<uint64_t>(k);
+            }
+        }
+        block |= bestIndex << (16 + 3 * i);
+    }
+    return block;
+}
+
+} // namespace
+
+uint64_t encodeBC1Block(const uint32_t texels[16]) {
+    uint32_t opaqueMask = 0;
+    for (int i = 0; i < 16; ++i) {
+        if ((texels[i] & 0xFFu) >= 128u) {
+            opaqueMask |= 1u << i;
+        }
+    }
+    return encodeColorBlock(texels, opaqueMask, opaqueMask == 0xFFFFu);
+}
+
+void decodeBC1Block(uint64_t block, uint32_t texels[16]) {
+    decodeColorBlock(block, false, texels);
+}
+
+void encodeBC3Block(const uint32_t texels[16], uint64_t block[2]) {
+    block[0] = encodeAlphaBlock(texels);
+    block[1] = encodeColorBlock(texels, 0xFFFFu, true);
+}
+
+void decodeBC3Block(const uint64_t block[2], uint32_t texels[16]) {
+    decodeColorBlock(block[1], true, texels);
+    uint32_t palette[8];
+    alphaPalette(static_cast<uint32_t>(block[0] & 0xFFu), static_cast<uint32_t>((block[0] >> 8) & 0xFFu), palette);
+    for (int i = 0; i < 16; ++i) {
+        texels[i] = (texels[i] & 0xFFFFFF00u) | palette[(block[0] >> (16 + 3 * i)) & 7u];
+    }
+}
+
+} // namespace Types
+} // namespace Core
@@ -0,0 +1,37 @@
+#ifndef CORE_TYPES_BLOCK_COMPRESSION_H
+#define CORE_TYPES_BLOCK_COMPRESSION_H
+
+#include <cstdint>
+
+namespace Core {
+namespace Types {
+
+/**
+ * @brief BC1 / BC3（DXT1 / DXT5）4×4 块编解码
+ *
+ * 纹素为打包 RGBA8（R 在最高字节，与 Color::toUint32 相同），按行主序排列：texels[y * 4 + x]。
+ * 块以小端 64 位整数保存，字节顺序与 DDS / GPU 中的块数据一致。
+ *
+ * BC1：两个 RGB565 端点 + 每纹素 2 位索引。端点 c0 > c1 时为四色模式（两个 1/3 插值点）；
+ * c0 <= c1 时为三色模式（中点）+ 索引 3 表示透明黑色。
+ * BC3：8 字节 alpha 块（两个 8 位端点 + 每纹素 3 位索引）+ 8 字节颜色块（总按四色模式解释）。
+ */
+
+/**
+ * @brief 编码一个 BC1 块；存在 alpha < 128 的纹素时使用三色模式并把这些纹素编码为透明
+ *
+ * 端点取颜色的主轴（协方差矩阵的幂迭代）两端并向内收缩，量化后按最近调色板项选索引，再以最小二乘调整端点（至多两轮，误差不再下降即停止）。
+ */
+uint64_t encodeBC1Block(const uint32_t texels[16]);
+void decodeBC1Block(uint64_t block, uint32_t texels[16]);
+
+/**
+ * @brief 编码一个 BC3 块：block[0] 为 alpha 块，block[1] 为颜色块
+ */
+void encodeBC3Block(const uint32_t texels[16], uint64_t block[2]);
+void decodeBC3Block(const uint64_t block[2], uint32_t texels[16]);
+
+} // namespace Types
+} // namespace Core
+
+#endif // CORE_TYPES_BLOCK_COMPRESSION_H
@@ -0,0 +1,874 @@
+#include "image_loader.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace Core {
+namespace Types {
+
+namespace {
+
+bool fail(std::string* error, const char* message) {
+    if (error) {
+        *error = message;
+    }
+    return false;
+}
+
+inline uint32_t packRgba(uint32_t r, uint32_t g, uint32_t b, uint32_t a) {
+    return (r << 24) | (g << 16) | (b << 8) | a;
+}
+
+// 把 [0, maxValue] 的通道值四舍五入到 [0, 255]
+inline uint32_t scaleTo8(uint32_t value, uint32_t maxValue) {
+    return (std::min(value, maxValue) * 255u + maxValue / 2) / maxValue;
+}
+
+// 图像尺寸上限：避免损坏或恶意的文件头导致巨大的分配（像素数上限对应 256 MB 的 RGBA）
+constexpr int kMaxImageDimension = 1 << 15;
+constexpr long long kMaxImagePixels = 1ll << 26;
+
+bool validDimensions(long long width, long long height) {
+    return width > 0 && height > 0 && width <= kMaxImageDimension && height <= kMaxImageDimension &&
+           width * height <= kMaxImagePixels;
+}
+
+// ---------------------------------------------------------------- inflate
+
+// 按流中顺序（低位在前）读取比特
+class BitReader {
+public:
+    BitReader(const uint8_t* data, std::size_t size) : m_data(data), m_size(size) {}
+
+    // 不足时以 0 补齐，越界由 overrun() 报告
+    uint32_t peek(int count) {
+        while (m_bitCount < count) {
+            const uint64_t byte = m_pos < m_size ? m_data[m_pos] : 0u;
+            ++m_pos;
+            m_bits |= byte << m_bitCount;
+            m_bitCount += 8;
+        }
+        return static_cast<uint32_t>(m_bits & ((uint64_t{1} << count) - 1u));
+    }
+
+    void consume(int count) {
+        m_bits >>= count;
+        m_bitCount -= count;
+    }
+
+    uint32_t read(int count) {
+        if (count == 0) return 0;
+        const uint32_t value = peek(count);
+        consume(count);
+        return value;
+    }
+
+    // 丢弃当前字节剩余的位，返回下一个完整字节的位置
+    std::size_t alignToByte() {
+        consume(m_bitCount % 8);
+        const std::size_t bufferedBytes = static_cast<std::size_t>(m_bitCount / 8);
+        m_bits = 0;
+        m_bitCount = 0;
+        m_pos -= bufferedBytes;
+        return m_pos;
+    }
+
+    void skipBytes(std::size_t count) { m_pos += count; }
+
+    bool overrun() const { return m_pos > m_size + static_cast<std::size_t>(m_bitCount / 8); }
+
+private:
+    const uint8_t* m_data;
+    std::size_t m_size;
+    std::size_t m_pos = 0;
+    uint64_t m_bits = 0;
+    int m_bitCount = 0;
+};
+
+constexpr int kMaxCodeLength = 15;
+constexpr int kFastBits = 9;
+
+// 规范 Huffman 解码表：短码查 kFastBits 位的直接表，长码按码长逐位比较（RFC 1951 3.2.2 的规范码分配）
+struct Huffman {
+    uint16_t fast[1 << kFastBits];   // (symbol << 4) | length，0 表示码长超过 kFastBits
+    uint16_t counts[kMaxCodeLength + 1];
+    uint16_t symbols[288];           // 按 (码长, 符号) 排序
+
+    bool build(const uint8_t* lengths, int count) {
+        std::fill(std::begin(counts), std::end(counts), 0);
+        std::fill(std::begin(fast), std::end(fast), 0);
+        for (int i = 0; i < count; ++i) {
+            ++counts[lengths[i]];
+        }
+        counts[0] = 0;
+
+        // 码空间超额（over-subscribed）的长度集合无法构成前缀码
+        int left = 1;
+        for (int len = 1; len <= kMaxCodeLength; ++len) {
+            left = (left << 1) - counts[len];
+            if (left < 0) return false;
+        }
+
+        uint16_t offsets[kMaxCodeLength + 2];
+        uint32_t nextCode[kMaxCodeLength + 1];
+        offsets[1] = 0;
+        uint32_t code = 0;
+        for (int len = 1; len <= kMaxCodeLength; ++len) {
+            offsets[len + 1] = static_cast<uint16_t>(offsets[len] + counts[len]);
+            code = (code + (len > 1 ? counts[len - 1] : 0)) << 1;
+            nextCode[len] = code;
+        }
+        for (int symbol = 0; symbol < count; ++symbol) {
+            const int len = lengths[symbol];
+            if (len == 0) continue;
+            symbols[offsets[len]++] = static_cast<uint16_t>(symbol);
+            const uint32_t assigned = nextCode[len]++;
+            if (len <= kFastBits) {
+                // 码按高位在前定义，流中按低位在前读取：反转后填满所有后缀
+                uint32_t reversed = 0;
+                for (int bit = 0; bit < len; ++bit) {
+                    reversed |= ((assigned >> bit) & 1u) << (len - 1 - bit);
+                }
+                for (uint32_t j = reversed; j < (1u << kFastBits); j += 1u << len) {
+                    fast[j] = static_cast<uint16_t>((symbol << 4) | len);
+                }
+            }
+        }
+        return true;
+    }
+
+    // 返回符号，码无效时返回 -1
+    int decode(BitReader& reader) const {
+        const uint16_t entry = fast[reader.peek(kFastBits)];
+        if (entry != 0) {
+            reader.consume(entry & 0xF);
+            return entry >> 4;
+        }
+        int code = 0;
+        int first = 0;
+        int index = 0;
+        for (int len = 1; len <= kMaxCodeLength; ++len) {
+            code |= static_cast<int>(reader.read(1));
+            const int count = counts[len];
+            if (code - first < count) {
+                return symbols[index + (code - first)];
+            }
+            index += count;
+            first = (first + count) << 1;
+            code <<= 1;
+        }
+        return -1;
+    }
+};
+
+constexpr uint16_t kLengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                      35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+constexpr uint8_t kLengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                      3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+constexpr uint16_t kDistanceBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                        257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                        8193, 12289, 16385, 24577};
+constexpr uint8_t kDistanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                        7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+bool inflateBlock(BitReader& reader, const Huffman& literals, const Huffman& distances,
+                  std::vector<uint8_t>& out, std::size_t outputEnd, std::size_t streamStart, std::string* error) {
+    while (true) {
+        // 截断的流以 0 补齐后仍可能解出合法符号，每个符号都检查是否读过了末尾
+        if (reader.overrun()) return fail(error, "inflate: truncated stream");
+        const int symbol = literals.decode(reader);
+        if (symbol < 0) return fail(error, "inflate: invalid literal/length code");
+        if (symbol < 256) {
+            if (out.size() >= outputEnd) return fail(error, "inflate: output exceeds limit");
+            out.push_back(static_cast<uint8_t>(symbol));
+            continue;
+        }
+        if (symbol == 256) return true;
+        if (symbol > 285) return fail(error, "inflate: invalid length symbol");
+
+        const int lengthIndex = symbol - 257;
+        const std::size_t length = kLengthBase[lengthIndex] + reader.read(kLengthExtra[lengthIndex]);
+        const int distanceSymbol = distances.decode(reader);
+        if (distanceSymbol < 0 || distanceSymbol > 29) return fail(error, "inflate: invalid distance code");
+        const std::size_t distance = kDistanceBase[distanceSymbol] + reader.read(kDistanceExtra[distanceSymbol]);
+        if (distance > out.size() - streamStart) return fail(error, "inflate: distance beyond output");
+        if (reader.overrun()) return fail(error, "inflate: truncated stream");
+        if (length > outputEnd - out.size()) return fail(error, "inflate: output exceeds limit");
+
+        // 距离可能小于长度（重复模式），只能逐字节复制
+        const std::size_t from = out.size() - distance;
+        for (std::size_t i = 0; i < length; ++i) {
+            const uint8_t byte = out[from + i];
+            out.push_back(byte);
+        }
+    }
+}
+
+bool buildFixedTables(Huffman& literals, Huffman& distances) {
+    uint8_t lengths[288];
+    std::fill(lengths, lengths + 144, 8);
+    std::fill(lengths + 144, lengths + 256, 9);
+    std::fill(lengths + 256, lengths + 280, 7);
+    std::fill(lengths + 280, lengths + 288, 8);
+    uint8_t distanceLengths[30];
+    std::fill(distanceLengths, distanceLengths + 30, 5);
+    return literals.build(lengths, 288) && distances.build(distanceLengths, 30);
+}
+
+bool readDynamicTables(BitReader& reader, Huffman& literals, Huffman& distances, std::string* error) {
+    static constexpr uint8_t kOrder[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+    const int literalCount = static_cast<int>(reader.read(5)) + 257;
+    const int distanceCount = static_cast<int>(reader.read(5)) + 1;
+    const int codeLengthCount = static_cast<int>(reader.read(4)) + 4;
+    if (literalCount > 286 || distanceCount > 30) return fail(error, "inflate: too many codes");
+
+    uint8_t codeLengths[19] = {};
+    for (int i = 0; i < codeLengthCount; ++i) {
+        codeLengths[kOrder[i]] = static_cast<uint8_t>(reader.read(3));
+    }
+    Huffman codeLengthCode;
+    if (!codeLengthCode.build(codeLengths, 19)) return fail(error, "inflate: invalid code length code");
+
+    // 字面量/长度码与距离码的码长连续编码，重复指令可以跨越两者的边界
+    uint8_t lengths[286 + 30] = {};
+    int index = 0;
+    while (index < literalCount + distanceCount) {
+        const int symbol = codeLengthCode.decode(reader);
+        if (symbol < 0) return fail(error, "inflate: invalid code length symbol");
+        if (symbol < 16) {
+            lengths[index++] = static_cast<uint8_t>(symbol);
+            continue;
+        }
+        uint8_t value = 0;
+        int repeat = 0;
+        if (symbol == 16) {
+            if (index == 0) return fail(error, "inflate: repeat without previous length");
+            value = lengths[index - 1];
+            repeat = 3 + static_cast<int>(reader.read(2));
+        } else if (symbol == 17) {
+            repeat = 3 + static_cast<int>(reader.read(3));
+        } else {
+            repeat = 11 + static_cast<int>(reader.read(7));
+        }
+        if (index + repeat > literalCount + distanceCount) return fail(error, "inflate: code lengths overflow");
+        std::fill(lengths + index, lengths + index + repeat, value);
+        index += repeat;
+    }
+    if (lengths[256] == 0) return fail(error, "inflate: missing end-of-block code");
+    if (!literals.build(lengths, literalCount) || !distances.build(lengths + literalCount, distanceCount)) {
+        return fail(error, "inflate: invalid Huffman lengths");
+    }
+    return true;
+}
+
+uint32_t adler32(const uint8_t* data, std::size_t size) {
+    constexpr uint32_t kMod = 65521;
+    uint32_t a = 1;
+    uint32_t b = 0;
+    while (size > 0) {
+        // 5552 字节内累加不会溢出 32 位
+        const std::size_t chunk = std::min<std::size_t>(size, 5552);
+        for (std::size_t i = 0; i < chunk; ++i) {
+            a += data[i];
+            b += a;
+        }
+        a %= kMod;
+        b %= kMod;
+        data += chunk;
+        size -= chunk;
+    }
+    return (b << 16) | a;
+}
+
+// ---------------------------------------------------------------- PNG
+
+uint32_t crc32(const uint8_t* data, std::size_t size) {
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> result{};
+        for (uint32_t n = 0; n < 256; ++n) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1u) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            result[n] = c;
+        }
+        return result;
+    }();
+    uint32_t crc = 0xFFFFFFFFu;
+    for (std::size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ data[i]) & 0xFFu] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+inline uint32_t readBigEndian32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+inline uint32_t readBigEndian16(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 8) | p[1];
+}
+
+struct PngHeader {
+    int width = 0;
+    int height = 0;
+    int bitDepth = 0;
+    int colorType = 0;
+    bool interlaced = false;
+    int channels = 0;
+};
+
+inline uint8_t paeth(int a, int b, int c) {
+    const int p = a + b - c;
+    const int pa = std::abs(p - a);
+    const int pb = std::abs(p - b);
+    const int pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc) return static_cast<uint8_t>(a);
+    if (pb <= pc) return static_cast<uint8_t>(b);
+    return static_cast<uint8_t>(c);
+}
+
+// 原地反滤波一个子图像（非隔行时即整幅图），rows 行、每行 stride 字节（不含滤波类型字节）
+bool unfilter(uint8_t* data, int rows, std::size_t stride, std::size_t bytesPerPixel, std::string* error) {
+    const uint8_t* previous = nullptr;
+    for (int y = 0; y < rows; ++y) {
+        uint8_t* row = data + static_cast<std::size_t>(y) * (stride + 1);
+        const int filter = row[0];
+        uint8_t* current = row + 1;
+        switch (filter) {
+        case 0:
+            break;
+        case 1:
+            for (std::size_t i = bytesPerPixel; i < stride; ++i) {
+                current[i] = static_cast<uint8_t>(current[i] + current[i - bytesPerPixel]);
+            }
+            break;
+        case 2:
+            if (previous) {
+                for (std::size_t i = 0; i < stride; ++i) {
+                    current[i] = static_cast<uint8_t>(current[i] + previous[i]);
+                }
+            }
+            break;
+        case 3:
+            for (std::size_t i = 0; i < stride; ++i) {
+                const int left = i >= bytesPerPixel ? current[i - bytesPerPixel] : 0;
+                const int up = previous ? previous[i] : 0;
+                current[i] = static_cast<uint8_t>(current[i] + ((left + up) >> 1));
+            }
+            break;
+        case 4:
+            for (std::size_t i = 0; i < stride; ++i) {
+                const int left = i >= bytesPerPixel ? current[i - bytesPerPixel] : 0;
+                const int up = previous ? previous[i] : 0;
+                const int upLeft = previous && i >= bytesPerPixel ? previous[i - bytesPerPixel] : 0;
+                current[i] = static_cast<uint8_t>(current[i] + paeth(left, up, upLeft));
+            }
+            break;
+        default:
+            return fail(error, "png: invalid filter type");
+        }
+        previous = current;
+    }
+    return true;
+}
+
+// 读取第 index 个样本（位深 < 8 时高位在前打包）
+inline uint32_t readSample(const uint8_t* row, std::size_t index, int bitDepth) {
+    switch (bitDepth) {
+    case 16:
+        return readBigEndian16(row + index * 2);
+    case 8:
+        return row[index];
+    default: {
+        const std::size_t bit = index * static_cast<std::size_t>(bitDepth);
+        const int shift = 8 - bitDepth - static_cast<int>(bit % 8);
+        return (row[bit / 8] >> shift) & ((1u << bitDepth) - 1u);
+    }
+    }
+}
+
+struct PngPalette {
+    uint32_t entries[256];
+    int size = 0;
+};
+
+// 透明色键（tRNS 对灰度与真彩色给出的原始样本值）
+struct PngColorKey {
+    bool enabled = false;
+    uint32_t values[3] = {};
+};
+
+void convertRow(const PngHeader& header, const uint8_t* row, int count, const PngPalette& palette,
+                const PngColorKey& key, uint32_t* out, std::size_t outStep) {
+    const uint32_t maxValue = (1u << header.bitDepth) - 1u;
+    for (int x = 0; x < count; ++x) {
+        const std::size_t base = static_cast<std::size_t>(x) * header.channels;
+        uint32_t pixel;
+        switch (header.colorType) {
+        case 0: {
+            const uint32_t gray = readSample(row, base, header.bitDepth);
+            const uint32_t g8 = scaleTo8(gray, maxValue);
+            const bool transparent = key.enabled && gray == key.values[0];
+            pixel = packRgba(g8, g8, g8, transparent ? 0u : 255u);
+            break;
+        }
+        case 2: {
+            const uint32_t r = readSample(row, base, header.bitDepth);
+            const uint32_t g = readSample(row, base + 1, header.bitDepth);
+            const uint32_t b = readSample(row, base + 2, header.bitDepth);
+            const bool transparent = key.enabled && r == key.values[0] && g == key.values[1] && b == key.values[2];
+            pixel = packRgba(scaleTo8(r, maxValue), scaleTo8(g, maxValue), scaleTo8(b, maxValue),
+                             transparent ? 0u : 255u);
+            break;
+        }
+        case 3: {
+            const uint32_t index = readSample(row, base, header.bitDepth);
+            // 越界索引按黑色处理
+            pixel = static_cast<int>(index) < palette.size ? palette.entries[index] : packRgba(0, 0, 0, 255);
+            break;
+        }
+        case 4: {
+            const uint32_t g8 = scaleTo8(readSample(row, base, header.bitDepth), maxValue);
+            pixel = packRgba(g8, g8, g8, scaleTo8(readSample(row, base + 1, header.bitDepth), maxValue));
+            break;
+        }
+        default: {
+            pixel = packRgba(scaleTo8(readSample(row, base, header.bitDepth), maxValue),
+                             scaleTo8(readSample(row, base + 1, header.bitDepth), maxValue),
+                             scaleTo8(readSample(row, base + 2, header.bitDepth), maxValue),
+                             scaleTo8(readSample(row, base + 3, header.bitDepth), maxValue));
+            break;
+        }
+        }
+        out[static_cast<std::size_t>(x) * outStep] = pixel;
+    }
+}
+
+bool validPngFormat(int colorType, int bitDepth) {
+    switch (colorType) {
+    case 0: return bitDepth == 1 || bitDepth == 2 || bitDepth == 4 || bitDepth == 8 || bitDepth == 16;
+    case 3: return bitDepth == 1 || bitDepth == 2 || bitDepth == 4 || bitDepth == 8;
+    case 2:
+    case 4:
+    case 6: return bitDepth == 8 || bitDepth == 16;
+    default: return false;
+    }
+}
+
+bool decodePng(const uint8_t* data, std::size_t size, Image& image, std::string* error) {
+    std::size_t pos = 8;
+    PngHeader header;
+    PngPalette palette;
+    PngColorKey key;
+    std::vector<uint8_t> compressed;
+    bool seenHeader = false;
+    bool seenEnd = false;
+
+    while (!seenEnd) {
+        if (pos + 12 > size) return fail(error, "png: truncated chunk");
+        const uint32_t length = readBigEndian32(data + pos);
+        const uint8_t* type = data + pos + 4;
+        const uint8_t* body = data + pos + 8;
+        if (length > size - pos - 12) return fail(error, "png: chunk length exceeds file");
+        if (crc32(type, length + 4u) != readBigEndian32(body + length)) return fail(error, "png: chunk CRC mismatch");
+        pos += 12u + length;
+
+        if (std::memcmp(type, "IHDR", 4) == 0) {
+            if (length != 13) return fail(error, "png: invalid IHDR");
+            const uint32_t width = readBigEndian32(body);
+            const uint32_t height = readBigEndian32(body + 4);
+            if (!validDimensions(width, height)) return fail(error, "png: unsupported dimensions");
+            header.width = static_cast<int>(width);
+            header.height = static_cast<int>(height);
+            header.bitDepth = body[8];
+            header.colorType = body[9];
+            if (!validPngFormat(header.colorType, header.bitDepth)) return fail(error, "png: invalid color type / bit depth");
+            if (body[10] != 0 || body[11] != 0 || body[12] > 1) return fail(error, "png: unsupported compression, filter or interlace method");
+            header.interlaced = body[12] == 1;
+            static constexpr int kChannels[7] = {1, 0, 3, 1, 2, 0, 4};
+            header.channels = kChannels[header.colorType];
+            seenHeader = true;
+        } else if (!seenHeader) {
+            return fail(error, "png: IHDR must be the first chunk");
+        } else if (std::memcmp(type, "PLTE", 4) == 0) {
+            if (length % 3 != 0 || length / 3 > 256) return fail(error, "png: invalid PLTE");
+            palette.size = static_cast<int>(length / 3);
+            for (int i = 0; i < palette.size; ++i) {
+                palette.entries[i] = packRgba(body[i * 3], body[i * 3 + 1], body[i * 3 + 2], 255);
+            }
+        } else if (std::memcmp(type, "tRNS", 4) == 0) {
+            if (header.colorType == 3) {
+                for (uint32_t i = 0; i < length && static_cast<int>(i) < palette.size; ++i) {
+                    palette.entries[i] = (palette.entries[i] & 0xFFFFFF00u) | body[i];
+                }
+            } else if (header.colorType == 0 && length >= 2) {
+                key.enabled = true;
+                key.values[0] = readBigEndian16(body);
+            } else if (header.colorType == 2 && length >= 6) {
+                key.enabled = true;
+                for (int c = 0; c < 3; ++c) {
+                    key.values[c] = readBigEndian16(body + 2 * c);
+                }
+            }
+        } else if (std::memcmp(type, "IDAT", 4) == 0) {
+            compressed.insert(compressed.end(), body, body + length);
+        } else if (std::memcmp(type, "IEND", 4) == 0) {
+            seenEnd = true;
+        } else if ((type[0] & 0x20) == 0) {
+            // 首字母大写的是关键块，不认识时无法正确解码
+            return fail(error, "png: unknown critical chunk");
+        }
+    }
+    if (header.colorType == 3 && palette.size == 0) return fail(error, "png: missing PLTE");
+
+    // 各子图像（Adam7 共 7 遍，非隔行只有 1 遍）的起点与步长
+    static constexpr int kStartX[7] = {0, 4, 0, 2, 0, 1, 0};
+    static constexpr int kStartY[7] = {0, 0, 4, 0, 2, 0, 1};
+    static constexpr int kStepX[7] = {8, 8, 4, 4, 2, 2, 1};
+    static constexpr int kStepY[7] = {8, 8, 8, 4, 4, 2, 2};
+    const int passCount = header.interlaced ? 7 : 1;
+    const std::size_t bitsPerPixel = static_cast<std::size_t>(header.channels) * header.bitDepth;
+    const std::size_t bytesPerPixel = std::max<std::size_t>(1, bitsPerPixel / 8);
+
+    struct Pass {
+        int x0, y0, dx, dy, width, height;
+        std::size_t stride;
+    };
+    Pass passes[7];
+    std::size_t expectedSize = 0;
+    for (int p = 0; p < passCount; ++p) {
+        Pass& pass = passes[p];
+        pass.x0 = header.interlaced ? kStartX[p] : 0;
+        pass.y0 = header.interlaced ? kStartY[p] : 0;
+        pass.dx = header.interlaced ? kStepX[p] : 1;
+        pass.dy = header.interlaced ? kStepY[p] : 1;
+        pass.width = (header.width - pass.x0 + pass.dx - 1) / pass.dx;
+        pass.height = (header.height - pass.y0 + pass.dy - 1) / pass.dy;
+        pass.stride = (static_cast<std::size_t>(pass.width) * bitsPerPixel + 7) / 8;
+        // 空的子图像不占任何字节（也没有滤波类型字节）
+        if (pass.width > 0 && pass.height > 0) {
+            expectedSize += (pass.stride + 1) * static_cast<std::size_t>(pass.height);
+        }
+    }
+
+    // 解压结果不能超过 IHDR 决定的大小：少量压缩数据不能借此展开成巨大的分配
+    std::vector<uint8_t> raw;
+    raw.reserve(expectedSize);
+    if (!inflateZlib(compressed.data(), compressed.size(), raw, error, expectedSize)) return false;
+    if (raw.size() < expectedSize) return fail(error, "png: image data too short");
+
+    image.width = header.width;
+    image.height = header.height;
+    image.pixels.assign(static_cast<std::size_t>(header.width) * header.height, 0u);
+    uint8_t* cursor = raw.data();
+    for (int p = 0; p < passCount; ++p) {
+        const Pass& pass = passes[p];
+        if (pass.width == 0 || pass.height == 0) continue;
+        if (!unfilter(cursor, pass.height, pass.stride, bytesPerPixel, error)) return false;
+        for (int y = 0; y < pass.height; ++y) {
+            const uint8_t* row = cursor + static_cast<std::size_t>(y) * (pass.stride + 1) + 1;
+            uint32_t* out = image.pixels.data() + static_cast<std::size_t>(pass.y0 + y * pass.dy) * header.width + pass.x0;
+            convertRow(header, row, pass.width, palette, key, out, static_cast<std::size_t>(pass.dx));
+        }
+        cursor += (pass.stride + 1) * static_cast<std::size_t>(pass.height);
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------- PPM / PGM
+
+class PnmTokenizer {
+public:
+    PnmTokenizer(const uint8_t* data, std::size_t size) : m_data(data), m_size(size) {}
+
+    // 读取一个十进制整数，跳过空白与 # 注释
+    bool readInt(long long& value) {
+        while (m_pos < m_size) {
+            const uint8_t c = m_data[m_pos];
+            if (c == '#') {
+                while (m_pos < m_size && m_data[m_pos] != '\n' && m_data[m_pos] != '\r') ++m_pos;
+            } else if (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f') {
+                ++m_pos;
+            } else {
+                break;
+            }
+        }
+        if (m_pos >= m_size || m_data[m_pos] < '0' || m_data[m_pos] > '9') return false;
+        value = 0;
+        while (m_pos < m_size && m_data[m_pos] >= '0' && m_data[m_pos] <= '9') {
+            value = value * 10 + (m_data[m_pos] - '0');
+            if (value > 0xFFFFFFFFll) return false;
+            ++m_pos;
+        }
+        return true;
+    }
+
+    std::size_t position() const { return m_pos; }
+    void skip(std::size_t count) { m_pos += count; }
+
+private:
+    const uint8_t* m_data;
+    std::size_t m_size;
+    std::size_t m_pos = 0;
+};
+
+bool decodePnm(const uint8_t* data, std::size_t size, Image& image, std::string* error) {
+    const char kind = static_cast<char>(data[1]);
+    const bool ascii = kind == '2' || kind == '3';
+    const int channels = (kind == '3' || kind == '6') ? 3 : 1;
+
+    PnmTokenizer tokens(data, size);
+    tokens.skip(2);
+    long long width = 0, height = 0, maxValue = 0;
+    if (!tokens.readInt(width) || !tokens.readInt(height) || !tokens.readInt(maxValue)) {
+        return fail(error, "pnm: invalid header");
+    }
+    if (!validDimensions(width, height)) return fail(error, "pnm: unsupported dimensions");
+    if (maxValue <= 0 || maxValue > 65535) return fail(error, "pnm: invalid maxval");
+
+    // 分配像素之前先确认数据足够：ASCII 每个样本至少一位数字加一个分隔符
+    const std::size_t pixelCount = static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+    const std::size_t sampleCount = pixelCount * channels;
+    const std::size_t start = tokens.position() + 1;
+    const std::size_t bytesPerSample = ascii ? 2 : (maxValue > 255 ? 2 : 1);
+    if (start > size + (ascii ? 1 : 0) || (size + (ascii ? 1 : 0) - start) / bytesPerSample < sampleCount) {
+        return fail(error, "pnm: truncated pixel data");
+    }
+
+    image.width = static_cast<int>(width);
+    image.height = static_cast<int>(height);
+    image.pixels.resize(pixelCount);
+    const uint32_t maxSample = static_cast<uint32_t>(maxValue);
+    uint32_t samples[3];
+
+    if (ascii) {
+        for (std::size_t i = 0; i < pixelCount; ++i) {
+            for (int c = 0; c < channels; ++c) {
+                long long value = 0;
+                if (!tokens.readInt(value)) return fail(error, "pnm: truncated pixel data");
+                samples[c] = scaleTo8(static_cast<uint32_t>(std::min<long long>(value, maxSample)), maxSample);
+            }
+            image.pixels[i] = channels == 3 ? packRgba(samples[0], samples[1], samples[2], 255)
+                                            : packRgba(samples[0], samples[0], samples[0], 255);
+        }
+        return true;
+    }
+
+    // 二进制格式：maxval 之后恰好一个空白字符，然后是像素数据（maxval > 255 时为 16 位大端）
+    const uint8_t* p = data + start;
+    for (std::size_t i = 0; i < pixelCount; ++i) {
+        for (int c = 0; c < channels; ++c) {
+            const uint32_t value = bytesPerSample == 2 ? readBigEndian16(p) : *p;
+            p += bytesPerSample;
+            samples[c] = scaleTo8(value, maxSample);
+        }
+        image.pixels[i] = channels == 3 ? packRgba(samples[0], samples[1], samples[2], 255)
+                                        : packRgba(samples[0], samples[0], samples[0], 255);
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------- TGA
+
+inline uint32_t readLittleEndian16(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8);
+}
+
+// 按位深解释一个 TGA 像素（小端 BGR(A)；15/16 位为 ARGB1555）
+uint32_t decodeTgaPixel(const uint8_t* p, int bits, bool grayscale, bool useAlphaBit) {
+    switch (bits) {
+    case 8:
+        return grayscale ? packRgba(p[0], p[0], p[0], 255) : packRgba(0, 0, 0, 255);
+    case 15:
+    case 16: {
+        const uint32_t v = readLittleEndian16(p);
+        const uint32_t r = scaleTo8((v >> 10) & 0x1F, 31);
+        const uint32_t g = scaleTo8((v >> 5) & 0x1F, 31);
+        const uint32_t b = scaleTo8(v & 0x1F, 31);
+        const uint32_t a = (bits == 16 && useAlphaBit) ? ((v & 0x8000u) ? 255u : 0u) : 255u;
+        return packRgba(r, g, b, a);
+    }
+    case 24:
+        return packRgba(p[2], p[1], p[0], 255);
+    default:
+        return packRgba(p[2], p[1], p[0], p[3]);
+    }
+}
+
+bool decodeTga(const uint8_t* data, std::size_t size, Image& image, std::string* error) {
+    if (size < 18) return fail(error, "tga: truncated header");
+    const int idLength = data[0];
+    const int colorMapType = data[1];
+    const int imageType = data[2];
+    const int colorMapFirst = static_cast<int>(readLittleEndian16(data + 3));
+    const int colorMapLength = static_cast<int>(readLittleEndian16(data + 5));
+    const int colorMapBits = data[7];
+    const int width = static_cast<int>(readLittleEndian16(data + 12));
+    const int height = static_cast<int>(readLittleEndian16(data + 14));
+    const int pixelBits = data[16];
+    const int descriptor = data[17];
+
+    const bool rle = imageType >= 9;
+    const int baseType = rle ? imageType - 8 : imageType;
+    if (colorMapType > 1 || baseType < 1 || baseType > 3 || (imageType > 3 && imageType < 9) || imageType > 11) {
+        return fail(error, "tga: unsupported image type");
+    }
+    if (!validDimensions(width, height)) return fail(error, "tga: unsupported dimensions");
+    const bool indexed = baseType == 1;
+    const bool grayscale = baseType == 3;
+    if (indexed ? (pixelBits != 8 || colorMapType != 1)
+                : grayscale ? pixelBits != 8
+                            : (pixelBits != 15 && pixelBits != 16 && pixelBits != 24 && pixelBits != 32)) {
+        return fail(error, "tga: unsupported pixel depth");
+    }
+    const bool useAlphaBit = (descriptor & 0x0F) != 0;
+
+    std::size_t pos = 18u + static_cast<std::size_t>(idLength);
+    std::vector<uint32_t> colorMap;
+    if (colorMapType == 1) {
+        if (colorMapBits != 15 && colorMapBits != 16 && colorMapBits != 24 && colorMapBits != 32) {
+            return fail(error, "tga: unsupported color map depth");
+        }
+        const std::size_t entryBytes = static_cast<std::size_t>((colorMapBits + 7) / 8);
+        if (pos + entryBytes * colorMapLength > size) return fail(error, "tga: truncated color map");
+        colorMap.resize(static_cast<std::size_t>(colorMapLength));
+        for (int i = 0; i < colorMapLength; ++i) {
+            colorMap[i] = decodeTgaPixel(data + pos + entryBytes * i, colorMapBits, false, useAlphaBit);
+        }
+        pos += entryBytes * colorMapLength;
+    }
+
+    const std::size_t pixelBytes = static_cast<std::size_t>((pixelBits + 7) / 8);
+    auto decodePixel = [&](const uint8_t* p) {
+        if (indexed) {
+            const int index = p[0] - colorMapFirst;
+            return index >= 0 && index < static_cast<int>(colorMap.size()) ? colorMap[index] : packRgba(0, 0, 0, 255);
+        }
+        return decodeTgaPixel(p, pixelBits, grayscale, useAlphaBit);
+    };
+
+    // 先按文件顺序解出所有像素，再按原点位置翻转
+    const std::size_t pixelCount = static_cast<std::size_t>(width) * height;
+    // RLE 包最多展开成 128 个像素，剩余数据不够时不必分配
+    if (pos > size || (size - pos) * 128 < pixelCount) return fail(error, "tga: truncated pixel data");
+    std::vector<uint32_t> decoded(pixelCount);
+    if (!rle) {
+        if (pos + pixelBytes * pixelCount > size) return fail(error, "tga: truncated pixel data");
+        for (std::size_t i = 0; i < pixelCount; ++i) {
+            decoded[i] = decodePixel(data + pos + pixelBytes * i);
+        }
+    } else {
+        // RLE 包可以跨越扫描线
+        std::size_t i = 0;
+        while (i < pixelCount) {
+            if (pos >= size) return fail(error, "tga: truncated RLE data");
+            const int packet = data[pos++];
+            const std::size_t count = std::min<std::size_t>(static_cast<std::size_t>(packet & 0x7F) + 1, pixelCount - i);
+            if (packet & 0x80) {
+                if (pos + pixelBytes > size) return fail(error, "tga: truncated RLE data");
+                std::fill(decoded.begin() + i, decoded.begin() + i + count, decodePixel(data + pos));
+                pos += pixelBytes;
+            } else {
+                if (pos + pixelBytes * count > size) return fail(error, "tga: truncated RLE data");
+                for (std::size_t k = 0; k < count; ++k) {
+                    decoded[i + k] = decodePixel(data + pos + pixelBytes * k);
+                }
+                pos += pixelBytes * count;
+            }
+            i += count;
+        }
+    }
+
+    const bool topToBottom = (descriptor & 0x20) != 0;
+    const bool rightToLeft = (descriptor & 0x10) != 0;
+    image.width = width;
+    image.height = height;
+    image.pixels.resize(pixelCount);
+    for (int y = 0; y < height; ++y) {
+        const int srcY = topToBottom ? y : height - 1 - y;
+        for (int x = 0; x < width; ++x) {
+            const int srcX = rightToLeft ? width - 1 - x : x;
+            image.pixels[static_cast<std::size_t>(y) * width + x] = decoded[static_cast<std::size_t>(srcY) * width + srcX];
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool inflateZlib(const uint8_t* data, std::size_t size, std::vector<uint8_t>& out, std::string* error,
+                 std::size_t maxOutput) {
+    if (size < 6) return fail(error, "zlib: stream too short");
+    const uint32_t cmf = data[0];
+    const uint32_t flg = data[1];
+    if ((cmf & 0x0F) != 8 || (cmf >> 4) > 7 || ((cmf << 8) | flg) % 31 != 0) return fail(error, "zlib: invalid header");
+    if (flg & 0x20) return fail(error, "zlib: preset dictionary not supported");
+
+    const std::size_t streamStart = out.size();
+    const std::size_t outputEnd = maxOutput > SIZE_MAX - streamStart ? SIZE_MAX : streamStart + maxOutput;
+    BitReader reader(data + 2, size - 2);
+    Huffman literals;
+    Huffman distances;
+    bool last = false;
+    while (!last) {
+        last = reader.read(1) != 0;
+        const uint32_t type = reader.read(2);
+        if (type == 0) {
+            const std::size_t pos = reader.alignToByte();
+            if (pos + 4 > size - 2) return fail(error, "inflate: truncated stored block");
+            const uint8_t* header = data + 2 + pos;
+            const uint32_t length = readLittleEndian16(header);
+            if ((length ^ 0xFFFFu) != readLittleEndian16(header + 2)) return fail(error, "inflate: stored block length mismatch");
+            if (pos + 4 + length > size - 2) return fail(error, "inflate: truncated stored block");
+            if (length > outputEnd - out.size()) return fail(error, "inflate: output exceeds limit");
+            out.insert(out.end(), header + 4, header + 4 + length);
+            reader.skipBytes(4u + length);
+        } else if (type == 1) {
+            if (!buildFixedTables(literals, distances)) return fail(error, "inflate: internal error");
+            if (!inflateBlock(reader, literals, distances, out, outputEnd, streamStart, error)) return false;
+        } else if (type == 2) {
+            if (!readDynamicTables(reader, literals, distances, error)) return false;
+            if (!inflateBlock(reader, literals, distances, out, outputEnd, streamStart, error)) return false;
+        } else {
+            return fail(error, "inflate: invalid block type");
+        }
+        if (reader.overrun()) return fail(error, "inflate: truncated stream");
+    }
+
+    const std::size_t pos = reader.alignToByte();
+    if (pos + 4 > size - 2) return fail(error, "zlib: missing Adler-32 checksum");
+    if (adler32(out.data() + streamStart, out.size() - streamStart) != readBigEndian32(data + 2 + pos)) {
+        return fail(error, "zlib: Adler-32 mismatch");
+    }
+    return true;
+}
+
+bool decodeImage(const uint8_t* data, std::size_t size, Image& image, std::string* error) {
+    static constexpr uint8_t kPngSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    if (size >= 8 && std::memcmp(data, kPngSignature, 8) == 0) {
+        return decodePng(data, size, image, error);
+    }
+    if (size >= 2 && data[0] == 'P' && (data[1] == '2' || data[1] == '3' || data[1] == '5' || data[1] == '6')) {
+        return decodePnm(data, size, image, error);
+    }
+    // TGA 没有魔数，其余情况都按 TGA 尝试（文件头校验失败时报告不支持的格式）
+    return decodeTga(data, size, image, error);
+}
+
+bool loadImage(const std::string& filename, Image& image, std::string* error) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return fail(error, "cannot open file");
+    }
+    const std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return decodeImage(bytes.data(), bytes.size(), image, error);
+}
+
+} // namespace Types
+} // namespace Core
@@ -0,0 +1,50 @@
+#ifndef CORE_TYPES_IMAGE_LOADER_H
+#define CORE_TYPES_IMAGE_LOADER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Core {
+namespace Types {
+
+/**
+ * @brief 解码后的 8 位 RGBA 图像
+ *
+ * 像素按行主序、从上到下排列，打包格式与 Color::toUint32 相同（R 在最高字节，A 在最低字节）。
+ */
+struct Image {
+    int width = 0;
+    int height = 0;
+    std::vector<uint32_t> pixels;
+};
+
+/**
+ * @brief 按内容识别格式并解码：PNG（全部颜色类型与位深、tRNS、Adam7 隔行）、
+ * PPM/PGM（P2/P3/P5/P6，maxval 至 65535）、TGA（真彩色/灰度/调色板及其 RLE 变体）
+ *
+ * 灰度展开为 RGB，缺少 alpha 的格式 alpha 为 255，16 位通道四舍五入到 8 位。
+ * @param error 非空时在失败时写入原因
+ * @return 成功返回 true；失败时 image 内容未定义
+ */
+bool decodeImage(const uint8_t* data, std::size_t size, Image& image, std::string* error = nullptr);
+
+/**
+ * @brief 读取整个文件后调用 decodeImage
+ */
+bool loadImage(const std::string& filename, Image& image, std::string* error = nullptr);
+
+/**
+ * @brief 解压 zlib 流（RFC 1950/1951：存储、固定与动态 Huffman 块），校验 Adler-32
+ *
+ * 解压结果追加到 out 末尾。PNG 的 IDAT 数据即为一个 zlib 流。
+ * @param maxOutput 本次解压最多产生的字节数，超出即失败（PNG 按 IHDR 计算的扫描线总字节数传入）
+ */
+bool inflateZlib(const uint8_t* data, std::size_t size, std::vector<uint8_t>& out, std::string* error = nullptr,
+                 std::size_t maxOutput = SIZE_MAX);
+
+} // namespace Types
+} // namespace Core
+
+#endif // CORE_TYPES_IMAGE_LOADER_H
@@ -12,7 +12,12 @@ Material::Material()
       m_specular(0.5f, 0.5f, 0.5f, 1.0f),
       m_shininess(32.0f),
       m_diffuseMap(nullptr),
-      m_normalMap(nullptr) {}
+      m_normalMap(nullptr),
+      m_lightingFrequency(LightingFrequency::Inherit),
+      m_shadingRate(ShadingRate::Inherit),
+      m_shadingModel(ShadingModel::BlinnPhong),
+      m_metallic(0.0f),
+      m_roughness(0.5f) {}
 
 Material::Material(const Color& ambient, const Color& diffuse, const Color& specular, float shininess)
     : m_ambient(ambient),
@@ -20,7 +25,12 @@ Material::Material(const Color& ambient, const Color& diffuse, const Color& spec
       m_specular(specular),
       m_shininess(shininess),
       m_diffuseMap(nullptr),
-      m_normalMap(nullptr) {}
+      m_normalMap(nullptr),
+      m_lightingFrequency(LightingFrequency::Inherit),
+      m_shadingRate(ShadingRate::Inherit),
+      m_shadingModel(ShadingModel::BlinnPhong),
+      m_metallic(0.0f),
+      m_roughness(0.5f) {}
 
 Material::~Material() = default;
 
@@ -55,6 +65,17 @@ Color Material::sampleAlbedo(const Vector2& texCoord,
     return m_diffuse;
 }
 
+void Material::sampleAlbedo8(const float* u, const float* v,
+                             float dudx, float dudy,
+                             float dvdx, float dvdy,
+                             Color* out) const {
+    if (m_diffuseMap) {
+        m_diffuseMap->sample8(u, v, dudx, dudy, dvdx, dvdy, out);
+        return;
+    }
+    std::fill(out, out + 8, m_diffuse);
+}
+
 Vector3 Material::sampleNormal(const Vector2& texCoord) const {
     if (m_normalMap) {
         Color normalColor = m_normalMap->sample(texCoord.x, texCoord.y);
@@ -111,5 +132,14 @@ Material* Material::createWhiteDiffuse() {
     );
 }
 
+Material* Material::createMetallicRoughness(const Color& baseColor, float metallic, float roughness) {
+    Material* material = new Material();
+    material->setDiffuse(baseColor);
+    material->setShadingModel(ShadingModel::MetallicRoughness);
+    material->setMetallic(metallic);
+    material->setRoughness(roughness);
+    return material;
+}
+
 } // namespace Types
 } // namespace Core
@@ -12,6 +12,28 @@ class Texture;
 using Core::Math::Vector2;
 using Core::Math::Vector3;
 
+// 光照计算频率：逐像素、逐顶点（Gouraud），或按投影三角形大小自动选择
+enum class LightingFrequency {
+    Inherit,   // 沿用上一级设置（物体 → 材质 → 渲染器）
+    PerPixel,
+    PerVertex,
+    Auto
+};
+
+// 可变着色率：每个 N×N 像素块（同一三角形内）只着色一次
+enum class ShadingRate {
+    Inherit,   // 沿用渲染器设置
+    Rate1x1,
+    Rate2x2,
+    Rate4x4
+};
+
+// 光照模型：经典 Blinn-Phong（环境/漫反射/高光/光泽度）或金属度-粗糙度 PBR（Cook-Torrance GGX）
+enum class ShadingModel {
+    BlinnPhong,
+    MetallicRoughness
+};
+
 class Material {
 private:
     Color m_ambient;
@@ -20,6 +42,11 @@ private:
     float m_shininess;
     Texture* m_diffuseMap;
     Texture* m_normalMap;
+    LightingFrequency m_lightingFrequency;
+    ShadingRate m_shadingRate;
+    ShadingModel m_shadingModel;
+    float m_metallic;   // [0, 1]，仅 MetallicRoughness 使用
+    float m_roughness;  // 感知粗糙度 [0, 1]，GGX α = roughness²
 
 public:
     Material();
@@ -32,6 +59,11 @@ public:
     float getShininess() const { return m_shininess; }
     Texture* getDiffuseMap() const { return m_diffuseMap; }
     Texture* getNormalMap() const { return m_normalMap; }
+    LightingFrequency getLightingFrequency() const { return m_lightingFrequency; }
+    ShadingRate getShadingRate() const { return m_shadingRate; }
+    ShadingModel getShadingModel() const { return m_shadingModel; }
+    float getMetallic() const { return m_metallic; }
+    float getRoughness() const { return m_roughness; }
 
     void setAmbient(const Color& ambient) { m_ambient = ambient; }
     void setDiffuse(const Color& diffuse) { m_diffuse = diffuse; }
@@ -39,6 +71,11 @@ public:
     void setShininess(float shininess) { m_shininess = shininess; }
     void setDiffuseMap(Texture* texture) { m_diffuseMap = texture; }
     void setNormalMap(Texture* texture) { m_normalMap = texture; }
+    void setLightingFrequency(LightingFrequency frequency) { m_lightingFrequency = frequency; }
+    void setShadingRate(ShadingRate rate) { m_shadingRate = rate; }
+    void setShadingModel(ShadingModel model) { m_shadingModel = model; }
+    void setMetallic(float metallic) { m_metallic = metallic; }
+    void setRoughness(float roughness) { m_roughness = roughness; }
 
     Color calculateLighting(const Vector3& normal, const Vector3& lightDir,
                             const Vector3& viewDir, const Vector3& worldPos) const;
@@ -48,6 +85,12 @@ public:
                        float dudx, float dudy,
                        float dvdx, float dvdy) const;
 
+    // 8 个纹理坐标共用一组导数的批量采样（包着色用），逐个结果与 sampleAlbedo 相同
+    void sampleAlbedo8(const float* u, const float* v,
+                       float dudx, float dudy,
+                       float dvdx, float dvdy,
+                       Color* out) const;
+
     Vector3 sampleNormal(const Vector2& texCoord) const;
 
     const uint32_t* getDiffuseMapPixels() const;
@@ -56,6 +99,8 @@ public:
     static Material* createRedPlastic();
     static Material* createBlueMetal();
     static Material* createWhiteDiffuse();
+    // 金属度-粗糙度材质：baseColor 写入漫反射色（同时作为金属的 F0）
+    static Material* createMetallicRoughness(const Color& baseColor, float metallic, float roughness);
 };
 
 } // namespace Types
@@ -0,0 +1,279 @@
+#include "mip_generation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "../platform/parallel.h"
+
+namespace Core {
+namespace Types {
+
+namespace {
+
+constexpr int kTaps = 8;
+constexpr int kReach = 3;     // 8 tap 时 2×2 之外每侧多读的纹素数
+
+// sRGB ↔ 线性的查找表：解码为 16 位定点与浮点，编码按 16 位定点线性值直接查表
+struct SrgbTables {
+    uint16_t toLinear[256];
+    float toLinearFloat[256];
+    float unorm[256]; // 不做变换的 v / 255，用于 alpha 与非 sRGB 通道
+    uint8_t fromLinear[65536];
+};
+
+double srgbToLinear(double value) {
+    return value <= 0.04045 ? value / 12.92 : std::pow((value + 0.055) / 1.055, 2.4);
+}
+
+double linearToSrgb(double value) {
+    return value <= 0.0031308 ? value * 12.92 : 1.055 * std::pow(value, 1.0 / 2.4) - 0.055;
+}
+
+std::unique_ptr<SrgbTables> buildSrgbTables() {
+    std::unique_ptr<SrgbTables> tables(new SrgbTables());
+    for (int i = 0; i < 256; ++i) {
+        const double linear = srgbToLinear(i / 255.0);
+        tables->toLinear[i] = static_cast<uint16_t>(std::lround(linear * 65535.0));
+        tables->toLinearFloat[i] = static_cast<float>(linear);
+        tables->unorm[i] = static_cast<float>(i / 255.0);
+    }
+    for (int i = 0; i < 65536; ++i) {
+        tables->fromLinear[i] = static_cast<uint8_t>(std::lround(linearToSrgb(i / 65535.0) * 255.0));
+    }
+    return tables;
+}
+
+const SrgbTables& srgbTables() {
+    static const std::unique_ptr<SrgbTables> tables = buildSrgbTables();
+    return *tables;
+}
+
+// 四个打包颜色逐通道求平均并四舍五入：0x00FF00FF 把四个通道分成两组，各在 16 位子字中累加（4 × 255 + 2 不会溢出）
+inline uint32_t averagePacked(uint32_t a, uint32_t b, uint32_t c, uint32_t d) {
+    constexpr uint32_t kMask = 0x00FF00FFu;
+    constexpr uint32_t kRound = 0x00020002u;
+    const uint32_t low = (a & kMask) + (b & kMask) + (c & kMask) + (d & kMask) + kRound;
+    const uint32_t high = ((a >> 8) & kMask) + ((b >> 8) & kMask) + ((c >> 8) & kMask) + ((d >> 8) & kMask) + kRound;
+    return ((low >> 2) & kMask) | ((high << 6) & ~kMask);
+}
+
+inline uint32_t averageSrgb(const SrgbTables& tables, uint32_t a, uint32_t b, uint32_t c, uint32_t d) {
+    uint32_t result = (((a & 0xFFu) + (b & 0xFFu) + (c & 0xFFu) + (d & 0xFFu) + 2u) >> 2);
+    for (int shift = 8; shift < 32; shift += 8) {
+        const uint32_t sum = tables.toLinear[(a >> shift) & 0xFFu] + tables.toLinear[(b >> shift) & 0xFFu] +
+                             tables.toLinear[(c >> shift) & 0xFFu] + tables.toLinear[(d >> shift) & 0xFFu];
+        result |= static_cast<uint32_t>(tables.fromLinear[(sum + 2u) >> 2]) << shift;
+    }
+    return result;
+}
+
+// 同一行上 2x、2x + 1 两个纹素作为一个 64 位字读入（行主序与 Morton 序中这两个纹素都相邻）
+inline uint64_t loadPair(const uint32_t* texels) {
+    uint64_t pair;
+    std::memcpy(&pair, texels, sizeof(pair));
+    return pair;
+}
+
+// 两个目标纹素一起平均：p0、q0 为第一个目标纹素上下两行的纹素对，p1、q1 为第二个；结果低 32 位为第一个目标纹素。
+// 与 averagePacked 相同地把通道分成两组在 16 位子字中累加上下两行，再把纹素对的两半对折相加并四舍五入
+inline uint64_t averagePairs(uint64_t p0, uint64_t q0, uint64_t p1, uint64_t q1) {
+    constexpr uint64_t kMask = 0x00FF00FF00FF00FFull;
+    constexpr uint64_t kLow = 0x00000000FFFFFFFFull;
+    constexpr uint64_t kRound = 0x0002000200020002ull;
+    const uint64_t even0 = (p0 & kMask) + (q0 & kMask);
+    const uint64_t even1 = (p1 & kMask) + (q1 & kMask);
+    const uint64_t odd0 = ((p0 >> 8) & kMask) + ((q0 >> 8) & kMask);
+    const uint64_t odd1 = ((p1 >> 8) & kMask) + ((q1 >> 8) & kMask);
+    const uint64_t even = (((even0 + (even0 >> 32)) & kLow) | ((even1 + (even1 << 32)) & ~kLow)) + kRound;
+    const uint64_t odd = (((odd0 + (odd0 >> 32)) & kLow) | ((odd1 + (odd1 << 32)) & ~kLow)) + kRound;
+    return ((even >> 2) & kMask) | ((odd << 6) & ~kMask);
+}
+
+void boxRows(const MipLevelView& source, const MipLevelView& target, int x0, int x1,
+             int rowBegin, int rowEnd, bool srgb) {
+    const SrgbTables& tables = srgbTables();
+    // 目标纹素 (x, y) 读取上一级的 2x、2x + 1 与 2y、2y + 1（边界截断）；列偏移每段只查一次
+    const int count = x1 - x0;
+    std::vector<uint32_t> offsets(static_cast<std::size_t>(count) * 3);
+    uint32_t* col0 = offsets.data();
+    uint32_t* col1 = col0 + count;
+    uint32_t* dst = col1 + count;
+    // 2x + 1 仍在上一级内且与 2x 相邻的前缀按 64 位成对读取
+    int pairCount = 0;
+    for (int i = 0; i < count; ++i) {
+        const int x = x0 + i;
+        col0[i] = source.xOffset[std::min(2 * x, source.width - 1)];
+        col1[i] = source.xOffset[std::min(2 * x + 1, source.width - 1)];
+        dst[i] = target.xOffset[x];
+        if (pairCount == i && 2 * x + 1 < source.width && col1[i] == col0[i] + 1) {
+            ++pairCount;
+        }
+    }
+    pairCount &= ~1;
+    for (int y = rowBegin; y < rowEnd; ++y) {
+        const uint32_t* row0 = source.pixels + source.yOffset[std::min(2 * y, source.height - 1)];
+        const uint32_t* row1 = source.pixels + source.yOffset[std::min(2 * y + 1, source.height - 1)];
+        uint32_t* out = target.pixels + target.yOffset[y];
+        if (srgb) {
+            for (int i = 0; i < count; ++i) {
+                out[dst[i]] = averageSrgb(tables, row0[col0[i]], row0[col1[i]], row1[col0[i]], row1[col1[i]]);
+            }
+            continue;
+        }
+        for (int i = 0; i < pairCount; i += 2) {
+            const uint64_t average = averagePairs(loadPair(row0 + col0[i]), loadPair(row1 + col0[i]),
+                                                  loadPair(row0 + col0[i + 1]), loadPair(row1 + col0[i + 1]));
+            out[dst[i]] = static_cast<uint32_t>(average);
+            out[dst[i + 1]] = static_cast<uint32_t>(average >> 32);
+        }
+        for (int i = pairCount; i < count; ++i) {
+            out[dst[i]] = averagePacked(row0[col0[i]], row0[col1[i]], row1[col0[i]], row1[col1[i]]);
+        }
+    }
+}
+
+double besselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 32; ++k) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+double sinc(double x) {
+    constexpr double kPi = 3.14159265358979323846;
+    return x == 0.0 ? 1.0 : std::sin(kPi * x) / (kPi * x);
+}
+
+// 第 k 个 tap 位于上一级的 2x - 3 + k，到目标纹素中心（2x + 0.5）的距离以目标纹素为单位为 (k - 3.5) / 2
+void filterWeights(MipFilter filter, float weights[kTaps]) {
+    constexpr double kKaiserAlpha = 4.0;
+    double sum = 0.0;
+    double raw[kTaps];
+    for (int k = 0; k < kTaps; ++k) {
+        const double t = (k - 3.5) * 0.5;
+        if (filter == MipFilter::Lanczos) {
+            raw[k] = sinc(t) * sinc(t * 0.5);
+        } else {
+            const double r = t * 0.5; // 窗宽为 ±2 个目标纹素
+            raw[k] = sinc(t) * besselI0(kKaiserAlpha * std::sqrt(std::max(0.0, 1.0 - r * r))) / besselI0(kKaiserAlpha);
+        }
+        sum += raw[k];
+    }
+    for (int k = 0; k < kTaps; ++k) {
+        weights[k] = static_cast<float>(raw[k] / sum);
+    }
+}
+
+inline uint32_t encodeUnorm(float value) {
+    return static_cast<uint32_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+void separableRows(const MipLevelView& source, const MipLevelView& target, int x0, int x1,
+                   int rowBegin, int rowEnd, const float filterWeights[kTaps], bool srgb) {
+    // 局部副本：写入浮点缓冲时编译器不必假设权重被改写
+    float weights[kTaps];
+    std::copy(filterWeights, filterWeights + kTaps, weights);
+    const SrgbTables& tables = srgbTables();
+    const float* colorTable = srgb ? tables.toLinearFloat : tables.unorm;
+    const int count = x1 - x0;
+
+    // 目标列 x0 … x1 - 1 读取上一级的 2x0 - 3 … 2x1 + 2 列（截断后的寻址偏移）；
+    // 每行先把这些纹素解码成浮点，相邻目标列共用的 tap 只解码一次
+    const int sourceCount = 2 * count + kTaps - 2;
+    std::vector<uint32_t> columns(static_cast<std::size_t>(sourceCount));
+    for (int i = 0; i < sourceCount; ++i) {
+        columns[i] = source.xOffset[std::clamp(2 * x0 - kReach + i, 0, source.width - 1)];
+    }
+    std::vector<float> decoded(static_cast<std::size_t>(sourceCount) * 4);
+
+    // 水平滤波结果的环形缓冲：上一级第 r 行存放在第 r % 8 行，每行 count 个纹素 × 4 个通道（R、G、B、A）；
+    // 相邻目标行共用 6 行，每个上一级行只滤波一次
+    // 行距多留一条缓存行：宽度为 2 的幂时 8 行的起点不会全部映射到同一组缓存
+    const std::size_t rowFloats = static_cast<std::size_t>(count) * 4;
+    const std::size_t rowStride = rowFloats + 16;
+    std::vector<float> horizontal(rowStride * kTaps);
+    auto filterSourceRow = [&](int sourceRow) {
+        const uint32_t* row = source.pixels + source.yOffset[std::clamp(sourceRow, 0, source.height - 1)];
+        for (int i = 0; i < sourceCount; ++i) {
+            const uint32_t texel = row[columns[i]];
+            decoded[i * 4 + 0] = colorTable[texel >> 24];
+            decoded[i * 4 + 1] = colorTable[(texel >> 16) & 0xFFu];
+            decoded[i * 4 + 2] = colorTable[(texel >> 8) & 0xFFu];
+            decoded[i * 4 + 3] = tables.unorm[texel & 0xFFu];
+        }
+        // 权重对称（w[k] = w[7 - k]），成对相加后每个通道只需 4 次乘法
+        float* out = &horizontal[static_cast<std::size_t>(sourceRow & (kTaps - 1)) * rowStride];
+        for (int x = 0; x < count; ++x) {
+            const float* in = &decoded[static_cast<std::size_t>(x) * 8];
+            for (int c = 0; c < 4; ++c) {
+                out[x * 4 + c] = weights[0] * (in[c] + in[28 + c]) + weights[1] * (in[4 + c] + in[24 + c]) +
+                                 weights[2] * (in[8 + c] + in[20 + c]) + weights[3] * (in[12 + c] + in[16 + c]);
+            }
+        }
+    };
+
+    // 目标行 y 读取上一级的 2y - 3 … 2y + 4
+    for (int sourceRow = 2 * rowBegin - kReach; sourceRow < 2 * rowBegin + kReach; ++sourceRow) {
+        filterSourceRow(sourceRow);
+    }
+    for (int y = rowBegin; y < rowEnd; ++y) {
+        filterSourceRow(2 * y + kReach);
+        filterSourceRow(2 * y + kReach + 1);
+        const float* rows[kTaps];
+        for (int k = 0; k < kTaps; ++k) {
+            rows[k] = &horizontal[static_cast<std::size_t>((2 * y - kReach + k) & (kTaps - 1)) * rowStride];
+        }
+        uint32_t* out = target.pixels + target.yOffset[y];
+        for (int x = 0; x < count; ++x) {
+            float channel[4];
+            for (int c = 0; c < 4; ++c) {
+                const std::size_t i = static_cast<std::size_t>(x) * 4 + c;
+                channel[c] = weights[0] * (rows[0][i] + rows[7][i]) + weights[1] * (rows[1][i] + rows[6][i]) +
+                             weights[2] * (rows[2][i] + rows[5][i]) + weights[3] * (rows[3][i] + rows[4][i]);
+            }
+            uint32_t packed = encodeUnorm(channel[3]);
+            for (int c = 0; c < 3; ++c) {
+                const uint32_t value = srgb
+                    ? tables.fromLinear[static_cast<uint32_t>(std::clamp(channel[c], 0.0f, 1.0f) * 65535.0f + 0.5f)]
+                    : encodeUnorm(channel[c]);
+                packed |= value << (24 - 8 * c);
+            }
+            out[target.xOffset[x0 + x]] = packed;
+        }
+    }
+}
+
+} // namespace
+
+int mipFilterReach(MipFilter filter) {
+    return filter == MipFilter::Box ? 0 : kReach;
+}
+
+void downsampleMipRegion(const MipLevelView& source, const MipLevelView& target,
+                         int x0, int y0, int x1, int y1, MipFilter filter, bool srgb) {
+    if (x0 >= x1 || y0 >= y1) return;
+    if (filter == MipFilter::Box) {
+        // 每段至少约 4K 个目标纹素，小区域与高层级直接在当前线程执行
+        const int minRows = std::max(1, 4096 / (x1 - x0));
+        Core::Platform::parallelFor(y0, y1, [&](int rowBegin, int rowEnd) {
+            boxRows(source, target, x0, x1, rowBegin, rowEnd, srgb);
+        }, minRows);
+        return;
+    }
+    float weights[kTaps];
+    filterWeights(filter, weights);
+    // 8 tap 每个目标纹素的计算量远大于 Box，分段可以更小；每段开头多滤波 6 行上一级
+    const int minRows = std::max(4, 512 / (x1 - x0));
+    Core::Platform::parallelFor(y0, y1, [&](int rowBegin, int rowEnd) {
+        separableRows(source, target, x0, x1, rowBegin, rowEnd, weights, srgb);
+    }, minRows);
+}
+
+} // namespace Types
+} // namespace Core
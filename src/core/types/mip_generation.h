@@ -0,0 +1,49 @@
+#ifndef CORE_TYPES_MIP_GENERATION_H
+#define CORE_TYPES_MIP_GENERATION_H
+
+#include <cstdint>
+
+namespace Core {
+namespace Types {
+
+// mip 级之间的下采样滤波器
+enum class MipFilter {
+    Box,    // 2×2 平均
+    Kaiser, // Kaiser 窗（α = 4）sinc，每轴 8 tap，比 Box 保留更多细节
+    Lanczos // Lanczos2，每轴 8 tap，负瓣带来轻微锐化
+};
+
+/**
+ * @brief 一级 mip 的纹素视图：纹素 (x, y) 位于 pixels[xOffset[x] + yOffset[y]]（与 Texture::MipLevel 相同），
+ * 行主序与 Z 序存储都能直接处理
+ */
+struct MipLevelView {
+    uint32_t* pixels;
+    const uint32_t* xOffset;
+    const uint32_t* yOffset;
+    int width;
+    int height;
+};
+
+/**
+ * @brief 目标纹素 x 读取上一级的 [2x - reach, 2x + 1 + reach]（越界截断到边缘）
+ *
+ * Box 为 0，8 tap 的滤波器为 3；脏矩形向下一级传播时按此扩展。
+ */
+int mipFilterReach(MipFilter filter);
+
+/**
+ * @brief 由上一级 source 重新生成 target 的矩形 [x0, x1) × [y0, y1)（target 的坐标），按行分段并行
+ *
+ * Box 直接在打包的 RGBA8 上用 SWAR 求四个纹素的平均（四舍五入）；8 tap 滤波器可分离，
+ * 先对所需的上一级行做水平滤波，再在列方向合成，结果截断到 [0, 1]。
+ * srgb 为 true 时 RGB 按 sRGB 查表解码到线性空间再滤波、结果重新编码，避免在伽马空间平均使高对比度细节变暗；
+ * alpha 总是按线性值处理。
+ */
+void downsampleMipRegion(const MipLevelView& source, const MipLevelView& target,
+                         int x0, int y0, int x1, int y1, MipFilter filter, bool srgb);
+
+} // namespace Types
+} // namespace Core
+
+#endif // CORE_TYPES_MIP_GENERATION_H
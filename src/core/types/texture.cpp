@@ -1,18 +1,138 @@
 #include "texture.h"
+#include "block_compression.h"
+#include "image_loader.h"
 #include <algorithm>
 #include <cmath>
+#include <cstring>
+
+#include "../platform/parallel.h"
 
 namespace Core {
 namespace Types {
 
-Texture::Texture(int width, int height, bool shouldBuildMipmaps) {
+namespace {
+
+// 纹理坐标小数部分的定点位数；重复寻址即对 kUvOne - 1 取掩码。
+// 24 位与 [0.5, 1) 内浮点的尾数精度相当，乘以纹理宽度后在 16k 纹理上仍有约 1/1024 纹素的分辨率
+constexpr int kUvFractionBits = 24;
+constexpr uint32_t kUvWrapMask = (1u << kUvFractionBits) - 1u;
+constexpr float kUvScale = static_cast<float>(1u << kUvFractionBits);
+
+// 两个打包颜色按 w / 256（w ∈ [0, 256]）插值，0x00FF00FF 掩码把四个通道分成两组，各在 16 位子字中并行计算
+inline uint32_t lerpPacked(uint32_t a, uint32_t b, uint32_t w) {
+    constexpr uint32_t kMask = 0x00FF00FFu;
+    constexpr uint32_t kRound = 0x00800080u;
+    const uint32_t inv = 256u - w;
+    const uint32_t low = ((((a & kMask) * inv + (b & kMask) * w) + kRound) >> 8) & kMask;
+    const uint32_t high = ((((a >> 8) & kMask) * inv + ((b >> 8) & kMask) * w) + kRound) & ~kMask;
+    return low | high;
+}
+
+inline Color unpack(uint32_t color) {
+    constexpr float kInv255 = 1.0f / 255.0f;
+    return Color(static_cast<float>(color >> 24) * kInv255,
+                 static_cast<float>((color >> 16) & 0xFF) * kInv255,
+                 static_cast<float>((color >> 8) & 0xFF) * kInv255,
+                 static_cast<float>(color & 0xFF) * kInv255);
+}
+
+// 坐标取小数部分后转成 24 位定点（截断转整数后对负数修正为向下取整）
+inline uint32_t wrapCoordinate(float t) {
+    const float scaled = t * kUvScale;
+    int64_t fixed = static_cast<int64_t>(scaled);
+    fixed -= static_cast<float>(fixed) > scaled ? 1 : 0;
+    return static_cast<uint32_t>(fixed) & kUvWrapMask;
+}
+
+// 每线程的已解码块缓存：64 个槽按块坐标低 3 位（8×8 块，即 32×32 纹素的邻域）直接映射，
+// 再异或层级 id 的散列，三线性同时读取的两级不会固定落在同一槽。
+// 标签为 blockCacheId << 32 | 块序号，id 从 1 开始分配，零初始化的槽不会命中。
+struct DecodedBlock {
+    uint64_t tag;
+    uint32_t texels[16];
+};
+
+constexpr uint32_t kBlockCacheSlots = 64;
+thread_local DecodedBlock t_blockCache[kBlockCacheSlots];
+std::atomic<uint32_t> g_nextBlockCacheId{1};
+
+uint32_t allocateBlockCacheId() {
+    uint32_t id = g_nextBlockCacheId.fetch_add(1, std::memory_order_relaxed);
+    while (id == 0) {
+        id = g_nextBlockCacheId.fetch_add(1, std::memory_order_relaxed);
+    }
+    return id;
+}
+
+// 返回块 (bx, by) 解码后的 16 个纹素；相邻块的块坐标低 3 位不同，映射到不同的槽，
+// 因此双线性邻域取到的至多四个块指针在本次采样内都有效
+inline const uint32_t* decodedBlock(const Texture::MipLevel& level, uint32_t bx, uint32_t by) {
+    const uint32_t blockIndex = by * static_cast<uint32_t>(level.blocksPerRow) + bx;
+    const uint64_t tag = (static_cast<uint64_t>(level.blockCacheId) << 32) | blockIndex;
+    const uint32_t slotIndex = ((bx & 7u) | ((by & 7u) << 3)) ^ ((level.blockCacheId * 0x9E3779B1u) >> 26);
+    DecodedBlock& slot = t_blockCache[slotIndex];
+    if (slot.tag != tag) {
+        if (level.format == TextureFormat::BC1) {
+            decodeBC1Block(level.blocks[blockIndex], slot.texels);
+        } else {
+            decodeBC3Block(&level.blocks[static_cast<std::size_t>(blockIndex) * 2], slot.texels);
+        }
+        slot.tag = tag;
+    }
+    return slot.texels;
+}
+
+// 双线性采样的 2×2 邻域：小数坐标映射到 [0, width - 1]，在纹素空间中以 64 位乘积保留 24 位小数，
+// 权重取其最高 8 位；相邻纹素在边缘截断
+struct BilinearTaps {
+    int x0, y0, x1, y1;
+    uint32_t wx, wy; // 8 位权重
+};
+
+inline BilinearTaps bilinearTaps(int width, int height, float u, float v) {
+    const uint64_t fx = static_cast<uint64_t>(wrapCoordinate(u)) * static_cast<uint32_t>(width - 1);
+    const uint64_t fy = static_cast<uint64_t>(wrapCoordinate(v)) * static_cast<uint32_t>(height - 1);
+    BilinearTaps taps;
+    taps.x0 = static_cast<int>(fx >> kUvFractionBits);
+    taps.y0 = static_cast<int>(fy >> kUvFractionBits);
+    taps.x1 = std::min(taps.x0 + 1, width - 1);
+    taps.y1 = std::min(taps.y0 + 1, height - 1);
+    taps.wx = static_cast<uint32_t>(fx >> (kUvFractionBits - 8)) & 0xFFu;
+    taps.wy = static_cast<uint32_t>(fy >> (kUvFractionBits - 8)) & 0xFFu;
+    return taps;
+}
+
+inline uint32_t texelInBlock(const uint32_t* block, int x, int y) {
+    return block[((static_cast<uint32_t>(y) & 3u) << 2) | (static_cast<uint32_t>(x) & 3u)];
+}
+
+inline uint32_t fetchCompressedTexel(const Texture::MipLevel& level, int x, int y) {
+    return texelInBlock(decodedBlock(level, static_cast<uint32_t>(x) >> 2, static_cast<uint32_t>(y) >> 2), x, y);
+}
+
+} // namespace
+
+std::atomic<uint32_t> Texture::s_mipUseClock{0};
+
+Texture::Texture()
+    : m_mipState(new MipState()) {
+    m_mipState->lastUse.store(getMipUseClock(), std::memory_order_relaxed);
+}
+
+Texture::Texture(int width, int height, bool shouldBuildMipmaps)
+    : m_mipState(new MipState()) {
+    m_mipState->lastUse.store(getMipUseClock(), std::memory_order_relaxed);
     allocateLevels(width, height);
     if (shouldBuildMipmaps) {
         buildMipmaps();
+    } else {
+        markAllDirty();
     }
 }
 
-Texture::Texture(const std::vector<uint32_t>& pixels, int width, int height, bool shouldBuildMipmaps) {
+Texture::Texture(const std::vector<uint32_t>& pixels, int width, int height, bool shouldBuildMipmaps)
+    : m_mipState(new MipState()) {
+    m_mipState->lastUse.store(getMipUseClock(), std::memory_order_relaxed);
     allocateLevels(width, height);
     if (!pixels.empty()) {
         MipLevel& base = m_levels[0];
@@ -20,6 +140,8 @@ Texture::Texture(const std::vector<uint32_t>& pixels, int width, int height, boo
     }
     if (shouldBuildMipmaps) {
         buildMipmaps();
+    } else {
+        markAllDirty();
     }
 }
 
@@ -30,8 +152,14 @@ Color Texture::sample(float u, float v) const {
 Color Texture::sample(float u, float v,
                       float dudx, float dudy,
                       float dvdx, float dvdy) const {
-    int level = pickMipLevel(dudx, dudy, dvdx, dvdy);
-    return sampleLevel(u, v, level);
+    if (m_levels.empty()) {
+        return Color::BLACK;
+    }
+    const Footprint footprint = selectFootprint(dudx, dudy, dvdx, dvdy);
+    if (footprint.mip.level > 0 || footprint.mip.weight > 0) {
+        resolveMipmaps();
+    }
+    return unpack(samplePacked(u, v, footprint));
 }
 
 Color Texture::sampleLevel(float u, float v, int level) const {
@@ -39,67 +167,165 @@ Color Texture::sampleLevel(float u, float v, int level) const {
         return Color::BLACK;
     }
     level = std::clamp(level, 0, static_cast<int>(m_levels.size()) - 1);
-    return sampleBilinear(m_levels[level], u, v);
+    if (level > 0) {
+        resolveMipmaps();
+    }
+    return unpack(sampleLevelPacked(level, u, v));
+}
+
+void Texture::sample4(const float* u, const float* v,
+                      float dudx, float dudy, float dvdx, float dvdy, Color* out) const {
+    sampleBatch(4, u, v, dudx, dudy, dvdx, dvdy, out);
+}
+
+void Texture::sample8(const float* u, const float* v,
+                      float dudx, float dudy, float dvdx, float dvdy, Color* out) const {
+    sampleBatch(8, u, v, dudx, dudy, dvdx, dvdy, out);
+}
+
+void Texture::sampleBatch(int count, const float* u, const float* v,
+                          float dudx, float dudy, float dvdx, float dvdy, Color* out) const {
+    if (m_levels.empty()) {
+        std::fill(out, out + count, Color::BLACK);
+        return;
+    }
+    const Footprint footprint = selectFootprint(dudx, dudy, dvdx, dvdy);
+    if (footprint.mip.level > 0 || footprint.mip.weight > 0) {
+        resolveMipmaps();
+    }
+    uint32_t packed[8];
+    for (int i = 0; i < count; ++i) {
+        packed[i] = samplePacked(u[i], v[i], footprint);
+    }
+    for (int i = 0; i < count; ++i) {
+        out[i] = unpack(packed[i]);
+    }
 }
 
 void Texture::setPixel(int x, int y, const Color& color, int level) {
-    if (m_levels.empty()) return;
+    if (m_levels.empty() || !prepareForWrite()) return;
     level = std::clamp(level, 0, static_cast<int>(m_levels.size()) - 1);
+    if (level > 0) {
+        resolveMipmaps(); // 先补上待重建（或已释放）的 mip，直接写入才不会被随后的重建覆盖
+    }
     MipLevel& target = m_levels[level];
     if (x >= 0 && x < target.width && y >= 0 && y < target.height) {
-        target.pixels[y * target.width + x] = color.toUint32();
-        if (level == 0 && m_levels.size() > 1) {
-            buildMipmaps();
+        target.pixels[target.index(x, y)] = color.toUint32();
+        if (level == 0) {
+            markDirty(x, y, x + 1, y + 1);
+        }
+    }
+}
+
+void Texture::updateRegion(int x, int y, int width, int height, const uint32_t* pixels) {
+    if (m_levels.empty() || !pixels || !prepareForWrite()) return;
+    MipLevel& base = m_levels[0];
+    const int x0 = std::max(x, 0);
+    const int y0 = std::max(y, 0);
+    const int x1 = std::min(x + width, base.width);
+    const int y1 = std::min(y + height, base.height);
+    if (x0 >= x1 || y0 >= y1) return;
+    for (int row = y0; row < y1; ++row) {
+        const uint32_t* src = pixels + static_cast<size_t>(row - y) * width + (x0 - x);
+        if (m_layout == TextureLayout::Linear) {
+            std::copy(src, src + (x1 - x0), base.pixels.begin() + base.index(x0, row));
+        } else {
+            for (int col = x0; col < x1; ++col) {
+                base.pixels[base.index(col, row)] = src[col - x0];
+            }
+        }
+    }
+    markDirty(x0, y0, x1, y1);
+}
+
+void Texture::setMipFilter(MipFilter filter) {
+    if (filter == m_mipFilter || m_levels.empty() || !prepareForWrite()) return;
+    m_mipFilter = filter;
+    markAllDirty();
+}
+
+void Texture::setSrgb(bool srgb) {
+    if (srgb == m_srgb || m_levels.empty() || !prepareForWrite()) return;
+    m_srgb = srgb;
+    markAllDirty();
+}
+
+bool Texture::hasPendingMipmapUpdate() const {
+    return m_mipState && m_mipState->dirty.load(std::memory_order_acquire);
+}
+
+void Texture::updateMipmaps() const {
+    if (!m_mipState) return;
+    std::lock_guard<std::mutex> lock(m_mipState->mutex);
+    if (!m_mipState->dirty.load(std::memory_order_relaxed)) {
+        return; // 其他线程已重建
+    }
+    // mip 链是 level 0 的派生缓存，延迟重建不改变纹理的可见内容
+    Texture* self = const_cast<Texture*>(this);
+    std::vector<DirtyRect> rects;
+    rects.swap(m_mipState->rects);
+    const int reach = mipFilterReach(m_mipFilter);
+    for (std::size_t i = 1; i < m_levels.size(); ++i) {
+        MipLevel& current = self->m_levels[i];
+        if (current.pixels.empty()) {
+            // 被 releaseMipmaps 释放过：重新分配，释放时已标记整体重建
+            buildAddressing(current, m_layout);
+        }
+        for (DirtyRect& rect : rects) {
+            // 目标像素 x 读取上一级的 [2x - reach, 2x + 1 + reach]（边界截断），
+            // 受影响范围为 [(x0 - reach) / 2, (x1 - 1 + reach) / 2]
+            rect.x0 = std::min(std::max(rect.x0 - reach, 0) / 2, current.width - 1);
+            rect.y0 = std::min(std::max(rect.y0 - reach, 0) / 2, current.height - 1);
+            rect.x1 = std::min((rect.x1 - 1 + reach) / 2 + 1, current.width);
+            rect.y1 = std::min((rect.y1 - 1 + reach) / 2 + 1, current.height);
+            self->rebuildRegion(i, rect);
         }
     }
+    m_mipState->dirty.store(false, std::memory_order_release);
 }
 
 Color Texture::getPixel(int x, int y, int level) const {
     if (m_levels.empty()) return Color::BLACK;
     level = std::clamp(level, 0, static_cast<int>(m_levels.size()) - 1);
+    if (level > 0) {
+        resolveMipmaps();
+    }
+    if (m_virtual && level < m_virtual->getPagedLevels()) {
+        return Color::fromUint32(fetchVirtualTexel(level, x, y));
+    }
     return readPixel(m_levels[level], x, y);
 }
 
 void Texture::clear(const Color& color) {
-    if (m_levels.empty()) return;
-    uint32_t packed = color.toUint32();
-    for (auto& level : m_levels) {
-        std::fill(level.pixels.begin(), level.pixels.end(), packed);
-        if (&level != &m_levels[0]) break; // fill base, rebuild below
-    }
-    if (m_levels.size() > 1) {
-        buildMipmaps();
-    }
+    if (m_levels.empty() || !prepareForWrite()) return;
+    std::fill(m_levels[0].pixels.begin(), m_levels[0].pixels.end(), color.toUint32());
+    markAllDirty();
 }
 
 void Texture::generateCheckerboard(const Color& color1, const Color& color2, int squareSize) {
-    if (m_levels.empty()) return;
+    if (m_levels.empty() || !prepareForWrite()) return;
     MipLevel& base = m_levels[0];
     for (int y = 0; y < base.height; ++y) {
         for (int x = 0; x < base.width; ++x) {
             bool useFirst = ((x / squareSize) + (y / squareSize)) % 2 == 0;
-            base.pixels[y * base.width + x] = (useFirst ? color1 : color2).toUint32();
+            base.pixels[base.index(x, y)] = (useFirst ? color1 : color2).toUint32();
         }
     }
-    if (m_levels.size() > 1) {
-        buildMipmaps();
-    }
+    markAllDirty();
 }
 
 void Texture::generateGradient(const Color& topColor, const Color& bottomColor) {
-    if (m_levels.empty()) return;
+    if (m_levels.empty() || !prepareForWrite()) return;
     MipLevel& base = m_levels[0];
     for (int y = 0; y < base.height; ++y) {
         float t = base.height > 1 ? static_cast<float>(y) / static_cast<float>(base.height - 1) : 0.0f;
         Color rowColor = topColor * (1.0f - t) + bottomColor * t;
         uint32_t packed = rowColor.toUint32();
         for (int x = 0; x < base.width; ++x) {
-            base.pixels[y * base.width + x] = packed;
+            base.pixels[base.index(x, y)] = packed;
         }
     }
-    if (m_levels.size() > 1) {
-        buildMipmaps();
-    }
+    markAllDirty();
 }
 
 int Texture::getWidth(int level) const {
@@ -115,17 +341,73 @@ int Texture::getHeight(int level) const {
 }
 
 const uint32_t* Texture::getPixels(int level) const {
-    if (m_levels.empty()) return nullptr;
+    if (m_levels.empty() || m_format != TextureFormat::RGBA8) return nullptr;
     level = std::clamp(level, 0, static_cast<int>(m_levels.size()) - 1);
-    return m_levels[level].pixels.data();
+    if (level > 0) {
+        resolveMipmaps();
+    }
+    return m_levels[level].pixels.empty() ? nullptr : m_levels[level].pixels.data();
 }
 
-Texture* Texture::loadFromFile(const std::string& /*filename*/) {
-    // Placeholder loader: create a checkerboard texture for now.
-    Texture* texture = new Texture(128, 128, false);
-    texture->generateCheckerboard(Color::WHITE, Color(0.5f, 0.5f, 0.5f, 1.0f), 8);
-    texture->buildMipmaps();
-    return texture;
+Texture* Texture::loadFromFile(const std::string& filename, std::string* error) {
+    Image image;
+    if (!loadImage(filename, image, error)) {
+        return nullptr;
+    }
+    return new Texture(image.pixels, image.width, image.height, true);
+}
+
+Texture* Texture::loadVirtual(const std::string& filename, int capacity, std::string* error) {
+    std::unique_ptr<VirtualPageCache> pages(VirtualPageCache::open(filename, capacity, error));
+    if (!pages) {
+        return nullptr;
+    }
+    // 分页级只有尺寸，没有寻址表与纹素存储；mip 尾按行主序常驻
+    std::unique_ptr<Texture> texture(new Texture());
+    int width = pages->getWidth();
+    int height = pages->getHeight();
+    for (int level = 0; level < pages->getLevelCount(); ++level) {
+        MipLevel mip;
+        mip.width = width;
+        mip.height = height;
+        if (level >= pages->getPagedLevels()) {
+            buildAddressing(mip, TextureLayout::Linear, false);
+            if (!pages->readTailLevel(level, mip.pixels, error)) {
+                return nullptr;
+            }
+        }
+        texture->m_levels.push_back(std::move(mip));
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+    }
+    texture->m_virtual = std::move(pages);
+    return texture.release();
+}
+
+std::size_t Texture::getMemoryUsage() const {
+    std::size_t bytes = 0;
+    for (const MipLevel& level : m_levels) {
+        bytes += level.pixels.size() * sizeof(uint32_t) + level.blocks.size() * sizeof(uint64_t);
+    }
+    if (m_virtual) {
+        bytes += m_virtual->getMemoryUsage();
+    }
+    return bytes;
+}
+
+std::size_t Texture::releaseMipmaps() {
+    if (m_levels.size() <= 1 || !m_mipState || m_virtual) return 0;
+    std::lock_guard<std::mutex> lock(m_mipState->mutex);
+    std::size_t freed = 0;
+    for (std::size_t i = 1; i < m_levels.size(); ++i) {
+        freed += m_levels[i].pixels.size() * sizeof(uint32_t);
+        std::vector<uint32_t>().swap(m_levels[i].pixels);
+    }
+    if (freed > 0) {
+        m_mipState->rects.assign(1, DirtyRect{0, 0, m_levels[0].width, m_levels[0].height});
+        m_mipState->dirty.store(true, std::memory_order_release);
+    }
+    return freed;
 }
 
 Texture* Texture::createSolidColor(const Color& color, int width, int height) {
@@ -146,7 +428,7 @@ void Texture::allocateLevels(int width, int height) {
         MipLevel level;
         level.width = levelWidth;
         level.height = levelHeight;
-        level.pixels.resize(static_cast<size_t>(levelWidth * levelHeight), Color::BLACK.toUint32());
+        buildAddressing(level, m_layout);
         m_levels.push_back(std::move(level));
 
         if (levelWidth == 1 && levelHeight == 1) break;
@@ -155,76 +437,338 @@ void Texture::allocateLevels(int width, int height) {
     }
 }
 
-void Texture::buildMipmaps() {
-    if (m_levels.size() <= 1) return;
-    for (std::size_t i = 1; i < m_levels.size(); ++i) {
-        MipLevel& prev = m_levels[i - 1];
-        MipLevel& current = m_levels[i];
-        for (int y = 0; y < current.height; ++y) {
-            for (int x = 0; x < current.width; ++x) {
-                int srcX = x * 2;
-                int srcY = y * 2;
-                Color c00 = readPixel(prev, srcX, srcY);
-                Color c10 = readPixel(prev, srcX + 1, srcY);
-                Color c01 = readPixel(prev, srcX, srcY + 1);
-                Color c11 = readPixel(prev, srcX + 1, srcY + 1);
-                Color avg = (c00 + c10 + c01 + c11) * 0.25f;
-                current.pixels[y * current.width + x] = avg.toUint32();
+void Texture::setLayout(TextureLayout layout) {
+    if (layout == m_layout || m_virtual) return;
+    for (MipLevel& level : m_levels) {
+        if (level.pixels.empty()) {
+            // 已释放的 mip 与压缩的级只更新寻址表，重建或解压时按新布局分配
+            buildAddressing(level, layout, false);
+            continue;
+        }
+        MipLevel reordered;
+        reordered.width = level.width;
+        reordered.height = level.height;
+        buildAddressing(reordered, layout);
+        for (int y = 0; y < level.height; ++y) {
+            for (int x = 0; x < level.width; ++x) {
+                reordered.pixels[reordered.index(x, y)] = level.pixels[level.index(x, y)];
             }
         }
+        level = std::move(reordered);
     }
+    m_layout = layout;
 }
 
-int Texture::pickMipLevel(float dudx, float dudy, float dvdx, float dvdy) const {
-    if (m_levels.size() <= 1) return 0;
-    float dudxAbs = std::fabs(dudx);
-    float dudyAbs = std::fabs(dudy);
-    float dvdxAbs = std::fabs(dvdx);
-    float dvdyAbs = std::fabs(dvdy);
+void Texture::buildAddressing(MipLevel& level, TextureLayout layout, bool allocate) {
+    level.xOffset.resize(static_cast<size_t>(level.width));
+    level.yOffset.resize(static_cast<size_t>(level.height));
+    if (layout == TextureLayout::Linear) {
+        for (int x = 0; x < level.width; ++x) level.xOffset[x] = static_cast<uint32_t>(x);
+        for (int y = 0; y < level.height; ++y) level.yOffset[y] = static_cast<uint32_t>(y * level.width);
+        if (allocate) {
+            level.pixels.assign(static_cast<size_t>(level.width) * level.height, Color::BLACK.toUint32());
+        }
+        return;
+    }
+
+    // 宽高取到 2 的幂；低 min(bx, by) 位交错（x 在偶数位、y 在奇数位），较长一维的高位接在后面
+    int bitsX = 0, bitsY = 0;
+    while ((1 << bitsX) < level.width) ++bitsX;
+    while ((1 << bitsY) < level.height) ++bitsY;
+    const int shared = std::min(bitsX, bitsY);
+    auto spread = [shared](uint32_t value, int lane) {
+        uint32_t result = 0;
+        for (int bit = 0; bit < shared; ++bit) {
+            result |= ((value >> bit) & 1u) << (2 * bit + lane);
+        }
+        return result | ((value >> shared) << (2 * shared));
+    };
+    for (int x = 0; x < level.width; ++x) level.xOffset[x] = spread(static_cast<uint32_t>(x), 0);
+    // 只有较长的一维有剩余高位，两张表的位仍互不重叠
+    for (int y = 0; y < level.height; ++y) level.yOffset[y] = spread(static_cast<uint32_t>(y), 1);
+    if (allocate) {
+        level.pixels.assign(static_cast<size_t>(1u) << (bitsX + bitsY), Color::BLACK.toUint32());
+    }
+}
 
-    float rho = std::max({dudxAbs, dudyAbs, dvdxAbs, dvdyAbs});
-    if (rho < 1e-8f) return 0;
+void Texture::setFormat(TextureFormat format) {
+    if (format == m_format || m_virtual) return;
+    if (m_format != TextureFormat::RGBA8) {
+        for (MipLevel& level : m_levels) {
+            decodeLevel(level, m_layout);
+        }
+        m_format = TextureFormat::RGBA8;
+    }
+    if (format != TextureFormat::RGBA8) {
+        updateMipmaps(); // mip 从未压缩的上一级生成，编码前先补齐
+        for (MipLevel& level : m_levels) {
+            encodeLevel(level, format);
+        }
+        m_format = format;
+    }
+}
 
-    float baseWidth = static_cast<float>(m_levels[0].width);
-    float baseHeight = static_cast<float>(m_levels[0].height);
-    float lambda = std::log2(std::max(rho * std::max(baseWidth, baseHeight), 1.0f));
-    int level = static_cast<int>(std::floor(lambda));
-    return std::clamp(level, 0, static_cast<int>(m_levels.size()) - 1);
+void Texture::encodeLevel(MipLevel& level, TextureFormat format) {
+    const int blocksPerRow = (level.width + 3) / 4;
+    const int blockRows = (level.height + 3) / 4;
+    const std::size_t words = format == TextureFormat::BC3 ? 2 : 1;
+    std::vector<uint64_t> blocks(static_cast<std::size_t>(blocksPerRow) * blockRows * words);
+    // 每段至少约 64 个块；宽高不是 4 的倍数时边缘块重复最后一行 / 列
+    Core::Platform::parallelFor(0, blockRows, [&](int rowBegin, int rowEnd) {
+        uint32_t texels[16];
+        for (int by = rowBegin; by < rowEnd; ++by) {
+            for (int bx = 0; bx < blocksPerRow; ++bx) {
+                for (int i = 0; i < 16; ++i) {
+                    const int x = std::min(bx * 4 + (i & 3), level.width - 1);
+                    const int y = std::min(by * 4 + (i >> 2), level.height - 1);
+                    texels[i] = level.pixels[level.index(x, y)];
+                }
+                uint64_t* out = &blocks[(static_cast<std::size_t>(by) * blocksPerRow + bx) * words];
+                if (format == TextureFormat::BC1) {
+                    out[0] = encodeBC1Block(texels);
+                } else {
+                    encodeBC3Block(texels, out);
+                }
+            }
+        }
+    }, std::max(1, 64 / blocksPerRow));
+    level.blocks.swap(blocks);
+    level.blocksPerRow = blocksPerRow;
+    level.blockCacheId = allocateBlockCacheId();
+    level.format = format;
+    std::vector<uint32_t>().swap(level.pixels);
 }
 
-Color Texture::sampleBilinear(const MipLevel& level, float u, float v) const {
-    if (level.width == 0 || level.height == 0) {
-        return Color::BLACK;
+void Texture::decodeLevel(MipLevel& level, TextureLayout layout) {
+    buildAddressing(level, layout);
+    const int blockRows = (level.height + 3) / 4;
+    Core::Platform::parallelFor(0, blockRows, [&](int rowBegin, int rowEnd) {
+        uint32_t texels[16];
+        for (int by = rowBegin; by < rowEnd; ++by) {
+            for (int bx = 0; bx < level.blocksPerRow; ++bx) {
+                const std::size_t blockIndex = static_cast<std::size_t>(by) * level.blocksPerRow + bx;
+                if (level.format == TextureFormat::BC1) {
+                    decodeBC1Block(level.blocks[blockIndex], texels);
+                } else {
+                    decodeBC3Block(&level.blocks[blockIndex * 2], texels);
+                }
+                const int width = std::min(4, level.width - bx * 4);
+                const int height = std::min(4, level.height - by * 4);
+                for (int y = 0; y < height; ++y) {
+                    for (int x = 0; x < width; ++x) {
+                        level.pixels[level.index(bx * 4 + x, by * 4 + y)] = texels[y * 4 + x];
+                    }
+                }
+            }
+        }
+    }, std::max(1, 64 / std::max(1, level.blocksPerRow)));
+    std::vector<uint64_t>().swap(level.blocks);
+    level.blocksPerRow = 0;
+    level.blockCacheId = 0;
+    level.format = TextureFormat::RGBA8;
+}
+
+void Texture::buildMipmaps() {
+    markAllDirty();
+    updateMipmaps();
+}
+
+void Texture::markDirty(int x0, int y0, int x1, int y1) {
+    if (m_levels.size() <= 1 || !m_mipState) return;
+    std::lock_guard<std::mutex> lock(m_mipState->mutex);
+    std::vector<DirtyRect>& rects = m_mipState->rects;
+    DirtyRect added{x0, y0, x1, y1};
+    // 与已有矩形相交或相邻时合并，逐像素写入的连续区域因此只占一个矩形
+    for (auto it = rects.begin(); it != rects.end();) {
+        if (added.x0 <= it->x1 && it->x0 <= added.x1 && added.y0 <= it->y1 && it->y0 <= added.y1) {
+            added = {std::min(added.x0, it->x0), std::min(added.y0, it->y0),
+                     std::max(added.x1, it->x1), std::max(added.y1, it->y1)};
+            it = rects.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    rects.push_back(added);
+    if (static_cast<int>(rects.size()) > kMaxDirtyRects) {
+        DirtyRect bounds = rects.front();
+        for (const DirtyRect& rect : rects) {
+            bounds = {std::min(bounds.x0, rect.x0), std::min(bounds.y0, rect.y0),
+                      std::max(bounds.x1, rect.x1), std::max(bounds.y1, rect.y1)};
+        }
+        rects.assign(1, bounds);
+    }
+    m_mipState->dirty.store(true, std::memory_order_release);
+}
+
+void Texture::markAllDirty() {
+    if (m_levels.empty()) return;
+    markDirty(0, 0, m_levels[0].width, m_levels[0].height);
+}
+
+void Texture::rebuildRegion(std::size_t level, DirtyRect rect) {
+    MipLevel& prev = m_levels[level - 1];
+    MipLevel& current = m_levels[level];
+    const MipLevelView source{prev.pixels.data(), prev.xOffset.data(), prev.yOffset.data(), prev.width, prev.height};
+    const MipLevelView target{current.pixels.data(), current.xOffset.data(), current.yOffset.data(),
+                              current.width, current.height};
+    downsampleMipRegion(source, target, rect.x0, rect.y0, rect.x1, rect.y1, m_mipFilter, m_srgb);
+}
+
+Texture::Footprint Texture::selectFootprint(float dudx, float dudy, float dvdx, float dvdy) const {
+    if (m_filter != TextureFilter::Anisotropic) {
+        // 各向同性：按绝对值最大的导数分量估计 footprint
+        const float rho = std::max({std::fabs(dudx), std::fabs(dudy), std::fabs(dvdx), std::fabs(dvdy)});
+        const float baseSize = static_cast<float>(std::max(m_levels[0].width, m_levels[0].height));
+        return {mipFromFootprint(rho * baseSize, m_filter == TextureFilter::Trilinear), 1, 0.0f, 0.0f};
     }
 
-    u = u - std::floor(u);
-    v = v - std::floor(v);
+    // 屏幕 x / y 方向在 level 0 纹素空间中的两条轴，长轴决定采样方向，长短轴之比决定采样数
+    const float w = static_cast<float>(m_levels[0].width);
+    const float h = static_cast<float>(m_levels[0].height);
+    const float lengthX = std::sqrt(dudx * dudx * w * w + dvdx * dvdx * h * h);
+    const float lengthY = std::sqrt(dudy * dudy * w * w + dvdy * dvdy * h * h);
+    const bool majorIsX = lengthX >= lengthY;
+    const float major = majorIsX ? lengthX : lengthY;
+    const float minor = majorIsX ? lengthY : lengthX;
+    if (!(major > 1.0f) || !std::isfinite(major)) {
+        // 放大或非有限导数：单个 level 0 样本
+        return {{0, 0}, 1, 0.0f, 0.0f};
+    }
 
-    float x = u * (level.width - 1);
-    float y = v * (level.height - 1);
+    const float ratio = minor > 0.0f ? major / minor : static_cast<float>(m_maxAnisotropy);
+    // 先按上限截断再转整数：短轴极小时比值可超出 int 范围
+    const float cappedRatio = std::min(ratio, static_cast<float>(m_maxAnisotropy));
+    const int taps = std::clamp(static_cast<int>(std::ceil(cappedRatio - 1e-3f)), 1, m_maxAnisotropy);
+    // 样本数不足以覆盖长轴时按长轴 / 样本数提高 mip 级，宁可模糊也不走样
+    const float invTaps = 1.0f / static_cast<float>(taps);
+    return {mipFromFootprint(major * invTaps, true), taps,
+            (majorIsX ? dudx : dudy) * invTaps, (majorIsX ? dvdx : dvdy) * invTaps};
+}
 
-    int x0 = static_cast<int>(std::floor(x));
-    int y0 = static_cast<int>(std::floor(y));
-    int x1 = std::min(x0 + 1, level.width - 1);
-    int y1 = std::min(y0 + 1, level.height - 1);
+Texture::MipSelection Texture::mipFromFootprint(float footprint, bool blend) const {
+    const int lastLevel = static_cast<int>(m_levels.size()) - 1;
+    if (lastLevel <= 0) return {0, 0};
+    if (!(footprint > 1.0f)) return {0, 0}; // 放大或非有限导数都取 level 0
+
+    // log2 的整数部分直接取浮点指数（与 floor(log2(x)) 相同）；三线性权重用尾数线性近似小数部分
+    uint32_t bits;
+    std::memcpy(&bits, &footprint, sizeof(bits));
+    const int exponent = static_cast<int>((bits >> 23) & 0xFFu) - 127;
+    if (exponent >= lastLevel) return {lastLevel, 0};
+    const uint32_t weight = blend ? (bits & 0x7FFFFFu) >> 15 : 0u;
+    return {exponent, weight};
+}
+
+uint32_t Texture::samplePacked(float u, float v, const Footprint& footprint) const {
+    if (footprint.taps == 1) {
+        return sampleTrilinearPacked(u, v, footprint.mip);
+    }
+    // 样本以 (u, v) 为中心沿长轴等距分布；四个通道分两组累加在 16 位子字中（16 × 255 不会溢出）
+    constexpr uint32_t kMask = 0x00FF00FFu;
+    const float offset = 0.5f * static_cast<float>(1 - footprint.taps);
+    uint32_t lowSum = 0;
+    uint32_t highSum = 0;
+    for (int i = 0; i < footprint.taps; ++i) {
+        const float t = offset + static_cast<float>(i);
+        const uint32_t texel = sampleTrilinearPacked(u + t * footprint.stepU, v + t * footprint.stepV, footprint.mip);
+        lowSum += texel & kMask;
+        highSum += (texel >> 8) & kMask;
+    }
+    const uint32_t taps = static_cast<uint32_t>(footprint.taps);
+    const uint32_t half = taps / 2;
+    const uint32_t byte0 = ((lowSum & 0xFFFFu) + half) / taps;
+    const uint32_t byte1 = ((highSum & 0xFFFFu) + half) / taps;
+    const uint32_t byte2 = ((lowSum >> 16) + half) / taps;
+    const uint32_t byte3 = ((highSum >> 16) + half) / taps;
+    return (byte3 << 24) | (byte2 << 16) | (byte1 << 8) | byte0;
+}
+
+uint32_t Texture::sampleTrilinearPacked(float u, float v, const MipSelection& mip) const {
+    const uint32_t nearer = sampleLevelPacked(mip.level, u, v);
+    if (mip.weight == 0) {
+        return nearer;
+    }
+    return lerpPacked(nearer, sampleLevelPacked(mip.level + 1, u, v), mip.weight);
+}
 
-    float fx = x - static_cast<float>(x0);
-    float fy = y - static_cast<float>(y0);
+uint32_t Texture::sampleBilinearPacked(const MipLevel& level, float u, float v) {
+    const BilinearTaps taps = bilinearTaps(level.width, level.height, u, v);
+    const int x0 = taps.x0, y0 = taps.y0, x1 = taps.x1, y1 = taps.y1;
+    const uint32_t wx = taps.wx, wy = taps.wy;
+
+    if (level.format != TextureFormat::RGBA8) {
+        // 2×2 邻域多数落在同一块内，只在跨块时再查缓存
+        const uint32_t bx0 = static_cast<uint32_t>(x0) >> 2, bx1 = static_cast<uint32_t>(x1) >> 2;
+        const uint32_t by0 = static_cast<uint32_t>(y0) >> 2, by1 = static_cast<uint32_t>(y1) >> 2;
+        const uint32_t* b00 = decodedBlock(level, bx0, by0);
+        const uint32_t* b10 = bx1 == bx0 ? b00 : decodedBlock(level, bx1, by0);
+        const uint32_t* b01 = by1 == by0 ? b00 : decodedBlock(level, bx0, by1);
+        const uint32_t* b11 = by1 == by0 ? b10 : (bx1 == bx0 ? b01 : decodedBlock(level, bx1, by1));
+        const uint32_t top = lerpPacked(texelInBlock(b00, x0, y0), texelInBlock(b10, x1, y0), wx);
+        const uint32_t bottom = lerpPacked(texelInBlock(b01, x0, y1), texelInBlock(b11, x1, y1), wx);
+        return lerpPacked(top, bottom, wy);
+    }
+    const uint32_t* pixels = level.pixels.data();
+    const uint32_t row0 = level.yOffset[y0];
+    const uint32_t row1 = level.yOffset[y1];
+    const uint32_t col0 = level.xOffset[x0];
+    const uint32_t col1 = level.xOffset[x1];
+    const uint32_t top = lerpPacked(pixels[row0 + col0], pixels[row0 + col1], wx);
+    const uint32_t bottom = lerpPacked(pixels[row1 + col0], pixels[row1 + col1], wx);
+    return lerpPacked(top, bottom, wy);
+}
 
-    Color c00 = readPixel(level, x0, y0);
-    Color c10 = readPixel(level, x1, y0);
-    Color c01 = readPixel(level, x0, y1);
-    Color c11 = readPixel(level, x1, y1);
+uint32_t Texture::sampleVirtualPacked(int level, float u, float v) const {
+    const int pagedLevels = m_virtual->getPagedLevels();
+    const int shift = m_virtual->getPageShift();
+    const uint32_t mask = static_cast<uint32_t>(m_virtual->getPageSize()) - 1u;
+    for (; level < pagedLevels; ++level) {
+        const BilinearTaps taps = bilinearTaps(m_levels[level].width, m_levels[level].height, u, v);
+        const int px0 = taps.x0 >> shift, px1 = taps.x1 >> shift;
+        const int py0 = taps.y0 >> shift, py1 = taps.y1 >> shift;
+        // 每个用到的页都记入反馈，即使邻域中已有页缺失
+        const uint32_t* p00 = m_virtual->requestPage(level, px0, py0);
+        const uint32_t* p10 = px1 == px0 ? p00 : m_virtual->requestPage(level, px1, py0);
+        const uint32_t* p01 = py1 == py0 ? p00 : m_virtual->requestPage(level, px0, py1);
+        const uint32_t* p11 = py1 == py0 ? p10 : (px1 == px0 ? p01 : m_virtual->requestPage(level, px1, py1));
+        if (!p00 || !p10 || !p01 || !p11) {
+            continue;
+        }
+        auto texel = [shift, mask](const uint32_t* page, int x, int y) {
+            return page[((static_cast<uint32_t>(y) & mask) << shift) | (static_cast<uint32_t>(x) & mask)];
+        };
+        const uint32_t top = lerpPacked(texel(p00, taps.x0, taps.y0), texel(p10, taps.x1, taps.y0), taps.wx);
+        const uint32_t bottom = lerpPacked(texel(p01, taps.x0, taps.y1), texel(p11, taps.x1, taps.y1), taps.wx);
+        return lerpPacked(top, bottom, taps.wy);
+    }
+    return sampleBilinearPacked(m_levels[level], u, v);
+}
 
-    Color c0 = c00 * (1.0f - fx) + c10 * fx;
-    Color c1 = c01 * (1.0f - fx) + c11 * fx;
-    return c0 * (1.0f - fy) + c1 * fy;
+uint32_t Texture::fetchVirtualTexel(int level, int x, int y) const {
+    const int pagedLevels = m_virtual->getPagedLevels();
+    const int shift = m_virtual->getPageShift();
+    const uint32_t mask = static_cast<uint32_t>(m_virtual->getPageSize()) - 1u;
+    for (; level < pagedLevels; ++level) {
+        x = std::clamp(x, 0, m_levels[level].width - 1);
+        y = std::clamp(y, 0, m_levels[level].height - 1);
+        if (const uint32_t* page = m_virtual->requestPage(level, x >> shift, y >> shift)) {
+            return page[((static_cast<uint32_t>(y) & mask) << shift) | (static_cast<uint32_t>(x) & mask)];
+        }
+        // 缺页：取下一级中覆盖该纹素的纹素
+        x >>= 1;
+        y >>= 1;
+    }
+    const MipLevel& tail = m_levels[level];
+    return tail.pixels[tail.index(std::clamp(x, 0, tail.width - 1), std::clamp(y, 0, tail.height - 1))];
 }
 
 Color Texture::readPixel(const MipLevel& level, int x, int y) {
     x = std::clamp(x, 0, level.width - 1);
     y = std::clamp(y, 0, level.height - 1);
-    return Color::fromUint32(level.pixels[y * level.width + x]);
+    if (level.format != TextureFormat::RGBA8) {
+        return Color::fromUint32(fetchCompressedTexel(level, x, y));
+    }
+    return Color::fromUint32(level.pixels[level.index(x, y)]);
 }
 
 } // namespace Types
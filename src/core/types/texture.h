@@ -2,15 +2,54 @@
 #define CORE_TYPES_TEXTURE_H
 
 #include "color.h"
+#include "mip_generation.h"
+#include "virtual_texture.h"
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 namespace Core {
 namespace Types {
 
+// 纹素存储布局
+enum class TextureLayout {
+    Linear, // 行主序
+    Tiled   // Z 序（Morton）：任意 2^k × 2^k 对齐块连续存放，4×4 块正好占一条 64 字节缓存行
+};
+
+// mip 间的过滤方式
+enum class TextureFilter {
+    Bilinear,  // 按导数选最近的 mip 级，级内双线性
+    Trilinear,  // 相邻两级各做双线性后按 LOD 小数部分混合
+    Anisotropic // 沿 footprint 长轴取多个三线性样本平均，mip 级按长轴 / 样本数选取
+};
+
+// 纹素存储格式（块格式见 block_compression.h）
+enum class TextureFormat {
+    RGBA8, // 每纹素 32 位
+    BC1,   // 每 4×4 块 8 字节（4 位 / 纹素）：RGB565 端点 + 2 位索引，alpha 只有 0 / 255
+    BC3    // 每 4×4 块 16 字节（8 位 / 纹素）：BC1 颜色块 + 8 位端点 / 3 位索引的 alpha 块
+};
+
 /**
  * @brief Simple mipmapped texture container with bilinear sampling support.
+ *
+ * 写入 level 0（setPixel、updateRegion、clear、程序化生成）只记录脏矩形，
+ * mip 链在下一次读取 level > 0 时按脏区域增量重建一次；也可以用 updateMipmaps() 显式提前重建。
+ * 每一级由上一级经 mip_generation 的滤波器下采样，可选在线性空间中对 sRGB 颜色求平均。
+ *
+ * 采样直接在打包的 RGBA8 上进行：2×2 邻域按 8 位定点权重以 SWAR（一个 32 位整数里同时处理两个通道）插值，
+ * 最后只做一次到浮点的转换；纹理坐标以 16 位定点表示，重复寻址就是对小数位取掩码。
+ *
+ * setFormat(BC1 / BC3) 把所有 mip 级压缩为 4×4 块，采样时按块解码：每个线程有一个小的直接映射缓存保存
+ * 最近解码的块，相邻样本与双线性邻域大多命中同一块。压缩纹理视为只读：任何写入接口都会先解压回 RGBA8。
+ *
+ * loadVirtual 打开的虚拟纹理只常驻 mip 尾，较大的级按页经 VirtualPageCache 读入：采样记录用到的页，
+ * 页未驻留时退到更粗的级（最终落到常驻的 mip 尾）。虚拟纹理只读，写入接口不做任何事。
  */
 class Texture {
 public:
@@ -18,10 +57,47 @@ public:
         int width;
         int height;
         std::vector<uint32_t> pixels;
+        // 寻址表：纹素 (x, y) 位于 pixels[xOffset[x] + yOffset[y]]；
+        // 行主序时为 x 与 y·width，Z 序时为 x、y 各自的位展开（两者的位互不重叠）
+        std::vector<uint32_t> xOffset;
+        std::vector<uint32_t> yOffset;
+        // 压缩格式时 pixels 为空，块按行主序存放在 blocks 中（BC3 每块两个字）；
+        // blockCacheId 在每次编码时重新分配，作为解码缓存的标签，纹理销毁或重新编码后旧条目不会被误用
+        TextureFormat format = TextureFormat::RGBA8;
+        std::vector<uint64_t> blocks;
+        int blocksPerRow = 0;
+        uint32_t blockCacheId = 0;
+
+        std::size_t index(int x, int y) const { return static_cast<std::size_t>(xOffset[x]) + yOffset[y]; }
     };
 
 private:
+    // level 0 上的半开矩形 [x0, x1) × [y0, y1)
+    struct DirtyRect {
+        int x0, y0, x1, y1;
+    };
+
+    static constexpr int kMaxDirtyRects = 8; // 超过后合并为包围盒
+
+    // 延迟重建状态；放在堆上使 Texture 保持可移动
+    struct MipState {
+        std::mutex mutex;
+        std::atomic<bool> dirty{false};
+        std::vector<DirtyRect> rects;
+        std::atomic<uint32_t> lastUse{0}; // 最近一次读取 mip 时的使用时钟
+    };
+
+    static std::atomic<uint32_t> s_mipUseClock;
+
     std::vector<MipLevel> m_levels;   // mip pyramid (level 0 = base)
+    TextureLayout m_layout = TextureLayout::Linear;
+    TextureFilter m_filter = TextureFilter::Bilinear;
+    TextureFormat m_format = TextureFormat::RGBA8;
+    MipFilter m_mipFilter = MipFilter::Box;
+    bool m_srgb = false;
+    int m_maxAnisotropy = kMaxAnisotropy;
+    std::unique_ptr<MipState> m_mipState;
+    std::unique_ptr<VirtualPageCache> m_virtual; // 非空时 level < getPagedLevels() 的级没有纹素存储
 
 public:
     Texture(int width, int height, bool buildMipmaps = true);
@@ -41,7 +117,80 @@ public:
                  float dvdx, float dvdy) const;
     Color sampleLevel(float u, float v, int level) const;
 
+    /**
+     * @brief 批量采样 4 / 8 个纹理坐标，共用同一组屏幕空间导数（同一三角形内为常量）
+     *
+     * mip 级与三线性权重每批只计算一次；逐个结果与 sample(u, v, 导数) 完全相同。
+     */
+    void sample4(const float* u, const float* v,
+                 float dudx, float dudy, float dvdx, float dvdy, Color* out) const;
+    void sample8(const float* u, const float* v,
+                 float dudx, float dudy, float dvdx, float dvdy, Color* out) const;
+
+    void setFilter(TextureFilter filter) { m_filter = filter; }
+    TextureFilter getFilter() const { return m_filter; }
+
+    // 各向异性过滤时每个样本沿长轴的最大采样数（1–16，常用 2/4/8/16）；实际采样数按 footprint 长短轴之比逐次选取
+    static constexpr int kMaxAnisotropy = 16;
+    void setMaxAnisotropy(int taps) { m_maxAnisotropy = std::clamp(taps, 1, kMaxAnisotropy); }
+    int getMaxAnisotropy() const { return m_maxAnisotropy; }
+
     void setPixel(int x, int y, const Color& color, int level = 0);
+
+    /**
+     * @brief 批量写入 level 0 的矩形区域
+     * @param pixels 行主序、紧密排列的 width × height 个打包像素（与 getPixels 相同格式）
+     * 超出纹理的部分被裁掉；只标记一个脏矩形，不立即重建 mip。
+     */
+    void updateRegion(int x, int y, int width, int height, const uint32_t* pixels);
+
+    /**
+     * @brief 立即按脏区域重建 mip 链；没有待更新区域时不做任何事
+     *
+     * 读取 mip 的接口会自动调用，可在多线程采样时并发调用（只有一个线程执行重建）。
+     */
+    void updateMipmaps() const;
+    bool hasPendingMipmapUpdate() const;
+
+    /**
+     * @brief mip 的下采样滤波器（见 mip_generation.h），默认 Box；改变时整条 mip 链标记为待重建
+     *
+     * 与写入相同，压缩纹理先解压；虚拟纹理的 mip 在写出分页文件时已确定，调用不做任何事。
+     */
+    void setMipFilter(MipFilter filter);
+    MipFilter getMipFilter() const { return m_mipFilter; }
+
+    // 纹素是否为 sRGB 编码的颜色（颜色贴图为 true，法线等数据贴图为 false）；为 true 时 mip 在线性空间中滤波
+    void setSrgb(bool srgb);
+    bool isSrgb() const { return m_srgb; }
+
+    /**
+     * @brief 当前纹素存储占用的字节数（含已分配的 mip 级）
+     */
+    std::size_t getMemoryUsage() const;
+
+    /**
+     * @brief 释放 level > 0 的存储并标记整体待重建，下一次读取 mip 时重新分配生成；返回释放的字节数
+     *
+     * 不能与采样并发调用，由纹理缓存在帧与帧之间调用。压缩格式的 mip 重建需要重新编码，不释放（返回 0）；
+     * 虚拟纹理的页由页缓存管理，也不释放。
+     */
+    std::size_t releaseMipmaps();
+    // 是否有可由 releaseMipmaps 释放的 mip 存储
+    bool hasResidentMipmaps() const { return !m_virtual && m_levels.size() > 1 && !m_levels[1].pixels.empty(); }
+
+    /**
+     * @brief 切换纹素存储格式：BC1 / BC3 先补齐待重建的 mip，再逐级编码并释放 RGBA8 存储；RGBA8 则解压
+     *
+     * 块格式有损，压缩 → 解压不能还原原始纹素。不能与采样并发调用。虚拟纹理不支持压缩，调用不做任何事。
+     */
+    void setFormat(TextureFormat format);
+    TextureFormat getFormat() const { return m_format; }
+
+    // mip 使用时钟：读取 mip 时记下当前时钟值，纹理缓存按这个值以最近最少使用的顺序释放 mip
+    uint32_t getLastMipUse() const { return m_mipState ? m_mipState->lastUse.load(std::memory_order_relaxed) : 0u; }
+    static uint32_t getMipUseClock() { return s_mipUseClock.load(std::memory_order_relaxed); }
+    static uint32_t advanceMipUseClock() { return s_mipUseClock.fetch_add(1, std::memory_order_relaxed) + 1; }
     Color getPixel(int x, int y, int level = 0) const;
 
     void clear(const Color& color);
@@ -51,16 +200,93 @@ public:
     int getWidth(int level = 0) const;
     int getHeight(int level = 0) const;
 
+    /**
+     * @brief 原始存储；只有 Linear 布局下是 width × height 的行主序数组，压缩格式与虚拟纹理的分页级为 nullptr
+     */
     const uint32_t* getPixels(int level = 0) const;
 
-    static Texture* loadFromFile(const std::string& filename);
+    /**
+     * @brief 切换所有 mip 级的存储布局（重新排列已有纹素，采样结果不变）
+     *
+     * Tiled 布局的每一级按宽高向上取到 2 的幂分配，非 2 的幂纹理会有填充。
+     * 压缩格式的块顺序不受布局影响，布局在解压时生效。虚拟纹理的页与 mip 尾总是行主序，调用不做任何事。
+     */
+    void setLayout(TextureLayout layout);
+    TextureLayout getLayout() const { return m_layout; }
+
+    /**
+     * @brief 读取 PNG / PPM / PGM / TGA 文件并立即生成 mip 链（格式见 image_loader.h）
+     * @return 新建的纹理，由调用者持有；读取或解码失败返回 nullptr，error 非空时写入原因
+     */
+    static Texture* loadFromFile(const std::string& filename, std::string* error = nullptr);
+
+    /**
+     * @brief 以虚拟纹理方式打开分页文件（格式见 virtual_texture.h），读入 mip 尾，分页级的页按需读入
+     * @param capacity 页缓存的物理页数，决定分页级占用的内存上限
+     * @return 新建的纹理，由调用者持有；失败返回 nullptr，error 非空时写入原因
+     */
+    static Texture* loadVirtual(const std::string& filename, int capacity = VirtualPageCache::kDefaultCapacity,
+                                std::string* error = nullptr);
+    bool isVirtual() const { return m_virtual != nullptr; }
+    // 虚拟纹理的页缓存（普通纹理为 nullptr）；帧与帧之间调用其 update 按采样反馈读入页
+    VirtualPageCache* getVirtualPages() { return m_virtual.get(); }
+    const VirtualPageCache* getVirtualPages() const { return m_virtual.get(); }
     static Texture* createSolidColor(const Color& color, int width = 64, int height = 64);
 
 private:
+    Texture();
     void allocateLevels(int width, int height);
+    // allocate 为 false 时只生成寻址表，不分配纹素存储
+    static void buildAddressing(MipLevel& level, TextureLayout layout, bool allocate = true);
+    static void encodeLevel(MipLevel& level, TextureFormat format);
+    static void decodeLevel(MipLevel& level, TextureLayout layout);
+    // 写入前调用：压缩纹理先解压回 RGBA8；虚拟纹理不可写，返回 false
+    bool prepareForWrite() {
+        if (m_virtual) return false;
+        if (m_format != TextureFormat::RGBA8) setFormat(TextureFormat::RGBA8);
+        return true;
+    }
     void buildMipmaps();
-    int pickMipLevel(float dudx, float dudy, float dvdx, float dvdy) const;
-    Color sampleBilinear(const MipLevel& level, float u, float v) const;
+    void markDirty(int x0, int y0, int x1, int y1);
+    void markAllDirty();
+    void rebuildRegion(std::size_t level, DirtyRect rect);
+    // 读取 level > 0 之前调用：有脏区域时重建
+    // 同时记录使用时钟；时钟每帧最多变化一次，只有每帧第一次读取会写入
+    void resolveMipmaps() const {
+        if (!m_mipState) return;
+        const uint32_t now = s_mipUseClock.load(std::memory_order_relaxed);
+        if (m_mipState->lastUse.load(std::memory_order_relaxed) != now) {
+            m_mipState->lastUse.store(now, std::memory_order_relaxed);
+        }
+        if (m_mipState->dirty.load(std::memory_order_acquire)) {
+            updateMipmaps();
+        }
+    }
+    // 由导数选取的 mip：level 为整数级，weight 为向下一级混合的 8 位权重（双线性过滤时为 0）
+    struct MipSelection {
+        int level;
+        uint32_t weight;
+    };
+    // 一次采样的完整过滤参数：mip 选择，以及各向异性时沿长轴的采样数与相邻样本的 uv 间距
+    struct Footprint {
+        MipSelection mip;
+        int taps;
+        float stepU;
+        float stepV;
+    };
+    Footprint selectFootprint(float dudx, float dudy, float dvdx, float dvdy) const;
+    MipSelection mipFromFootprint(float footprint, bool blend) const;
+    uint32_t samplePacked(float u, float v, const Footprint& footprint) const;
+    uint32_t sampleTrilinearPacked(float u, float v, const MipSelection& mip) const;
+    static uint32_t sampleBilinearPacked(const MipLevel& level, float u, float v);
+    // 虚拟纹理的一级双线性采样：所需的页未全部驻留时依次退到更粗的级
+    uint32_t sampleVirtualPacked(int level, float u, float v) const;
+    uint32_t fetchVirtualTexel(int level, int x, int y) const;
+    uint32_t sampleLevelPacked(int level, float u, float v) const {
+        return m_virtual ? sampleVirtualPacked(level, u, v) : sampleBilinearPacked(m_levels[level], u, v);
+    }
+    void sampleBatch(int count, const float* u, const float* v,
+                     float dudx, float dudy, float dvdx, float dvdy, Color* out) const;
     static Color readPixel(const MipLevel& level, int x, int y);
 };
 
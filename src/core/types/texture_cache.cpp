@@ -0,0 +1,201 @@
+#include "texture_cache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+
+#include "../platform/parallel.h"
+
+namespace Core {
+namespace Types {
+
+TextureCache::TextureCache(std::size_t memoryBudget)
+    : m_memoryBudget(memoryBudget) {}
+
+TextureCache::~TextureCache() = default;
+
+TextureCache& TextureCache::shared() {
+    static TextureCache cache;
+    return cache;
+}
+
+std::string TextureCache::normalizePath(const std::string& filename) {
+    std::error_code ec;
+    const std::filesystem::path canonical = std::filesystem::weakly_canonical(filename, ec);
+    if (ec) {
+        return std::filesystem::path(filename).lexically_normal().string();
+    }
+    return canonical.string();
+}
+
+Texture* TextureCache::openTexture(const std::string& filename, TextureFormat format, std::string* error) {
+    if (std::filesystem::path(filename).extension() == ".vtex") {
+        return Texture::loadVirtual(filename, VirtualPageCache::kDefaultCapacity, error);
+    }
+    Texture* texture = Texture::loadFromFile(filename, error);
+    if (texture) {
+        texture->setFormat(format);
+    }
+    return texture;
+}
+
+Texture* TextureCache::load(const std::string& filename, std::string* error) {
+    const std::string key = normalizePath(filename);
+    TextureFormat format;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_textures.find(key);
+        if (it != m_textures.end()) {
+            return it->second.get();
+        }
+        format = m_compression;
+    }
+
+    // 解码与压缩不持锁；两个线程同时加载同一文件时后插入的一方丢弃自己的结果
+    std::unique_ptr<Texture> texture(openTexture(filename, format, error));
+    if (!texture) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto inserted = m_textures.emplace(key, std::move(texture));
+    return inserted.first->second.get();
+}
+
+std::vector<Texture*> TextureCache::loadAll(const std::vector<std::string>& filenames) {
+    std::vector<std::string> keys(filenames.size());
+    for (std::size_t i = 0; i < filenames.size(); ++i) {
+        keys[i] = normalizePath(filenames[i]);
+    }
+
+    // 只为尚未缓存的不同路径创建任务
+    std::vector<std::size_t> pending;
+    TextureFormat format;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        format = m_compression;
+        std::unordered_map<std::string, bool> queued;
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            if (m_textures.count(keys[i]) == 0 && queued.emplace(keys[i], true).second) {
+                pending.push_back(i);
+            }
+        }
+    }
+
+    // 纹理大小差别很大，工作线程从共享计数器逐个领取任务，而不是预先平均分段。
+    // 每个任务内部的 mip 生成与块压缩编码也调用 parallelFor，嵌套调用在本加载线程内直接执行
+    std::vector<std::unique_ptr<Texture>> loaded(pending.size());
+    std::atomic<std::size_t> next{0};
+    const int workers = std::min<int>(Core::Platform::getWorkerCount(), static_cast<int>(pending.size()));
+    Core::Platform::parallelFor(0, workers, [&](int, int) {
+        for (std::size_t task = next++; task < pending.size(); task = next++) {
+            loaded[task].reset(openTexture(filenames[pending[task]], format, nullptr));
+        }
+    }, 1);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (std::size_t task = 0; task < pending.size(); ++task) {
+        if (loaded[task]) {
+            m_textures.emplace(keys[pending[task]], std::move(loaded[task]));
+        }
+    }
+    std::vector<Texture*> result(filenames.size(), nullptr);
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        auto it = m_textures.find(keys[i]);
+        if (it != m_textures.end()) {
+            result[i] = it->second.get();
+        }
+    }
+    return result;
+}
+
+Texture* TextureCache::find(const std::string& filename) const {
+    const std::string key = normalizePath(filename);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_textures.find(key);
+    return it != m_textures.end() ? it->second.get() : nullptr;
+}
+
+void TextureCache::endFrame() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& entry : m_textures) {
+        if (VirtualPageCache* pages = entry.second->getVirtualPages()) {
+            pages->update();
+        }
+    }
+    enforceBudgetLocked();
+    Texture::advanceMipUseClock();
+}
+
+void TextureCache::setCompression(TextureFormat format) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_compression = format;
+}
+
+TextureFormat TextureCache::getCompression() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_compression;
+}
+
+void TextureCache::setMemoryBudget(std::size_t bytes) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_memoryBudget = bytes;
+    enforceBudgetLocked();
+}
+
+std::size_t TextureCache::getMemoryBudget() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_memoryBudget;
+}
+
+std::size_t TextureCache::getMemoryUsage() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return memoryUsageLocked();
+}
+
+std::size_t TextureCache::size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_textures.size();
+}
+
+void TextureCache::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_textures.clear();
+}
+
+std::size_t TextureCache::memoryUsageLocked() const {
+    std::size_t bytes = 0;
+    for (const auto& entry : m_textures) {
+        bytes += entry.second->getMemoryUsage();
+    }
+    return bytes;
+}
+
+void TextureCache::enforceBudgetLocked() {
+    std::size_t usage = memoryUsageLocked();
+    if (usage <= m_memoryBudget) {
+        return;
+    }
+
+    // 当前时钟周期内读取过 mip 的纹理正在使用，释放后下一帧立即重建，不参与淘汰
+    const uint32_t now = Texture::getMipUseClock();
+    std::vector<Texture*> candidates;
+    for (const auto& entry : m_textures) {
+        Texture* texture = entry.second.get();
+        if (texture->hasResidentMipmaps() && texture->getLastMipUse() != now) {
+            candidates.push_back(texture);
+        }
+    }
+    // 时钟只增不减（回绕前足够用）：距离当前时钟越远越久未用
+    std::sort(candidates.begin(), candidates.end(), [now](const Texture* a, const Texture* b) {
+        return now - a->getLastMipUse() > now - b->getLastMipUse();
+    });
+    for (Texture* texture : candidates) {
+        if (usage <= m_memoryBudget) {
+            break;
+        }
+        usage -= texture->releaseMipmaps();
+    }
+}
+
+} // namespace Types
+} // namespace Core
@@ -0,0 +1,97 @@
+#ifndef CORE_TYPES_TEXTURE_CACHE_H
+#define CORE_TYPES_TEXTURE_CACHE_H
+
+#include "texture.h"
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Core {
+namespace Types {
+
+/**
+ * @brief 按文件路径去重的共享纹理缓存
+ *
+ * 同一文件（规范化后的路径）只解码一次，所有材质共用同一个 Texture；纹理由缓存持有，
+ * 返回的指针在缓存销毁或 clear() 之前一直有效。
+ *
+ * 内存预算只约束可再生的 mip 链：超出预算时，按最近一次读取 mip 的时钟（Texture::getLastMipUse）
+ * 从最久未用的纹理开始释放其 mip，当前帧读取过 mip 的纹理不释放；level 0 始终保留。
+ * 被释放的 mip 在下一次采样需要时自动重建。
+ *
+ * setCompression 可让之后加载的纹理在加载时压缩为 BC1 / BC3（在加载线程中编码）；压缩纹理的 mip 不参与释放。
+ *
+ * 扩展名为 .vtex 的文件以虚拟纹理打开（Texture::loadVirtual），页缓存容量固定、不参与释放，
+ * 每次 endFrame 按本帧的采样反馈读入缺失的页。
+ */
+class TextureCache {
+public:
+    static constexpr std::size_t kDefaultMemoryBudget = std::size_t{256} << 20;
+
+    explicit TextureCache(std::size_t memoryBudget = kDefaultMemoryBudget);
+    ~TextureCache();
+
+    TextureCache(const TextureCache&) = delete;
+    TextureCache& operator=(const TextureCache&) = delete;
+
+    // 进程内共享的缓存实例
+    static TextureCache& shared();
+
+    /**
+     * @brief 返回路径对应的纹理，未缓存时读取并生成 mip
+     * @return 失败返回 nullptr（失败不缓存，下次调用会重新尝试），error 非空时写入原因
+     */
+    Texture* load(const std::string& filename, std::string* error = nullptr);
+
+    /**
+     * @brief 并行加载多个文件（解码与 mip 生成分布到工作线程），结果与 filenames 一一对应
+     *
+     * 重复的路径与已缓存的纹理只处理一次；失败的项为 nullptr。
+     */
+    std::vector<Texture*> loadAll(const std::vector<std::string>& filenames);
+
+    // 已缓存时返回纹理，不触发加载
+    Texture* find(const std::string& filename) const;
+
+    /**
+     * @brief 帧结束时调用：为虚拟纹理读入本帧请求的页；超出预算则释放本帧未读取 mip 的纹理的 mip，
+     * 然后推进 mip 使用时钟
+     *
+     * 不能与渲染并发调用。
+     */
+    void endFrame();
+
+    // 之后加载的纹理使用的存储格式，默认 RGBA8；不影响已缓存的纹理
+    void setCompression(TextureFormat format);
+    TextureFormat getCompression() const;
+
+    void setMemoryBudget(std::size_t bytes);
+    std::size_t getMemoryBudget() const;
+    std::size_t getMemoryUsage() const;
+    std::size_t size() const;
+
+    // 释放所有纹理；之前返回的指针全部失效
+    void clear();
+
+private:
+    static std::string normalizePath(const std::string& filename);
+    // 按扩展名选择普通或虚拟纹理；普通纹理按 format 压缩
+    static Texture* openTexture(const std::string& filename, TextureFormat format, std::string* error);
+    // 调用时需持有 m_mutex
+    std::size_t memoryUsageLocked() const;
+    void enforceBudgetLocked();
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, std::unique_ptr<Texture>> m_textures;
+    std::size_t m_memoryBudget;
+    TextureFormat m_compression = TextureFormat::RGBA8;
+};
+
+} // namespace Types
+} // namespace Core
+
+#endif // CORE_TYPES_TEXTURE_CACHE_H
@@ -0,0 +1,304 @@
+#include "virtual_texture.h"
+#include "texture.h"
+
+#include <algorithm>
+
+namespace Core {
+namespace Types {
+
+namespace {
+
+constexpr uint8_t kMagic[4] = {'V', 'T', 'E', 'X'};
+constexpr uint32_t kVersion = 1;
+constexpr std::size_t kHeaderBytes = 24;
+constexpr int kMaxDimension = 1 << 16;
+
+bool fail(std::string* error, const char* message) {
+    if (error) {
+        *error = message;
+    }
+    return false;
+}
+
+bool isPowerOfTwo(int value) {
+    return value > 0 && (value & (value - 1)) == 0;
+}
+
+void storeU32(uint8_t* out, uint32_t value) {
+    out[0] = static_cast<uint8_t>(value);
+    out[1] = static_cast<uint8_t>(value >> 8);
+    out[2] = static_cast<uint8_t>(value >> 16);
+    out[3] = static_cast<uint8_t>(value >> 24);
+}
+
+uint32_t loadU32(const uint8_t* in) {
+    return static_cast<uint32_t>(in[0]) | (static_cast<uint32_t>(in[1]) << 8) |
+           (static_cast<uint32_t>(in[2]) << 16) | (static_cast<uint32_t>(in[3]) << 24);
+}
+
+// 与 Texture::allocateLevels 相同：逐级减半（不小于 1）直到 1×1
+int countLevels(int width, int height) {
+    int levels = 1;
+    while (width > 1 || height > 1) {
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+        ++levels;
+    }
+    return levels;
+}
+
+} // namespace
+
+bool writeVirtualTexture(const std::string& filename, const uint32_t* pixels, int width, int height,
+                         int pageSize, std::string* error) {
+    if (!pixels || width <= 0 || height <= 0 || width > kMaxDimension || height > kMaxDimension) {
+        return fail(error, "invalid image size");
+    }
+    if (!isPowerOfTwo(pageSize) || pageSize < 4 || pageSize > 4096) {
+        return fail(error, "page size must be a power of two in [4, 4096]");
+    }
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return fail(error, "cannot open file");
+    }
+
+    // mip 链由 Texture 按 Linear 布局生成，getPixels 即为各级的行主序纹素
+    const Texture source(std::vector<uint32_t>(pixels, pixels + static_cast<std::size_t>(width) * height),
+                         width, height, true);
+    const int levelCount = countLevels(width, height);
+
+    uint8_t header[kHeaderBytes];
+    std::copy(kMagic, kMagic + 4, header);
+    storeU32(header + 4, kVersion);
+    storeU32(header + 8, static_cast<uint32_t>(width));
+    storeU32(header + 12, static_cast<uint32_t>(height));
+    storeU32(header + 16, static_cast<uint32_t>(pageSize));
+    storeU32(header + 20, static_cast<uint32_t>(levelCount));
+    file.write(reinterpret_cast<const char*>(header), kHeaderBytes);
+
+    std::vector<uint8_t> buffer;
+    for (int level = 0; level < levelCount; ++level) {
+        const int levelWidth = source.getWidth(level);
+        const int levelHeight = source.getHeight(level);
+        const uint32_t* texels = source.getPixels(level);
+        if (levelWidth <= pageSize && levelHeight <= pageSize) {
+            buffer.resize(static_cast<std::size_t>(levelWidth) * levelHeight * 4);
+            for (std::size_t i = 0; i < static_cast<std::size_t>(levelWidth) * levelHeight; ++i) {
+                storeU32(&buffer[i * 4], texels[i]);
+            }
+            file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+            continue;
+        }
+        const int pagesX = (levelWidth + pageSize - 1) / pageSize;
+        const int pagesY = (levelHeight + pageSize - 1) / pageSize;
+        buffer.resize(static_cast<std::size_t>(pageSize) * pageSize * 4);
+        for (int py = 0; py < pagesY; ++py) {
+            for (int px = 0; px < pagesX; ++px) {
+                for (int y = 0; y < pageSize; ++y) {
+                    const int sourceY = std::min(py * pageSize + y, levelHeight - 1);
+                    for (int x = 0; x < pageSize; ++x) {
+                        const int sourceX = std::min(px * pageSize + x, levelWidth - 1);
+                        storeU32(&buffer[(static_cast<std::size_t>(y) * pageSize + x) * 4],
+                                 texels[static_cast<std::size_t>(sourceY) * levelWidth + sourceX]);
+                    }
+                }
+                file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+            }
+        }
+    }
+    if (!file.good()) {
+        return fail(error, "write failed");
+    }
+    return true;
+}
+
+VirtualPageCache* VirtualPageCache::open(const std::string& filename, int capacity, std::string* error) {
+    std::unique_ptr<VirtualPageCache> cache(new VirtualPageCache());
+    cache->m_file.open(filename, std::ios::binary);
+    if (!cache->m_file.is_open()) {
+        fail(error, "cannot open file");
+        return nullptr;
+    }
+    uint8_t header[kHeaderBytes];
+    if (!cache->m_file.read(reinterpret_cast<char*>(header), kHeaderBytes) ||
+        !std::equal(kMagic, kMagic + 4, header)) {
+        fail(error, "not a virtual texture file");
+        return nullptr;
+    }
+    if (loadU32(header + 4) != kVersion) {
+        fail(error, "unsupported virtual texture version");
+        return nullptr;
+    }
+    const uint32_t width = loadU32(header + 8);
+    const uint32_t height = loadU32(header + 12);
+    const uint32_t pageSize = loadU32(header + 16);
+    const uint32_t levelCount = loadU32(header + 20);
+    if (width == 0 || height == 0 || width > kMaxDimension || height > kMaxDimension ||
+        pageSize < 4 || pageSize > 4096 || !isPowerOfTwo(static_cast<int>(pageSize)) ||
+        levelCount != static_cast<uint32_t>(countLevels(static_cast<int>(width), static_cast<int>(height)))) {
+        fail(error, "invalid virtual texture header");
+        return nullptr;
+    }
+    cache->m_width = static_cast<int>(width);
+    cache->m_height = static_cast<int>(height);
+    cache->m_pageSize = static_cast<int>(pageSize);
+    while ((1 << cache->m_pageShift) < cache->m_pageSize) ++cache->m_pageShift;
+    cache->m_levelCount = static_cast<int>(levelCount);
+    cache->m_pageTexels = static_cast<std::size_t>(pageSize) * pageSize;
+
+    // 按与写出时相同的顺序计算各级的位置，文件长度必须完全一致
+    const uint64_t pageBytes = static_cast<uint64_t>(cache->m_pageTexels) * 4;
+    uint64_t offset = kHeaderBytes;
+    uint32_t totalPages = 0;
+    int levelWidth = cache->m_width;
+    int levelHeight = cache->m_height;
+    for (int level = 0; level < cache->m_levelCount; ++level) {
+        if (levelWidth <= cache->m_pageSize && levelHeight <= cache->m_pageSize) {
+            cache->m_tailOffsets.push_back(offset);
+            offset += static_cast<uint64_t>(levelWidth) * levelHeight * 4;
+        } else {
+            PagedLevel paged;
+            paged.width = levelWidth;
+            paged.height = levelHeight;
+            paged.pagesX = (levelWidth + cache->m_pageSize - 1) / cache->m_pageSize;
+            paged.pagesY = (levelHeight + cache->m_pageSize - 1) / cache->m_pageSize;
+            paged.firstPage = totalPages;
+            paged.fileOffset = offset;
+            cache->m_levels.push_back(paged);
+            const uint32_t pages = static_cast<uint32_t>(paged.pagesX) * static_cast<uint32_t>(paged.pagesY);
+            totalPages += pages;
+            offset += pages * pageBytes;
+        }
+        levelWidth = std::max(1, levelWidth / 2);
+        levelHeight = std::max(1, levelHeight / 2);
+    }
+    cache->m_file.seekg(0, std::ios::end);
+    if (static_cast<uint64_t>(cache->m_file.tellg()) != offset) {
+        fail(error, "virtual texture file size mismatch");
+        return nullptr;
+    }
+
+    capacity = std::max(1, capacity);
+    cache->m_pool.assign(cache->m_pageTexels * static_cast<std::size_t>(capacity), 0u);
+    cache->m_pageTable.assign(totalPages, -1);
+    cache->m_feedbackWords = (static_cast<std::size_t>(totalPages) + 63) / 64;
+    cache->m_feedback.reset(new std::atomic<uint64_t>[std::max<std::size_t>(1, cache->m_feedbackWords)]);
+    for (std::size_t i = 0; i < cache->m_feedbackWords; ++i) {
+        cache->m_feedback[i].store(0, std::memory_order_relaxed);
+    }
+    cache->m_slots.assign(static_cast<std::size_t>(capacity), Slot{0, 0});
+    // 倒序压栈，先分配低编号的物理页
+    for (int slot = capacity - 1; slot >= 0; --slot) {
+        cache->m_freeSlots.push_back(slot);
+    }
+    return cache.release();
+}
+
+bool VirtualPageCache::readTailLevel(int level, std::vector<uint32_t>& pixels, std::string* error) {
+    const int tailIndex = level - getPagedLevels();
+    if (tailIndex < 0 || tailIndex >= static_cast<int>(m_tailOffsets.size())) {
+        return fail(error, "not a tail level");
+    }
+    const int levelWidth = std::max(1, m_width >> level);
+    const int levelHeight = std::max(1, m_height >> level);
+    const std::size_t count = static_cast<std::size_t>(levelWidth) * levelHeight;
+    m_readBuffer.resize(count * 4);
+    m_file.clear();
+    m_file.seekg(static_cast<std::streamoff>(m_tailOffsets[tailIndex]));
+    if (!m_file.read(reinterpret_cast<char*>(m_readBuffer.data()), static_cast<std::streamsize>(m_readBuffer.size()))) {
+        return fail(error, "read failed");
+    }
+    pixels.resize(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        pixels[i] = loadU32(&m_readBuffer[i * 4]);
+    }
+    return true;
+}
+
+int VirtualPageCache::update(int maxLoads) {
+    ++m_frame;
+    std::vector<uint32_t> missing;
+    for (std::size_t wordIndex = 0; wordIndex < m_feedbackWords; ++wordIndex) {
+        uint64_t bits = m_feedback[wordIndex].exchange(0, std::memory_order_relaxed);
+        while (bits) {
+            int bit = 0;
+            while (!((bits >> bit) & 1u)) ++bit;
+            bits &= bits - 1;
+            const uint32_t page = static_cast<uint32_t>(wordIndex * 64 + static_cast<std::size_t>(bit));
+            const int32_t slot = m_pageTable[page];
+            if (slot >= 0) {
+                m_slots[slot].lastUse = m_frame;
+            } else {
+                missing.push_back(page);
+            }
+        }
+    }
+
+    // 全局页序号按级递增，倒序即先读较粗的级
+    std::sort(missing.begin(), missing.end(), [](uint32_t a, uint32_t b) { return a > b; });
+    int loads = 0;
+    for (uint32_t page : missing) {
+        if (loads >= maxLoads) break;
+        const int slot = acquireSlot();
+        if (slot < 0) break;
+        if (!readPage(page, slot)) {
+            m_freeSlots.push_back(slot);
+            continue;
+        }
+        m_pageTable[page] = slot;
+        m_slots[slot] = Slot{page, m_frame};
+        ++m_residentPages;
+        ++m_loadedPages;
+        ++loads;
+    }
+    return loads;
+}
+
+int VirtualPageCache::acquireSlot() {
+    if (!m_freeSlots.empty()) {
+        const int slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+        return slot;
+    }
+    // 帧序号只增不减：距离当前帧越远越久未用；本帧用到的页不淘汰
+    int victim = -1;
+    uint32_t oldest = 0;
+    for (std::size_t i = 0; i < m_slots.size(); ++i) {
+        const uint32_t age = m_frame - m_slots[i].lastUse;
+        if (age > oldest) {
+            oldest = age;
+            victim = static_cast<int>(i);
+        }
+    }
+    if (victim >= 0) {
+        m_pageTable[m_slots[victim].page] = -1;
+        --m_residentPages;
+    }
+    return victim;
+}
+
+bool VirtualPageCache::readPage(uint32_t page, int slot) {
+    // 找到页所在的级：各级的 firstPage 递增
+    std::size_t level = 0;
+    while (level + 1 < m_levels.size() && m_levels[level + 1].firstPage <= page) ++level;
+    const uint64_t pageBytes = static_cast<uint64_t>(m_pageTexels) * 4;
+    m_readBuffer.resize(static_cast<std::size_t>(pageBytes));
+    m_file.clear();
+    m_file.seekg(static_cast<std::streamoff>(m_levels[level].fileOffset + (page - m_levels[level].firstPage) * pageBytes));
+    if (!m_file.read(reinterpret_cast<char*>(m_readBuffer.data()), static_cast<std::streamsize>(pageBytes))) {
+        return false;
+    }
+    uint32_t* out = m_pool.data() + static_cast<std::size_t>(slot) * m_pageTexels;
+    for (std::size_t i = 0; i < m_pageTexels; ++i) {
+        out[i] = loadU32(&m_readBuffer[i * 4]);
+    }
+    return true;
+}
+
+std::size_t VirtualPageCache::getMemoryUsage() const {
+    return m_pool.size() * sizeof(uint32_t) + m_pageTable.size() * sizeof(int32_t) +
+           m_feedbackWords * sizeof(uint64_t) + m_slots.size() * sizeof(Slot);
+}
+
+} // namespace Types
+} // namespace Core
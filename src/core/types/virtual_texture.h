@@ -0,0 +1,152 @@
+#ifndef CORE_TYPES_VIRTUAL_TEXTURE_H
+#define CORE_TYPES_VIRTUAL_TEXTURE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Core {
+namespace Types {
+
+/**
+ * @brief 写出分页纹理文件（.vtex）：生成 mip 链后按固定大小的正方形页存放，读取时可以只读需要的页
+ *
+ * 文件布局（整数均为小端 32 位）：
+ *   "VTEX" | 版本 1 | width | height | pageSize | levelCount
+ * 之后从 level 0 到最后一级依次存放。宽或高超过 pageSize 的级为分页级，按页行主序排列，
+ * 每页 pageSize × pageSize 个纹素，边缘页用最后一行 / 列填充；其余级（mip 尾）按行主序紧密排列。
+ * 纹素为打包 RGBA8（与 Color::toUint32 相同），每个 4 字节小端。
+ *
+ * 生成 mip 需要整张图在内存中，是离线转换步骤；mip 与 Texture 自身生成的完全相同。
+ * @param pageSize 2 的幂，4–4096
+ * @return 成功返回 true；参数非法或写入失败返回 false，error 非空时写入原因
+ */
+bool writeVirtualTexture(const std::string& filename, const uint32_t* pixels, int width, int height,
+                         int pageSize = 128, std::string* error = nullptr);
+
+/**
+ * @brief 虚拟纹理的页缓存：固定容量的物理页池 + 页表 + 采样反馈
+ *
+ * 打开文件时只读取文件头与 mip 尾（由 Texture 常驻），分页级的页都不驻留。
+ * 采样通过 requestPage 查页表并在反馈位图中记下用到的页（并发采样只做原子或）；
+ * 帧与帧之间调用 update，按反馈从文件读入缺失的页，池满时淘汰本帧没有用到、最久未用的页。
+ * 内存只取决于容量与页大小，与源纹理尺寸无关（页表与反馈位图每页只占 4 字节 + 1 位）。
+ */
+class VirtualPageCache {
+public:
+    static constexpr int kDefaultPageSize = 128;
+    static constexpr int kDefaultCapacity = 256;       // 128² 的页约 16 MB
+    static constexpr int kDefaultLoadsPerFrame = 32;   // 每帧最多读入的页数，限制一帧内的 I/O
+
+    /**
+     * @brief 打开分页文件并校验文件头与长度
+     * @param capacity 物理页数（至少 1）
+     * @return 新建的缓存，由调用者持有；失败返回 nullptr，error 非空时写入原因
+     */
+    static VirtualPageCache* open(const std::string& filename, int capacity = kDefaultCapacity,
+                                  std::string* error = nullptr);
+
+    VirtualPageCache(const VirtualPageCache&) = delete;
+    VirtualPageCache& operator=(const VirtualPageCache&) = delete;
+
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+    int getPageSize() const { return m_pageSize; }
+    int getPageShift() const { return m_pageShift; } // log2(pageSize)
+    int getLevelCount() const { return m_levelCount; }
+    // level < getPagedLevels() 的级分页存放，其余为 mip 尾
+    int getPagedLevels() const { return static_cast<int>(m_levels.size()); }
+    int getPagesX(int level) const { return m_levels[level].pagesX; }
+    int getPagesY(int level) const { return m_levels[level].pagesY; }
+
+    // 读取 mip 尾的一级（行主序 width × height）；level 必须不小于 getPagedLevels()
+    bool readTailLevel(int level, std::vector<uint32_t>& pixels, std::string* error = nullptr);
+
+    /**
+     * @brief 采样时调用：记录该页被请求，返回页内行主序的纹素，未驻留时返回 nullptr
+     *
+     * 可与其他采样线程并发调用；位已置上时只做一次读取。
+     */
+    const uint32_t* requestPage(int level, int pageX, int pageY) const {
+        const uint32_t page = pageIndex(level, pageX, pageY);
+        std::atomic<uint64_t>& word = m_feedback[page >> 6];
+        const uint64_t bit = uint64_t{1} << (page & 63u);
+        if (!(word.load(std::memory_order_relaxed) & bit)) {
+            word.fetch_or(bit, std::memory_order_relaxed);
+        }
+        const int32_t slot = m_pageTable[page];
+        return slot < 0 ? nullptr : m_pool.data() + static_cast<std::size_t>(slot) * m_pageTexels;
+    }
+
+    // 不记录反馈的驻留查询
+    bool isResident(int level, int pageX, int pageY) const { return m_pageTable[pageIndex(level, pageX, pageY)] >= 0; }
+
+    /**
+     * @brief 帧结束时调用：消费反馈，读入至多 maxLoads 个缺失的页，返回读入的页数
+     *
+     * 较粗的级先读入，缺页的采样能尽快退到更接近的级；本帧用到的页不会被淘汰，
+     * 池中全是本帧用到的页时剩余请求留到以后的帧。不能与采样并发调用。
+     */
+    int update(int maxLoads = kDefaultLoadsPerFrame);
+
+    int getCapacity() const { return static_cast<int>(m_slots.size()); }
+    int getResidentPages() const { return m_residentPages; }
+    // 累计读入的页数
+    uint64_t getLoadedPages() const { return m_loadedPages; }
+    std::size_t getMemoryUsage() const;
+
+private:
+    struct PagedLevel {
+        int width;
+        int height;
+        int pagesX;
+        int pagesY;
+        uint32_t firstPage;  // 在全局页序号中的起点
+        uint64_t fileOffset; // 该级第一页在文件中的位置
+    };
+
+    struct Slot {
+        uint32_t page;
+        uint32_t lastUse; // 最近一次被请求时的帧序号
+    };
+
+    VirtualPageCache() = default;
+
+    uint32_t pageIndex(int level, int pageX, int pageY) const {
+        const PagedLevel& paged = m_levels[level];
+        return paged.firstPage + static_cast<uint32_t>(pageY) * static_cast<uint32_t>(paged.pagesX) +
+               static_cast<uint32_t>(pageX);
+    }
+    int acquireSlot();
+    bool readPage(uint32_t page, int slot);
+
+    std::ifstream m_file;
+    int m_width = 0;
+    int m_height = 0;
+    int m_pageSize = 0;
+    int m_pageShift = 0;
+    int m_levelCount = 0;
+    std::size_t m_pageTexels = 0;
+    std::vector<PagedLevel> m_levels;
+    std::vector<uint64_t> m_tailOffsets; // 下标为 level - getPagedLevels()
+
+    std::vector<uint32_t> m_pool;
+    std::vector<int32_t> m_pageTable; // 全局页序号 → 物理页，-1 为未驻留
+    std::unique_ptr<std::atomic<uint64_t>[]> m_feedback;
+    std::size_t m_feedbackWords = 0;
+    std::vector<Slot> m_slots;
+    std::vector<int> m_freeSlots;
+    std::vector<uint8_t> m_readBuffer;
+    uint32_t m_frame = 0;
+    int m_residentPages = 0;
+    uint64_t m_loadedPages = 0;
+};
+
+} // namespace Types
+} // namespace Core
+
+#endif // CORE_TYPES_VIRTUAL_TEXTURE_H
@@ -7,13 +7,16 @@
 #include <optional>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "scene/scene.h"
 #include "scene/camera.h"
 #include "scene/mesh.h"
 #include "core/types/material.h"
 #include "core/types/texture.h"
+#include "core/types/texture_cache.h"
 #include "renderer/pipeline/software_renderer.h"
+#include "renderer/lighting/environment_light.h"
 #include "renderer/lighting/light.h"
 #include "renderer/preview/sdl_preview.h"
 #include "util/ffmpeg_utils.h"
@@ -36,6 +39,17 @@ struct RenderOptions {
     std::string outputPath;
     float durationSeconds = 5.0f;
     int fps = 30;
+    Renderer::Pipeline::AntiAliasingMode aaMode = Renderer::Pipeline::AntiAliasingMode::SSAA;
+    float exposure = 1.0f;
+    std::optional<Renderer::Effects::ToneMapOperator> toneMap;
+    bool dither = false;
+    bool shadows = false;
+    bool sky = false; // 用球谐渐变天空替代平坦环境光
+    bool deferred = false; // 不透明物体走 G-buffer 延迟着色
+    bool pbr = false; // 球体改用金属度-粗糙度材质
+    std::string texturePath; // 立方体的漫反射贴图（PNG/PPM/PGM/TGA）
+    Core::Types::LightingFrequency lighting = Core::Types::LightingFrequency::PerPixel;
+    Core::Types::ShadingRate shadingRate = Core::Types::ShadingRate::Rate1x1;
 };
 
 RenderOptions parseOptions(int argc, char** argv) {
@@ -79,12 +93,77 @@ RenderOptions parseOptions(int argc, char** argv) {
             opts.durationSeconds = std::max(0.0f, *value);
         } else if (auto value = assignInt("--fps=")) {
             opts.fps = std::max(1, *value);
+        } else if (arg.rfind("--aa=", 0) == 0) {
+            const std::string value = arg.substr(std::string("--aa=").size());
+            if (value == "none") {
+                opts.aaMode = Renderer::Pipeline::AntiAliasingMode::None;
+            } else if (value == "ssaa") {
+                opts.aaMode = Renderer::Pipeline::AntiAliasingMode::SSAA;
+            } else if (value == "fxaa") {
+                opts.aaMode = Renderer::Pipeline::AntiAliasingMode::FXAA;
+            } else {
+                std::cerr << "未知的抗锯齿模式: " << value << std::endl;
+                std::exit(1);
+            }
+        } else if (auto value = assignFloat("--exposure=")) {
+            opts.exposure = std::max(0.0f, *value);
+        } else if (arg.rfind("--tonemap=", 0) == 0) {
+            const std::string value = arg.substr(std::string("--tonemap=").size());
+            if (value == "none") {
+                opts.toneMap.reset();
+            } else if (value == "reinhard") {
+                opts.toneMap = Renderer::Effects::ToneMapOperator::Reinhard;
+            } else if (value == "aces") {
+                opts.toneMap = Renderer::Effects::ToneMapOperator::ACES;
+            } else {
+                std::cerr << "未知的色调映射: " << value << std::endl;
+                std::exit(1);
+            }
+        } else if (arg == "--dither") {
+            opts.dither = true;
+        } else if (arg == "--shadows") {
+            opts.shadows = true;
+        } else if (arg == "--sky") {
+            opts.sky = true;
+        } else if (arg == "--deferred") {
+            opts.deferred = true;
+        } else if (arg == "--pbr") {
+            opts.pbr = true;
+        } else if (arg.rfind("--texture=", 0) == 0) {
+            opts.texturePath = arg.substr(std::string("--texture=").size());
+        } else if (arg.rfind("--shading-rate=", 0) == 0) {
+            const std::string value = arg.substr(std::string("--shading-rate=").size());
+            if (value == "1") {
+                opts.shadingRate = Core::Types::ShadingRate::Rate1x1;
+            } else if (value == "2") {
+                opts.shadingRate = Core::Types::ShadingRate::Rate2x2;
+            } else if (value == "4") {
+                opts.shadingRate = Core::Types::ShadingRate::Rate4x4;
+            } else {
+                std::cerr << "未知的着色率: " << value << std::endl;
+                std::exit(1);
+            }
+        } else if (arg.rfind("--lighting=", 0) == 0) {
+            const std::string value = arg.substr(std::string("--lighting=").size());
+            if (value == "pixel") {
+                opts.lighting = Core::Types::LightingFrequency::PerPixel;
+            } else if (value == "vertex") {
+                opts.lighting = Core::Types::LightingFrequency::PerVertex;
+            } else if (value == "auto") {
+                opts.lighting = Core::Types::LightingFrequency::Auto;
+            } else {
+                std::cerr << "未知的光照频率: " << value << std::endl;
+                std::exit(1);
+            }
         } else if (arg == "--help" || arg == "-h") {
             std::cout << "用法: " << argv[0]
                       << " --mode=<preview|png|video>"
                       << " [--width=<像素>] [--height=<像素>]"
                       << " [--output=<文件>] [--camera-distance=<值>]"
-                      << " [--duration=<秒>] [--fps=<帧率>]" << std::endl;
+                      << " [--duration=<秒>] [--fps=<帧率>]"
+                      << " [--aa=<none|ssaa|fxaa>]"
+                      << " [--exposure=<倍数>] [--tonemap=<none|reinhard|aces>] [--dither]"
+                      << " [--shadows] [--sky] [--deferred] [--pbr] [--texture=<文件>] [--lighting=<pixel|vertex|auto>] [--shading-rate=<1|2|4>]" << std::endl;
             std::exit(0);
         } else {
             std::cerr << "未知参数: " << arg << std::endl;
@@ -119,6 +198,16 @@ int main(int argc, char** argv) {
     auto material = std::unique_ptr<Core::Types::Material>(Core::Types::Material::createRedPlastic());
     //auto texture = std::unique_ptr<Core::Types::Texture>(Core::Types::Texture::createSolidColor(Core::Types::Color::RED, 256, 256));
     //material->setDiffuseMap(texture.get());
+    if (!options.texturePath.empty()) {
+        std::string error;
+        Core::Types::Texture* texture = Core::Types::TextureCache::shared().load(options.texturePath, &error);
+        if (!texture) {
+            std::cerr << "无法加载纹理 " << options.texturePath << ": " << error << std::endl;
+            return 1;
+        }
+        texture->setFilter(Core::Types::TextureFilter::Trilinear);
+        material->setDiffuseMap(texture);
+    }
     material->setDiffuse(Core::Types::Color(1.0f, 1.0f, 1.0f, 0.2f)); // 50% 透明
     material->setSpecular(Core::Types::Color(1.0f, 1.0f, 1.0f, 0.8f));
     material->setShininess(84.0f);
@@ -127,6 +216,11 @@ int main(int argc, char** argv) {
     auto sphereMat = std::unique_ptr<Core::Types::Material>(Core::Types::Material::createWhiteDiffuse());
     sphereMat->setSpecular(Core::Types::Color(0.2f, 0.2f, 0.2f, 1.0f));
     sphereMat->setShininess(132.0f);
+    if (options.pbr) {
+        sphereMat->setShadingModel(Core::Types::ShadingModel::MetallicRoughness);
+        sphereMat->setMetallic(0.8f);
+        sphereMat->setRoughness(0.35f);
+    }
     gradSphere->setMaterial(sphereMat.get());
 
     int cubeIndex = scene.addObject(mesh.get());
@@ -136,13 +230,41 @@ int main(int argc, char** argv) {
 
     auto pointLight = std::make_unique<Renderer::Lighting::PointLight>(Core::Math::Vector3(0.0f, 0.0f, -5.0f), Core::Types::Color::WHITE, 4.0f, 20.0f);
     auto dirLight = std::make_unique<Renderer::Lighting::DirectionalLight>(Core::Math::Vector3(-1.0f, -1.0f, -1.0f), Core::Types::Color(1.0f, 0.95f, 0.85f, 1.0f), 0.4f);
+    pointLight->setCastShadows(options.shadows);
+    dirLight->setCastShadows(options.shadows);
     scene.addLight(pointLight.get());
     scene.addLight(dirLight.get());
 
+    auto environment = std::make_unique<Renderer::Lighting::EnvironmentLight>();
+    if (options.sky) {
+        environment->setGradientSky(Core::Types::Color(0.3f, 0.45f, 0.75f, 1.0f),
+                                    Core::Types::Color(0.65f, 0.65f, 0.6f, 1.0f),
+                                    Core::Types::Color(0.2f, 0.18f, 0.15f, 1.0f));
+        scene.setEnvironment(environment.get());
+    }
+
     Renderer::Pipeline::SoftwareRendererSettings settings;
     settings.width = options.width;
     settings.height = options.height;
+    settings.aaMode = options.aaMode;
+    settings.lightingFrequency = options.lighting;
+    settings.shadingRate = options.shadingRate;
     settings.ssaaFactor = 2;
+    settings.ssaaTileSize = 64;
+    if (options.deferred) {
+        // 分块 SSAA 会退回前向渲染，延迟着色时整帧渲染高分辨率缓冲
+        settings.deferredShading = true;
+        settings.ssaaTileSize = 0;
+    }
+    if (options.exposure != 1.0f) {
+        settings.postProcess.addExposure(options.exposure);
+    }
+    if (options.toneMap) {
+        settings.postProcess.addToneMap(*options.toneMap);
+    }
+    if (options.dither) {
+        settings.postProcess.addOrderedDither();
+    }
 
     Renderer::Pipeline::SoftwareRenderer renderer(settings);
 
@@ -161,6 +283,7 @@ int main(int argc, char** argv) {
             return 1;
         }
 
+        std::vector<uint8_t> frame;
         bool running = true;
         uint32_t lastTicks = SDL_GetTicks();
         float time = 0.0f;
@@ -174,7 +297,9 @@ int main(int argc, char** argv) {
             animateScene(time);
 
             renderer.render(scene);
-            preview.presentOnce(renderer.getRenderTarget(), "软件渲染预览 - 旋转立方体");
+            Core::Types::TextureCache::shared().endFrame();
+            renderer.encodeOutput(frame, true);
+            preview.presentOnce(frame, "软件渲染预览 - 旋转立方体");
 
             SDL_Delay(16);
         }
@@ -195,7 +320,7 @@ int main(int argc, char** argv) {
 
         fs::path ppmPath = output;
         ppmPath.replace_extension(".ppm");
-        if (!renderer.getRenderTarget().savePPM(ppmPath.string())) {
+        if (!renderer.savePPM(ppmPath.string())) {
             std::cerr << "写入临时 PPM 失败: " << ppmPath << std::endl;
             return 1;
         }
@@ -241,11 +366,12 @@ int main(int argc, char** argv) {
             float time = static_cast<float>(frame) / static_cast<float>(fps);
             animateScene(time);
             renderer.render(scene);
+            Core::Types::TextureCache::shared().endFrame();
 
             std::ostringstream fileName;
             fileName << "frame_" << std::setw(4) << std::setfill('0') << frame << ".ppm";
             fs::path framePath = framesDir / fileName.str();
-            if (!renderer.getRenderTarget().savePPM(framePath.string())) {
+            if (!renderer.savePPM(framePath.string())) {
                 std::cerr << "写入帧失败: " << framePath << std::endl;
                 return 1;
             }
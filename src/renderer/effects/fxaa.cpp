@@ -0,0 +1,203 @@
+#include "fxaa.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "core/platform/parallel.h"
+
+namespace Renderer {
+namespace Effects {
+
+using Core::Types::Color;
+using Renderer::Pipeline::RenderTarget;
+
+namespace {
+
+// 沿边搜索的步长序列（整数步，保证沿边方向的采样点落在像素中心）
+constexpr int kSearchSteps[] = {1, 1, 1, 1, 1, 2, 2, 2, 2, 4, 8};
+constexpr int kSearchStepCount = static_cast<int>(sizeof(kSearchSteps) / sizeof(kSearchSteps[0]));
+
+float computeLuma(const Color& c) {
+    float r = std::clamp(c.r, 0.0f, 1.0f);
+    float g = std::clamp(c.g, 0.0f, 1.0f);
+    float b = std::clamp(c.b, 0.0f, 1.0f);
+    return 0.299f * r + 0.587f * g + 0.114f * b;
+}
+
+class LumaView {
+public:
+    LumaView(const std::vector<float>& luma, int width, int height)
+        : m_luma(luma), m_width(width), m_height(height) {}
+
+    float at(int x, int y) const {
+        x = std::clamp(x, 0, m_width - 1);
+        y = std::clamp(y, 0, m_height - 1);
+        return m_luma[static_cast<std::size_t>(y) * static_cast<std::size_t>(m_width) + static_cast<std::size_t>(x)];
+    }
+
+private:
+    const std::vector<float>& m_luma;
+    int m_width;
+    int m_height;
+};
+
+// 处理已通过对比度检测的边缘像素；lumaM/N/S/W/E 与 range 由调用方在快速路径中算好
+Color fxaaEdgePixel(const std::vector<Color>& colors, const LumaView& luma,
+                    int width, int height, int x, int y,
+                    float lumaM, float lumaN, float lumaS, float lumaW, float lumaE, float range,
+                    const FxaaSettings& settings) {
+    auto colorAt = [&](int cx, int cy) -> const Color& {
+        cx = std::clamp(cx, 0, width - 1);
+        cy = std::clamp(cy, 0, height - 1);
+        return colors[static_cast<std::size_t>(cy) * static_cast<std::size_t>(width) + static_cast<std::size_t>(cx)];
+    };
+
+    const float lumaNW = luma.at(x - 1, y - 1);
+    const float lumaNE = luma.at(x + 1, y - 1);
+    const float lumaSW = luma.at(x - 1, y + 1);
+    const float lumaSE = luma.at(x + 1, y + 1);
+
+    // 判断边缘走向：水平边缘的亮度变化主要在竖直方向
+    const float edgeHorz = std::fabs(lumaNW + lumaSW - 2.0f * lumaW) +
+                           std::fabs(lumaN + lumaS - 2.0f * lumaM) * 2.0f +
+                           std::fabs(lumaNE + lumaSE - 2.0f * lumaE);
+    const float edgeVert = std::fabs(lumaNW + lumaNE - 2.0f * lumaN) +
+                           std::fabs(lumaW + lumaE - 2.0f * lumaM) * 2.0f +
+                           std::fabs(lumaSW + lumaSE - 2.0f * lumaS);
+    const bool horizontal = edgeHorz >= edgeVert;
+
+    // 垂直于边缘的两侧邻居，选梯度更大的一侧作为混合方向
+    const float luma1 = horizontal ? lumaN : lumaW;
+    const float luma2 = horizontal ? lumaS : lumaE;
+    const float gradient1 = luma1 - lumaM;
+    const float gradient2 = luma2 - lumaM;
+    const bool steepest1 = std::fabs(gradient1) >= std::fabs(gradient2);
+    const float gradientScaled = 0.25f * std::max(std::fabs(gradient1), std::fabs(gradient2));
+    const int side = steepest1 ? -1 : 1;
+    const float lumaLocalAverage = 0.5f * ((steepest1 ? luma1 : luma2) + lumaM);
+
+    // 沿边两侧的采样取"当前行/列与相邻行/列"的平均，相当于在半像素偏移处做双线性采样
+    auto edgeLuma = [&](int offset) {
+        if (horizontal) {
+            return 0.5f * (luma.at(x + offset, y) + luma.at(x + offset, y + side));
+        }
+        return 0.5f * (luma.at(x, y + offset) + luma.at(x, y + offset + side));
+    };
+
+    int distanceNeg = 0;
+    int distancePos = 0;
+    float deltaNeg = 0.0f;
+    float deltaPos = 0.0f;
+    bool doneNeg = false;
+    bool donePos = false;
+    for (int i = 0; i < kSearchStepCount && !(doneNeg && donePos); ++i) {
+        if (!doneNeg) {
+            distanceNeg += kSearchSteps[i];
+            deltaNeg = edgeLuma(-distanceNeg) - lumaLocalAverage;
+            doneNeg = std::fabs(deltaNeg) >= gradientScaled;
+        }
+        if (!donePos) {
+            distancePos += kSearchSteps[i];
+            deltaPos = edgeLuma(distancePos) - lumaLocalAverage;
+            donePos = std::fabs(deltaPos) >= gradientScaled;
+        }
+    }
+
+    // 端点处的采样点与中心相距 distance - 0.5 个像素
+    const float distNeg = static_cast<float>(distanceNeg) - 0.5f;
+    const float distPos = static_cast<float>(distancePos) - 0.5f;
+    const bool negCloser = distNeg < distPos;
+    const float closest = std::min(distNeg, distPos);
+    const float edgeLength = distNeg + distPos;
+
+    const bool centerSmaller = lumaM < lumaLocalAverage;
+    const float closestDelta = negCloser ? deltaNeg : deltaPos;
+    const bool correctVariation = (closestDelta < 0.0f) != centerSmaller;
+    float edgeOffset = correctVariation ? (0.5f - closest / edgeLength) : 0.0f;
+
+    // 子像素锯齿：周围 3×3 平均亮度与中心差异越大，混合越强
+    const float lumaAverage = (2.0f * (lumaN + lumaS + lumaW + lumaE) +
+                               lumaNW + lumaNE + lumaSW + lumaSE) / 12.0f;
+    const float subpixA = std::clamp(std::fabs(lumaAverage - lumaM) / range, 0.0f, 1.0f);
+    const float subpixB = (-2.0f * subpixA + 3.0f) * subpixA * subpixA;
+    const float subpixOffset = subpixB * subpixB * settings.subpixelQuality;
+
+    const float offset = std::clamp(std::max(edgeOffset, subpixOffset), 0.0f, 1.0f);
+    const Color& center = colorAt(x, y);
+    const Color& neighbor = horizontal ? colorAt(x, y + side) : colorAt(x + side, y);
+    Color result = center * (1.0f - offset) + neighbor * offset;
+    result.a = center.a;
+    return result;
+}
+
+} // namespace
+
+void applyFxaa(RenderTarget& target, const FxaaSettings& settings, FxaaWorkspace& workspace) {
+    const int width = target.getWidth();
+    const int height = target.getHeight();
+    if (width < 3 || height < 3) {
+        return;
+    }
+
+    // FXAA 读取邻域，不能边读边写：先算整帧亮度，再把边缘像素的结果按行收集，最后统一写回
+    const std::vector<Color>& source = target.getColorBuffer();
+    workspace.luma.resize(source.size());
+    workspace.rowEdits.resize(static_cast<std::size_t>(height));
+    std::vector<float>& lumaBuffer = workspace.luma;
+    Core::Platform::parallelFor(0, height, [&](int rowBegin, int rowEnd) {
+        for (int y = rowBegin; y < rowEnd; ++y) {
+            const std::size_t rowOffset = static_cast<std::size_t>(y) * static_cast<std::size_t>(width);
+            for (int x = 0; x < width; ++x) {
+                lumaBuffer[rowOffset + static_cast<std::size_t>(x)] = computeLuma(source[rowOffset + static_cast<std::size_t>(x)]);
+            }
+        }
+    });
+
+    const LumaView luma(lumaBuffer, width, height);
+    Core::Platform::parallelFor(0, height, [&](int rowBegin, int rowEnd) {
+        for (int y = rowBegin; y < rowEnd; ++y) {
+            std::vector<FxaaWorkspace::PixelEdit>& edits = workspace.rowEdits[static_cast<std::size_t>(y)];
+            edits.clear();
+            // 快速路径：直接按行指针读取十字邻域，绝大多数平坦像素在这里提前退出
+            const float* rowN = lumaBuffer.data() + static_cast<std::size_t>(std::max(y - 1, 0)) * static_cast<std::size_t>(width);
+            const float* rowM = lumaBuffer.data() + static_cast<std::size_t>(y) * static_cast<std::size_t>(width);
+            const float* rowS = lumaBuffer.data() + static_cast<std::size_t>(std::min(y + 1, height - 1)) * static_cast<std::size_t>(width);
+            for (int x = 0; x < width; ++x) {
+                const int xW = x > 0 ? x - 1 : 0;
+                const int xE = x < width - 1 ? x + 1 : width - 1;
+                const float lumaM = rowM[x];
+                const float lumaN = rowN[x];
+                const float lumaS = rowS[x];
+                const float lumaW = rowM[xW];
+                const float lumaE = rowM[xE];
+                const float lumaMin = std::min(std::min(lumaM, lumaN), std::min(std::min(lumaS, lumaW), lumaE));
+                const float lumaMax = std::max(std::max(lumaM, lumaN), std::max(std::max(lumaS, lumaW), lumaE));
+                const float range = lumaMax - lumaMin;
+                if (range < std::max(settings.edgeThresholdMin, lumaMax * settings.edgeThreshold)) {
+                    continue;
+                }
+                edits.push_back({x, fxaaEdgePixel(source, luma, width, height, x, y,
+                                                  lumaM, lumaN, lumaS, lumaW, lumaE, range, settings)});
+            }
+        }
+    });
+
+    std::vector<Color>& output = target.accessColorBuffer();
+    Core::Platform::parallelFor(0, height, [&](int rowBegin, int rowEnd) {
+        for (int y = rowBegin; y < rowEnd; ++y) {
+            const std::size_t rowOffset = static_cast<std::size_t>(y) * static_cast<std::size_t>(width);
+            for (const auto& edit : workspace.rowEdits[static_cast<std::size_t>(y)]) {
+                output[rowOffset + static_cast<std::size_t>(edit.x)] = edit.color;
+            }
+        }
+    });
+}
+
+void applyFxaa(RenderTarget& target, const FxaaSettings& settings) {
+    FxaaWorkspace workspace;
+    applyFxaa(target, settings, workspace);
+}
+
+} // namespace Effects
+} // namespace Renderer
@@ -0,0 +1,36 @@
+#ifndef RENDERER_EFFECTS_FXAA_H
+#define RENDERER_EFFECTS_FXAA_H
+
+#include <vector>
+
+#include "renderer/pipeline/render_target.h"
+
+namespace Renderer {
+namespace Effects {
+
+struct FxaaSettings {
+    float edgeThreshold = 0.125f;     // 局部对比度低于 lumaMax * edgeThreshold 的像素不处理
+    float edgeThresholdMin = 0.0312f; // 暗部的绝对对比度阈值，避免在噪声上做平滑
+    float subpixelQuality = 0.75f;    // 子像素混合强度 [0,1]，越大越柔和
+};
+
+// 跨帧复用的暂存缓冲，避免每帧重新分配整帧内存。
+// 只有亮度是整帧的；边缘像素的结果按行暂存，全部计算完后再写回，因此不需要颜色快照。
+struct FxaaWorkspace {
+    struct PixelEdit {
+        int x;
+        Core::Types::Color color;
+    };
+    std::vector<float> luma;
+    std::vector<std::vector<PixelEdit>> rowEdits;
+};
+
+// 基于亮度的后处理抗锯齿（FXAA 3.11 Quality 思路）：检测边缘方向，沿边搜索端点，
+// 按像素到端点的距离在边缘两侧做混合。按行并行，直接修改 target 的颜色缓冲。
+void applyFxaa(Pipeline::RenderTarget& target, const FxaaSettings& settings, FxaaWorkspace& workspace);
+void applyFxaa(Pipeline::RenderTarget& target, const FxaaSettings& settings = FxaaSettings());
+
+} // namespace Effects
+} // namespace Renderer
+
+#endif // RENDERER_EFFECTS_FXAA_H
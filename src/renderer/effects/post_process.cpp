@@ -0,0 +1,304 @@
+#include "post_process.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "core/platform/parallel.h"
+
+namespace Renderer {
+namespace Effects {
+
+using Core::Types::Color;
+using Renderer::Pipeline::RenderTarget;
+
+namespace {
+
+constexpr int kTransferTableSize = 1024;
+
+// 4×4 Bayer 矩阵，取值 0..15
+constexpr int kBayer4x4[4][4] = {
+    { 0,  8,  2, 10},
+    {12,  4, 14,  6},
+    { 3, 11,  1,  9},
+    {15,  7, 13,  5}
+};
+
+float linearToSrgb(float v) {
+    if (v <= 0.0031308f) {
+        return v * 12.92f;
+    }
+    return 1.055f * std::pow(v, 1.0f / 2.4f) - 0.055f;
+}
+
+template <typename Fn>
+std::vector<float> buildTransferTable(Fn&& fn) {
+    std::vector<float> table(kTransferTableSize + 1);
+    for (int i = 0; i <= kTransferTableSize; ++i) {
+        table[static_cast<std::size_t>(i)] = fn(static_cast<float>(i) / static_cast<float>(kTransferTableSize));
+    }
+    return table;
+}
+
+float lookupTransfer(const std::vector<float>& table, float v) {
+    float pos = std::clamp(v, 0.0f, 1.0f) * static_cast<float>(kTransferTableSize);
+    int index = std::min(static_cast<int>(pos), kTransferTableSize - 1);
+    float frac = pos - static_cast<float>(index);
+    return table[static_cast<std::size_t>(index)] * (1.0f - frac) + table[static_cast<std::size_t>(index + 1)] * frac;
+}
+
+float reinhard(float v) {
+    v = std::max(0.0f, v);
+    return v / (1.0f + v);
+}
+
+float acesFilmic(float v) {
+    v = std::max(0.0f, v);
+    return std::clamp((v * (2.51f * v + 0.03f)) / (v * (2.43f * v + 0.59f) + 0.14f), 0.0f, 1.0f);
+}
+
+uint8_t quantize8(float v) {
+    // 与 Color::toUint32 一致：截断量化
+    return static_cast<uint8_t>(std::clamp(v, 0.0f, 1.0f) * 255.0f);
+}
+
+} // namespace
+
+// ==================== ColorGradingLut ====================
+
+ColorGradingLut ColorGradingLut::identity(int size) {
+    ColorGradingLut lut;
+    lut.size = std::max(2, size);
+    lut.table.resize(static_cast<std::size_t>(lut.size * lut.size * lut.size));
+    const float scale = 1.0f / static_cast<float>(lut.size - 1);
+    for (int b = 0; b < lut.size; ++b) {
+        for (int g = 0; g < lut.size; ++g) {
+            for (int r = 0; r < lut.size; ++r) {
+                lut.table[static_cast<std::size_t>((b * lut.size + g) * lut.size + r)] =
+                    Color(r * scale, g * scale, b * scale, 1.0f);
+            }
+        }
+    }
+    return lut;
+}
+
+Color ColorGradingLut::sample(const Color& color) const {
+    if (size < 2 || table.size() < static_cast<std::size_t>(size * size * size)) {
+        return color;
+    }
+
+    const float maxIndex = static_cast<float>(size - 1);
+    float fr = std::clamp(color.r, 0.0f, 1.0f) * maxIndex;
+    float fg = std::clamp(color.g, 0.0f, 1.0f) * maxIndex;
+    float fb = std::clamp(color.b, 0.0f, 1.0f) * maxIndex;
+    int r0 = std::min(static_cast<int>(fr), size - 2);
+    int g0 = std::min(static_cast<int>(fg), size - 2);
+    int b0 = std::min(static_cast<int>(fb), size - 2);
+    float tr = fr - static_cast<float>(r0);
+    float tg = fg - static_cast<float>(g0);
+    float tb = fb - static_cast<float>(b0);
+
+    auto at = [this](int r, int g, int b) -> const Color& {
+        return table[static_cast<std::size_t>((b * size + g) * size + r)];
+    };
+
+    Color c00 = at(r0, g0, b0) * (1.0f - tr) + at(r0 + 1, g0, b0) * tr;
+    Color c10 = at(r0, g0 + 1, b0) * (1.0f - tr) + at(r0 + 1, g0 + 1, b0) * tr;
+    Color c01 = at(r0, g0, b0 + 1) * (1.0f - tr) + at(r0 + 1, g0, b0 + 1) * tr;
+    Color c11 = at(r0, g0 + 1, b0 + 1) * (1.0f - tr) + at(r0 + 1, g0 + 1, b0 + 1) * tr;
+    Color c0 = c00 * (1.0f - tg) + c10 * tg;
+    Color c1 = c01 * (1.0f - tg) + c11 * tg;
+    Color result = c0 * (1.0f - tb) + c1 * tb;
+    result.a = color.a;
+    return result;
+}
+
+// ==================== PostProcessChain ====================
+
+PostProcessChain& PostProcessChain::addExposure(float exposure) {
+    Operator op;
+    op.type = OperatorType::Exposure;
+    op.param0 = exposure;
+    m_operators.push_back(std::move(op));
+    return *this;
+}
+
+PostProcessChain& PostProcessChain::addToneMap(ToneMapOperator toneMap) {
+    Operator op;
+    op.type = OperatorType::ToneMap;
+    op.toneMap = toneMap;
+    m_operators.push_back(std::move(op));
+    return *this;
+}
+
+PostProcessChain& PostProcessChain::addGamma(float gamma) {
+    Operator op;
+    op.type = OperatorType::Transfer;
+    const float invGamma = 1.0f / std::max(gamma, 1e-3f);
+    op.transferTable = buildTransferTable([invGamma](float v) { return std::pow(v, invGamma); });
+    m_operators.push_back(std::move(op));
+    return *this;
+}
+
+PostProcessChain& PostProcessChain::addSrgbEncode() {
+    Operator op;
+    op.type = OperatorType::Transfer;
+    op.transferTable = buildTransferTable(linearToSrgb);
+    m_operators.push_back(std::move(op));
+    return *this;
+}
+
+PostProcessChain& PostProcessChain::addColorGrading(const ColorGradingLut* lut) {
+    if (!lut) {
+        return *this;
+    }
+    Operator op;
+    op.type = OperatorType::ColorGrading;
+    op.lut = lut;
+    m_operators.push_back(std::move(op));
+    return *this;
+}
+
+PostProcessChain& PostProcessChain::addVignette(float strength, float radius) {
+    Operator op;
+    op.type = OperatorType::Vignette;
+    op.param0 = std::clamp(strength, 0.0f, 1.0f);
+    op.param1 = std::clamp(radius, 0.0f, 0.999f);
+    m_operators.push_back(std::move(op));
+    return *this;
+}
+
+PostProcessChain& PostProcessChain::addOrderedDither(int bits) {
+    Operator op;
+    op.type = OperatorType::Dither;
+    bits = std::clamp(bits, 1, 16);
+    op.param0 = 1.0f / static_cast<float>((1 << bits) - 1);
+    m_operators.push_back(std::move(op));
+    return *this;
+}
+
+void PostProcessChain::processRow(Color* row, int width, int y, float centerX, float centerY,
+                                  float invHalfDiagonal) const {
+    for (const Operator& op : m_operators) {
+        switch (op.type) {
+        case OperatorType::Exposure:
+            for (int x = 0; x < width; ++x) {
+                row[x].r *= op.param0;
+                row[x].g *= op.param0;
+                row[x].b *= op.param0;
+            }
+            break;
+        case OperatorType::ToneMap:
+            if (op.toneMap == ToneMapOperator::ACES) {
+                for (int x = 0; x < width; ++x) {
+                    row[x].r = acesFilmic(row[x].r);
+                    row[x].g = acesFilmic(row[x].g);
+                    row[x].b = acesFilmic(row[x].b);
+                }
+            } else {
+                for (int x = 0; x < width; ++x) {
+                    row[x].r = reinhard(row[x].r);
+                    row[x].g = reinhard(row[x].g);
+                    row[x].b = reinhard(row[x].b);
+                }
+            }
+            break;
+        case OperatorType::Transfer:
+            for (int x = 0; x < width; ++x) {
+                row[x].r = lookupTransfer(op.transferTable, row[x].r);
+                row[x].g = lookupTransfer(op.transferTable, row[x].g);
+                row[x].b = lookupTransfer(op.transferTable, row[x].b);
+            }
+            break;
+        case OperatorType::ColorGrading:
+            for (int x = 0; x < width; ++x) {
+                row[x] = op.lut->sample(row[x]);
+            }
+            break;
+        case OperatorType::Vignette: {
+            const float dy = (static_cast<float>(y) + 0.5f - centerY) * invHalfDiagonal;
+            const float invSpan = 1.0f / (1.0f - op.param1);
+            for (int x = 0; x < width; ++x) {
+                float dx = (static_cast<float>(x) + 0.5f - centerX) * invHalfDiagonal;
+                float dist = std::sqrt(dx * dx + dy * dy);
+                float t = std::clamp((dist - op.param1) * invSpan, 0.0f, 1.0f);
+                float factor = 1.0f - op.param0 * t * t * (3.0f - 2.0f * t);
+                row[x].r *= factor;
+                row[x].g *= factor;
+                row[x].b *= factor;
+            }
+            break;
+        }
+        case OperatorType::Dither: {
+            // 量化为截断取整：加上 [0,1) 个量化步长的阈值后，截断结果的期望值等于原值
+            const int* bayerRow = kBayer4x4[y & 3];
+            for (int x = 0; x < width; ++x) {
+                float threshold = (static_cast<float>(bayerRow[x & 3]) + 0.5f) * (1.0f / 16.0f) * op.param0;
+                row[x].r += threshold;
+                row[x].g += threshold;
+                row[x].b += threshold;
+            }
+            break;
+        }
+        }
+    }
+}
+
+void PostProcessChain::apply(RenderTarget& target) const {
+    const int width = target.getWidth();
+    const int height = target.getHeight();
+    if (m_operators.empty() || width == 0 || height == 0) {
+        return;
+    }
+
+    const float centerX = static_cast<float>(width) * 0.5f;
+    const float centerY = static_cast<float>(height) * 0.5f;
+    const float invHalfDiagonal = 1.0f / std::sqrt(centerX * centerX + centerY * centerY);
+
+    std::vector<Color>& pixels = target.accessColorBuffer();
+    Core::Platform::parallelFor(0, height, [&](int rowBegin, int rowEnd) {
+        for (int y = rowBegin; y < rowEnd; ++y) {
+            processRow(pixels.data() + static_cast<std::size_t>(y) * static_cast<std::size_t>(width),
+                       width, y, centerX, centerY, invHalfDiagonal);
+        }
+    });
+}
+
+void PostProcessChain::encode(const RenderTarget& target, std::vector<uint8_t>& out, bool includeAlpha) const {
+    const int width = target.getWidth();
+    const int height = target.getHeight();
+    const int channels = includeAlpha ? 4 : 3;
+    out.resize(static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * static_cast<std::size_t>(channels));
+    if (width == 0 || height == 0) {
+        return;
+    }
+
+    const float centerX = static_cast<float>(width) * 0.5f;
+    const float centerY = static_cast<float>(height) * 0.5f;
+    const float invHalfDiagonal = 1.0f / std::sqrt(centerX * centerX + centerY * centerY);
+
+    const std::vector<Color>& pixels = target.getColorBuffer();
+    Core::Platform::parallelFor(0, height, [&](int rowBegin, int rowEnd) {
+        // 每个线程一行暂存：源缓冲保持只读，处理结果在缓存中直接量化输出
+        std::vector<Color> scratch(static_cast<std::size_t>(width));
+        for (int y = rowBegin; y < rowEnd; ++y) {
+            const Color* row = pixels.data() + static_cast<std::size_t>(y) * static_cast<std::size_t>(width);
+            std::copy(row, row + width, scratch.begin());
+            processRow(scratch.data(), width, y, centerX, centerY, invHalfDiagonal);
+
+            uint8_t* dst = out.data() + static_cast<std::size_t>(y) * static_cast<std::size_t>(width) * static_cast<std::size_t>(channels);
+            for (int x = 0; x < width; ++x) {
+                const Color& c = scratch[static_cast<std::size_t>(x)];
+                dst[0] = quantize8(c.r);
+                dst[1] = quantize8(c.g);
+                dst[2] = quantize8(c.b);
+                if (includeAlpha) {
+                    dst[3] = quantize8(c.a);
+                }
+                dst += channels;
+            }
+        }
+    });
+}
+
+} // namespace Effects
+} // namespace Renderer
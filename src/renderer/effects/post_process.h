@@ -0,0 +1,78 @@
+#ifndef RENDERER_EFFECTS_POST_PROCESS_H
+#define RENDERER_EFFECTS_POST_PROCESS_H
+
+#include <cstdint>
+#include <vector>
+
+#include "renderer/pipeline/render_target.h"
+
+namespace Renderer {
+namespace Effects {
+
+enum class ToneMapOperator {
+    Reinhard, // c / (1 + c)
+    ACES      // Narkowicz 的 ACES filmic 拟合曲线
+};
+
+/**
+ * @brief 三维颜色查找表（调色 LUT），输入输出均为 [0,1] 的 RGB，三线性插值
+ */
+struct ColorGradingLut {
+    int size = 0;                           // 每个轴的格点数
+    std::vector<Core::Types::Color> table;  // 下标 = (b * size + g) * size + r
+
+    static ColorGradingLut identity(int size = 16);
+    Core::Types::Color sample(const Core::Types::Color& color) const;
+};
+
+/**
+ * @brief 后处理链：按添加顺序对每个像素依次执行各算子，整条链只遍历一次缓冲
+ *
+ * 以行为单位融合：一行数据读入缓存后跑完所有算子再写出。算子只作用于 RGB，alpha 保持不变。增加算子只增加逐像素计算量，不增加额外的整帧读写。
+ * 用法示例：chain.addExposure(1.5f).addToneMap(ToneMapOperator::ACES).addSrgbEncode().addOrderedDither();
+ */
+class PostProcessChain {
+public:
+    PostProcessChain& addExposure(float exposure);
+    PostProcessChain& addToneMap(ToneMapOperator op);
+    PostProcessChain& addGamma(float gamma);
+    PostProcessChain& addSrgbEncode();
+    // lut 由调用方持有，生命周期需覆盖整条链的使用期
+    PostProcessChain& addColorGrading(const ColorGradingLut* lut);
+    // strength: 角落处的最大压暗比例；radius: 从该归一化半径（中心 0，角落 1）开始压暗
+    PostProcessChain& addVignette(float strength, float radius = 0.5f);
+    // 4×4 Bayer 有序抖动，幅度为 1 / (2^bits - 1)，用于隐藏量化到 bits 位时的色带
+    PostProcessChain& addOrderedDither(int bits = 8);
+
+    void clear() { m_operators.clear(); }
+    bool empty() const { return m_operators.empty(); }
+
+    // 就地处理浮点颜色缓冲（单趟，按行并行）
+    void apply(Pipeline::RenderTarget& target) const;
+
+    // 处理并直接输出 8 位像素（RGB 或 RGBA 交错），与格式转换合并在同一趟中，不修改 target
+    void encode(const Pipeline::RenderTarget& target, std::vector<uint8_t>& out, bool includeAlpha) const;
+
+private:
+    enum class OperatorType { Exposure, ToneMap, Transfer, ColorGrading, Vignette, Dither };
+
+    struct Operator {
+        OperatorType type;
+        float param0 = 0.0f;
+        float param1 = 0.0f;
+        ToneMapOperator toneMap = ToneMapOperator::Reinhard;
+        const ColorGradingLut* lut = nullptr;
+        std::vector<float> transferTable; // Transfer 算子的预计算曲线（[0,1] 上均匀采样）
+    };
+
+    std::vector<Operator> m_operators;
+
+    // 对一行像素依次执行全部算子：行数据常驻缓存，各算子的内层循环保持紧凑、便于向量化
+    void processRow(Core::Types::Color* row, int width, int y, float centerX, float centerY,
+                    float invHalfDiagonal) const;
+};
+
+} // namespace Effects
+} // namespace Renderer
+
+#endif // RENDERER_EFFECTS_POST_PROCESS_H
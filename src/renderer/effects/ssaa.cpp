@@ -60,6 +60,26 @@ void resolveBox(const RenderTarget& highRes, RenderTarget& lowRes, int factor) {
     }
 }
 
+void resolveBoxTile(const RenderTarget& tile, RenderTarget& lowRes,
+                    int dstX, int dstY, int width, int height, int factor) {
+    factor = std::max(1, factor);
+    const float invFactor = 1.0f / static_cast<float>(factor);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            // 与 resolveBox 相同的求和顺序（先水平后垂直），保证分块与整帧结果逐位一致
+            Color sum(0, 0, 0, 0);
+            for (int yy = 0; yy < factor; ++yy) {
+                Color rowSum(0, 0, 0, 0);
+                for (int xx = 0; xx < factor; ++xx) {
+                    rowSum = rowSum + tile.getPixel(x * factor + xx, y * factor + yy);
+                }
+                sum = sum + rowSum * invFactor;
+            }
+            lowRes.setPixel(dstX + x, dstY + y, sum * invFactor);
+        }
+    }
+}
+
 } // namespace Effects
 } // namespace Renderer
 
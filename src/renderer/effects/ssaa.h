@@ -11,6 +11,14 @@ void resolveBox(const Pipeline::RenderTarget& highRes,
                 Pipeline::RenderTarget& lowRes,
                 int factor);
 
+// 分块 SSAA resolve：tile 是屏幕上一块区域的高分辨率缓冲（左上角对齐），
+// 把其中 (width*factor)×(height*factor) 的部分按块平均后写入 lowRes 的 [dstX, dstX+width)×[dstY, dstY+height)
+void resolveBoxTile(const Pipeline::RenderTarget& tile,
+                    Pipeline::RenderTarget& lowRes,
+                    int dstX, int dstY,
+                    int width, int height,
+                    int factor);
+
 } // namespace Effects
 } // namespace Renderer
 
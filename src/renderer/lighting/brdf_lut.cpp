@@ -0,0 +1,101 @@
+#include "brdf_lut.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "../../core/math/vector.h"
+
+namespace Renderer {
+namespace Lighting {
+
+namespace {
+
+// Hammersley 点集的第二维：位反转的基 2 根逆
+float radicalInverse(uint32_t bits) {
+    bits = (bits << 16u) | (bits >> 16u);
+    bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+    bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+    bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+    bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+    return static_cast<float>(bits) * 2.3283064365386963e-10f;
+}
+
+} // namespace
+
+const BrdfLut& BrdfLut::instance() {
+    static const BrdfLut lut;
+    return lut;
+}
+
+BrdfLut::BrdfLut()
+    : m_scale(kSize * kSize), m_bias(kSize * kSize) {
+    for (int row = 0; row < kSize; ++row) {
+        const float roughness = static_cast<float>(row) / (kSize - 1);
+        for (int col = 0; col < kSize; ++col) {
+            // NdotV = 0 时积分退化，第一列取一个很小的正值
+            const float NdotV = std::max(static_cast<float>(col) / (kSize - 1), 1e-3f);
+            integrate(NdotV, roughness, kSampleCount, m_scale[row * kSize + col], m_bias[row * kSize + col]);
+        }
+    }
+}
+
+void BrdfLut::integrate(float NdotV, float roughness, int sampleCount, float& scale, float& bias) {
+    using Core::Math::Vector3;
+
+    // 法线取 +z，视线在 xz 平面内
+    const Vector3 V(std::sqrt(std::max(0.0f, 1.0f - NdotV * NdotV)), 0.0f, NdotV);
+    const float alpha = std::max(roughness * roughness, 1e-4f);
+    const float a2 = alpha * alpha;
+
+    float sumScale = 0.0f;
+    float sumBias = 0.0f;
+    for (int i = 0; i < sampleCount; ++i) {
+        // 按 D(h)·NdotH 重要性采样半程向量
+        const float u = (static_cast<float>(i) + 0.5f) / sampleCount;
+        const float v = radicalInverse(static_cast<uint32_t>(i));
+        const float phi = Core::Math::Constants::TAU * u;
+        const float cosTheta = std::sqrt((1.0f - v) / (1.0f + (a2 - 1.0f) * v));
+        const float sinTheta = std::sqrt(std::max(0.0f, 1.0f - cosTheta * cosTheta));
+        const Vector3 H(sinTheta * std::cos(phi), sinTheta * std::sin(phi), cosTheta);
+        const float VdotH = V.dot(H);
+        const Vector3 L = H * (2.0f * VdotH) - V;
+
+        const float NdotL = L.z;
+        const float NdotH = H.z;
+        if (NdotL <= 0.0f || VdotH <= 0.0f) {
+            continue;
+        }
+        // f·cosθ / pdf = 4·V·NdotL·VdotH / NdotH（D 约去）
+        const float weight = 4.0f * smithGgxVisibility(NdotV, NdotL, alpha) * NdotL * VdotH / NdotH;
+        const float m = 1.0f - VdotH;
+        const float fresnel = m * m * m * m * m;
+        sumScale += (1.0f - fresnel) * weight;
+        sumBias += fresnel * weight;
+    }
+    scale = sumScale / sampleCount;
+    bias = sumBias / sampleCount;
+}
+
+void BrdfLut::lookup(float NdotV, float roughness, float& scale, float& bias) const {
+    const float fx = std::clamp(NdotV, 0.0f, 1.0f) * (kSize - 1);
+    const float fy = std::clamp(roughness, 0.0f, 1.0f) * (kSize - 1);
+    const int x0 = std::min(static_cast<int>(fx), kSize - 2);
+    const int y0 = std::min(static_cast<int>(fy), kSize - 2);
+    const float tx = fx - x0;
+    const float ty = fy - y0;
+
+    const int i00 = y0 * kSize + x0;
+    const int i10 = i00 + 1;
+    const int i01 = i00 + kSize;
+    const int i11 = i01 + 1;
+    const float w00 = (1.0f - tx) * (1.0f - ty);
+    const float w10 = tx * (1.0f - ty);
+    const float w01 = (1.0f - tx) * ty;
+    const float w11 = tx * ty;
+    scale = m_scale[i00] * w00 + m_scale[i10] * w10 + m_scale[i01] * w01 + m_scale[i11] * w11;
+    bias = m_bias[i00] * w00 + m_bias[i10] * w10 + m_bias[i01] * w01 + m_bias[i11] * w11;
+}
+
+} // namespace Lighting
+} // namespace Renderer
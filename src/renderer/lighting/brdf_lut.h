@@ -0,0 +1,57 @@
+#ifndef RENDERER_LIGHTING_BRDF_LUT_H
+#define RENDERER_LIGHTING_BRDF_LUT_H
+
+#include <cmath>
+#include <vector>
+
+namespace Renderer {
+namespace Lighting {
+
+/**
+ * @brief 高度相关 Smith 可见性 V = G / (4·NdotL·NdotV)，α 为 GGX 粗糙度（感知粗糙度的平方）
+ */
+inline float smithGgxVisibility(float NdotV, float NdotL, float alpha) {
+    const float a2 = alpha * alpha;
+    const float ggxV = NdotL * std::sqrt(NdotV * NdotV * (1.0f - a2) + a2);
+    const float ggxL = NdotV * std::sqrt(NdotL * NdotL * (1.0f - a2) + a2);
+    const float denom = ggxV + ggxL;
+    return denom > 0.0f ? 0.5f / denom : 0.0f;
+}
+
+/**
+ * @brief 预计算的 split-sum DFG 查找表
+ *
+ * 对 GGX 法线分布 + 高度相关 Smith 可见性 + Schlick 菲涅尔的镜面 BRDF，
+ * 在半球上对余弦加权积分并拆成 F0 的一次式：∫ f·cosθ = F0·scale + bias。
+ * 表以 (NdotV, roughness) 为坐标，进程内只构建一次（首次 instance() 时，重要性采样积分），
+ * 之后每个片元的环境镜面项只是一次双线性查表。
+ */
+class BrdfLut {
+public:
+    static constexpr int kSize = 32;          // 每个维度的采样数
+    static constexpr int kSampleCount = 256;  // 每个表项的重要性采样数
+
+    // 全局唯一的表，线程安全地惰性构建
+    static const BrdfLut& instance();
+
+    /**
+     * @brief 双线性查表，NdotV 与 roughness 截断到 [0, 1]
+     */
+    void lookup(float NdotV, float roughness, float& scale, float& bias) const;
+
+    /**
+     * @brief 直接积分一个表项（构建表与测试参照共用）
+     */
+    static void integrate(float NdotV, float roughness, int sampleCount, float& scale, float& bias);
+
+private:
+    BrdfLut();
+
+    std::vector<float> m_scale; // kSize × kSize，行为 roughness，列为 NdotV
+    std::vector<float> m_bias;
+};
+
+} // namespace Lighting
+} // namespace Renderer
+
+#endif // RENDERER_LIGHTING_BRDF_LUT_H
@@ -0,0 +1,133 @@
+#include "environment_light.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "../../core/types/texture.h"
+
+namespace Renderer {
+namespace Lighting {
+
+using Core::Math::Vector3;
+using Core::Types::Color;
+
+namespace {
+
+// 投影时的经纬度积分网格；环境光只取 l ≤ 2 的低频，64×32 个样本已足够
+constexpr int kThetaSteps = 32;
+constexpr int kPhiSteps = 64;
+
+// 实球谐基函数常数 K_lm，与 SHIrradiance::evaluate 中的多项式一一对应
+constexpr float kBasisScale[9] = {
+    0.282095f,
+    0.488603f, 0.488603f, 0.488603f,
+    1.092548f, 1.092548f, 0.315392f, 1.092548f, 0.546274f,
+};
+
+// 余弦卷积核 Â_l / π：l = 0, 1, 2 分别为 1, 2/3, 1/4
+constexpr float kConvolution[9] = {
+    1.0f,
+    2.0f / 3.0f, 2.0f / 3.0f, 2.0f / 3.0f,
+    0.25f, 0.25f, 0.25f, 0.25f, 0.25f,
+};
+
+} // namespace
+
+EnvironmentLight::EnvironmentLight()
+    : m_source(Source::GradientSky),
+      m_zenith(0.35f, 0.5f, 0.8f, 1.0f),
+      m_horizon(0.7f, 0.75f, 0.8f, 1.0f),
+      m_ground(0.25f, 0.22f, 0.2f, 1.0f),
+      m_image(nullptr),
+      m_intensity(1.0f),
+      m_dirty(true),
+      m_projectionCount(0) {}
+
+void EnvironmentLight::setGradientSky(const Color& zenith, const Color& horizon, const Color& ground) {
+    m_source = Source::GradientSky;
+    m_zenith = zenith;
+    m_horizon = horizon;
+    m_ground = ground;
+    m_image = nullptr;
+    m_dirty = true;
+}
+
+void EnvironmentLight::setImage(const Core::Types::Texture* image) {
+    m_source = Source::Image;
+    m_image = image;
+    m_dirty = true;
+}
+
+void EnvironmentLight::setIntensity(float intensity) {
+    if (intensity != m_intensity) {
+        m_intensity = intensity;
+        m_dirty = true;
+    }
+}
+
+Color EnvironmentLight::radiance(const Vector3& dir) const {
+    Color color;
+    if (m_source == Source::Image) {
+        if (!m_image) {
+            return Color(0.0f, 0.0f, 0.0f, 1.0f);
+        }
+        const float u = std::atan2(dir.x, -dir.z) / (2.0f * Core::Math::Constants::PI) + 0.5f;
+        const float v = std::acos(std::clamp(dir.y, -1.0f, 1.0f)) / Core::Math::Constants::PI;
+        color = m_image->sampleLevel(u, v, 0);
+    } else {
+        const Color& target = dir.y >= 0.0f ? m_zenith : m_ground;
+        const float t = std::min(std::fabs(dir.y), 1.0f);
+        color = m_horizon * (1.0f - t) + target * t;
+    }
+    return Color(color.r * m_intensity, color.g * m_intensity, color.b * m_intensity, 1.0f);
+}
+
+const SHIrradiance& EnvironmentLight::getIrradiance() {
+    if (m_dirty) {
+        project();
+        m_dirty = false;
+    }
+    return m_irradiance;
+}
+
+void EnvironmentLight::project() {
+    // L_lm = ∫ L(ω) Y_lm(ω) dω，按经纬度中点规则积分，dω = sinθ dθ dφ
+    float sumR[9] = {};
+    float sumG[9] = {};
+    float sumB[9] = {};
+    const float dTheta = Core::Math::Constants::PI / static_cast<float>(kThetaSteps);
+    const float dPhi = 2.0f * Core::Math::Constants::PI / static_cast<float>(kPhiSteps);
+
+    for (int t = 0; t < kThetaSteps; ++t) {
+        const float theta = (static_cast<float>(t) + 0.5f) * dTheta;
+        const float sinTheta = std::sin(theta);
+        const float cosTheta = std::cos(theta);
+        const float solidAngle = sinTheta * dTheta * dPhi;
+        for (int p = 0; p < kPhiSteps; ++p) {
+            const float phi = (static_cast<float>(p) + 0.5f) * dPhi;
+            const float x = sinTheta * std::sin(phi);
+            const float y = cosTheta;
+            const float z = -sinTheta * std::cos(phi);
+            const Color L = radiance(Vector3(x, y, z));
+            const float basis[9] = {1.0f, y, z, x, x * y, y * z, 3.0f * z * z - 1.0f, x * z, x * x - y * y};
+            for (int i = 0; i < 9; ++i) {
+                const float w = kBasisScale[i] * basis[i] * solidAngle;
+                sumR[i] += L.r * w;
+                sumG[i] += L.g * w;
+                sumB[i] += L.b * w;
+            }
+        }
+    }
+
+    // 卷积核与基函数常数一并折入系数，求值时只剩多项式
+    for (int i = 0; i < 9; ++i) {
+        const float scale = kConvolution[i] * kBasisScale[i];
+        m_irradiance.r[i] = sumR[i] * scale;
+        m_irradiance.g[i] = sumG[i] * scale;
+        m_irradiance.b[i] = sumB[i] * scale;
+    }
+    ++m_projectionCount;
+}
+
+} // namespace Lighting
+} // namespace Renderer
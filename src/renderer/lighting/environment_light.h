@@ -0,0 +1,118 @@
+#ifndef RENDERER_LIGHTING_ENVIRONMENT_LIGHT_H
+#define RENDERER_LIGHTING_ENVIRONMENT_LIGHT_H
+
+#include <cstdint>
+
+#include "../../core/math/vector.h"
+#include "../../core/types/color.h"
+
+namespace Core {
+namespace Types {
+class Texture;
+}
+}
+
+namespace Renderer {
+namespace Lighting {
+
+/**
+ * @brief 9 系数（l ≤ 2）球谐表示的漫反射环境光
+ *
+ * 系数已乘入球谐基函数常数、余弦卷积核与 1/π，求值结果即朗伯表面在法线 n 处的
+ * 出射辐亮度与反照率之比：均匀辐亮度 L 的环境求值结果就是 L，与平坦环境光的语义一致。
+ */
+struct SHIrradiance {
+    float r[9] = {};
+    float g[9] = {};
+    float b[9] = {};
+
+    /**
+     * @brief 按单位法线求值（9 次乘加，结果截断为非负）
+     */
+    void evaluate(float x, float y, float z, float& outR, float& outG, float& outB) const {
+        const float basis[9] = {1.0f, y, z, x, x * y, y * z, 3.0f * z * z - 1.0f, x * z, x * x - y * y};
+        float sr = 0.0f, sg = 0.0f, sb = 0.0f;
+        for (int i = 0; i < 9; ++i) {
+            sr += r[i] * basis[i];
+            sg += g[i] * basis[i];
+            sb += b[i] * basis[i];
+        }
+        outR = sr > 0.0f ? sr : 0.0f;
+        outG = sg > 0.0f ? sg : 0.0f;
+        outB = sb > 0.0f ? sb : 0.0f;
+    }
+
+    Core::Types::Color evaluate(const Core::Math::Vector3& normal) const {
+        Core::Types::Color result(0.0f, 0.0f, 0.0f, 1.0f);
+        evaluate(normal.x, normal.y, normal.z, result.r, result.g, result.b);
+        return result;
+    }
+};
+
+/**
+ * @brief 环境光照
+ *
+ * 环境来源为程序化的渐变天空或等距柱状投影（equirectangular）图像，
+ * 只在来源或强度变化后的第一次 getIrradiance() 时重新投影到球谐系数；
+ * 之后每个片元的环境光只需几次乘加，开销与光源数量无关。
+ * 场景通过 Scene::setEnvironment 引用，对象由调用者持有。
+ */
+class EnvironmentLight {
+public:
+    EnvironmentLight();
+
+    /**
+     * @brief 程序化渐变天空：天顶 → 地平线按 y 线性过渡，地平线以下 → 地面色
+     */
+    void setGradientSky(const Core::Types::Color& zenith,
+                        const Core::Types::Color& horizon,
+                        const Core::Types::Color& ground);
+
+    /**
+     * @brief 等距柱状投影环境图：u 对应方位角，v = 0 为天顶（+y）
+     * @param image 环境图（调用者持有）；图像内容修改后需调用 invalidate()
+     */
+    void setImage(const Core::Types::Texture* image);
+
+    void setIntensity(float intensity);
+    float getIntensity() const { return m_intensity; }
+
+    /**
+     * @brief 标记来源已变化，下次取系数时重新投影
+     */
+    void invalidate() { m_dirty = true; }
+
+    /**
+     * @brief 方向 dir（单位向量，指向环境）上的环境辐亮度，已乘强度
+     */
+    Core::Types::Color radiance(const Core::Math::Vector3& dir) const;
+
+    /**
+     * @brief 取球谐系数，来源变化后惰性重新投影
+     */
+    const SHIrradiance& getIrradiance();
+
+    // 已执行的投影次数，用于确认静止环境不会重复计算
+    uint64_t getProjectionCount() const { return m_projectionCount; }
+
+private:
+    enum class Source { GradientSky, Image };
+
+    Source m_source;
+    Core::Types::Color m_zenith;
+    Core::Types::Color m_horizon;
+    Core::Types::Color m_ground;
+    const Core::Types::Texture* m_image;
+    float m_intensity;
+
+    SHIrradiance m_irradiance;
+    bool m_dirty;
+    uint64_t m_projectionCount;
+
+    void project();
+};
+
+} // namespace Lighting
+} // namespace Renderer
+
+#endif // RENDERER_LIGHTING_ENVIRONMENT_LIGHT_H
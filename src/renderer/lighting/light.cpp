@@ -8,7 +8,7 @@ namespace Lighting {
 // ==================== Light 基类实现 ====================
 
 Light::Light(Type type, const Color& color, float intensity)
-    : m_type(type), m_color(color), m_intensity(intensity), m_ambientIntensity(0.1f) {
+    : m_type(type), m_color(color), m_intensity(intensity), m_ambientIntensity(0.1f), m_castShadows(false) {
 }
 
 // ==================== PointLight 实现 ====================
@@ -52,6 +52,109 @@ void PointLight::setAttenuation(float constant, float linear, float quadratic) {
     m_quadraticAttenuation = quadratic;
 }
 
+// ==================== SpotLight 实现 ====================
+
+SpotLight::SpotLight(const Vector3& position, const Vector3& direction,
+                     float innerAngle, float outerAngle,
+                     const Color& color, float intensity, float range)
+    : Light(SPOT, color, intensity),
+      m_position(position),
+      m_direction(direction.normalize()),
+      m_range(range),
+      m_innerAngle(innerAngle),
+      m_outerAngle(outerAngle),
+      m_cosInner(1.0f),
+      m_cosOuter(1.0f),
+      m_sinOuter(0.0f),
+      m_constantAttenuation(1.0f),
+      m_linearAttenuation(0.09f),
+      m_quadraticAttenuation(0.032f) {
+    updateCone();
+}
+
+void SpotLight::updateCone() {
+    // 外锥限制在半球以内，包围球与锥体-球体测试都依赖这一点
+    const float maxAngle = 1.5607963f; // π/2 - 0.01
+    m_outerAngle = std::clamp(m_outerAngle, 0.0f, maxAngle);
+    m_innerAngle = std::clamp(m_innerAngle, 0.0f, m_outerAngle);
+    m_cosInner = std::cos(m_innerAngle);
+    m_cosOuter = std::cos(m_outerAngle);
+    m_sinOuter = std::sin(m_outerAngle);
+}
+
+void SpotLight::setConeAngles(float innerAngle, float outerAngle) {
+    m_innerAngle = innerAngle;
+    m_outerAngle = outerAngle;
+    updateCone();
+}
+
+void SpotLight::setAttenuation(float constant, float linear, float quadratic) {
+    m_constantAttenuation = constant;
+    m_linearAttenuation = linear;
+    m_quadraticAttenuation = quadratic;
+}
+
+Vector3 SpotLight::getDirection(const Vector3& worldPos) const {
+    return (m_position - worldPos).normalize();
+}
+
+float SpotLight::getAttenuation(const Vector3& worldPos) const {
+    Vector3 toSurface = worldPos - m_position;
+    float distance = toSurface.length();
+    if (distance > m_range) {
+        return 0.0f;
+    }
+    float cosAngle = distance > 0.0f ? toSurface.dot(m_direction) / distance : 1.0f;
+    if (cosAngle <= m_cosOuter) {
+        return 0.0f;
+    }
+    // 内外锥之间 smoothstep 过渡
+    float t = std::clamp((cosAngle - m_cosOuter) / std::max(m_cosInner - m_cosOuter, 1e-4f), 0.0f, 1.0f);
+    float cone = t * t * (3.0f - 2.0f * t);
+
+    float attenuation = 1.0f / (m_constantAttenuation +
+                                m_linearAttenuation * distance +
+                                m_quadraticAttenuation * distance * distance);
+    return std::min(attenuation, 1.0f) * cone;
+}
+
+bool SpotLight::isVisible(const Vector3& worldPos) const {
+    Vector3 toSurface = worldPos - m_position;
+    float distance = toSurface.length();
+    if (distance > m_range) {
+        return false;
+    }
+    return distance <= 0.0f || toSurface.dot(m_direction) > m_cosOuter * distance;
+}
+
+bool SpotLight::intersectsSphere(const Vector3& center, float radius) const {
+    const Vector3 v = center - m_position;
+    const float lengthSq = v.dot(v);
+    const float axial = v.dot(m_direction);
+    if (axial > m_range + radius || axial < -radius) {
+        return false; // 整个球在光源背后或超出范围
+    }
+    if (lengthSq > (m_range + radius) * (m_range + radius)) {
+        return false;
+    }
+    // 球心到锥面的距离：把球心投影到 (轴向, 径向) 平面上，与外锥母线求有符号距离
+    const float radial = std::sqrt(std::max(0.0f, lengthSq - axial * axial));
+    const float distanceToCone = m_cosOuter * radial - m_sinOuter * axial;
+    return distanceToCone <= radius;
+}
+
+void SpotLight::getBoundingSphere(Vector3& center, float& radius) const {
+    if (m_cosOuter <= 0.70710678f) {
+        // 宽锥：以底面圆为大圆
+        center = m_position + m_direction * (m_range * m_cosOuter);
+        radius = m_range * m_sinOuter;
+    } else {
+        // 窄锥：球过顶点与底面圆
+        radius = m_range / (2.0f * m_cosOuter);
+        center = m_position + m_direction * radius;
+    }
+}
+
 // ==================== DirectionalLight 实现 ====================
 
 DirectionalLight::DirectionalLight(const Vector3& direction, const Color& color, float intensity)
@@ -24,6 +24,7 @@ protected:
     Color m_color;          // 光源颜色
     float m_intensity;      // 光源强度
     float m_ambientIntensity; // 环境光强度
+    bool m_castShadows;     // 是否投射阴影（生成阴影贴图）
     
 public:
     /**
@@ -65,11 +66,13 @@ public:
     const Color& getColor() const { return m_color; }
     float getIntensity() const { return m_intensity; }
     float getAmbientIntensity() const { return m_ambientIntensity; }
+    bool getCastShadows() const { return m_castShadows; }
     
     // Setter方法
     void setColor(const Color& color) { m_color = color; }
     void setIntensity(float intensity) { m_intensity = intensity; }
     void setAmbientIntensity(float intensity) { m_ambientIntensity = intensity; }
+    void setCastShadows(bool castShadows) { m_castShadows = castShadows; }
 };
 
 /**
@@ -108,6 +111,83 @@ public:
     void setRange(float range) { m_range = range; }
     
     void setAttenuation(float constant, float linear, float quadratic);
+    float getConstantAttenuation() const { return m_constantAttenuation; }
+    float getLinearAttenuation() const { return m_linearAttenuation; }
+    float getQuadraticAttenuation() const { return m_quadraticAttenuation; }
+};
+
+/**
+ * @brief 聚光灯
+ *
+ * 从一点沿给定方向发射锥形光束。内锥角以内全亮，外锥角以外为 0，
+ * 两者之间按 smoothstep 平滑过渡；锥角余弦在设置时预先计算，着色时只需一次点积。
+ * 距离衰减与 PointLight 相同，超出 range 的位置不受照射。
+ */
+class SpotLight : public Light {
+private:
+    Vector3 m_position;     // 光源位置
+    Vector3 m_direction;    // 光束轴向（光线传播方向），已归一化
+    float m_range;          // 光照范围
+    float m_innerAngle;     // 内锥半角（弧度）
+    float m_outerAngle;     // 外锥半角（弧度）
+    float m_cosInner;
+    float m_cosOuter;
+    float m_sinOuter;
+    float m_constantAttenuation;
+    float m_linearAttenuation;
+    float m_quadraticAttenuation;
+
+    void updateCone();
+
+public:
+    /**
+     * @brief 构造函数
+     * @param position 光源位置
+     * @param direction 光束方向
+     * @param innerAngle 内锥半角（弧度）
+     * @param outerAngle 外锥半角（弧度），会被限制在 [innerAngle, π/2) 内
+     * @param color 光源颜色
+     * @param intensity 光源强度
+     * @param range 光照范围
+     */
+    SpotLight(const Vector3& position, const Vector3& direction,
+              float innerAngle, float outerAngle,
+              const Color& color = Color::WHITE, float intensity = 1.0f, float range = 100.0f);
+
+    Vector3 getDirection(const Vector3& worldPos) const override;
+    float getAttenuation(const Vector3& worldPos) const override;
+    bool isVisible(const Vector3& worldPos) const override;
+
+    /**
+     * @brief 锥体与球体是否可能相交（保守：返回 false 时球内各点都不受照射）
+     */
+    bool intersectsSphere(const Vector3& center, float radius) const;
+
+    /**
+     * @brief 包住整个锥体（截止到 range）的最小球，供屏幕空间分簇剔除使用
+     */
+    void getBoundingSphere(Vector3& center, float& radius) const;
+
+    // Getter/Setter
+    const Vector3& getPosition() const { return m_position; }
+    void setPosition(const Vector3& position) { m_position = position; }
+
+    const Vector3& getSpotDirection() const { return m_direction; }
+    void setSpotDirection(const Vector3& direction) { m_direction = direction.normalize(); }
+
+    float getRange() const { return m_range; }
+    void setRange(float range) { m_range = range; }
+
+    float getInnerAngle() const { return m_innerAngle; }
+    float getOuterAngle() const { return m_outerAngle; }
+    void setConeAngles(float innerAngle, float outerAngle);
+    float getCosInner() const { return m_cosInner; }
+    float getCosOuter() const { return m_cosOuter; }
+
+    void setAttenuation(float constant, float linear, float quadratic);
+    float getConstantAttenuation() const { return m_constantAttenuation; }
+    float getLinearAttenuation() const { return m_linearAttenuation; }
+    float getQuadraticAttenuation() const { return m_quadraticAttenuation; }
 };
 
 /**
@@ -0,0 +1,107 @@
+#include "light_buffer.h"
+
+#include <algorithm>
+#include <typeinfo>
+
+#include "light.h"
+#include "shadow_map.h"
+
+namespace Renderer {
+namespace Lighting {
+
+void LightBuffer::build(const std::vector<Light*>& lights, const ShadowMapCache* shadows) {
+    DirectionalLights& dir = m_directional;
+    dir.dirX.clear(); dir.dirY.clear(); dir.dirZ.clear();
+    dir.r.clear(); dir.g.clear(); dir.b.clear();
+    dir.shadow.clear();
+
+    PointLights& pts = m_points;
+    pts.posX.clear(); pts.posY.clear(); pts.posZ.clear();
+    pts.range.clear(); pts.rangeSq.clear();
+    pts.constant.clear(); pts.linear.clear(); pts.quadratic.clear();
+    pts.r.clear(); pts.g.clear(); pts.b.clear();
+    pts.shadow.clear();
+
+    SpotLights& spt = m_spots;
+    spt.posX.clear(); spt.posY.clear(); spt.posZ.clear();
+    spt.dirX.clear(); spt.dirY.clear(); spt.dirZ.clear();
+    spt.range.clear(); spt.rangeSq.clear();
+    spt.cosOuter.clear(); spt.invConeDelta.clear();
+    spt.constant.clear(); spt.linear.clear(); spt.quadratic.clear();
+    spt.r.clear(); spt.g.clear(); spt.b.clear();
+    spt.boundX.clear(); spt.boundY.clear(); spt.boundZ.clear(); spt.boundRadius.clear();
+    spt.source.clear();
+
+    m_others.clear();
+
+    for (Light* light : lights) {
+        if (!light) {
+            continue;
+        }
+        const Color& color = light->getColor();
+        const float intensity = light->getIntensity();
+
+        // 仅对确切的内置类型展开；派生自内置类型的用户类可能重写了虚函数，走通用路径
+        if (light->getType() == Light::DIRECTIONAL && typeid(*light) == typeid(DirectionalLight)) {
+            const auto* directional = static_cast<const DirectionalLight*>(light);
+            Vector3 toLight = (-directional->getLightDirection()).normalize();
+            dir.dirX.push_back(toLight.x);
+            dir.dirY.push_back(toLight.y);
+            dir.dirZ.push_back(toLight.z);
+            dir.r.push_back(color.r * intensity);
+            dir.g.push_back(color.g * intensity);
+            dir.b.push_back(color.b * intensity);
+            dir.shadow.push_back(shadows ? shadows->findDirectional(light) : nullptr);
+        } else if (light->getType() == Light::POINT && typeid(*light) == typeid(PointLight)) {
+            const auto* point = static_cast<const PointLight*>(light);
+            const Vector3& position = point->getPosition();
+            const float range = point->getRange();
+            pts.posX.push_back(position.x);
+            pts.posY.push_back(position.y);
+            pts.posZ.push_back(position.z);
+            pts.range.push_back(range);
+            pts.rangeSq.push_back(range * range);
+            pts.constant.push_back(point->getConstantAttenuation());
+            pts.linear.push_back(point->getLinearAttenuation());
+            pts.quadratic.push_back(point->getQuadraticAttenuation());
+            pts.r.push_back(color.r * intensity);
+            pts.g.push_back(color.g * intensity);
+            pts.b.push_back(color.b * intensity);
+            pts.shadow.push_back(shadows ? shadows->findCube(light) : nullptr);
+        } else if (light->getType() == Light::SPOT && typeid(*light) == typeid(SpotLight)) {
+            const auto* spot = static_cast<const SpotLight*>(light);
+            const Vector3& position = spot->getPosition();
+            const Vector3& axis = spot->getSpotDirection();
+            const float range = spot->getRange();
+            spt.posX.push_back(position.x);
+            spt.posY.push_back(position.y);
+            spt.posZ.push_back(position.z);
+            spt.dirX.push_back(axis.x);
+            spt.dirY.push_back(axis.y);
+            spt.dirZ.push_back(axis.z);
+            spt.range.push_back(range);
+            spt.rangeSq.push_back(range * range);
+            spt.cosOuter.push_back(spot->getCosOuter());
+            spt.invConeDelta.push_back(1.0f / std::max(spot->getCosInner() - spot->getCosOuter(), 1e-4f));
+            spt.constant.push_back(spot->getConstantAttenuation());
+            spt.linear.push_back(spot->getLinearAttenuation());
+            spt.quadratic.push_back(spot->getQuadraticAttenuation());
+            spt.r.push_back(color.r * intensity);
+            spt.g.push_back(color.g * intensity);
+            spt.b.push_back(color.b * intensity);
+            Vector3 boundCenter;
+            float boundRadius = 0.0f;
+            spot->getBoundingSphere(boundCenter, boundRadius);
+            spt.boundX.push_back(boundCenter.x);
+            spt.boundY.push_back(boundCenter.y);
+            spt.boundZ.push_back(boundCenter.z);
+            spt.boundRadius.push_back(boundRadius);
+            spt.source.push_back(spot);
+        } else {
+            m_others.push_back(light);
+        }
+    }
+}
+
+} // namespace Lighting
+} // namespace Renderer
@@ -0,0 +1,113 @@
+#ifndef RENDERER_LIGHTING_LIGHT_BUFFER_H
+#define RENDERER_LIGHTING_LIGHT_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "environment_light.h"
+
+namespace Renderer {
+namespace Lighting {
+
+class Light;
+class SpotLight;
+class DirectionalShadowMap;
+class CubeShadowMap;
+class ShadowMapCache;
+
+/**
+ * @brief 按类型分组的扁平光源缓冲（SoA）
+ *
+ * 每帧由场景光源编译一次：颜色预乘强度，方向预先归一化，衰减常数直接展开，
+ * 着色循环按类型分别遍历连续数组，不再经过 Light 的虚函数。
+ * 没有专用分组的自定义 Light 子类保存在 others() 中，仍按虚接口着色（不带阴影）。
+ */
+class LightBuffer {
+public:
+    struct DirectionalLights {
+        std::vector<float> dirX, dirY, dirZ; // 从表面指向光源，已归一化
+        std::vector<float> r, g, b;          // 颜色 × 强度
+        std::vector<const DirectionalShadowMap*> shadow; // 不投射阴影时为空指针
+        std::size_t size() const { return dirX.size(); }
+    };
+
+    struct PointLights {
+        std::vector<float> posX, posY, posZ;
+        std::vector<float> range;
+        std::vector<float> rangeSq;
+        std::vector<float> constant, linear, quadratic; // 1 / (kc + kl·d + kq·d²)
+        std::vector<float> r, g, b;                      // 颜色 × 强度
+        std::vector<const CubeShadowMap*> shadow;         // 不投射阴影时为空指针
+        std::size_t size() const { return posX.size(); }
+    };
+
+    struct SpotLights {
+        std::vector<float> posX, posY, posZ;
+        std::vector<float> dirX, dirY, dirZ;             // 光束轴向（光线传播方向），已归一化
+        std::vector<float> range;
+        std::vector<float> rangeSq;
+        std::vector<float> cosOuter;                     // 外锥半角余弦
+        std::vector<float> invConeDelta;                 // 1 / (cosInner - cosOuter)，smoothstep 的缩放
+        std::vector<float> constant, linear, quadratic;
+        std::vector<float> r, g, b;                      // 颜色 × 强度
+        std::vector<float> boundX, boundY, boundZ, boundRadius; // 锥体包围球，供分簇剔除
+        std::vector<const SpotLight*> source;            // 原始光源，用于物体级的锥体-球体测试
+        std::size_t size() const { return posX.size(); }
+    };
+
+    /**
+     * @brief 从场景光源重建缓冲（复用已分配的内存）
+     * @param shadows 本帧的阴影贴图缓存；为空时所有光源都不带阴影
+     */
+    void build(const std::vector<Light*>& lights, const ShadowMapCache* shadows = nullptr);
+
+    const DirectionalLights& directional() const { return m_directional; }
+    const PointLights& points() const { return m_points; }
+    const SpotLights& spots() const { return m_spots; }
+    const std::vector<Light*>& others() const { return m_others; }
+
+    /**
+     * @brief 设置本帧的球谐环境光（复制系数）；传入空指针时着色退回平坦环境光
+     */
+    void setEnvironment(const SHIrradiance* irradiance) {
+        m_hasEnvironment = irradiance != nullptr;
+        if (irradiance) {
+            m_environment = *irradiance;
+        }
+    }
+    const SHIrradiance* environment() const { return m_hasEnvironment ? &m_environment : nullptr; }
+
+    std::size_t size() const {
+        return m_directional.size() + m_points.size() + m_spots.size() + m_others.size();
+    }
+
+private:
+    DirectionalLights m_directional;
+    PointLights m_points;
+    SpotLights m_spots;
+    std::vector<Light*> m_others;
+    SHIrradiance m_environment;
+    bool m_hasEnvironment = false;
+};
+
+/**
+ * @brief 片元需要遍历的局部光源子集
+ *
+ * culled 为 false 时遍历全部点光源；否则只遍历 pointIndices 列出的点光源下标（升序）。
+ * 聚光灯同理，由 spotsCulled / spotIndices 描述。
+ * 方向光与自定义光源总是全部参与。
+ */
+struct LightSelection {
+    bool culled = false;
+    const uint32_t* pointIndices = nullptr;
+    std::size_t pointCount = 0;
+    bool spotsCulled = false;
+    const uint32_t* spotIndices = nullptr;
+    std::size_t spotCount = 0;
+};
+
+} // namespace Lighting
+} // namespace Renderer
+
+#endif // RENDERER_LIGHTING_LIGHT_BUFFER_H
@@ -0,0 +1,196 @@
+#include "light_culling.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+
+namespace Renderer {
+namespace Lighting {
+
+using Core::Math::Matrix4;
+using Core::Math::Vector3;
+using Core::Math::Vector4;
+
+namespace {
+
+struct ClusterRange {
+    int tileX0, tileX1;
+    int tileY0, tileY1;
+    int slice0, slice1;
+};
+
+} // namespace
+
+int LightCuller::depthToSlice(float viewDepth) const {
+    if (!(viewDepth > m_nearPlane)) {
+        return 0;
+    }
+    int slice = static_cast<int>(std::log(viewDepth) * m_sliceScale + m_sliceBias);
+    return std::clamp(slice, 0, m_depthSlices - 1);
+}
+
+void LightCuller::build(const LightBuffer& lights,
+                        const Matrix4& viewMatrix,
+                        const Matrix4& projectionMatrix,
+                        int width, int height,
+                        float nearPlane, float farPlane,
+                        int tileSize, int depthSlices) {
+    m_tileSize = std::max(1, tileSize);
+    m_tilesX = std::max(1, (width + m_tileSize - 1) / m_tileSize);
+    m_tilesY = std::max(1, (height + m_tileSize - 1) / m_tileSize);
+    m_depthSlices = std::max(1, depthSlices);
+    m_nearPlane = std::max(nearPlane, 1e-4f);
+    const float farClamped = std::max(farPlane, m_nearPlane * 1.001f);
+
+    // 指数切片：slice = floor(S * log(z / near) / log(far / near))
+    m_sliceScale = static_cast<float>(m_depthSlices) / std::log(farClamped / m_nearPlane);
+    m_sliceBias = -std::log(m_nearPlane) * m_sliceScale;
+
+    const std::size_t clusterCount =
+        static_cast<std::size_t>(m_tilesX) * static_cast<std::size_t>(m_tilesY) * static_cast<std::size_t>(m_depthSlices);
+
+    const float maxX = static_cast<float>(width - 1);
+    const float maxY = static_cast<float>(height - 1);
+
+    // 计算包围球覆盖的簇范围；返回 false 表示该光源不影响任何可见片元
+    auto computeRange = [&](const Vector3& worldCenter, float radius, ClusterRange& range) -> bool {
+        const Vector3 center = viewMatrix.transformPoint(worldCenter);
+        // 深度范围略微放宽，吸收片元深度（1/插值 1/w）与世界坐标插值之间的舍入差异
+        const float zMin = (center.z - radius) * (1.0f - 1e-3f);
+        const float zMax = (center.z + radius) * (1.0f + 1e-3f);
+        if (zMax <= 0.0f) {
+            return false; // 完全位于相机之后
+        }
+        range.slice0 = depthToSlice(zMin);
+        range.slice1 = depthToSlice(zMax);
+
+        if (zMin <= m_nearPlane) {
+            // 包围球跨过近平面时投影无界，保守地覆盖整个屏幕
+            range.tileX0 = 0;
+            range.tileX1 = m_tilesX - 1;
+            range.tileY0 = 0;
+            range.tileY1 = m_tilesY - 1;
+            return true;
+        }
+
+        // 视空间包围盒 8 个角点投影后的屏幕矩形包含球的投影
+        float sx0 = std::numeric_limits<float>::max();
+        float sy0 = std::numeric_limits<float>::max();
+        float sx1 = std::numeric_limits<float>::lowest();
+        float sy1 = std::numeric_limits<float>::lowest();
+        for (int corner = 0; corner < 8; ++corner) {
+            Vector4 p((corner & 1) ? center.x + radius : center.x - radius,
+                      (corner & 2) ? center.y + radius : center.y - radius,
+                      (corner & 4) ? zMax : zMin,
+                      1.0f);
+            Vector4 clip = projectionMatrix * p;
+            float invW = 1.0f / clip.w;
+            float sx = (clip.x * invW * 0.5f + 0.5f) * maxX;
+            float sy = (1.0f - (clip.y * invW * 0.5f + 0.5f)) * maxY;
+            sx0 = std::min(sx0, sx);
+            sx1 = std::max(sx1, sx);
+            sy0 = std::min(sy0, sy);
+            sy1 = std::max(sy1, sy);
+        }
+        // 光栅化按像素中心采样且包围盒取整，向外扩一个像素保持保守
+        sx0 -= 1.0f;
+        sy0 -= 1.0f;
+        sx1 += 1.0f;
+        sy1 += 1.0f;
+        if (sx1 < 0.0f || sy1 < 0.0f || sx0 > maxX || sy0 > maxY) {
+            return false;
+        }
+        const float invTile = 1.0f / static_cast<float>(m_tileSize);
+        range.tileX0 = std::clamp(static_cast<int>(std::floor(sx0 * invTile)), 0, m_tilesX - 1);
+        range.tileX1 = std::clamp(static_cast<int>(std::floor(sx1 * invTile)), 0, m_tilesX - 1);
+        range.tileY0 = std::clamp(static_cast<int>(std::floor(sy0 * invTile)), 0, m_tilesY - 1);
+        range.tileY1 = std::clamp(static_cast<int>(std::floor(sy1 * invTile)), 0, m_tilesY - 1);
+        return true;
+    };
+
+    // 按包围球把一组光源登记到簇：先计数再按下标顺序填充，保证簇内累加顺序与不剔除时一致
+    auto binSpheres = [&](std::size_t count, auto&& sphereAt,
+                          std::vector<uint32_t>& offsets, std::vector<uint32_t>& clusterLights) {
+        std::vector<ClusterRange> ranges(count);
+        std::vector<bool> affects(count, false);
+        offsets.assign(clusterCount + 1, 0);
+
+        for (std::size_t i = 0; i < count; ++i) {
+            Vector3 center;
+            float radius = 0.0f;
+            sphereAt(i, center, radius);
+            if (!computeRange(center, radius, ranges[i])) {
+                continue;
+            }
+            affects[i] = true;
+            const ClusterRange& r = ranges[i];
+            for (int s = r.slice0; s <= r.slice1; ++s) {
+                for (int ty = r.tileY0; ty <= r.tileY1; ++ty) {
+                    for (int tx = r.tileX0; tx <= r.tileX1; ++tx) {
+                        ++offsets[clusterIndex(tx, ty, s) + 1];
+                    }
+                }
+            }
+        }
+
+        for (std::size_t c = 0; c < clusterCount; ++c) {
+            offsets[c + 1] += offsets[c];
+        }
+
+        clusterLights.resize(offsets[clusterCount]);
+        std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (std::size_t i = 0; i < count; ++i) {
+            if (!affects[i]) {
+                continue;
+            }
+            const ClusterRange& r = ranges[i];
+            for (int s = r.slice0; s <= r.slice1; ++s) {
+                for (int ty = r.tileY0; ty <= r.tileY1; ++ty) {
+                    for (int tx = r.tileX0; tx <= r.tileX1; ++tx) {
+                        clusterLights[cursor[clusterIndex(tx, ty, s)]++] = static_cast<uint32_t>(i);
+                    }
+                }
+            }
+        }
+    };
+
+    const LightBuffer::PointLights& points = lights.points();
+    binSpheres(points.size(),
+               [&](std::size_t i, Vector3& center, float& radius) {
+                   center = Vector3(points.posX[i], points.posY[i], points.posZ[i]);
+                   radius = points.range[i];
+               },
+               m_clusterOffsets, m_clusterLights);
+
+    // 聚光灯使用锥体的包围球，锥体之外的 tile 不会登记该光源
+    const LightBuffer::SpotLights& spots = lights.spots();
+    binSpheres(spots.size(),
+               [&](std::size_t i, Vector3& center, float& radius) {
+                   center = Vector3(spots.boundX[i], spots.boundY[i], spots.boundZ[i]);
+                   radius = spots.boundRadius[i];
+               },
+               m_spotOffsets, m_spotLights);
+}
+
+LightSelection LightCuller::getLights(int x, int y, float viewDepth) const {
+    if (m_clusterOffsets.empty()) {
+        return LightSelection();
+    }
+    const int tx = std::clamp(x / m_tileSize, 0, m_tilesX - 1);
+    const int ty = std::clamp(y / m_tileSize, 0, m_tilesY - 1);
+    const std::size_t cluster = clusterIndex(tx, ty, depthToSlice(viewDepth));
+    const uint32_t begin = m_clusterOffsets[cluster];
+    const uint32_t end = m_clusterOffsets[cluster + 1];
+    LightSelection selection;
+    selection.culled = true;
+    selection.pointIndices = m_clusterLights.data() + begin;
+    selection.pointCount = end - begin;
+    selection.spotsCulled = true;
+    selection.spotIndices = m_spotLights.data() + m_spotOffsets[cluster];
+    selection.spotCount = m_spotOffsets[cluster + 1] - m_spotOffsets[cluster];
+    return selection;
+}
+
+} // namespace Lighting
+} // namespace Renderer
@@ -0,0 +1,80 @@
+#ifndef RENDERER_LIGHTING_LIGHT_CULLING_H
+#define RENDERER_LIGHTING_LIGHT_CULLING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "light_buffer.h"
+#include "../../core/math/matrix.h"
+
+namespace Renderer {
+namespace Lighting {
+
+/**
+ * @brief 分簇光源剔除
+ *
+ * 把屏幕划分为 tileSize×tileSize 像素的 tile，并在视空间深度上按指数分布切成若干 slice，
+ * 每个 (tile, slice) 是一个簇。点光源按其包围球、聚光灯按其锥体包围球覆盖的簇
+ * 登记为 LightBuffer 中的下标；方向光等无范围的光源不参与剔除，总是全部着色。
+ * 片元只遍历所在簇的点光源与聚光灯，着色开销随局部光源密度而不是场景光源总数增长。
+ * 下标保持升序，被剔除的只是对该簇贡献为 0 的光源，结果与不剔除时一致。
+ */
+class LightCuller {
+public:
+    /**
+     * @brief 重新构建簇与光源列表（每帧调用一次）
+     * @param lights 本帧编译好的光源缓冲
+     * @param viewMatrix 视图矩阵
+     * @param projectionMatrix 投影矩阵（透视）
+     * @param width 光栅化分辨率宽度
+     * @param height 光栅化分辨率高度
+     * @param nearPlane 近裁剪面
+     * @param farPlane 远裁剪面
+     * @param tileSize tile 边长（像素）
+     * @param depthSlices 深度切片数
+     */
+    void build(const LightBuffer& lights,
+               const Core::Math::Matrix4& viewMatrix,
+               const Core::Math::Matrix4& projectionMatrix,
+               int width, int height,
+               float nearPlane, float farPlane,
+               int tileSize, int depthSlices);
+
+    /**
+     * @brief 查询片元所在簇的点光源与聚光灯子集
+     * @param x 像素 x
+     * @param y 像素 y
+     * @param viewDepth 视空间深度（透视投影下即裁剪坐标 w）
+     */
+    LightSelection getLights(int x, int y, float viewDepth) const;
+
+    int getTileCountX() const { return m_tilesX; }
+    int getTileCountY() const { return m_tilesY; }
+    int getDepthSliceCount() const { return m_depthSlices; }
+
+private:
+    int m_tileSize = 16;
+    int m_tilesX = 0;
+    int m_tilesY = 0;
+    int m_depthSlices = 1;
+    float m_nearPlane = 0.1f;
+    float m_sliceScale = 0.0f; // slice = log(z) * m_sliceScale + m_sliceBias
+    float m_sliceBias = 0.0f;
+
+    std::vector<uint32_t> m_clusterOffsets; // 大小 = 簇数 + 1，前缀和
+    std::vector<uint32_t> m_clusterLights;  // 所有簇的点光源下标依次拼接
+    std::vector<uint32_t> m_spotOffsets;    // 聚光灯的簇前缀和
+    std::vector<uint32_t> m_spotLights;     // 所有簇的聚光灯下标依次拼接
+
+    int depthToSlice(float viewDepth) const;
+    std::size_t clusterIndex(int tileX, int tileY, int slice) const {
+        return (static_cast<std::size_t>(slice) * static_cast<std::size_t>(m_tilesY) + static_cast<std::size_t>(tileY)) *
+                   static_cast<std::size_t>(m_tilesX) + static_cast<std::size_t>(tileX);
+    }
+};
+
+} // namespace Lighting
+} // namespace Renderer
+
+#endif // RENDERER_LIGHTING_LIGHT_CULLING_H
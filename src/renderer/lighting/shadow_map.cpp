@@ -0,0 +1,441 @@
+#include "shadow_map.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <typeinfo>
+
+#include "light.h"
+#include "../pipeline/triangle_rasterizer.h"
+#include "../../core/platform/parallel.h"
+#include "../../scene/scene.h"
+
+namespace Renderer {
+namespace Lighting {
+
+using Core::Math::Matrix4;
+using Core::Math::Vector3;
+using Core::Math::Vector4;
+
+namespace {
+
+bool castsShadow(const Scene::SceneObject& object) {
+    return object.visible && object.castShadows && object.mesh &&
+           !object.mesh->getVertices().empty() && object.mesh->getIndices().size() >= 3;
+}
+
+// 以 forward 为 +Z 的光源视图矩阵（行存储，列向量约定）
+Matrix4 makeLightView(const Vector3& position, const Vector3& forward, const Vector3& upHint) {
+    Vector3 right = upHint.cross(forward).normalize();
+    Vector3 up = forward.cross(right);
+    return Matrix4{
+        right.x, right.y, right.z, -right.dot(position),
+        up.x, up.y, up.z, -up.dot(position),
+        forward.x, forward.y, forward.z, -forward.dot(position),
+        0.0f, 0.0f, 0.0f, 1.0f
+    };
+}
+
+void worldBoundsCorners(const Scene::SceneObject& object, Vector3 (&corners)[8]) {
+    const Scene::BoundingBox& box = object.mesh->getBoundingBox();
+    for (int i = 0; i < 8; ++i) {
+        Vector3 local((i & 1) ? box.max.x : box.min.x,
+                      (i & 2) ? box.max.y : box.min.y,
+                      (i & 4) ? box.max.z : box.min.z);
+        corners[i] = object.transform.transformPoint(local);
+    }
+}
+
+} // namespace
+
+// ==================== ShadowMap ====================
+
+void ShadowMap::resize(int size) {
+    m_size = std::max(1, size);
+    m_depth.resize(static_cast<std::size_t>(m_size) * static_cast<std::size_t>(m_size));
+}
+
+void ShadowMap::clear() {
+    std::fill(m_depth.begin(), m_depth.end(), std::numeric_limits<float>::max());
+}
+
+void ShadowMap::project(const Vector4& clip, ProjectedVertex& out) const {
+    out.clip = clip;
+    out.valid = clip.w >= m_minClipW;
+    if (!out.valid) {
+        return;
+    }
+    const float invW = 1.0f / clip.w;
+    out.x = toPixelX(clip.x * invW);
+    out.y = toPixelY(clip.y * invW);
+    out.z = clip.z * invW;
+}
+
+void ShadowMap::rasterize(const ProjectedVertex& a, const ProjectedVertex& b, const ProjectedVertex& c) {
+    float* depth = m_depth.data();
+    const int size = m_size;
+    Renderer::Pipeline::forEachCoveredPixel(a.x, a.y, b.x, b.y, c.x, c.y, 0, 0, size - 1, size - 1,
+                                            [&](int x, int y, float alpha, float beta, float gamma) {
+        const float z = alpha * a.z + beta * b.z + gamma * c.z;
+        float& dst = depth[static_cast<std::size_t>(y) * static_cast<std::size_t>(size) + static_cast<std::size_t>(x)];
+        if (z < dst) {
+            dst = z;
+        }
+    });
+}
+
+void ShadowMap::renderMesh(const Scene::Mesh& mesh, const Matrix4& model) {
+    const Matrix4 mvp = m_viewProjection * model;
+    const auto& vertices = mesh.getVertices();
+    const auto& indices = mesh.getIndices();
+
+    m_scratch.resize(vertices.size());
+    for (std::size_t i = 0; i < vertices.size(); ++i) {
+        const Vector3& p = vertices[i].position;
+        project(mvp * Vector4(p.x, p.y, p.z, 1.0f), m_scratch[i]);
+    }
+
+    for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
+        const ProjectedVertex* tri[3] = {&m_scratch[indices[i]], &m_scratch[indices[i + 1]], &m_scratch[indices[i + 2]]};
+        if (tri[0]->valid && tri[1]->valid && tri[2]->valid) {
+            rasterize(*tri[0], *tri[1], *tri[2]);
+            continue;
+        }
+        if (!tri[0]->valid && !tri[1]->valid && !tri[2]->valid) {
+            continue;
+        }
+
+        // 在 w = m_minClipW 平面上裁剪（Sutherland–Hodgman），一个顶点在外得到四边形，两个在外得到三角形
+        ProjectedVertex polygon[4];
+        int count = 0;
+        for (int k = 0; k < 3; ++k) {
+            const ProjectedVertex& current = *tri[k];
+            const ProjectedVertex& next = *tri[(k + 1) % 3];
+            if (current.valid) {
+                polygon[count++] = current;
+            }
+            if (current.valid != next.valid) {
+                const float t = (m_minClipW - current.clip.w) / (next.clip.w - current.clip.w);
+                Vector4 crossing = current.clip + (next.clip - current.clip) * t;
+                crossing.w = m_minClipW;
+                project(crossing, polygon[count++]);
+            }
+        }
+        for (int k = 1; k + 1 < count; ++k) {
+            rasterize(polygon[0], polygon[k], polygon[k + 1]);
+        }
+    }
+}
+
+float ShadowMap::filter(float sx, float sy, float refDepth, int radius) const {
+    const int cx = static_cast<int>(std::floor(sx));
+    const int cy = static_cast<int>(std::floor(sy));
+    if (cx < 0 || cy < 0 || cx >= m_size || cy >= m_size) {
+        return 1.0f;
+    }
+    const int x0 = std::max(0, cx - radius);
+    const int x1 = std::min(m_size - 1, cx + radius);
+    const int y0 = std::max(0, cy - radius);
+    const int y1 = std::min(m_size - 1, cy + radius);
+
+    // 行内连续访问、整数累加、无分支比较：编译器可把内层循环展开为 SIMD 比较与求和
+    int litCount = 0;
+    for (int y = y0; y <= y1; ++y) {
+        const float* row = m_depth.data() + static_cast<std::size_t>(y) * static_cast<std::size_t>(m_size);
+        for (int x = x0; x <= x1; ++x) {
+            litCount += row[x] >= refDepth ? 1 : 0;
+        }
+    }
+    const int taps = (x1 - x0 + 1) * (y1 - y0 + 1);
+    return static_cast<float>(litCount) / static_cast<float>(taps);
+}
+
+// ==================== DirectionalShadowMap ====================
+
+bool DirectionalShadowMap::render(const Vector3& lightDirection,
+                                  const std::vector<Scene::SceneObject>& objects,
+                                  int size) {
+    const Vector3 forward = lightDirection.normalize();
+    const Vector3 upHint = std::fabs(forward.y) > 0.99f ? Vector3(0.0f, 0.0f, 1.0f) : Vector3(0.0f, 1.0f, 0.0f);
+    const Matrix4 lightView = makeLightView(Vector3(0.0f, 0.0f, 0.0f), forward, upHint);
+
+    // 在光源空间中求所有投射体包围盒的范围
+    float minX = std::numeric_limits<float>::max(), maxX = std::numeric_limits<float>::lowest();
+    float minY = minX, maxY = maxX;
+    float minZ = minX, maxZ = maxX;
+    bool any = false;
+    for (const auto& object : objects) {
+        if (!castsShadow(object)) {
+            continue;
+        }
+        Vector3 corners[8];
+        worldBoundsCorners(object, corners);
+        for (const Vector3& corner : corners) {
+            Vector3 p = lightView * corner;
+            minX = std::min(minX, p.x); maxX = std::max(maxX, p.x);
+            minY = std::min(minY, p.y); maxY = std::max(maxY, p.y);
+            minZ = std::min(minZ, p.z); maxZ = std::max(maxZ, p.z);
+        }
+        any = true;
+    }
+    if (!any) {
+        return false;
+    }
+
+    // 四周留出 PCF 核与取整的余量
+    const float padX = std::max(1e-3f, (maxX - minX) * 0.02f);
+    const float padY = std::max(1e-3f, (maxY - minY) * 0.02f);
+    minX -= padX; maxX += padX;
+    minY -= padY; maxY += padY;
+    minZ -= 1e-3f; maxZ += 1e-3f;
+
+    const float halfW = (maxX - minX) * 0.5f;
+    const float halfH = (maxY - minY) * 0.5f;
+    const float centerX = (maxX + minX) * 0.5f;
+    const float centerY = (maxY + minY) * 0.5f;
+    m_depthRange = maxZ - minZ;
+
+    // 正交投影：xy 映射到 [-1,1]，深度线性映射到 [0,1]
+    const Matrix4 projection{
+        1.0f / halfW, 0.0f, 0.0f, -centerX / halfW,
+        0.0f, 1.0f / halfH, 0.0f, -centerY / halfH,
+        0.0f, 0.0f, 1.0f / m_depthRange, -minZ / m_depthRange,
+        0.0f, 0.0f, 0.0f, 1.0f
+    };
+
+    m_map.resize(size);
+    m_map.clear();
+    m_map.setViewProjection(projection * lightView);
+    for (const auto& object : objects) {
+        if (castsShadow(object)) {
+            m_map.renderMesh(*object.mesh, object.transform);
+        }
+    }
+    return true;
+}
+
+void DirectionalShadowMap::setFilter(const ShadowSettings& settings) {
+    m_depthBias = settings.depthBias;
+    m_normalOffset = settings.normalOffset;
+    m_pcfRadius = std::max(0, settings.pcfRadius);
+}
+
+float DirectionalShadowMap::visibility(const Vector3& worldPos, const Vector3& normal) const {
+    const Vector3 p = worldPos + normal * m_normalOffset;
+    const Vector3 ndc = m_map.getViewProjection() * p; // 正交投影 w = 1
+    const float refDepth = ndc.z - m_depthBias / m_depthRange;
+    return m_map.filter(m_map.toPixelX(ndc.x), m_map.toPixelY(ndc.y), refDepth, m_pcfRadius);
+}
+
+// ==================== CubeShadowMap ====================
+
+void CubeShadowMap::render(const Vector3& lightPosition,
+                           float range,
+                           const std::vector<Scene::SceneObject>& objects,
+                           int size) {
+    static const Vector3 kForward[6] = {
+        Vector3(1.0f, 0.0f, 0.0f), Vector3(-1.0f, 0.0f, 0.0f),
+        Vector3(0.0f, 1.0f, 0.0f), Vector3(0.0f, -1.0f, 0.0f),
+        Vector3(0.0f, 0.0f, 1.0f), Vector3(0.0f, 0.0f, -1.0f)
+    };
+    static const Vector3 kUp[6] = {
+        Vector3(0.0f, 1.0f, 0.0f), Vector3(0.0f, 1.0f, 0.0f),
+        Vector3(0.0f, 0.0f, -1.0f), Vector3(0.0f, 0.0f, 1.0f),
+        Vector3(0.0f, 1.0f, 0.0f), Vector3(0.0f, 1.0f, 0.0f)
+    };
+
+    m_position = lightPosition;
+    m_far = std::max(range, 1e-2f);
+    m_near = std::min(0.05f, m_far * 0.01f);
+    const Matrix4 projection = Matrix4::perspective(Core::Math::Constants::PI * 0.5f, 1.0f, m_near, m_far);
+
+    // 只有包围盒与光照范围相交的物体才需要写入
+    std::vector<const Scene::SceneObject*> casters;
+    for (const auto& object : objects) {
+        if (!castsShadow(object)) {
+            continue;
+        }
+        Vector3 corners[8];
+        worldBoundsCorners(object, corners);
+        Vector3 bmin = corners[0], bmax = corners[0];
+        for (const Vector3& c : corners) {
+            bmin = Vector3(std::min(bmin.x, c.x), std::min(bmin.y, c.y), std::min(bmin.z, c.z));
+            bmax = Vector3(std::max(bmax.x, c.x), std::max(bmax.y, c.y), std::max(bmax.z, c.z));
+        }
+        Vector3 closest(std::clamp(lightPosition.x, bmin.x, bmax.x),
+                        std::clamp(lightPosition.y, bmin.y, bmax.y),
+                        std::clamp(lightPosition.z, bmin.z, bmax.z));
+        if ((closest - lightPosition).lengthSquared() <= m_far * m_far) {
+            casters.push_back(&object);
+        }
+    }
+
+    // 6 个面互不相关，并行渲染
+    Core::Platform::parallelFor(0, 6, [&](int begin, int end) {
+        for (int face = begin; face < end; ++face) {
+            ShadowMap& map = m_faces[static_cast<std::size_t>(face)];
+            map.resize(size);
+            map.clear();
+            map.setViewProjection(projection * makeLightView(lightPosition, kForward[face], kUp[face]));
+            map.setMinClipW(m_near);
+            for (const Scene::SceneObject* object : casters) {
+                map.renderMesh(*object->mesh, object->transform);
+            }
+        }
+    }, 1);
+}
+
+void CubeShadowMap::setFilter(const ShadowSettings& settings) {
+    m_depthBias = settings.depthBias;
+    m_normalOffset = settings.normalOffset;
+    m_pcfRadius = std::max(0, settings.pcfRadius);
+}
+
+float CubeShadowMap::visibility(const Vector3& worldPos, const Vector3& normal) const {
+    const Vector3 p = worldPos + normal * m_normalOffset;
+    const Vector3 d = p - m_position;
+    const float ax = std::fabs(d.x);
+    const float ay = std::fabs(d.y);
+    const float az = std::fabs(d.z);
+
+    int face;
+    float major;
+    if (ax >= ay && ax >= az) {
+        face = d.x >= 0.0f ? 0 : 1;
+        major = ax;
+    } else if (ay >= az) {
+        face = d.y >= 0.0f ? 2 : 3;
+        major = ay;
+    } else {
+        face = d.z >= 0.0f ? 4 : 5;
+        major = az;
+    }
+
+    // 偏移在视空间深度上施加，再换算为该面的 NDC 深度
+    const float biased = major - m_depthBias;
+    if (biased <= m_near) {
+        return 1.0f;
+    }
+    const float range = m_far - m_near;
+    const float refDepth = m_far / range - (m_near * m_far / range) / biased;
+
+    const ShadowMap& map = m_faces[static_cast<std::size_t>(face)];
+    const Vector4 clip = map.getViewProjection() * Vector4(p.x, p.y, p.z, 1.0f);
+    const float invW = 1.0f / clip.w;
+    return map.filter(map.toPixelX(clip.x * invW), map.toPixelY(clip.y * invW), refDepth, m_pcfRadius);
+}
+
+// ==================== ShadowMapCache ====================
+
+void ShadowMapCache::invalidate() {
+    m_entries.clear();
+    m_casterKeys.clear();
+}
+
+void ShadowMapCache::update(const std::vector<Light*>& lights,
+                            const std::vector<Scene::SceneObject>& objects,
+                            const ShadowSettings& settings) {
+    m_lastRenderCount = 0;
+
+    // 投射体签名：任何网格、变换或可见性变化都会让全部阴影贴图失效
+    std::vector<CasterKey> casterKeys;
+    for (const auto& object : objects) {
+        if (!castsShadow(object)) {
+            continue;
+        }
+        casterKeys.push_back({object.mesh, object.mesh->getVertices().size(),
+                              object.mesh->getIndices().size(), object.transform});
+    }
+    bool castersChanged = casterKeys.size() != m_casterKeys.size();
+    for (std::size_t i = 0; !castersChanged && i < casterKeys.size(); ++i) {
+        const CasterKey& a = casterKeys[i];
+        const CasterKey& b = m_casterKeys[i];
+        castersChanged = a.mesh != b.mesh || a.vertexCount != b.vertexCount || a.indexCount != b.indexCount ||
+                         std::memcmp(a.transform.m, b.transform.m, sizeof(a.transform.m)) != 0;
+    }
+    const bool sizeChanged = settings.mapSize != m_mapSize || settings.cubeMapSize != m_cubeMapSize;
+    m_casterKeys = std::move(casterKeys);
+    m_mapSize = settings.mapSize;
+    m_cubeMapSize = settings.cubeMapSize;
+
+    std::vector<Entry> entries;
+    for (Light* light : lights) {
+        if (!light || !light->getCastShadows()) {
+            continue;
+        }
+        // 与 LightBuffer 相同，只为确切的内置类型生成贴图：派生类走不带阴影的通用着色路径，贴图不会被采样
+        const DirectionalLight* directional = nullptr;
+        const PointLight* point = nullptr;
+        if (light->getType() == Light::DIRECTIONAL && typeid(*light) == typeid(DirectionalLight)) {
+            directional = static_cast<const DirectionalLight*>(light);
+        } else if (light->getType() == Light::POINT && typeid(*light) == typeid(PointLight)) {
+            point = static_cast<const PointLight*>(light);
+        }
+        std::vector<float> key;
+        if (directional) {
+            const Vector3& dir = directional->getLightDirection();
+            key = {0.0f, dir.x, dir.y, dir.z};
+        } else if (point) {
+            const Vector3& pos = point->getPosition();
+            key = {1.0f, pos.x, pos.y, pos.z, point->getRange()};
+        } else {
+            continue;
+        }
+
+        Entry entry;
+        auto previous = std::find_if(m_entries.begin(), m_entries.end(),
+                                     [light](const Entry& e) { return e.light == light; });
+        if (previous != m_entries.end()) {
+            entry = std::move(*previous);
+        }
+        const bool dirty = castersChanged || sizeChanged || entry.lightKey != key ||
+                           (!entry.directional && !entry.cube);
+        entry.light = light;
+        entry.lightKey = std::move(key);
+
+        if (directional) {
+            if (!entry.directional) {
+                entry.directional = std::make_unique<DirectionalShadowMap>();
+            }
+            if (dirty) {
+                entry.valid = entry.directional->render(directional->getLightDirection(), objects, settings.mapSize);
+                ++m_lastRenderCount;
+            }
+            entry.directional->setFilter(settings);
+        } else {
+            if (!entry.cube) {
+                entry.cube = std::make_unique<CubeShadowMap>();
+            }
+            if (dirty) {
+                entry.cube->render(point->getPosition(), point->getRange(), objects, settings.cubeMapSize);
+                entry.valid = true;
+                ++m_lastRenderCount;
+            }
+            entry.cube->setFilter(settings);
+        }
+        entries.push_back(std::move(entry));
+    }
+    m_entries = std::move(entries);
+}
+
+const DirectionalShadowMap* ShadowMapCache::findDirectional(const Light* light) const {
+    for (const auto& entry : m_entries) {
+        if (entry.light == light) {
+            return entry.valid ? entry.directional.get() : nullptr;
+        }
+    }
+    return nullptr;
+}
+
+const CubeShadowMap* ShadowMapCache::findCube(const Light* light) const {
+    for (const auto& entry : m_entries) {
+        if (entry.light == light) {
+            return entry.valid ? entry.cube.get() : nullptr;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace Lighting
+} // namespace Renderer
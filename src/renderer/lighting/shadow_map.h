@@ -0,0 +1,189 @@
+#ifndef RENDERER_LIGHTING_SHADOW_MAP_H
+#define RENDERER_LIGHTING_SHADOW_MAP_H
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "../../core/math/matrix.h"
+#include "../../core/math/vector.h"
+
+namespace Scene {
+class Mesh;
+struct SceneObject;
+}
+
+namespace Renderer {
+namespace Lighting {
+
+class Light;
+
+struct ShadowSettings {
+    int mapSize = 1024;         // 方向光阴影贴图边长
+    int cubeMapSize = 512;      // 点光源立方体阴影贴图每个面的边长
+    float depthBias = 0.05f;    // 深度比较偏移（世界单位），抑制自阴影条纹
+    float normalOffset = 0.02f; // 采样点沿法线外移的距离（世界单位）
+    int pcfRadius = 1;          // PCF 半径：每次查询做 (2r+1)² 次深度比较
+};
+
+/**
+ * @brief 单张深度贴图及其光源空间变换
+ *
+ * 深度值为光源投影后的 NDC z，越小越靠近光源；用与主光栅化相同的覆盖规则写入。
+ */
+class ShadowMap {
+public:
+    void resize(int size);
+    void clear();
+
+    void setViewProjection(const Core::Math::Matrix4& viewProjection) { m_viewProjection = viewProjection; }
+    // 裁剪空间 w 的下限：透视投影设为近平面距离，跨过它的三角形在该平面上裁剪；正交投影保持默认值
+    void setMinClipW(float minW) { m_minClipW = minW; }
+    const Core::Math::Matrix4& getViewProjection() const { return m_viewProjection; }
+
+    /**
+     * @brief 把网格的深度写入贴图（不做背面剔除，保留最近深度）
+     *
+     * 部分顶点 w 低于下限的三角形在 w = 下限处裁剪为多边形后写入，不会整个丢弃。
+     */
+    void renderMesh(const Scene::Mesh& mesh, const Core::Math::Matrix4& model);
+
+    /**
+     * @brief PCF 过滤：统计 (sx, sy) 周围 (2r+1)² 个纹素中深度不小于 refDepth 的比例
+     * @param sx 贴图像素坐标 x
+     * @param sy 贴图像素坐标 y
+     * @return 可见度 [0,1]；落在贴图外视为完全可见
+     */
+    float filter(float sx, float sy, float refDepth, int radius) const;
+
+    /**
+     * @brief 把 NDC xy 映射为贴图像素坐标（与主光栅化的视口映射一致）
+     */
+    float toPixelX(float ndcX) const { return (ndcX * 0.5f + 0.5f) * static_cast<float>(m_size - 1); }
+    float toPixelY(float ndcY) const { return (1.0f - (ndcY * 0.5f + 0.5f)) * static_cast<float>(m_size - 1); }
+
+    int getSize() const { return m_size; }
+    float getDepth(int x, int y) const { return m_depth[static_cast<std::size_t>(y) * static_cast<std::size_t>(m_size) + static_cast<std::size_t>(x)]; }
+
+private:
+    struct ProjectedVertex {
+        Core::Math::Vector4 clip;
+        float x, y, z;
+        bool valid; // clip.w 不低于下限，x/y/z 为投影结果
+    };
+
+    void project(const Core::Math::Vector4& clip, ProjectedVertex& out) const;
+    void rasterize(const ProjectedVertex& a, const ProjectedVertex& b, const ProjectedVertex& c);
+
+    int m_size = 0;
+    float m_minClipW = 1e-6f;
+    std::vector<float> m_depth;
+    Core::Math::Matrix4 m_viewProjection;
+    std::vector<ProjectedVertex> m_scratch;
+};
+
+/**
+ * @brief 方向光阴影：正交投影紧贴所有投射体的包围盒
+ */
+class DirectionalShadowMap {
+public:
+    /**
+     * @brief 按光线方向与投射体包围盒重新渲染
+     * @return 是否存在投射体（没有时贴图无效）
+     */
+    bool render(const Core::Math::Vector3& lightDirection,
+                const std::vector<Scene::SceneObject>& objects,
+                int size);
+
+    /**
+     * @brief 查询世界坐标点的可见度
+     * @param worldPos 表面位置
+     * @param normal 表面法线（已归一化）
+     */
+    float visibility(const Core::Math::Vector3& worldPos, const Core::Math::Vector3& normal) const;
+
+    void setFilter(const ShadowSettings& settings);
+    const ShadowMap& getMap() const { return m_map; }
+
+private:
+    ShadowMap m_map;
+    float m_depthRange = 1.0f; // 光源空间深度跨度（世界单位），用于换算偏移
+    float m_depthBias = 0.0f;
+    float m_normalOffset = 0.0f;
+    int m_pcfRadius = 0;
+};
+
+/**
+ * @brief 点光源阴影：6 个 90° 透视面组成的立方体贴图
+ */
+class CubeShadowMap {
+public:
+    void render(const Core::Math::Vector3& lightPosition,
+                float range,
+                const std::vector<Scene::SceneObject>& objects,
+                int size);
+
+    float visibility(const Core::Math::Vector3& worldPos, const Core::Math::Vector3& normal) const;
+
+    void setFilter(const ShadowSettings& settings);
+    const ShadowMap& getFace(int face) const { return m_faces[static_cast<std::size_t>(face)]; }
+
+private:
+    std::array<ShadowMap, 6> m_faces; // +X, -X, +Y, -Y, +Z, -Z
+    Core::Math::Vector3 m_position;
+    float m_near = 0.05f;
+    float m_far = 1.0f;
+    float m_depthBias = 0.0f;
+    float m_normalOffset = 0.0f;
+    int m_pcfRadius = 0;
+};
+
+/**
+ * @brief 阴影贴图缓存
+ *
+ * 每帧调用 update：只有光源参数、贴图尺寸或投射体（网格、变换、可见性）变化时才重新渲染，
+ * 静止场景的阴影贴图跨帧复用。只为 getCastShadows() 为 true 的方向光与点光源（确切的内置类型，
+ * 派生类不带阴影，与 LightBuffer 一致）生成贴图。
+ * 网格顶点被原地修改不会被检测到，需要时调用 invalidate()。
+ */
+class ShadowMapCache {
+public:
+    void update(const std::vector<Light*>& lights,
+                const std::vector<Scene::SceneObject>& objects,
+                const ShadowSettings& settings);
+    void invalidate();
+
+    const DirectionalShadowMap* findDirectional(const Light* light) const;
+    const CubeShadowMap* findCube(const Light* light) const;
+
+    // 最近一次 update 中重新渲染的阴影贴图数（立方体贴图计为 1）
+    int getLastRenderCount() const { return m_lastRenderCount; }
+
+private:
+    struct CasterKey {
+        const Scene::Mesh* mesh;
+        std::size_t vertexCount;
+        std::size_t indexCount;
+        Core::Math::Matrix4 transform;
+    };
+
+    struct Entry {
+        const Light* light = nullptr;
+        std::vector<float> lightKey;
+        std::unique_ptr<DirectionalShadowMap> directional;
+        std::unique_ptr<CubeShadowMap> cube;
+        bool valid = false;
+    };
+
+    std::vector<Entry> m_entries;
+    std::vector<CasterKey> m_casterKeys;
+    int m_mapSize = 0;
+    int m_cubeMapSize = 0;
+    int m_lastRenderCount = 0;
+};
+
+} // namespace Lighting
+} // namespace Renderer
+
+#endif // RENDERER_LIGHTING_SHADOW_MAP_H
@@ -0,0 +1,64 @@
+#ifndef RENDERER_PIPELINE_FRAGMENT_PACKET_H
+#define RENDERER_PIPELINE_FRAGMENT_PACKET_H
+
+#include <cstdint>
+
+#include "geometry_stage.h"
+
+namespace Renderer {
+namespace Pipeline {
+
+constexpr int kFragmentPacketWidth = 8;
+
+/**
+ * @brief 一组片元的插值属性（SoA 布局）
+ *
+ * 同一属性分量的 kFragmentPacketWidth 个通道连续存放，着色循环按通道遍历即可被编译器向量化。
+ * activeMask 第 i 位为 1 表示第 i 个通道有效；无效通道的数据可为任意值，结果会被忽略。
+ */
+struct FragmentPacket {
+    uint32_t activeMask = 0;
+    float posX[kFragmentPacketWidth], posY[kFragmentPacketWidth], posZ[kFragmentPacketWidth];
+    float normalX[kFragmentPacketWidth], normalY[kFragmentPacketWidth], normalZ[kFragmentPacketWidth];
+    float tangentX[kFragmentPacketWidth], tangentY[kFragmentPacketWidth], tangentZ[kFragmentPacketWidth];
+    float bitangentX[kFragmentPacketWidth], bitangentY[kFragmentPacketWidth], bitangentZ[kFragmentPacketWidth];
+    float u[kFragmentPacketWidth], v[kFragmentPacketWidth];
+    float r[kFragmentPacketWidth], g[kFragmentPacketWidth], b[kFragmentPacketWidth], a[kFragmentPacketWidth];
+
+    bool isActive(int lane) const { return (activeMask >> lane) & 1u; }
+
+    // 把单个插值顶点写入指定通道并标记为有效
+    void setLane(int lane, const GeometryVertex& vertex) {
+        posX[lane] = vertex.worldPosition.x;
+        posY[lane] = vertex.worldPosition.y;
+        posZ[lane] = vertex.worldPosition.z;
+        normalX[lane] = vertex.normal.x;
+        normalY[lane] = vertex.normal.y;
+        normalZ[lane] = vertex.normal.z;
+        tangentX[lane] = vertex.tangent.x;
+        tangentY[lane] = vertex.tangent.y;
+        tangentZ[lane] = vertex.tangent.z;
+        bitangentX[lane] = vertex.bitangent.x;
+        bitangentY[lane] = vertex.bitangent.y;
+        bitangentZ[lane] = vertex.bitangent.z;
+        u[lane] = vertex.texCoord.x;
+        v[lane] = vertex.texCoord.y;
+        r[lane] = vertex.color.r;
+        g[lane] = vertex.color.g;
+        b[lane] = vertex.color.b;
+        a[lane] = vertex.color.a;
+        activeMask |= 1u << lane;
+    }
+};
+
+/**
+ * @brief 一组片元的着色结果（SoA 布局）
+ */
+struct ColorPacket {
+    float r[kFragmentPacketWidth], g[kFragmentPacketWidth], b[kFragmentPacketWidth], a[kFragmentPacketWidth];
+};
+
+} // namespace Pipeline
+} // namespace Renderer
+
+#endif // RENDERER_PIPELINE_FRAGMENT_PACKET_H
@@ -0,0 +1,113 @@
+#ifndef RENDERER_PIPELINE_GBUFFER_H
+#define RENDERER_PIPELINE_GBUFFER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../../core/math/vector.h"
+
+namespace Core {
+namespace Types {
+class Material;
+}
+}
+
+namespace Renderer {
+namespace Pipeline {
+
+// 单位法线的八面体编码：两个分量即可无损（浮点精度内）表示方向
+inline void encodeOctahedral(const Core::Math::Vector3& n, float& u, float& v) {
+    const float invL1 = 1.0f / (std::fabs(n.x) + std::fabs(n.y) + std::fabs(n.z));
+    float px = n.x * invL1;
+    float py = n.y * invL1;
+    if (n.z < 0.0f) {
+        const float ox = (1.0f - std::fabs(py)) * (px >= 0.0f ? 1.0f : -1.0f);
+        const float oy = (1.0f - std::fabs(px)) * (py >= 0.0f ? 1.0f : -1.0f);
+        px = ox;
+        py = oy;
+    }
+    u = px;
+    v = py;
+}
+
+inline Core::Math::Vector3 decodeOctahedral(float u, float v) {
+    float z = 1.0f - std::fabs(u) - std::fabs(v);
+    float x = u;
+    float y = v;
+    if (z < 0.0f) {
+        x = (1.0f - std::fabs(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+        y = (1.0f - std::fabs(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+    }
+    return Core::Math::Vector3(x, y, z).normalize();
+}
+
+/**
+ * @brief 延迟着色的几何缓冲（SoA，每个通道一个数组）
+ *
+ * 几何阶段只写入解析完贴图与法线贴图后的表面属性，光照阶段按像素读取后调用
+ * ShadingPipeline::shadeSurface；高光色与光泽度不逐像素保存，而是通过 materialIndex
+ * 查本帧的材质表。逐顶点光照的三角形直接写入已着色颜色并标记 kPreLit。
+ */
+struct GBuffer {
+    enum Flags : uint8_t {
+        kCovered = 1, // 被不透明几何覆盖
+        kPreLit = 2   // albedo 已是最终颜色（Gouraud），光照阶段直接输出
+    };
+
+    int width = 0;
+    int height = 0;
+    std::vector<float> albedoR, albedoG, albedoB, albedoA; // 顶点色 × 材质漫反射 × 贴图
+    std::vector<float> normalU, normalV;                    // 八面体编码的世界空间法线
+    std::vector<float> posX, posY, posZ;                    // 世界坐标（透视正确插值）
+    std::vector<float> viewDepth;                           // 1/插值(1/w)，透视下即视空间深度，用于查询光源簇
+    std::vector<uint16_t> materialIndex;                    // materials 中的下标
+    std::vector<uint8_t> flags;
+    std::vector<Core::Types::Material*> materials;          // 本帧材质表，可含 nullptr（默认材质）
+
+    void resize(int w, int h) {
+        width = w;
+        height = h;
+        const std::size_t count = static_cast<std::size_t>(w) * static_cast<std::size_t>(h);
+        albedoR.resize(count);
+        albedoG.resize(count);
+        albedoB.resize(count);
+        albedoA.resize(count);
+        normalU.resize(count);
+        normalV.resize(count);
+        posX.resize(count);
+        posY.resize(count);
+        posZ.resize(count);
+        viewDepth.resize(count);
+        materialIndex.resize(count);
+        flags.resize(count);
+    }
+
+    // 只需清除覆盖标记，其余通道在写入时整体覆盖
+    void clear() {
+        std::fill(flags.begin(), flags.end(), static_cast<uint8_t>(0));
+        materials.clear();
+    }
+
+    std::size_t index(int x, int y) const {
+        return static_cast<std::size_t>(y) * static_cast<std::size_t>(width) + static_cast<std::size_t>(x);
+    }
+
+    // 返回材质在材质表中的下标，首次出现时追加
+    uint16_t registerMaterial(Core::Types::Material* material) {
+        for (std::size_t i = 0; i < materials.size(); ++i) {
+            if (materials[i] == material) {
+                return static_cast<uint16_t>(i);
+            }
+        }
+        materials.push_back(material);
+        return static_cast<uint16_t>(materials.size() - 1);
+    }
+};
+
+} // namespace Pipeline
+} // namespace Renderer
+
+#endif // RENDERER_PIPELINE_GBUFFER_H
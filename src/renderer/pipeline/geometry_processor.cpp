@@ -1,10 +1,8 @@
 #include "geometry_processor.h"
 
-#include "screen_vertex.h"
-#include "software_renderer.h"
+#include <cmath>
 
-#include "../../scene/scene.h"
-#include "../../scene/mesh.h"
+#include "shading_pipeline.h"
 
 namespace Renderer {
 namespace Pipeline {
@@ -12,41 +10,64 @@ namespace Pipeline {
 GeometryProcessor::GeometryProcessor(const SoftwareRendererSettings& settings)
     : m_settings(settings) {}
 
-std::vector<ScreenVertex> GeometryProcessor::process(const Scene::SceneObject& object,
-                                                     const Core::Math::Matrix4& viewMatrix,
-                                                     const Core::Math::Matrix4& projectionMatrix) const {
-    const auto& vertices = object.mesh->getVertices();
-    std::vector<ScreenVertex> results(vertices.size());
-
-    for (std::size_t i = 0; i < vertices.size(); ++i) {
-        GeometryVertex geomVertex = GeometryVertex::fromVertex(vertices[i],
-                                                               object.transform,
-                                                               viewMatrix,
-                                                               projectionMatrix);
-
-        float w = geomVertex.clipPosition.w;
-        if (w <= 1e-6f) {
-            ScreenVertex invalid{};
-            invalid.valid = false;
-            results[i] = invalid;
+void GeometryProcessor::lightVertices(const ScreenVertex* vertices, std::size_t count,
+                                      Core::Types::Material* material,
+                                      const ShadingPipeline& shading,
+                                      const Renderer::Lighting::LightBuffer& lights,
+                                      const Core::Math::Vector3& viewPos,
+                                      const Core::Types::Color& sceneAmbient,
+                                      Core::Types::Color* colors) const {
+    for (std::size_t i = 0; i < count; ++i) {
+        colors[i] = vertices[i].valid
+            ? shading.shadeVertex(vertices[i].attributes, material, lights, viewPos, sceneAmbient)
+            : Core::Types::Color::BLACK;
+    }
+}
+
+float GeometryProcessor::averageProjectedArea(const ScreenVertex* vertices,
+                                              const std::vector<uint32_t>& indices) {
+    double totalArea = 0.0;
+    std::size_t count = 0;
+    for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
+        const ScreenVertex& v0 = vertices[indices[i]];
+        const ScreenVertex& v1 = vertices[indices[i + 1]];
+        const ScreenVertex& v2 = vertices[indices[i + 2]];
+        if (!v0.valid || !v1.valid || !v2.valid) {
             continue;
         }
+        const float cross = (v1.screenX - v0.screenX) * (v2.screenY - v0.screenY) -
+                            (v2.screenX - v0.screenX) * (v1.screenY - v0.screenY);
+        totalArea += 0.5 * std::fabs(cross);
+        ++count;
+    }
+    return count > 0 ? static_cast<float>(totalArea / static_cast<double>(count)) : 0.0f;
+}
+
+RasterDerivatives GeometryProcessor::rasterDerivatives(const ScreenVertex& v0,
+                                                       const ScreenVertex& v1,
+                                                       const ScreenVertex& v2) {
+    float x0 = v0.screenX;
+    float y0 = v0.screenY;
+    float x1 = v1.screenX;
+    float y1 = v1.screenY;
+    float x2 = v2.screenX;
+    float y2 = v2.screenY;
 
-        float invW = 1.0f / w;
-        Core::Math::Vector3 ndc(geomVertex.clipPosition.x * invW,
-                                geomVertex.clipPosition.y * invW,
-                                geomVertex.clipPosition.z * invW);
-
-        ScreenVertex screenVertex;
-        screenVertex.attributes = geomVertex;
-        screenVertex.ndcZ = geomVertex.ndcZ;
-        screenVertex.screenX = (ndc.x * 0.5f + 0.5f) * (m_settings.width - 1);
-        screenVertex.screenY = (1.0f - (ndc.y * 0.5f + 0.5f)) * (m_settings.height - 1);
-        screenVertex.valid = true;
-        results[i] = screenVertex;
+    float det = (x1 - x0) * (y2 - y0) - (x2 - x0) * (y1 - y0);
+    if (std::fabs(det) < 1e-6f) {
+        return {0.0f, 0.0f, 0.0f, 0.0f};
     }
 
-    return results;
+    RasterDerivatives derivs{};
+    Core::Math::Vector2 uv0 = v0.attributes.texCoord;
+    Core::Math::Vector2 uv1 = v1.attributes.texCoord;
+    Core::Math::Vector2 uv2 = v2.attributes.texCoord;
+
+    derivs.dudx = ((uv1.x - uv0.x) * (y2 - y0) - (uv2.x - uv0.x) * (y1 - y0)) / det;
+    derivs.dudy = (-(uv1.x - uv0.x) * (x2 - x0) + (uv2.x - uv0.x) * (x1 - x0)) / det;
+    derivs.dvdx = ((uv1.y - uv0.y) * (y2 - y0) - (uv2.y - uv0.y) * (y1 - y0)) / det;
+    derivs.dvdy = (-(uv1.y - uv0.y) * (x2 - x0) + (uv2.y - uv0.y) * (x1 - x0)) / det;
+    return derivs;
 }
 
 } // namespace Pipeline
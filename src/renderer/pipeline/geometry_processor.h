@@ -1,27 +1,77 @@
 #ifndef RENDERER_PIPELINE_GEOMETRY_PROCESSOR_H
 #define RENDERER_PIPELINE_GEOMETRY_PROCESSOR_H
 
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
 #include "screen_vertex.h"
+#include "shader_interface.h"
+#include "software_renderer.h"
 #include "../../core/math/matrix.h"
+#include "../../core/types/color.h"
+#include "../../core/types/vertex.h"
 
-namespace Scene {
-struct SceneObject;
+namespace Core {
+namespace Types {
+class Material;
+}
 }
 
 namespace Renderer {
+namespace Lighting {
+class LightBuffer;
+}
 namespace Pipeline {
 
-struct SoftwareRendererSettings;
+class ShadingPipeline;
 
 class GeometryProcessor {
 public:
     explicit GeometryProcessor(const SoftwareRendererSettings& settings);
 
-    std::vector<ScreenVertex> process(const Scene::SceneObject& object,
-                                      const Core::Math::Matrix4& viewMatrix,
-                                      const Core::Math::Matrix4& projectionMatrix) const;
+    /**
+     * @brief 对物体的每个顶点调用一次顶点着色器，再做透视除法与视口变换
+     * @param results 至少有 vertices.size() 个元素，通常来自帧内分配器；w ≤ 0 的顶点标记为无效
+     */
+    template <typename VertexShader>
+    void process(const VertexShader& vertexShader,
+                 const ShaderUniforms& uniforms,
+                 const std::vector<Core::Types::Vertex>& vertices,
+                 BasicScreenVertex<typename VertexShader::Varyings>* results) const {
+        const float widthScale = static_cast<float>(m_settings.width - 1);
+        const float heightScale = static_cast<float>(m_settings.height - 1);
+        for (std::size_t i = 0; i < vertices.size(); ++i) {
+            BasicScreenVertex<typename VertexShader::Varyings>& out = results[i];
+            const Core::Math::Vector4 clip = vertexShader(vertices[i], uniforms, out.attributes);
+            out.valid = clip.w > 1e-6f;
+            if (!out.valid) {
+                continue;
+            }
+            out.reciprocalW = 1.0f / clip.w;
+            out.ndcZ = clip.z * out.reciprocalW;
+            out.screenX = (clip.x * out.reciprocalW * 0.5f + 0.5f) * widthScale;
+            out.screenY = (1.0f - (clip.y * out.reciprocalW * 0.5f + 0.5f)) * heightScale;
+        }
+    }
+
+    // 逐顶点光照（Gouraud）：为每个有效顶点计算一次光照颜色写入 colors，无效顶点为黑色
+    void lightVertices(const ScreenVertex* vertices, std::size_t count,
+                       Core::Types::Material* material,
+                       const ShadingPipeline& shading,
+                       const Renderer::Lighting::LightBuffer& lights,
+                       const Core::Math::Vector3& viewPos,
+                       const Core::Types::Color& sceneAmbient,
+                       Core::Types::Color* colors) const;
+
+    // 三个顶点都有效的三角形在屏幕上的平均投影面积（像素²），没有有效三角形时返回 0
+    static float averageProjectedArea(const ScreenVertex* vertices,
+                                      const std::vector<uint32_t>& indices);
+
+    // 屏幕空间的 UV 导数（光栅化一个像素时 u、v 的变化量）；退化三角形返回全 0
+    static RasterDerivatives rasterDerivatives(const ScreenVertex& v0,
+                                               const ScreenVertex& v1,
+                                               const ScreenVertex& v2);
 
 private:
     const SoftwareRendererSettings& m_settings;
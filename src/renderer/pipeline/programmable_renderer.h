@@ -0,0 +1,358 @@
+#ifndef RENDERER_PIPELINE_PROGRAMMABLE_RENDERER_H
+#define RENDERER_PIPELINE_PROGRAMMABLE_RENDERER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+
+#include "geometry_processor.h"
+#include "render_queue.h"
+#include "render_target.h"
+#include "shader_interface.h"
+#include "shading_pipeline.h"
+#include "software_renderer.h"
+#include "triangle_rasterizer.h"
+#include "../effects/ssaa.h"
+#include "../../core/types/material.h"
+#include "../../scene/camera.h"
+#include "../../scene/mesh.h"
+#include "../../scene/scene.h"
+
+namespace Renderer {
+namespace Pipeline {
+
+// BasicSoftwareRenderer 的模板成员定义：使用自定义着色器对时包含本头文件
+
+// 自定义着色器对的渲染器即 BasicSoftwareRenderer 的实例
+template <typename VertexShader = BlinnPhongVertexShader, typename FragmentShader = BlinnPhongFragmentShader>
+using ProgrammableRenderer = BasicSoftwareRenderer<VertexShader, FragmentShader>;
+
+template <typename VertexShader, typename FragmentShader>
+BasicSoftwareRenderer<VertexShader, FragmentShader>::BasicSoftwareRenderer(const SoftwareRendererSettings& settings,
+                                                                           VertexShader vertexShader,
+                                                                           FragmentShader fragmentShader)
+    : SoftwareRendererBase(settings),
+      m_vertexShader(std::move(vertexShader)),
+      m_fragmentShader(std::move(fragmentShader)) {}
+
+template <typename VertexShader, typename FragmentShader>
+void BasicSoftwareRenderer<VertexShader, FragmentShader>::buildRenderQueue(const Scene::Scene& scene,
+                                                                          const ShaderUniforms& uniforms,
+                                                                          BasicRenderQueue<Varyings>& renderQueue) {
+    GeometryProcessor geometryProcessor(m_settings);
+
+    // 顶点、绘制状态与三角形总数的上界决定队列容量，整帧只分配一次
+    std::size_t maxTriangles = 0;
+    std::size_t maxVertices = 0;
+    std::size_t maxStates = 0;
+    for (const auto& object : scene.getObjects()) {
+        if (object.visible && object.mesh) {
+            maxTriangles += object.mesh->getIndices().size() / 3;
+            maxVertices += object.mesh->getVertices().size();
+            ++maxStates;
+        }
+    }
+    renderQueue.reset(m_frameArena, maxTriangles, maxVertices, maxStates);
+
+    for (const auto& object : scene.getObjects()) {
+        if (!object.visible || !object.mesh) {
+            continue;
+        }
+
+        Scene::Mesh* mesh = object.mesh;
+        Core::Types::Material* material = object.materialOverride ? object.materialOverride : mesh->getMaterial();
+        const auto& vertices = mesh->getVertices();
+        const auto& indices = mesh->getIndices();
+        if (vertices.empty() || indices.size() < 3) {
+            continue;
+        }
+
+        ShaderUniforms* objectUniforms = m_frameArena.allocateArray<ShaderUniforms>(1);
+        *objectUniforms = uniforms;
+        objectUniforms->model = object.transform;
+        objectUniforms->material = material;
+
+        // 顶点着色器的结果直接写入共享顶点缓冲，三角形只记录下标
+        uint32_t baseIndex = 0;
+        BasicScreenVertex<Varyings>* transformed = renderQueue.allocateVertices(vertices.size(), baseIndex);
+        geometryProcessor.process(m_vertexShader, *objectUniforms, vertices, transformed);
+
+        DrawState state;
+        state.material = material;
+        state.uniforms = objectUniforms;
+        if constexpr (kBuiltInShaders) {
+            // 逐顶点光照：Auto 模式下三角形平均只覆盖几个像素时，逐像素着色几乎没有额外细节
+            Core::Types::LightingFrequency frequency = resolveLightingFrequency(object, material);
+            if (frequency == Core::Types::LightingFrequency::Auto) {
+                const float area = GeometryProcessor::averageProjectedArea(transformed, indices);
+                frequency = area < m_settings.vertexLightingAreaThreshold
+                    ? Core::Types::LightingFrequency::PerVertex
+                    : Core::Types::LightingFrequency::PerPixel;
+            }
+            state.vertexLit = frequency == Core::Types::LightingFrequency::PerVertex;
+        }
+        cullSpotLights(object, state);
+        const uint32_t stateIndex = renderQueue.addState(state);
+
+        const float materialAlpha = material ? material->getDiffuse().a : 1.0f;
+        for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
+            uint32_t i0 = indices[i];
+            uint32_t i1 = indices[i + 1];
+            uint32_t i2 = indices[i + 2];
+
+            const BasicScreenVertex<Varyings>& v0 = transformed[i0];
+            const BasicScreenVertex<Varyings>& v1 = transformed[i1];
+            const BasicScreenVertex<Varyings>& v2 = transformed[i2];
+
+            if (!v0.valid || !v1.valid || !v2.valid) {
+                continue;
+            }
+
+            // 先根据输入顶点与材质 alpha 判断是否透明，再决定是否进行背面剔除（着色器输出的 alpha 只参与混合）
+            const float vertexAlpha = (vertices[i0].color.a + vertices[i1].color.a + vertices[i2].color.a) / 3.0f;
+            const bool opaque = vertexAlpha * materialAlpha >= 0.999f;
+            if (!assemblePrimitive(v0, v1, v2, uniforms.cameraPosition, opaque)) {
+                continue;
+            }
+
+            TriangleWorkItem item;
+            item.i0 = baseIndex + i0;
+            item.i1 = baseIndex + i1;
+            item.i2 = baseIndex + i2;
+            item.state = stateIndex;
+            item.depthKey = (v0.ndcZ + v1.ndcZ + v2.ndcZ) / 3.0f;
+
+            if (opaque) {
+                renderQueue.addOpaque(item);
+            } else {
+                renderQueue.addTransparent(item);
+            }
+        }
+
+        if constexpr (kBuiltInShaders) {
+            // 透明判断用的是原始顶点 alpha，之后才把顶点颜色换成光照结果
+            if (state.vertexLit) {
+                Core::Types::Color* litColors = m_frameArena.allocateArray<Core::Types::Color>(vertices.size());
+                geometryProcessor.lightVertices(transformed, vertices.size(), material, *uniforms.shading,
+                                                m_lightBuffer, uniforms.cameraPosition, uniforms.ambientLight,
+                                                litColors);
+                for (std::size_t i = 0; i < vertices.size(); ++i) {
+                    transformed[i].attributes.color = litColors[i];
+                    m_stats.vertexShadeInvocations += transformed[i].valid ? 1 : 0;
+                }
+            }
+        }
+    }
+
+    renderQueue.finalize();
+}
+
+template <typename VertexShader, typename FragmentShader>
+void BasicSoftwareRenderer<VertexShader, FragmentShader>::render(const Scene::Scene& scene) {
+    Scene::Camera* camera = scene.getCamera();
+    if (!camera) {
+        return;
+    }
+    m_stats = RenderStats();
+    // 上一帧的队列与变换顶点不再使用
+    m_frameArena.reset();
+
+    // 处理 SSAA：当 ssaaFactor > 1 时，临时使用更高分辨率渲染
+    const int ssaaFactor = m_settings.aaMode == AntiAliasingMode::SSAA ? std::max(1, m_settings.ssaaFactor) : 1;
+    if (ssaaFactor > 1 && m_settings.ssaaTileSize > 0) {
+        renderTiled(scene, ssaaFactor);
+        applyPostProcessing();
+        return;
+    }
+
+    const int baseWidth = m_settings.width;
+    const int baseHeight = m_settings.height;
+    if (ssaaFactor > 1) {
+        // 切换到高分辨率设置
+        m_settings.width = baseWidth * ssaaFactor;
+        m_settings.height = baseHeight * ssaaFactor;
+    }
+
+    if (m_target.getWidth() != m_settings.width || m_target.getHeight() != m_settings.height) {
+        m_target.resize(m_settings.width, m_settings.height);
+    }
+
+    m_target.clear(scene.getBackgroundColor(), 1.0f);
+
+    prepareLights(scene);
+    ShadingPipeline shadingPipeline(m_settings);
+    const ShaderUniforms uniforms = frameUniforms(scene, shadingPipeline);
+
+    BasicRenderQueue<Varyings> renderQueue;
+    BasicTriangleRasterizer<VertexShader, FragmentShader> rasterizer(m_target, m_settings, m_fragmentShader);
+    const Renderer::Lighting::LightCuller* culler = prepareLightCulling(scene, uniforms.view, uniforms.projection);
+    rasterizer.setLightCuller(culler);
+    rasterizer.setStats(&m_stats);
+
+    buildRenderQueue(scene, uniforms, renderQueue);
+
+    bool deferred = false;
+    if constexpr (kBuiltInShaders) {
+        deferred = m_settings.deferredShading;
+        if (deferred) {
+            // 几何阶段只写 G-buffer，每个像素最终只着色一次，与不透明物体的重叠层数无关
+            m_gbuffer.resize(m_settings.width, m_settings.height);
+            m_gbuffer.clear();
+            for (const TriangleWorkItem& item : renderQueue.getOpaque()) {
+                const RasterTriangle tri = renderQueue.resolve(item);
+                rasterizer.rasterizeGBuffer(tri,
+                                            m_gbuffer.registerMaterial(tri.state->material),
+                                            shadingPipeline,
+                                            m_gbuffer);
+            }
+            shadeGBuffer(shadingPipeline, culler, uniforms.cameraPosition, uniforms.ambientLight);
+        }
+    }
+    if (!deferred) {
+        for (const TriangleWorkItem& item : renderQueue.getOpaque()) {
+            rasterizer.rasterize(renderQueue.resolve(item));
+        }
+    }
+
+    for (const TriangleWorkItem& item : renderQueue.getTransparent()) {
+        rasterizer.rasterize(renderQueue.resolve(item));
+    }
+
+    // 若使用了 SSAA，则在渲染后进行低通+下采样回基准分辨率
+    if (ssaaFactor > 1) {
+        Renderer::Pipeline::RenderTarget lowRes(baseWidth, baseHeight);
+        lowRes.clear(scene.getBackgroundColor(), 1.0f);
+        Renderer::Effects::resolveBox(m_target, lowRes, ssaaFactor);
+        // 覆盖为低分辨率结果
+        m_target = lowRes;
+        // 恢复设置
+        m_settings.width = baseWidth;
+        m_settings.height = baseHeight;
+    }
+
+    applyPostProcessing();
+}
+
+template <typename VertexShader, typename FragmentShader>
+void BasicSoftwareRenderer<VertexShader, FragmentShader>::renderTiled(const Scene::Scene& scene, int ssaaFactor) {
+    const int baseWidth = m_settings.width;
+    const int baseHeight = m_settings.height;
+    const int tileSize = std::max(1, m_settings.ssaaTileSize);
+    const int highTileSize = tileSize * ssaaFactor;
+
+    // 最终目标只保留输出分辨率；高分辨率数据只存在于单个 tile 的暂存缓冲中
+    if (m_target.getWidth() != baseWidth || m_target.getHeight() != baseHeight) {
+        m_target.resize(baseWidth, baseHeight);
+    }
+    if (m_tileTarget.getWidth() != highTileSize || m_tileTarget.getHeight() != highTileSize) {
+        m_tileTarget.resize(highTileSize, highTileSize);
+    }
+
+    prepareLights(scene);
+
+    // 几何阶段仍在超采样分辨率的屏幕空间中进行，三角形队列与分辨率无关
+    m_settings.width = baseWidth * ssaaFactor;
+    m_settings.height = baseHeight * ssaaFactor;
+
+    ShadingPipeline shadingPipeline(m_settings);
+    const ShaderUniforms uniforms = frameUniforms(scene, shadingPipeline);
+    BasicRenderQueue<Varyings> renderQueue;
+    buildRenderQueue(scene, uniforms, renderQueue);
+
+    BasicTriangleRasterizer<VertexShader, FragmentShader> rasterizer(m_tileTarget, m_settings, m_fragmentShader);
+    rasterizer.setLightCuller(prepareLightCulling(scene, uniforms.view, uniforms.projection));
+    rasterizer.setStats(&m_stats);
+
+    // 按包围盒把三角形分到各个 tile，保持队列原有顺序（不透明前→后、透明后→前）；
+    // 先计数再填充，每个分箱是帧内分配器中一段连续的下标
+    const int tilesX = (baseWidth + tileSize - 1) / tileSize;
+    const int tilesY = (baseHeight + tileSize - 1) / tileSize;
+    const std::size_t tileCount = static_cast<std::size_t>(tilesX * tilesY);
+
+    // 三角形覆盖的 tile 范围，完全在屏幕外时返回 false
+    const BasicScreenVertex<Varyings>* queueVertices = renderQueue.getVertices();
+    auto tileRange = [&](const TriangleWorkItem& tri, int& tx0, int& tx1, int& ty0, int& ty1) {
+        const BasicScreenVertex<Varyings>& v0 = queueVertices[tri.i0];
+        const BasicScreenVertex<Varyings>& v1 = queueVertices[tri.i1];
+        const BasicScreenVertex<Varyings>& v2 = queueVertices[tri.i2];
+        float minX = std::floor(std::min({v0.screenX, v1.screenX, v2.screenX}));
+        float maxX = std::ceil(std::max({v0.screenX, v1.screenX, v2.screenX}));
+        float minY = std::floor(std::min({v0.screenY, v1.screenY, v2.screenY}));
+        float maxY = std::ceil(std::max({v0.screenY, v1.screenY, v2.screenY}));
+        if (maxX < 0.0f || maxY < 0.0f ||
+            minX >= static_cast<float>(m_settings.width) || minY >= static_cast<float>(m_settings.height)) {
+            return false;
+        }
+        tx0 = std::clamp(static_cast<int>(minX) / highTileSize, 0, tilesX - 1);
+        tx1 = std::clamp(static_cast<int>(maxX) / highTileSize, 0, tilesX - 1);
+        ty0 = std::clamp(static_cast<int>(minY) / highTileSize, 0, tilesY - 1);
+        ty1 = std::clamp(static_cast<int>(maxY) / highTileSize, 0, tilesY - 1);
+        return true;
+    };
+
+    struct TileBins {
+        uint32_t* offsets; // tileCount + 1 项，分箱 t 为 indices[offsets[t], offsets[t + 1])
+        uint32_t* indices;
+    };
+    auto binTriangles = [&](TriangleRange items) {
+        TileBins bins{m_frameArena.allocateArray<uint32_t>(tileCount + 1), nullptr};
+        std::fill(bins.offsets, bins.offsets + tileCount + 1, 0u);
+        int tx0 = 0, tx1 = 0, ty0 = 0, ty1 = 0;
+        for (const TriangleWorkItem& tri : items) {
+            if (!tileRange(tri, tx0, tx1, ty0, ty1)) continue;
+            for (int ty = ty0; ty <= ty1; ++ty) {
+                for (int tx = tx0; tx <= tx1; ++tx) {
+                    ++bins.offsets[static_cast<std::size_t>(ty * tilesX + tx) + 1];
+                }
+            }
+        }
+        for (std::size_t t = 0; t < tileCount; ++t) {
+            bins.offsets[t + 1] += bins.offsets[t];
+        }
+        bins.indices = m_frameArena.allocateArray<uint32_t>(bins.offsets[tileCount]);
+        uint32_t* cursor = m_frameArena.allocateArray<uint32_t>(tileCount);
+        std::copy(bins.offsets, bins.offsets + tileCount, cursor);
+        for (std::size_t i = 0; i < items.size(); ++i) {
+            if (!tileRange(items[i], tx0, tx1, ty0, ty1)) continue;
+            for (int ty = ty0; ty <= ty1; ++ty) {
+                for (int tx = tx0; tx <= tx1; ++tx) {
+                    bins.indices[cursor[ty * tilesX + tx]++] = static_cast<uint32_t>(i);
+                }
+            }
+        }
+        return bins;
+    };
+    const TileBins opaqueBins = binTriangles(renderQueue.getOpaque());
+    const TileBins transparentBins = binTriangles(renderQueue.getTransparent());
+
+    for (int ty = 0; ty < tilesY; ++ty) {
+        for (int tx = 0; tx < tilesX; ++tx) {
+            const int outX = tx * tileSize;
+            const int outY = ty * tileSize;
+            const int outW = std::min(tileSize, baseWidth - outX);
+            const int outH = std::min(tileSize, baseHeight - outY);
+            const std::size_t bin = static_cast<std::size_t>(ty * tilesX + tx);
+
+            m_tileTarget.clear(scene.getBackgroundColor(), 1.0f);
+            rasterizer.setViewport(outX * ssaaFactor, outY * ssaaFactor, outW * ssaaFactor, outH * ssaaFactor);
+
+            for (uint32_t k = opaqueBins.offsets[bin]; k < opaqueBins.offsets[bin + 1]; ++k) {
+                rasterizer.rasterize(renderQueue.resolve(renderQueue.getOpaque()[opaqueBins.indices[k]]));
+            }
+            for (uint32_t k = transparentBins.offsets[bin]; k < transparentBins.offsets[bin + 1]; ++k) {
+                rasterizer.rasterize(renderQueue.resolve(renderQueue.getTransparent()[transparentBins.indices[k]]));
+            }
+
+            Renderer::Effects::resolveBoxTile(m_tileTarget, m_target, outX, outY, outW, outH, ssaaFactor);
+        }
+    }
+
+    m_settings.width = baseWidth;
+    m_settings.height = baseHeight;
+}
+
+} // namespace Pipeline
+} // namespace Renderer
+
+#endif // RENDERER_PIPELINE_PROGRAMMABLE_RENDERER_H
@@ -1,31 +1,159 @@
 #include "render_queue.h"
 
 #include <algorithm>
+#include <cstring>
+#include <limits>
+
 
 namespace Renderer {
 namespace Pipeline {
 
-void RenderQueue::clear() {
-    m_opaque.clear();
-    m_transparent.clear();
+namespace {
+
+// 浮点数的位模式换成按数值大小单调递增的无符号整数：负数全部取反，非负数置最高位
+uint32_t orderedBits(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+/**
+ * 按 8 位一组的 LSD 基数排序 (键, 下标) 对；temp* 为同样大小的暂存，返回排好序的下标所在的数组
+ *
+ * 一次遍历统计全部 8 组直方图；所有键在某一组上相同时跳过该趟（排序键的低 15 位恒为 0，层位也常常相同）。
+ * 每趟稳定，键相同的元素保持加入顺序。
+ */
+const uint32_t* radixSortPairs(uint64_t* keys, uint32_t* values, uint64_t* tempKeys, uint32_t* tempValues, std::size_t count) {
+    constexpr int kPasses = 8;
+    uint32_t histogram[kPasses][256] = {};
+    for (std::size_t i = 0; i < count; ++i) {
+        const uint64_t key = keys[i];
+        for (int pass = 0; pass < kPasses; ++pass) {
+            ++histogram[pass][(key >> (pass * 8)) & 0xFFu];
+        }
+    }
+    for (int pass = 0; pass < kPasses; ++pass) {
+        const int shift = pass * 8;
+        uint32_t* counts = histogram[pass];
+        if (counts[(keys[0] >> shift) & 0xFFu] == count) {
+            continue;
+        }
+        uint32_t offset = 0;
+        for (int digit = 0; digit < 256; ++digit) {
+            const uint32_t n = counts[digit];
+            counts[digit] = offset;
+            offset += n;
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            const uint32_t slot = counts[(keys[i] >> shift) & 0xFFu]++;
+            tempKeys[slot] = keys[i];
+            tempValues[slot] = values[i];
+        }
+        std::swap(keys, tempKeys);
+        std::swap(values, tempValues);
+    }
+    return values;
+}
+
+} // namespace
+
+uint64_t RenderQueueBase::sortKey(bool transparent, float depth, uint32_t materialId) {
+    const uint64_t material = std::min<uint32_t>(materialId, 0xFFFFu);
+    const uint64_t ordered = orderedBits(depth);
+    if (transparent) {
+        return (uint64_t{1} << 63) | (static_cast<uint64_t>(~static_cast<uint32_t>(ordered)) << 31) | (material << 15);
+    }
+    return ((ordered >> 16) << 47) | (material << 31) | ((ordered & 0xFFFFu) << 15);
+}
+
+void RenderQueueBase::resetItems(Core::Platform::FrameArena& arena, std::size_t maxTriangles, std::size_t maxStates) {
+    m_items = arena.allocateArray<TriangleWorkItem>(maxTriangles);
+    m_capacity = maxTriangles;
+    m_opaqueCount = 0;
+    m_transparentCount = 0;
+
+    m_states = arena.allocateArray<DrawState>(maxStates);
+    m_stateCapacity = maxStates;
+    m_stateCount = 0;
+
+    m_arena = &arena;
+    m_transparentBegin = maxTriangles;
+
+    m_materialSlots = 16;
+    while (m_materialSlots < 2 * maxStates) {
+        m_materialSlots *= 2;
+    }
+    m_materialKeys = arena.allocateArray<const Core::Types::Material*>(m_materialSlots);
+    m_materialIds = arena.allocateArray<uint32_t>(m_materialSlots);
+    std::fill(m_materialKeys, m_materialKeys + m_materialSlots, nullptr);
+    m_materialCount = 0;
+}
+
+uint32_t RenderQueueBase::materialIdFor(const Core::Types::Material* material) {
+    // 指针低位因对齐恒为 0，先混合再取模
+    uint64_t hash = reinterpret_cast<std::uintptr_t>(material);
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    const std::size_t mask = m_materialSlots - 1;
+    for (std::size_t slot = static_cast<std::size_t>(hash) & mask;; slot = (slot + 1) & mask) {
+        if (m_materialKeys[slot] == material) {
+            return m_materialIds[slot];
+        }
+        if (m_materialKeys[slot] == nullptr) {
+            m_materialKeys[slot] = material;
+            m_materialIds[slot] = m_materialCount;
+            return m_materialCount++;
+        }
+    }
 }
 
-void RenderQueue::addOpaque(const TriangleWorkItem& tri) {
-    m_opaque.push_back(tri);
+uint32_t RenderQueueBase::addState(const DrawState& state) {
+    if (m_stateCount >= m_stateCapacity) return std::numeric_limits<uint32_t>::max();
+    m_states[m_stateCount] = state;
+    // 表中以 nullptr 标记空槽，没有材质的状态直接用编号 0（只影响分组，不影响正确性）
+    m_states[m_stateCount].materialId = state.material ? materialIdFor(state.material) : 0;
+    return static_cast<uint32_t>(m_stateCount++);
 }
 
-void RenderQueue::addTransparent(const TriangleWorkItem& tri) {
-    m_transparent.push_back(tri);
+void RenderQueueBase::addOpaque(const TriangleWorkItem& tri) {
+    if (m_opaqueCount + m_transparentCount >= m_capacity) return;
+    m_items[m_opaqueCount++] = tri;
 }
 
-void RenderQueue::finalize() {
-    std::sort(m_opaque.begin(), m_opaque.end(), [](const TriangleWorkItem& a, const TriangleWorkItem& b) {
-        return a.depthKey < b.depthKey;
-    });
+void RenderQueueBase::addTransparent(const TriangleWorkItem& tri) {
+    if (m_opaqueCount + m_transparentCount >= m_capacity) return;
+    m_items[m_capacity - ++m_transparentCount] = tri;
+    m_transparentBegin = m_capacity - m_transparentCount;
+}
+
+void RenderQueueBase::finalize() {
+    const std::size_t count = m_opaqueCount + m_transparentCount;
+    if (count == 0) return;
+
+    uint64_t* keys = m_arena->allocateArray<uint64_t>(count);
+    uint32_t* indices = m_arena->allocateArray<uint32_t>(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        // 不透明项在数组头部，半透明项从尾部向前填充；都按加入顺序取出，键相同的项保持加入顺序
+        const bool transparent = i >= m_opaqueCount;
+        const std::size_t source = transparent ? m_capacity - 1 - (i - m_opaqueCount) : i;
+        const TriangleWorkItem& item = m_items[source];
+        keys[i] = sortKey(transparent, item.depthKey, m_states[item.state].materialId);
+        indices[i] = static_cast<uint32_t>(source);
+    }
+
+    uint64_t* tempKeys = m_arena->allocateArray<uint64_t>(count);
+    uint32_t* tempIndices = m_arena->allocateArray<uint32_t>(count);
+    const uint32_t* order = radixSortPairs(keys, indices, tempKeys, tempIndices, count);
 
-    std::sort(m_transparent.begin(), m_transparent.end(), [](const TriangleWorkItem& a, const TriangleWorkItem& b) {
-        return a.depthKey > b.depthKey;
-    });
+    // 按排序结果收集到新数组：层位保证不透明在前、半透明在后
+    TriangleWorkItem* sorted = m_arena->allocateArray<TriangleWorkItem>(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        sorted[i] = m_items[order[i]];
+    }
+    m_items = sorted;
+    m_capacity = count;
+    m_transparentBegin = m_opaqueCount;
 }
 
 } // namespace Pipeline
@@ -1,9 +1,11 @@
 #ifndef RENDERER_PIPELINE_RENDER_QUEUE_H
 #define RENDERER_PIPELINE_RENDER_QUEUE_H
 
-#include <vector>
+#include <cstddef>
+#include <cstdint>
 
 #include "screen_vertex.h"
+#include "../../core/platform/frame_arena.h"
 
 namespace Core {
 namespace Types {
@@ -14,32 +16,165 @@ class Material;
 namespace Renderer {
 namespace Pipeline {
 
-struct TriangleWorkItem {
-    ScreenVertex v0;
-    ScreenVertex v1;
-    ScreenVertex v2;
+struct ShaderUniforms;
+
+// 同一物体的三角形共用的绘制状态
+struct DrawState {
     Core::Types::Material* material = nullptr;
-    RasterDerivatives derivs{};
-    float depthKey = 0.0f;
+    const ShaderUniforms* uniforms = nullptr; // 该物体的着色器输入，与 material 指向同一材质
+    uint32_t materialId = 0; // 本帧内材质的编号（按首次出现的顺序），由 RenderQueue::addState 分配
+    bool vertexLit = false; // 顶点颜色已是光照结果（Gouraud），光栅化只插值颜色
+    // 物体级聚光灯剔除：spotsCulled 为 true 时只有 spotIndices 列出的聚光灯可能照到该物体
+    bool spotsCulled = false;
+    const uint32_t* spotIndices = nullptr;
+    uint32_t spotCount = 0;
+};
+
+// 队列项：三个顶点在本帧共享顶点缓冲中的下标、绘制状态的编号与排序用的深度（重心的 NDC z）
+struct TriangleWorkItem {
+    uint32_t i0;
+    uint32_t i1;
+    uint32_t i2;
+    uint32_t state;
+    float depthKey;
+};
+
+// 光栅化一个三角形所需的输入，由 BasicRenderQueue::resolve 从队列项得到；顶点直接引用共享顶点缓冲
+template <typename Varyings>
+struct BasicRasterTriangle {
+    const BasicScreenVertex<Varyings>* v0;
+    const BasicScreenVertex<Varyings>* v1;
+    const BasicScreenVertex<Varyings>* v2;
+    const DrawState* state;
+};
+
+using RasterTriangle = BasicRasterTriangle<GeometryVertex>;
+
+// 队列中一段连续的三角形，指向帧内分配器中的存储
+class TriangleRange {
+public:
+    TriangleRange() = default;
+    TriangleRange(const TriangleWorkItem* data, std::size_t size) : m_data(data), m_size(size) {}
+
+    const TriangleWorkItem* begin() const { return m_data; }
+    const TriangleWorkItem* end() const { return m_data + m_size; }
+    const TriangleWorkItem& operator[](std::size_t i) const { return m_data[i]; }
+    std::size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+private:
+    const TriangleWorkItem* m_data = nullptr;
+    std::size_t m_size = 0;
 };
 
-class RenderQueue {
+/**
+ * @brief 一帧的三角形队列中与顶点类型无关的部分：绘制状态、队列项与排序
+ *
+ * 队列项只有 20 字节，排序移动的数据量与顶点属性的多少无关；共享顶点的三角形不再各自复制顶点。
+ * 绘制状态与队列项都从帧内分配器中分配：加入时不透明三角形从队列数组头部、
+ * 半透明三角形从尾部向前填充同一块存储。finalize 按 64 位排序键对 (键, 下标) 做 LSD 基数排序，
+ * 之后不透明三角形在前、半透明在后，连续存放。存储在分配器 reset 之前有效。
+ */
+class RenderQueueBase {
 public:
-    void clear();
+    /**
+     * @brief 排序键：第 63 位为层（0 不透明、1 半透明），其余位按层不同
+     *
+     * 不透明：62–47 位为深度的粗分桶，46–31 位为材质编号，30–15 位为深度的细分位。桶内由近到远的顺序让位于材质，
+     * 相同材质的三角形相邻以提高纹理缓存命中；桶取保序浮点位的高 16 位（符号、指数与 7 位尾数），宽度约为深度的 1/128。
+     * 半透明：62–31 位为取反的完整深度（由远到近，混合顺序不受材质影响），30–15 位为材质编号，只在深度相同时起作用。
+     * 材质编号超过 16 位时截断。
+     */
+    static uint64_t sortKey(bool transparent, float depth, uint32_t materialId);
+
+    // 返回新状态的编号并为其分配材质编号；容量不足时返回 UINT32_MAX
+    uint32_t addState(const DrawState& state);
 
     void addOpaque(const TriangleWorkItem& tri);
     void addTransparent(const TriangleWorkItem& tri);
 
+    // 按排序键排序；之后不应再加入三角形
     void finalize();
 
-    const std::vector<TriangleWorkItem>& getOpaque() const { return m_opaque; }
-    const std::vector<TriangleWorkItem>& getTransparent() const { return m_transparent; }
+    TriangleRange getOpaque() const { return TriangleRange(m_items, m_opaqueCount); }
+    TriangleRange getTransparent() const { return TriangleRange(m_items + m_transparentBegin, m_transparentCount); }
+
+    const DrawState& getState(uint32_t index) const { return m_states[index]; }
+
+protected:
+    // 清空队列项与绘制状态并从 arena 分配存储；超过容量的绘制状态与三角形会被丢弃
+    void resetItems(Core::Platform::FrameArena& arena, std::size_t maxTriangles, std::size_t maxStates);
+
+    DrawState* m_states = nullptr;
 
 private:
-    std::vector<TriangleWorkItem> m_opaque;
-    std::vector<TriangleWorkItem> m_transparent;
+    uint32_t materialIdFor(const Core::Types::Material* material);
+
+    Core::Platform::FrameArena* m_arena = nullptr;
+    TriangleWorkItem* m_items = nullptr;
+    std::size_t m_capacity = 0;
+    std::size_t m_opaqueCount = 0;
+    std::size_t m_transparentCount = 0;
+    std::size_t m_transparentBegin = 0; // finalize 之前为 m_capacity - m_transparentCount，之后为 m_opaqueCount
+
+    std::size_t m_stateCapacity = 0;
+    std::size_t m_stateCount = 0;
+
+    // 材质指针 → 编号的开放寻址表（容量为 2 的幂，至少是状态数的两倍）
+    const Core::Types::Material** m_materialKeys = nullptr;
+    uint32_t* m_materialIds = nullptr;
+    std::size_t m_materialSlots = 0;
+    uint32_t m_materialCount = 0;
 };
 
+/**
+ * @brief 一帧的三角形队列：所有物体的变换顶点存放在一块共享顶点缓冲中，队列项只保存顶点下标
+ *
+ * 顶点类型由顶点着色器的 Varyings 决定，顶点缓冲同样从帧内分配器中分配。
+ */
+template <typename Varyings>
+class BasicRenderQueue : public RenderQueueBase {
+public:
+    using Vertex = BasicScreenVertex<Varyings>;
+    using Triangle = BasicRasterTriangle<Varyings>;
+
+    // 清空队列并从 arena 分配存储；超过容量的顶点、绘制状态与三角形会被丢弃
+    void reset(Core::Platform::FrameArena& arena, std::size_t maxTriangles,
+               std::size_t maxVertices, std::size_t maxStates) {
+        resetItems(arena, maxTriangles, maxStates);
+        m_vertices = arena.allocateArray<Vertex>(maxVertices);
+        m_vertexCapacity = maxVertices;
+        m_vertexCount = 0;
+    }
+
+    /**
+     * @brief 在共享顶点缓冲末尾预留 count 个顶点，由调用者写入
+     * @param baseIndex 第一个顶点的下标，物体内的顶点下标加上它即为队列项中的下标
+     * @return 预留的顶点；容量不足时返回 nullptr
+     */
+    Vertex* allocateVertices(std::size_t count, uint32_t& baseIndex) {
+        if (count > m_vertexCapacity - m_vertexCount) return nullptr;
+        baseIndex = static_cast<uint32_t>(m_vertexCount);
+        m_vertexCount += count;
+        return m_vertices + baseIndex;
+    }
+
+    const Vertex* getVertices() const { return m_vertices; }
+    std::size_t getVertexCount() const { return m_vertexCount; }
+
+    // 取出队列项引用的顶点与绘制状态
+    Triangle resolve(const TriangleWorkItem& tri) const {
+        return Triangle{&m_vertices[tri.i0], &m_vertices[tri.i1], &m_vertices[tri.i2], &m_states[tri.state]};
+    }
+
+private:
+    Vertex* m_vertices = nullptr;
+    std::size_t m_vertexCapacity = 0;
+    std::size_t m_vertexCount = 0;
+};
+
+using RenderQueue = BasicRenderQueue<GeometryVertex>;
+
 } // namespace Pipeline
 } // namespace Renderer
 
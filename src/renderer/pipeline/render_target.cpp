@@ -1,6 +1,5 @@
 #include "render_target.h"
 #include <algorithm>
-#include <fstream>
 
 namespace Renderer {
 namespace Pipeline {
@@ -83,27 +82,5 @@ Color RenderTarget::getPixel(int x, int y) const {
     return m_colorBuffer[index];
 }
 
-bool RenderTarget::savePPM(const std::string& filename) const {
-    if (m_width == 0 || m_height == 0) {
-        return false;
-    }
-
-    std::ofstream file(filename, std::ios::binary);
-    if (!file.is_open()) {
-        return false;
-    }
-
-    file << "P6\n" << m_width << " " << m_height << "\n255\n";
-    for (const auto& color : m_colorBuffer) {
-        unsigned char r = static_cast<unsigned char>(std::clamp(color.r, 0.0f, 1.0f) * 255.0f);
-        unsigned char g = static_cast<unsigned char>(std::clamp(color.g, 0.0f, 1.0f) * 255.0f);
-        unsigned char b = static_cast<unsigned char>(std::clamp(color.b, 0.0f, 1.0f) * 255.0f);
-        file.write(reinterpret_cast<const char*>(&r), 1);
-        file.write(reinterpret_cast<const char*>(&g), 1);
-        file.write(reinterpret_cast<const char*>(&b), 1);
-    }
-    return true;
-}
-
 } // namespace Pipeline
 } // namespace Renderer
@@ -35,8 +35,7 @@ public:
     int getWidth() const { return m_width; }
     int getHeight() const { return m_height; }
     const std::vector<Core::Types::Color>& getColorBuffer() const { return m_colorBuffer; }
-
-    bool savePPM(const std::string& filename) const;
+    std::vector<Core::Types::Color>& accessColorBuffer() { return m_colorBuffer; }
 };
 
 } // namespace Pipeline
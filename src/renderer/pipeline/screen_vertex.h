@@ -6,14 +6,20 @@
 namespace Renderer {
 namespace Pipeline {
 
-struct ScreenVertex {
-    GeometryVertex attributes;
+// 顶点阶段的输出：顶点着色器写出的 varyings 与透视除法、视口变换后的屏幕坐标
+template <typename Varyings>
+struct BasicScreenVertex {
+    Varyings attributes;
     float screenX;
     float screenY;
     float ndcZ;
+    float reciprocalW; // 裁剪坐标 1/w，透视校正插值与深度测试使用
     bool valid = false;
 };
 
+// 内置 Blinn-Phong 着色器的 varyings 即 GeometryVertex
+using ScreenVertex = BasicScreenVertex<GeometryVertex>;
+
 struct RasterDerivatives {
     float dudx;
     float dudy;
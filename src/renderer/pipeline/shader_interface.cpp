@@ -0,0 +1,42 @@
+#include "shader_interface.h"
+
+#include "geometry_stage.h"
+#include "shading_pipeline.h"
+
+namespace Renderer {
+namespace Pipeline {
+
+Core::Math::Vector4 BlinnPhongVertexShader::operator()(const Core::Types::Vertex& vertex,
+                                                       const ShaderUniforms& uniforms,
+                                                       Varyings& out) const {
+    out = GeometryVertex::fromVertex(vertex, uniforms.model, uniforms.view, uniforms.projection);
+    return out.clipPosition;
+}
+
+bool BlinnPhongFragmentShader::operator()(const BlinnPhongVaryings& in,
+                                          const FragmentContext<BlinnPhongVaryings>& context,
+                                          Core::Types::Color& out) const {
+    const ShaderUniforms& uniforms = context.uniforms;
+    if (!uniforms.shading || !uniforms.lights) {
+        return false;
+    }
+    // 插值后的方向向量重新归一化，与 GeometryVertex::interpolate 一致
+    GeometryVertex surface = in;
+    surface.normal = in.normal.normalize();
+    surface.tangent = in.tangent.normalize();
+    surface.bitangent = in.bitangent.normalize();
+
+    const RasterDerivatives derivs{context.ddx.texCoord.x, context.ddy.texCoord.x,
+                                   context.ddx.texCoord.y, context.ddy.texCoord.y};
+    out = uniforms.shading->shade(surface,
+                                  uniforms.material,
+                                  *uniforms.lights,
+                                  context.lights,
+                                  uniforms.cameraPosition,
+                                  uniforms.ambientLight,
+                                  derivs);
+    return true;
+}
+
+} // namespace Pipeline
+} // namespace Renderer
@@ -0,0 +1,142 @@
+#ifndef RENDERER_PIPELINE_SHADER_INTERFACE_H
+#define RENDERER_PIPELINE_SHADER_INTERFACE_H
+
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+
+#include "geometry_stage.h"
+#include "../lighting/light_buffer.h"
+#include "../../core/math/matrix.h"
+#include "../../core/math/vector.h"
+#include "../../core/types/color.h"
+#include "../../core/types/vertex.h"
+
+namespace Core {
+namespace Types {
+class Material;
+}
+}
+
+namespace Renderer {
+namespace Pipeline {
+
+class ShadingPipeline;
+
+/**
+ * @brief 每个物体不变的着色器输入
+ *
+ * 由 BasicSoftwareRenderer 在处理每个物体前填写（存放在帧内分配器中，由 DrawState 引用），顶点与片元阶段共用。
+ */
+struct ShaderUniforms {
+    Core::Math::Matrix4 model;
+    Core::Math::Matrix4 view;
+    Core::Math::Matrix4 projection;
+    Core::Math::Vector3 cameraPosition;
+    Core::Types::Material* material = nullptr;          // 物体覆盖材质或网格材质，可为 nullptr
+    const Renderer::Lighting::LightBuffer* lights = nullptr; // 本帧编译的光源（含阴影与环境光）
+    Core::Types::Color ambientLight;
+    const ShadingPipeline* shading = nullptr;           // 内置光照模型，自定义着色器可直接复用
+};
+
+/**
+ * @brief 片元阶段除插值 varyings 外的输入
+ *
+ * ddx/ddy 是 varyings 在屏幕空间的偏导（按三角形顶点值仿射求得，每个三角形常量），
+ * 与 GeometryProcessor::rasterDerivatives 计算纹理导数的方式一致，可用于纹理 LOD。
+ * lights 是可能照到该片元的局部光源子集（光源簇与物体级聚光灯剔除的结果），未剔除时遍历全部光源。
+ */
+template <typename Varyings>
+struct FragmentContext {
+    const ShaderUniforms& uniforms;
+    int x;       // 光栅化坐标
+    int y;
+    float depth; // [0, 1]，越小越近
+    const Varyings& ddx;
+    const Varyings& ddy;
+    const Renderer::Lighting::LightSelection& lights;
+};
+
+/**
+ * @brief varyings 的分量布局
+ *
+ * 着色器声明的 Varyings 必须是只由 float（及 Vector2/3/4、Color 等 float 结构）组成的可平凡复制类型，
+ * 光栅化按 float 分量逐个插值，编译期即可确定分量数，不需要反射或虚函数。
+ */
+template <typename Varyings>
+struct VaryingLayout {
+    static_assert(std::is_trivially_copyable<Varyings>::value, "Varyings 必须可平凡复制");
+    static_assert(sizeof(Varyings) % sizeof(float) == 0, "Varyings 只能由 float 分量组成");
+    static constexpr int kComponents = static_cast<int>(sizeof(Varyings) / sizeof(float));
+
+    static void load(const Varyings& v, float* out) { std::memcpy(out, &v, sizeof(Varyings)); }
+    // Vector3 等成员有自定义默认构造（类型不平凡但可平凡复制），按 void* 复制以免 -Wclass-memaccess
+    static void store(const float* in, Varyings& v) { std::memcpy(static_cast<void*>(&v), in, sizeof(Varyings)); }
+
+    // out = v0·a + v1·b + v2·c（权重由调用者决定是否已做透视校正）
+    static void interpolate(const Varyings& v0, const Varyings& v1, const Varyings& v2,
+                            float a, float b, float c, Varyings& out) {
+        float f0[kComponents], f1[kComponents], f2[kComponents], result[kComponents];
+        load(v0, f0);
+        load(v1, f1);
+        load(v2, f2);
+        for (int i = 0; i < kComponents; ++i) {
+            result[i] = f0[i] * a + f1[i] * b + f2[i] * c;
+        }
+        store(result, out);
+    }
+
+    // 三角形上 varyings 对屏幕 x、y 的偏导（仿射，不做透视校正）；屏幕上退化的三角形为全 0
+    static void screenDerivatives(const Varyings& v0, const Varyings& v1, const Varyings& v2,
+                                  float x0, float y0, float x1, float y1, float x2, float y2,
+                                  Varyings& ddx, Varyings& ddy) {
+        float dx[kComponents] = {};
+        float dy[kComponents] = {};
+        const float det = (x1 - x0) * (y2 - y0) - (x2 - x0) * (y1 - y0);
+        if (std::fabs(det) >= 1e-6f) {
+            float f0[kComponents], f1[kComponents], f2[kComponents];
+            load(v0, f0);
+            load(v1, f1);
+            load(v2, f2);
+            for (int i = 0; i < kComponents; ++i) {
+                dx[i] = ((f1[i] - f0[i]) * (y2 - y0) - (f2[i] - f0[i]) * (y1 - y0)) / det;
+                dy[i] = (-(f1[i] - f0[i]) * (x2 - x0) + (f2[i] - f0[i]) * (x1 - x0)) / det;
+            }
+        }
+        store(dx, ddx);
+        store(dy, ddy);
+    }
+};
+
+// 内置 Blinn-Phong 的 varyings 即 GeometryVertex：包着色、逐顶点光照与延迟着色直接读取其中的属性
+using BlinnPhongVaryings = GeometryVertex;
+
+/**
+ * @brief 默认顶点着色器：GeometryVertex::fromVertex
+ *
+ * 顶点着色器约定：声明 Varyings 类型，operator() 写出 varyings 并返回裁剪空间坐标。
+ */
+struct BlinnPhongVertexShader {
+    using Varyings = BlinnPhongVaryings;
+
+    Core::Math::Vector4 operator()(const Core::Types::Vertex& vertex,
+                                   const ShaderUniforms& uniforms,
+                                   Varyings& out) const;
+};
+
+/**
+ * @brief 默认片元着色器：调用 ShadingPipeline::shade（法线贴图、Blinn-Phong、阴影、环境光）
+ *
+ * 片元着色器约定：operator() 写出预乘 alpha 的颜色，返回 false 表示丢弃该片元。
+ * 只遍历 context.lights 中的光源。
+ */
+struct BlinnPhongFragmentShader {
+    bool operator()(const BlinnPhongVaryings& in,
+                    const FragmentContext<BlinnPhongVaryings>& context,
+                    Core::Types::Color& out) const;
+};
+
+} // namespace Pipeline
+} // namespace Renderer
+
+#endif // RENDERER_PIPELINE_SHADER_INTERFACE_H
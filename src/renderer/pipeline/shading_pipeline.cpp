@@ -7,24 +7,269 @@
 
 #include "../../core/types/material.h"
 #include "../../core/types/color.h"
+#include "../../renderer/lighting/brdf_lut.h"
 #include "../../renderer/lighting/light.h"
+#include "../../renderer/lighting/shadow_map.h"
 
 namespace Renderer {
 namespace Pipeline {
 
+namespace {
+
+// GGX 在 α → 0 时退化为冲激，感知粗糙度下限避免高光峰值溢出
+constexpr float kMinRoughness = 0.045f;
+// 掠射角处 NdotV → 0，可见性与查表都取一个很小的正值
+constexpr float kMinNdotV = 1e-4f;
+
+// Schlick 菲涅尔权重 (1 - cosθ)^5
+inline float schlickWeight(float NdotV) {
+    const float m = 1.0f - std::clamp(NdotV, 0.0f, 1.0f);
+    const float m2 = m * m;
+    return m2 * m2 * m;
+}
+
+// 包着色的逐通道光照累加器；数组同属一个对象，编译器可确认互不别名并向量化累加循环
+struct LaneLighting {
+    float irrR[kFragmentPacketWidth] = {};
+    float irrG[kFragmentPacketWidth] = {};
+    float irrB[kFragmentPacketWidth] = {};
+    float specR[kFragmentPacketWidth] = {};
+    float specG[kFragmentPacketWidth] = {};
+    float specB[kFragmentPacketWidth] = {};
+    // 当前光源对各通道的漫反射/高光权重
+    float diffuseW[kFragmentPacketWidth] = {};
+    float specularW[kFragmentPacketWidth] = {};
+
+    void accumulate(float cr, float cg, float cb) {
+        for (int lane = 0; lane < kFragmentPacketWidth; ++lane) {
+            irrR[lane] += cr * diffuseW[lane];
+            irrG[lane] += cg * diffuseW[lane];
+            irrB[lane] += cb * diffuseW[lane];
+            specR[lane] += cr * specularW[lane];
+            specG[lane] += cg * specularW[lane];
+            specB[lane] += cb * specularW[lane];
+        }
+    }
+};
+
+// 逐光源累加结果：颜色×强度×衰减分别乘漫反射权重与镜面权重；
+// 逐光源菲涅尔的高光瓣另外累加乘了 Schlick 权重的镜面项
+struct LightSums {
+    float irradianceR = 0.0f, irradianceG = 0.0f, irradianceB = 0.0f;
+    float specularR = 0.0f, specularG = 0.0f, specularB = 0.0f;
+    float fresnelR = 0.0f, fresnelG = 0.0f, fresnelB = 0.0f;
+
+    void add(float r, float g, float b, float diffuseWeight, float specularWeight) {
+        irradianceR += r * diffuseWeight;
+        irradianceG += g * diffuseWeight;
+        irradianceB += b * diffuseWeight;
+        specularR += r * specularWeight;
+        specularG += g * specularWeight;
+        specularB += b * specularWeight;
+    }
+
+    void addFresnel(float r, float g, float b, float weight) {
+        fresnelR += r * weight;
+        fresnelG += g * weight;
+        fresnelB += b * weight;
+    }
+};
+
+// Blinn-Phong 高光瓣；菲涅尔（若启用）在累加之后按 NdotV 统一施加
+struct BlinnPhongLobe {
+    static constexpr bool kFresnelPerLight = false;
+    float power;
+
+    float operator()(float /*NdotL*/, float NdotH) const { return std::pow(NdotH, power); }
+};
+
+// GGX 高光瓣 π·D·V·NdotL：光源强度与漫反射一样按 π 倍辐亮度计，D 的 1/π 与之约去
+struct GgxLobe {
+    static constexpr bool kFresnelPerLight = true;
+    float alpha;
+    float alphaSq;
+    float NdotV;
+
+    float operator()(float NdotL, float NdotH) const {
+        const float nl = std::max(NdotL, 0.0f);
+        const float d = NdotH * NdotH * (alphaSq - 1.0f) + 1.0f;
+        return alphaSq / (d * d) * Renderer::Lighting::smithGgxVisibility(NdotV, nl, alpha) * nl;
+    }
+};
+
+/**
+ * 遍历光源缓冲，按高光瓣累加漫反射与镜面权重；Lobe 在编译期展开，
+ * Blinn-Phong 与 GGX 共用同一套衰减、锥角、阴影与剔除逻辑。
+ */
+template <typename Lobe>
+void accumulateLights(const Renderer::Lighting::LightBuffer& lights,
+                      const Renderer::Lighting::LightSelection& selection,
+                      const Core::Math::Vector3& P,
+                      const Core::Math::Vector3& normal,
+                      const Core::Math::Vector3& viewDir,
+                      const Lobe& lobe,
+                      LightSums& sums) {
+    using Core::Math::Vector3;
+
+    // 半程向量 h = l + v（未归一化）给出 NdotH；逐光源菲涅尔再用它求 LdotH
+    auto addLight = [&](float r, float g, float b, float lx, float ly, float lz,
+                        float diffuseWeight, float specularScale, float NdotL) {
+        const float hx = lx + viewDir.x;
+        const float hy = ly + viewDir.y;
+        const float hz = lz + viewDir.z;
+        const float hLenSq = hx * hx + hy * hy + hz * hz;
+        const float invHLen = hLenSq > 0.0f ? 1.0f / std::sqrt(hLenSq) : 0.0f;
+        const float NdotH = std::max(0.0f, (normal.x * hx + normal.y * hy + normal.z * hz) * invHLen);
+        const float specularWeight = specularScale * lobe(NdotL, NdotH);
+        sums.add(r, g, b, diffuseWeight, specularWeight);
+        if constexpr (Lobe::kFresnelPerLight) {
+            const float LdotH = (lx * hx + ly * hy + lz * hz) * invHLen;
+            sums.addFresnel(r, g, b, specularWeight * schlickWeight(LdotH));
+        }
+    };
+
+    // 方向光：无衰减，逐分量连续访问；投射阴影的光源额外乘以阴影贴图可见度
+    const auto& directional = lights.directional();
+    for (std::size_t i = 0; i < directional.size(); ++i) {
+        const float lx = directional.dirX[i];
+        const float ly = directional.dirY[i];
+        const float lz = directional.dirZ[i];
+        const float NdotLRaw = normal.x * lx + normal.y * ly + normal.z * lz;
+        const float lit = NdotLRaw > 0.0f ? 1.0f : 0.0f;
+        const float NdotL = std::max(0.0f, NdotLRaw);
+        const float visibility = (lit > 0.0f && directional.shadow[i])
+            ? directional.shadow[i]->visibility(P, normal)
+            : 1.0f;
+        addLight(directional.r[i], directional.g[i], directional.b[i], lx, ly, lz,
+                 NdotL * visibility, lit * visibility, NdotL);
+    }
+
+    // 点光源：范围外的光源贡献为 0，先用距离平方剔除
+    const auto& points = lights.points();
+    auto accumulatePoint = [&](std::size_t i) {
+        const float lx = points.posX[i] - P.x;
+        const float ly = points.posY[i] - P.y;
+        const float lz = points.posZ[i] - P.z;
+        const float distSq = lx * lx + ly * ly + lz * lz;
+        if (distSq > points.rangeSq[i]) {
+            return;
+        }
+        const float dist = std::sqrt(distSq);
+        const float invDist = dist > 0.0f ? 1.0f / dist : 0.0f;
+        const float nx = lx * invDist;
+        const float ny = ly * invDist;
+        const float nz = lz * invDist;
+        const float NdotL = normal.x * nx + normal.y * ny + normal.z * nz;
+        if (NdotL <= 0.0f) {
+            return;
+        }
+        float attenuation = std::min(1.0f,
+            1.0f / (points.constant[i] + points.linear[i] * dist + points.quadratic[i] * distSq));
+        if (points.shadow[i]) {
+            const float visibility = points.shadow[i]->visibility(P, normal);
+            if (visibility <= 0.0f) {
+                return;
+            }
+            attenuation *= visibility;
+        }
+        addLight(points.r[i], points.g[i], points.b[i], nx, ny, nz, attenuation * NdotL, attenuation, NdotL);
+    };
+    if (selection.culled) {
+        for (std::size_t k = 0; k < selection.pointCount; ++k) {
+            accumulatePoint(selection.pointIndices[k]);
+        }
+    } else {
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            accumulatePoint(i);
+        }
+    }
+
+    // 聚光灯：距离衰减 × 内外锥 smoothstep，外锥之外贡献为 0（暂不支持阴影）
+    const auto& spots = lights.spots();
+    auto accumulateSpot = [&](std::size_t i) {
+        const float lx = spots.posX[i] - P.x;
+        const float ly = spots.posY[i] - P.y;
+        const float lz = spots.posZ[i] - P.z;
+        const float distSq = lx * lx + ly * ly + lz * lz;
+        if (distSq > spots.rangeSq[i]) {
+            return;
+        }
+        const float dist = std::sqrt(distSq);
+        const float invDist = dist > 0.0f ? 1.0f / dist : 0.0f;
+        const float nx = lx * invDist;
+        const float ny = ly * invDist;
+        const float nz = lz * invDist;
+        const float cosAngle = dist > 0.0f ? -(nx * spots.dirX[i] + ny * spots.dirY[i] + nz * spots.dirZ[i]) : 1.0f;
+        if (cosAngle <= spots.cosOuter[i]) {
+            return;
+        }
+        const float NdotL = normal.x * nx + normal.y * ny + normal.z * nz;
+        if (NdotL <= 0.0f) {
+            return;
+        }
+        const float t = std::clamp((cosAngle - spots.cosOuter[i]) * spots.invConeDelta[i], 0.0f, 1.0f);
+        const float attenuation = t * t * (3.0f - 2.0f * t) * std::min(1.0f,
+            1.0f / (spots.constant[i] + spots.linear[i] * dist + spots.quadratic[i] * distSq));
+        addLight(spots.r[i], spots.g[i], spots.b[i], nx, ny, nz, attenuation * NdotL, attenuation, NdotL);
+    };
+    if (selection.spotsCulled) {
+        for (std::size_t k = 0; k < selection.spotCount; ++k) {
+            accumulateSpot(selection.spotIndices[k]);
+        }
+    } else {
+        for (std::size_t i = 0; i < spots.size(); ++i) {
+            accumulateSpot(i);
+        }
+    }
+
+    // 没有专用分组的自定义光源仍走虚接口
+    for (Renderer::Lighting::Light* light : lights.others()) {
+        if (!light->isVisible(P)) {
+            continue;
+        }
+        Vector3 lightDir = light->getDirection(P).normalize();
+        float attenuation = light->getAttenuation(P);
+        if (attenuation <= 0.0f) {
+            continue;
+        }
+        float NdotL = std::max(0.0f, normal.dot(lightDir));
+        if (NdotL <= 0.0f) {
+            continue;
+        }
+        const Core::Types::Color& color = light->getColor();
+        float scale = light->getIntensity() * attenuation;
+        addLight(color.r * scale, color.g * scale, color.b * scale, lightDir.x, lightDir.y, lightDir.z,
+                 NdotL, 1.0f, NdotL);
+    }
+}
+
+} // namespace
+
 ShadingPipeline::ShadingPipeline(const SoftwareRendererSettings& settings)
-    : m_settings(settings) {}
+    : m_settings(settings), m_brdfLut(Renderer::Lighting::BrdfLut::instance()) {}
 
 Core::Types::Color ShadingPipeline::shade(const GeometryVertex& interpolated,
                                           Core::Types::Material* material,
-                                          const std::vector<Renderer::Lighting::Light*>& lights,
+                                          const Renderer::Lighting::LightBuffer& lights,
+                                          const Renderer::Lighting::LightSelection& selection,
                                           const Core::Math::Vector3& viewPos,
                                           const Core::Types::Color& sceneAmbient,
                                           const RasterDerivatives& derivs) const {
+    Core::Types::Color baseColor;
+    Core::Math::Vector3 normal;
+    resolveSurface(interpolated, material, derivs, baseColor, normal);
+    return shadeSurface(baseColor, normal, interpolated.worldPosition, material, lights, selection, viewPos, sceneAmbient);
+}
+
+void ShadingPipeline::resolveSurface(const GeometryVertex& interpolated,
+                                     Core::Types::Material* material,
+                                     const RasterDerivatives& derivs,
+                                     Core::Types::Color& baseColor,
+                                     Core::Math::Vector3& normal) const {
     using Core::Types::Color;
     using Core::Math::Vector3;
 
-    Color baseColor = interpolated.color;
+    baseColor = interpolated.color;
     if (material) {
         Color albedo = material->sampleAlbedo(interpolated.texCoord,
                                               derivs.dudx, derivs.dudy,
@@ -32,7 +277,7 @@ Core::Types::Color ShadingPipeline::shade(const GeometryVertex& interpolated,
         baseColor = albedo * baseColor;
     }
 
-    Vector3 normal = interpolated.normal;
+    normal = interpolated.normal;
     if (material && material->getNormalMap()) {
         Vector3 tangentSpaceNormal = material->sampleNormal(interpolated.texCoord);
         Vector3 t = interpolated.tangent.normalize();
@@ -42,49 +287,72 @@ Core::Types::Color ShadingPipeline::shade(const GeometryVertex& interpolated,
     } else {
         normal = normal.normalize();
     }
+}
 
-    Vector3 viewDir = (viewPos - interpolated.worldPosition).normalize();
-
-    float baseAlpha = std::clamp(baseColor.a, 0.0f, 1.0f);
-    Color ambient = sceneAmbient * baseColor;
-    ambient.a = 0.0f;
+Core::Types::Color ShadingPipeline::shadeVertex(const GeometryVertex& vertex,
+                                                Core::Types::Material* material,
+                                                const Renderer::Lighting::LightBuffer& lights,
+                                                const Core::Math::Vector3& viewPos,
+                                                const Core::Types::Color& sceneAmbient) const {
+    using Core::Types::Color;
 
-    Color diffuseAccum = ambient;
-    Color specularAccum(0.0f, 0.0f, 0.0f, 0.0f);
+    // 漫反射贴图留到逐像素阶段调制，这里只用顶点色与材质漫反射色
+    Color baseColor = vertex.color;
+    if (material && !material->getDiffuseMap()) {
+        baseColor = material->getDiffuse() * baseColor;
+    }
+    return shadeSurface(baseColor, vertex.normal.normalize(), vertex.worldPosition, material,
+                        lights, Renderer::Lighting::LightSelection(), viewPos, sceneAmbient);
+}
 
-    for (const auto& light : lights) {
-        if (!light || !light->isVisible(interpolated.worldPosition)) {
-            continue;
-        }
+Core::Types::Color ShadingPipeline::shadeSurface(const Core::Types::Color& baseColor,
+                                                 const Core::Math::Vector3& normal,
+                                                 const Core::Math::Vector3& position,
+                                                 Core::Types::Material* material,
+                                                 const Renderer::Lighting::LightBuffer& lights,
+                                                 const Renderer::Lighting::LightSelection& selection,
+                                                 const Core::Math::Vector3& viewPos,
+                                                 const Core::Types::Color& sceneAmbient) const {
+    using Core::Types::Color;
+    using Core::Math::Vector3;
 
-        Vector3 lightDir = light->getDirection(interpolated.worldPosition).normalize();
-        float attenuation = light->getAttenuation(interpolated.worldPosition);
-        if (attenuation <= 0.0f) {
-            continue;
-        }
+    Vector3 viewDir = (viewPos - position).normalize();
+    if (material && material->getShadingModel() == Core::Types::ShadingModel::MetallicRoughness) {
+        return shadeMetallicRoughness(baseColor, normal, position, viewDir, *material, lights, selection, sceneAmbient);
+    }
 
-        float NdotL = std::max(0.0f, normal.dot(lightDir));
-        if (NdotL <= 0.0f) {
-            continue;
-        }
+    float baseAlpha = std::clamp(baseColor.a, 0.0f, 1.0f);
+    // 有球谐环境光时按法线求值，否则使用平坦的场景环境色
+    Color ambient = sceneAmbient * baseColor;
+    if (const Renderer::Lighting::SHIrradiance* environment = lights.environment()) {
+        ambient = environment->evaluate(normal) * baseColor;
+    }
+    ambient.a = 0.0f;
 
-        Color lightColor = light->getColor() * (light->getIntensity() * attenuation);
-        Vector3 halfVector = (lightDir + viewDir).normalize();
-        Color diffuse = baseColor * lightColor * NdotL;
-        diffuse.a = 0.0f;
+    const float specPower = material ? material->getShininess() : 32.0f;
+    LightSums sums;
+    accumulateLights(lights, selection, position, normal, viewDir, BlinnPhongLobe{specPower}, sums);
 
-        diffuseAccum = diffuseAccum + diffuse;
-        float specPower = material ? material->getShininess() : 32.0f;
-        float NdotH = std::max(0.0f, normal.dot(halfVector));
-        float specularFactor = std::pow(NdotH, specPower);
-        if (specularFactor > 0.0f) {
-            Color specular = lightColor * specularFactor;
-            Color specularColor = material ? material->getSpecular() : Color(1.0f, 1.0f, 1.0f, 1.0f);
-            specular = specular * specularColor;
-            specular.a = 0.0f;
-            specularAccum = specularAccum + specular;
-        }
+    Color specularColor = material ? material->getSpecular() : Color(1.0f, 1.0f, 1.0f, 1.0f);
+    if (m_settings.enableFresnel) {
+        // Schlick 近似：高光颜色（无材质时为 fresnelF0）作为法线入射反射率，掠射角时趋近 1
+        const float f0R = material ? specularColor.r : m_settings.fresnelF0;
+        const float f0G = material ? specularColor.g : m_settings.fresnelF0;
+        const float f0B = material ? specularColor.b : m_settings.fresnelF0;
+        const float fresnel = schlickWeight(normal.x * viewDir.x + normal.y * viewDir.y + normal.z * viewDir.z);
+        specularColor = Color(f0R + (1.0f - f0R) * fresnel,
+                              f0G + (1.0f - f0G) * fresnel,
+                              f0B + (1.0f - f0B) * fresnel,
+                              1.0f);
     }
+    Color diffuseAccum(ambient.r + baseColor.r * sums.irradianceR,
+                       ambient.g + baseColor.g * sums.irradianceG,
+                       ambient.b + baseColor.b * sums.irradianceB,
+                       0.0f);
+    Color specularAccum(sums.specularR * specularColor.r,
+                        sums.specularG * specularColor.g,
+                        sums.specularB * specularColor.b,
+                        0.0f);
 
     Color diffuseClamped(
         std::clamp(diffuseAccum.r, 0.0f, 1.0f),
@@ -111,5 +379,426 @@ Core::Types::Color ShadingPipeline::shade(const GeometryVertex& interpolated,
     return finalColor;
 }
 
+Core::Types::Color ShadingPipeline::shadeMetallicRoughness(const Core::Types::Color& baseColor,
+                                                           const Core::Math::Vector3& normal,
+                                                           const Core::Math::Vector3& position,
+                                                           const Core::Math::Vector3& viewDir,
+                                                           const Core::Types::Material& material,
+                                                           const Renderer::Lighting::LightBuffer& lights,
+                                                           const Renderer::Lighting::LightSelection& selection,
+                                                           const Core::Types::Color& sceneAmbient) const {
+    using Core::Types::Color;
+    using Core::Math::Vector3;
+
+    const float metallic = std::clamp(material.getMetallic(), 0.0f, 1.0f);
+    const float roughness = std::clamp(material.getRoughness(), kMinRoughness, 1.0f);
+    const float alpha = roughness * roughness;
+    const float NdotV = std::max(normal.dot(viewDir), kMinNdotV);
+
+    LightSums sums;
+    accumulateLights(lights, selection, position, normal, viewDir, GgxLobe{alpha, alpha * alpha, NdotV}, sums);
+
+    // 电介质的法线入射反射率取 fresnelF0，金属取基础色；金属没有漫反射
+    const float dielectric = m_settings.fresnelF0;
+    const float f0R = dielectric + (baseColor.r - dielectric) * metallic;
+    const float f0G = dielectric + (baseColor.g - dielectric) * metallic;
+    const float f0B = dielectric + (baseColor.b - dielectric) * metallic;
+    const float kd = 1.0f - metallic;
+
+    // 环境光：漫反射按法线求值，镜面按反射方向求值后乘 split-sum DFG 项 F0·scale + bias
+    float ambientR = sceneAmbient.r, ambientG = sceneAmbient.g, ambientB = sceneAmbient.b;
+    float reflectedR = sceneAmbient.r, reflectedG = sceneAmbient.g, reflectedB = sceneAmbient.b;
+    if (const Renderer::Lighting::SHIrradiance* environment = lights.environment()) {
+        const Vector3 reflected = normal * (2.0f * NdotV) - viewDir;
+        environment->evaluate(normal.x, normal.y, normal.z, ambientR, ambientG, ambientB);
+        environment->evaluate(reflected.x, reflected.y, reflected.z, reflectedR, reflectedG, reflectedB);
+    }
+    float dfgScale, dfgBias;
+    m_brdfLut.lookup(NdotV, roughness, dfgScale, dfgBias);
+
+    const float baseAlpha = std::clamp(baseColor.a, 0.0f, 1.0f);
+    const float diffuseR = std::clamp((ambientR + sums.irradianceR) * baseColor.r * kd, 0.0f, 1.0f);
+    const float diffuseG = std::clamp((ambientG + sums.irradianceG) * baseColor.g * kd, 0.0f, 1.0f);
+    const float diffuseB = std::clamp((ambientB + sums.irradianceB) * baseColor.b * kd, 0.0f, 1.0f);
+    // 逐光源 Schlick：Σ c·s·(F0 + (1 - F0)·w) = F0·Σ c·s + (1 - F0)·Σ c·s·w
+    const float specularR = std::clamp(f0R * sums.specularR + (1.0f - f0R) * sums.fresnelR +
+                                       reflectedR * (f0R * dfgScale + dfgBias), 0.0f, 1.0f);
+    const float specularG = std::clamp(f0G * sums.specularG + (1.0f - f0G) * sums.fresnelG +
+                                       reflectedG * (f0G * dfgScale + dfgBias), 0.0f, 1.0f);
+    const float specularB = std::clamp(f0B * sums.specularB + (1.0f - f0B) * sums.fresnelB +
+                                       reflectedB * (f0B * dfgScale + dfgBias), 0.0f, 1.0f);
+
+    return Color(std::clamp(diffuseR * baseAlpha + specularR, 0.0f, 1.0f),
+                 std::clamp(diffuseG * baseAlpha + specularG, 0.0f, 1.0f),
+                 std::clamp(diffuseB * baseAlpha + specularB, 0.0f, 1.0f),
+                 baseAlpha);
+}
+
+void ShadingPipeline::shadeBatch(const FragmentPacket& packet,
+                                 Core::Types::Material* material,
+                                 const Renderer::Lighting::LightBuffer& lights,
+                                 const Renderer::Lighting::LightSelection& selection,
+                                 const Core::Math::Vector3& viewPos,
+                                 const Core::Types::Color& sceneAmbient,
+                                 const RasterDerivatives& derivs,
+                                 ColorPacket& out) const {
+    using Core::Types::Color;
+    using Core::Math::Vector2;
+    using Core::Math::Vector3;
+    constexpr int W = kFragmentPacketWidth;
+
+    const uint32_t activeMask = packet.activeMask;
+    if (activeMask == 0) {
+        return;
+    }
+
+    // 无效通道统一填入安全值，避免未初始化数据产生 NaN 拖慢后续向量运算
+    float active[W];
+    float pX[W], pY[W], pZ[W];
+    float baseR[W], baseG[W], baseB[W], baseA[W];
+    float nX[W], nY[W], nZ[W];
+    for (int lane = 0; lane < W; ++lane) {
+        const bool on = packet.isActive(lane);
+        active[lane] = on ? 1.0f : 0.0f;
+        pX[lane] = on ? packet.posX[lane] : 0.0f;
+        pY[lane] = on ? packet.posY[lane] : 0.0f;
+        pZ[lane] = on ? packet.posZ[lane] : 0.0f;
+        baseR[lane] = on ? packet.r[lane] : 0.0f;
+        baseG[lane] = on ? packet.g[lane] : 0.0f;
+        baseB[lane] = on ? packet.b[lane] : 0.0f;
+        baseA[lane] = on ? packet.a[lane] : 0.0f;
+        nX[lane] = on ? packet.normalX[lane] : 0.0f;
+        nY[lane] = on ? packet.normalY[lane] : 0.0f;
+        nZ[lane] = on ? packet.normalZ[lane] : 1.0f;
+    }
+
+    // 漫反射贴图整包采样：导数每个三角形相同，mip 选择每包只做一次；无效通道用 (0, 0) 占位
+    if (material) {
+        static_assert(kFragmentPacketWidth == 8, "sampleAlbedo8 按 8 通道采样");
+        float texU[W], texV[W];
+        for (int lane = 0; lane < W; ++lane) {
+            const bool on = packet.isActive(lane);
+            texU[lane] = on ? packet.u[lane] : 0.0f;
+            texV[lane] = on ? packet.v[lane] : 0.0f;
+        }
+        Color albedo[W];
+        material->sampleAlbedo8(texU, texV, derivs.dudx, derivs.dudy, derivs.dvdx, derivs.dvdy, albedo);
+        for (int lane = 0; lane < W; ++lane) {
+            baseR[lane] *= albedo[lane].r;
+            baseG[lane] *= albedo[lane].g;
+            baseB[lane] *= albedo[lane].b;
+            baseA[lane] *= albedo[lane].a;
+        }
+    }
+
+    // 法线贴图是随机访问，逐通道标量执行
+
+    if (material && material->getNormalMap()) {
+        for (int lane = 0; lane < W; ++lane) {
+            if (!packet.isActive(lane)) {
+                continue;
+            }
+            Vector3 tangentSpaceNormal = material->sampleNormal(Vector2(packet.u[lane], packet.v[lane]));
+            Vector3 t = Vector3(packet.tangentX[lane], packet.tangentY[lane], packet.tangentZ[lane]).normalize();
+            Vector3 b = Vector3(packet.bitangentX[lane], packet.bitangentY[lane], packet.bitangentZ[lane]).normalize();
+            Vector3 n = Vector3(nX[lane], nY[lane], nZ[lane]).normalize();
+            Vector3 mapped = (t * tangentSpaceNormal.x + b * tangentSpaceNormal.y + n * tangentSpaceNormal.z).normalize();
+            nX[lane] = mapped.x;
+            nY[lane] = mapped.y;
+            nZ[lane] = mapped.z;
+        }
+    } else {
+        for (int lane = 0; lane < W; ++lane) {
+            const float lenSq = nX[lane] * nX[lane] + nY[lane] * nY[lane] + nZ[lane] * nZ[lane];
+            const float inv = lenSq > 0.0f ? 1.0f / std::sqrt(lenSq) : 0.0f;
+            nX[lane] *= inv;
+            nY[lane] *= inv;
+            nZ[lane] *= inv;
+        }
+    }
+
+    // 金属度-粗糙度材质逐通道走标量路径：纹理与法线已在上面解析，结果与 shade 一致
+    if (material && material->getShadingModel() == Core::Types::ShadingModel::MetallicRoughness) {
+        for (int lane = 0; lane < W; ++lane) {
+            if (!packet.isActive(lane)) {
+                continue;
+            }
+            const Color color = shadeSurface(Color(baseR[lane], baseG[lane], baseB[lane], baseA[lane]),
+                                             Vector3(nX[lane], nY[lane], nZ[lane]),
+                                             Vector3(pX[lane], pY[lane], pZ[lane]),
+                                             material, lights, selection, viewPos, sceneAmbient);
+            out.r[lane] = color.r;
+            out.g[lane] = color.g;
+            out.b[lane] = color.b;
+            out.a[lane] = color.a;
+        }
+        return;
+    }
+
+    float vX[W], vY[W], vZ[W];
+    for (int lane = 0; lane < W; ++lane) {
+        const float dx = viewPos.x - pX[lane];
+        const float dy = viewPos.y - pY[lane];
+        const float dz = viewPos.z - pZ[lane];
+        const float lenSq = dx * dx + dy * dy + dz * dz;
+        const float inv = lenSq > 0.0f ? 1.0f / std::sqrt(lenSq) : 0.0f;
+        vX[lane] = dx * inv;
+        vY[lane] = dy * inv;
+        vZ[lane] = dz * inv;
+    }
+
+    const float specPower = material ? material->getShininess() : 32.0f;
+
+    LaneLighting acc;
+    float* diffuseW = acc.diffuseW;
+    float* specularW = acc.specularW;
+
+    // 有阴影的光源只对受光通道查询阴影贴图
+    auto applyShadow = [&](const auto* shadow) {
+        if (!shadow) {
+            return;
+        }
+        for (int lane = 0; lane < W; ++lane) {
+            if (diffuseW[lane] > 0.0f) {
+                const float visibility = shadow->visibility(Vector3(pX[lane], pY[lane], pZ[lane]),
+                                                            Vector3(nX[lane], nY[lane], nZ[lane]));
+                diffuseW[lane] *= visibility;
+                specularW[lane] *= visibility;
+            }
+        }
+    };
+
+    const auto& directional = lights.directional();
+    for (std::size_t i = 0; i < directional.size(); ++i) {
+        const float lx = directional.dirX[i];
+        const float ly = directional.dirY[i];
+        const float lz = directional.dirZ[i];
+        for (int lane = 0; lane < W; ++lane) {
+            const float NdotLRaw = nX[lane] * lx + nY[lane] * ly + nZ[lane] * lz;
+            const float lit = NdotLRaw > 0.0f ? active[lane] : 0.0f;
+            const float hx = lx + vX[lane];
+            const float hy = ly + vY[lane];
+            const float hz = lz + vZ[lane];
+            const float hLenSq = hx * hx + hy * hy + hz * hz;
+            const float invHLen = hLenSq > 0.0f ? 1.0f / std::sqrt(hLenSq) : 0.0f;
+            const float NdotH = std::max(0.0f, (nX[lane] * hx + nY[lane] * hy + nZ[lane] * hz) * invHLen);
+            diffuseW[lane] = lit * NdotLRaw;
+            // pow 无法向量化，只对受光通道计算
+            specularW[lane] = lit > 0.0f ? lit * std::pow(NdotH, specPower) : 0.0f;
+        }
+        applyShadow(directional.shadow[i]);
+        acc.accumulate(directional.r[i], directional.g[i], directional.b[i]);
+    }
+
+    const auto& points = lights.points();
+    const std::size_t pointCount = selection.culled ? selection.pointCount : points.size();
+    for (std::size_t k = 0; k < pointCount; ++k) {
+        const std::size_t i = selection.culled ? selection.pointIndices[k] : k;
+        const float lightX = points.posX[i];
+        const float lightY = points.posY[i];
+        const float lightZ = points.posZ[i];
+        const float rangeSq = points.rangeSq[i];
+
+        // 整个包都在范围外时跳过该光源
+        float distSq[W];
+        float inRange[W];
+        float anyInRange = 0.0f;
+        for (int lane = 0; lane < W; ++lane) {
+            const float dx = lightX - pX[lane];
+            const float dy = lightY - pY[lane];
+            const float dz = lightZ - pZ[lane];
+            distSq[lane] = dx * dx + dy * dy + dz * dz;
+            inRange[lane] = distSq[lane] <= rangeSq ? active[lane] : 0.0f;
+            anyInRange += inRange[lane];
+        }
+        if (anyInRange == 0.0f) {
+            continue;
+        }
+
+        const float kc = points.constant[i];
+        const float kl = points.linear[i];
+        const float kq = points.quadratic[i];
+        for (int lane = 0; lane < W; ++lane) {
+            // 部分命中的包只计算范围内通道，sqrt/pow 不在范围外通道上浪费
+            if (inRange[lane] == 0.0f) {
+                diffuseW[lane] = 0.0f;
+                specularW[lane] = 0.0f;
+                continue;
+            }
+            const float dist = std::sqrt(distSq[lane]);
+            const float invDist = dist > 0.0f ? 1.0f / dist : 0.0f;
+            const float lx = (lightX - pX[lane]) * invDist;
+            const float ly = (lightY - pY[lane]) * invDist;
+            const float lz = (lightZ - pZ[lane]) * invDist;
+            const float NdotL = nX[lane] * lx + nY[lane] * ly + nZ[lane] * lz;
+            if (NdotL <= 0.0f) {
+                diffuseW[lane] = 0.0f;
+                specularW[lane] = 0.0f;
+                continue;
+            }
+            const float attenuation = std::min(1.0f, 1.0f / (kc + kl * dist + kq * distSq[lane]));
+
+            const float hx = lx + vX[lane];
+            const float hy = ly + vY[lane];
+            const float hz = lz + vZ[lane];
+            const float hLenSq = hx * hx + hy * hy + hz * hz;
+            const float invHLen = hLenSq > 0.0f ? 1.0f / std::sqrt(hLenSq) : 0.0f;
+            const float NdotH = std::max(0.0f, (nX[lane] * hx + nY[lane] * hy + nZ[lane] * hz) * invHLen);
+            diffuseW[lane] = attenuation * NdotL;
+            specularW[lane] = attenuation * std::pow(NdotH, specPower);
+        }
+        applyShadow(points.shadow[i]);
+        acc.accumulate(points.r[i], points.g[i], points.b[i]);
+    }
+
+    const auto& spots = lights.spots();
+    const std::size_t spotCount = selection.spotsCulled ? selection.spotCount : spots.size();
+    for (std::size_t k = 0; k < spotCount; ++k) {
+        const std::size_t i = selection.spotsCulled ? selection.spotIndices[k] : k;
+        const float lightX = spots.posX[i];
+        const float lightY = spots.posY[i];
+        const float lightZ = spots.posZ[i];
+        const float axisX = spots.dirX[i];
+        const float axisY = spots.dirY[i];
+        const float axisZ = spots.dirZ[i];
+        const float rangeSq = spots.rangeSq[i];
+        const float cosOuter = spots.cosOuter[i];
+        const float cosOuterSq = cosOuter * cosOuter;
+
+        // 范围与外锥一起判定；外锥半角小于 90°（cosOuter > 0），落在锥内等价于
+        // axial > 0 且 axial² > cosOuter²·dist²，无需开方
+        float distSq[W];
+        float inCone[W];
+        float anyInCone = 0.0f;
+        for (int lane = 0; lane < W; ++lane) {
+            const float dx = lightX - pX[lane];
+            const float dy = lightY - pY[lane];
+            const float dz = lightZ - pZ[lane];
+            distSq[lane] = dx * dx + dy * dy + dz * dz;
+            const float axial = -(dx * axisX + dy * axisY + dz * axisZ);
+            const bool inside = distSq[lane] <= rangeSq &&
+                                axial > 0.0f && axial * axial > cosOuterSq * distSq[lane];
+            inCone[lane] = inside ? active[lane] : 0.0f;
+            anyInCone += inCone[lane];
+        }
+        if (anyInCone == 0.0f) {
+            continue;
+        }
+
+        const float invConeDelta = spots.invConeDelta[i];
+        const float kc = spots.constant[i];
+        const float kl = spots.linear[i];
+        const float kq = spots.quadratic[i];
+        for (int lane = 0; lane < W; ++lane) {
+            if (inCone[lane] == 0.0f) {
+                diffuseW[lane] = 0.0f;
+                specularW[lane] = 0.0f;
+                continue;
+            }
+            const float dist = std::sqrt(distSq[lane]);
+            const float invDist = dist > 0.0f ? 1.0f / dist : 0.0f;
+            const float lx = (lightX - pX[lane]) * invDist;
+            const float ly = (lightY - pY[lane]) * invDist;
+            const float lz = (lightZ - pZ[lane]) * invDist;
+            const float cosAngle = -(lx * axisX + ly * axisY + lz * axisZ);
+            const float NdotL = nX[lane] * lx + nY[lane] * ly + nZ[lane] * lz;
+            if (NdotL <= 0.0f || cosAngle <= cosOuter) {
+                diffuseW[lane] = 0.0f;
+                specularW[lane] = 0.0f;
+                continue;
+            }
+            const float t = std::clamp((cosAngle - cosOuter) * invConeDelta, 0.0f, 1.0f);
+            const float attenuation = t * t * (3.0f - 2.0f * t) *
+                                      std::min(1.0f, 1.0f / (kc + kl * dist + kq * distSq[lane]));
+
+            const float hx = lx + vX[lane];
+            const float hy = ly + vY[lane];
+            const float hz = lz + vZ[lane];
+            const float hLenSq = hx * hx + hy * hy + hz * hz;
+            const float invHLen = hLenSq > 0.0f ? 1.0f / std::sqrt(hLenSq) : 0.0f;
+            const float NdotH = std::max(0.0f, (nX[lane] * hx + nY[lane] * hy + nZ[lane] * hz) * invHLen);
+            diffuseW[lane] = attenuation * NdotL;
+            specularW[lane] = attenuation * std::pow(NdotH, specPower);
+        }
+        acc.accumulate(spots.r[i], spots.g[i], spots.b[i]);
+    }
+
+    // 自定义光源走虚接口，逐通道标量
+    for (Renderer::Lighting::Light* light : lights.others()) {
+        const Color& color = light->getColor();
+        for (int lane = 0; lane < W; ++lane) {
+            diffuseW[lane] = 0.0f;
+            specularW[lane] = 0.0f;
+            if (!packet.isActive(lane)) {
+                continue;
+            }
+            const Vector3 P(pX[lane], pY[lane], pZ[lane]);
+            const Vector3 N(nX[lane], nY[lane], nZ[lane]);
+            if (!light->isVisible(P)) {
+                continue;
+            }
+            const float attenuation = light->getAttenuation(P);
+            if (attenuation <= 0.0f) {
+                continue;
+            }
+            Vector3 lightDir = light->getDirection(P).normalize();
+            const float NdotL = N.dot(lightDir);
+            if (NdotL <= 0.0f) {
+                continue;
+            }
+            Vector3 halfVector = (lightDir + Vector3(vX[lane], vY[lane], vZ[lane])).normalize();
+            const float NdotH = std::max(0.0f, N.dot(halfVector));
+            const float scale = light->getIntensity() * attenuation;
+            diffuseW[lane] = scale * NdotL;
+            specularW[lane] = scale * std::pow(NdotH, specPower);
+        }
+        acc.accumulate(color.r, color.g, color.b);
+    }
+
+    const Color specularColor = material ? material->getSpecular() : Color(1.0f, 1.0f, 1.0f, 1.0f);
+    const bool fresnelEnabled = m_settings.enableFresnel;
+    const float f0R = material ? specularColor.r : m_settings.fresnelF0;
+    const float f0G = material ? specularColor.g : m_settings.fresnelF0;
+    const float f0B = material ? specularColor.b : m_settings.fresnelF0;
+
+    float ambientR[W], ambientG[W], ambientB[W];
+    if (const Renderer::Lighting::SHIrradiance* environment = lights.environment()) {
+        for (int lane = 0; lane < W; ++lane) {
+            environment->evaluate(nX[lane], nY[lane], nZ[lane], ambientR[lane], ambientG[lane], ambientB[lane]);
+        }
+    } else {
+        for (int lane = 0; lane < W; ++lane) {
+            ambientR[lane] = sceneAmbient.r;
+            ambientG[lane] = sceneAmbient.g;
+            ambientB[lane] = sceneAmbient.b;
+        }
+    }
+
+    for (int lane = 0; lane < W; ++lane) {
+        float ksR = specularColor.r;
+        float ksG = specularColor.g;
+        float ksB = specularColor.b;
+        if (fresnelEnabled) {
+            const float fresnel = schlickWeight(nX[lane] * vX[lane] + nY[lane] * vY[lane] + nZ[lane] * vZ[lane]);
+            ksR = f0R + (1.0f - f0R) * fresnel;
+            ksG = f0G + (1.0f - f0G) * fresnel;
+            ksB = f0B + (1.0f - f0B) * fresnel;
+        }
+
+        const float baseAlpha = std::clamp(baseA[lane], 0.0f, 1.0f);
+        const float diffuseR = std::clamp(ambientR[lane] * baseR[lane] + baseR[lane] * acc.irrR[lane], 0.0f, 1.0f);
+        const float diffuseG = std::clamp(ambientG[lane] * baseG[lane] + baseG[lane] * acc.irrG[lane], 0.0f, 1.0f);
+        const float diffuseB = std::clamp(ambientB[lane] * baseB[lane] + baseB[lane] * acc.irrB[lane], 0.0f, 1.0f);
+        const float specularR = std::clamp(acc.specR[lane] * ksR, 0.0f, 1.0f);
+        const float specularG = std::clamp(acc.specG[lane] * ksG, 0.0f, 1.0f);
+        const float specularB = std::clamp(acc.specB[lane] * ksB, 0.0f, 1.0f);
+
+        out.r[lane] = std::clamp(diffuseR * baseAlpha + specularR, 0.0f, 1.0f);
+        out.g[lane] = std::clamp(diffuseG * baseAlpha + specularG, 0.0f, 1.0f);
+        out.b[lane] = std::clamp(diffuseB * baseAlpha + specularB, 0.0f, 1.0f);
+        out.a[lane] = baseAlpha;
+    }
+}
+
 } // namespace Pipeline
 } // namespace Renderer
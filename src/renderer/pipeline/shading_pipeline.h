@@ -4,6 +4,9 @@
 #include <vector>
 
 #include "screen_vertex.h"
+#include "fragment_packet.h"
+#include "../lighting/brdf_lut.h"
+#include "../lighting/light_buffer.h"
 #include "../../core/types/color.h"
 
 namespace Core {
@@ -16,9 +19,6 @@ struct Vector3;
 }
 
 namespace Renderer {
-namespace Lighting {
-class Light;
-}
 namespace Pipeline {
 
 struct SoftwareRendererSettings;
@@ -29,13 +29,86 @@ public:
 
     Core::Types::Color shade(const GeometryVertex& interpolated,
                              Core::Types::Material* material,
-                             const std::vector<Renderer::Lighting::Light*>& lights,
+                             const Renderer::Lighting::LightBuffer& lights,
+                             const Renderer::Lighting::LightSelection& selection,
                              const Core::Math::Vector3& viewPos,
                              const Core::Types::Color& sceneAmbient,
                              const RasterDerivatives& derivs) const;
 
+    /**
+     * @brief 解析片元的表面属性：基础色（顶点色 × 漫反射贴图/颜色）与单位法线（含法线贴图）
+     *
+     * shade 的前半部分；延迟着色的几何阶段用它填充 G-buffer。
+     */
+    void resolveSurface(const GeometryVertex& interpolated,
+                        Core::Types::Material* material,
+                        const RasterDerivatives& derivs,
+                        Core::Types::Color& baseColor,
+                        Core::Math::Vector3& normal) const;
+
+    /**
+     * @brief 基础色与单位法线已确定后的光照计算
+     *
+     * shade、shadeVertex 与延迟着色的光照阶段共用；
+     * lights 带球谐环境光时环境项按法线求值，sceneAmbient 不参与。
+     * 金属度-粗糙度材质改用 GGX 模型（见 shadeMetallicRoughness）。
+     */
+    Core::Types::Color shadeSurface(const Core::Types::Color& baseColor,
+                                    const Core::Math::Vector3& normal,
+                                    const Core::Math::Vector3& position,
+                                    Core::Types::Material* material,
+                                    const Renderer::Lighting::LightBuffer& lights,
+                                    const Renderer::Lighting::LightSelection& selection,
+                                    const Core::Math::Vector3& viewPos,
+                                    const Core::Types::Color& sceneAmbient) const;
+
+    /**
+     * @brief 逐顶点光照：在顶点上计算一次 Blinn-Phong，供 Gouraud 插值使用
+     *
+     * 不做法线贴图；材质有漫反射贴图时基础色只取顶点色，贴图在光栅化阶段乘到插值后的颜色上。
+     * 所有光源都参与（不经过分簇剔除）。
+     */
+    Core::Types::Color shadeVertex(const GeometryVertex& vertex,
+                                   Core::Types::Material* material,
+                                   const Renderer::Lighting::LightBuffer& lights,
+                                   const Core::Math::Vector3& viewPos,
+                                   const Core::Types::Color& sceneAmbient) const;
+
+    /**
+     * @brief 批量着色：一次处理 kFragmentPacketWidth 个片元（SoA）
+     *
+     * 光照循环以光源为外层、通道为内层，内层在定长数组上逐通道运算，sqrt/pow 只对受光通道计算；
+     * 与逐个调用 shade 相比仅浮点运算顺序不同，各通道颜色分量相差不超过 1e-5。
+     * 只有 activeMask 中的通道结果有意义，其余通道输出为有限值但内容未定义。
+     * 包内所有片元共用同一个光源子集 selection。
+     */
+    void shadeBatch(const FragmentPacket& packet,
+                    Core::Types::Material* material,
+                    const Renderer::Lighting::LightBuffer& lights,
+                    const Renderer::Lighting::LightSelection& selection,
+                    const Core::Math::Vector3& viewPos,
+                    const Core::Types::Color& sceneAmbient,
+                    const RasterDerivatives& derivs,
+                    ColorPacket& out) const;
+
 private:
+    /**
+     * @brief 金属度-粗糙度材质：Cook-Torrance GGX 直接光 + split-sum 环境镜面项
+     *
+     * 直接光与 Blinn-Phong 共用光源遍历，逐光源多一次 LdotH 与两次开方，省去 pow；
+     * 环境镜面项查预计算的 DFG 表。
+     */
+    Core::Types::Color shadeMetallicRoughness(const Core::Types::Color& baseColor,
+                                              const Core::Math::Vector3& normal,
+                                              const Core::Math::Vector3& position,
+                                              const Core::Math::Vector3& viewDir,
+                                              const Core::Types::Material& material,
+                                              const Renderer::Lighting::LightBuffer& lights,
+                                              const Renderer::Lighting::LightSelection& selection,
+                                              const Core::Types::Color& sceneAmbient) const;
+
     const SoftwareRendererSettings& m_settings;
+    const Renderer::Lighting::BrdfLut& m_brdfLut;
 };
 
 } // namespace Pipeline
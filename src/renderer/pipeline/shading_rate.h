@@ -0,0 +1,58 @@
+#ifndef RENDERER_PIPELINE_SHADING_RATE_H
+#define RENDERER_PIPELINE_SHADING_RATE_H
+
+#include <algorithm>
+#include <vector>
+
+#include "../../core/types/material.h"
+
+namespace Renderer {
+namespace Pipeline {
+
+// 着色块边长（像素）；Inherit 视为 1
+inline int shadingRateSize(Core::Types::ShadingRate rate) {
+    switch (rate) {
+        case Core::Types::ShadingRate::Rate2x2:
+            return 2;
+        case Core::Types::ShadingRate::Rate4x4:
+            return 4;
+        default:
+            return 1;
+    }
+}
+
+/**
+ * @brief 屏幕空间着色率图
+ *
+ * 把整帧均分为 tilesX × tilesY 个区域，每个区域指定一个着色率；坐标按帧宽高归一化，
+ * 因此与 SSAA 倍数无关。与材质着色率组合时取较粗的一个。
+ */
+struct ShadingRateImage {
+    int tilesX = 0;
+    int tilesY = 0;
+    std::vector<Core::Types::ShadingRate> rates; // 行优先，大小为 tilesX * tilesY
+
+    bool empty() const { return tilesX <= 0 || tilesY <= 0 || rates.empty(); }
+
+    void resize(int x, int y, Core::Types::ShadingRate rate = Core::Types::ShadingRate::Rate1x1) {
+        tilesX = std::max(0, x);
+        tilesY = std::max(0, y);
+        rates.assign(static_cast<std::size_t>(tilesX) * static_cast<std::size_t>(tilesY), rate);
+    }
+
+    void set(int tx, int ty, Core::Types::ShadingRate rate) {
+        rates[static_cast<std::size_t>(ty) * static_cast<std::size_t>(tilesX) + static_cast<std::size_t>(tx)] = rate;
+    }
+
+    // u, v 为 [0, 1) 的归一化屏幕坐标
+    Core::Types::ShadingRate rateAt(float u, float v) const {
+        const int tx = std::clamp(static_cast<int>(u * static_cast<float>(tilesX)), 0, tilesX - 1);
+        const int ty = std::clamp(static_cast<int>(v * static_cast<float>(tilesY)), 0, tilesY - 1);
+        return rates[static_cast<std::size_t>(ty) * static_cast<std::size_t>(tilesX) + static_cast<std::size_t>(tx)];
+    }
+};
+
+} // namespace Pipeline
+} // namespace Renderer
+
+#endif // RENDERER_PIPELINE_SHADING_RATE_H
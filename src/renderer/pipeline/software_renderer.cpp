@@ -2,20 +2,21 @@
 
 #include <algorithm>
 #include <cmath>
+#include <fstream>
 
 #include "geometry_processor.h"
+#include "programmable_renderer.h"
 #include "render_queue.h"
 #include "shading_pipeline.h"
-#include "triangle_rasterizer.h"
-#include "screen_vertex.h"
 #include "../effects/ssaa.h"
+#include "../effects/fxaa.h"
+#include "../../core/platform/parallel.h"
 #include "../../core/types/material.h"
 #include "../../renderer/lighting/light.h"
 
 namespace Renderer {
 namespace Pipeline {
 
-using Core::Math::Vector2;
 using Core::Math::Vector3;
 using Core::Math::Vector4;
 using Core::Math::Matrix4;
@@ -23,197 +24,219 @@ using Core::Types::Color;
 
 namespace {
 
-RasterDerivatives computeRasterDerivatives(const ScreenVertex& v0,
-                                           const ScreenVertex& v1,
-                                           const ScreenVertex& v2) {
-    float x0 = v0.screenX;
-    float y0 = v0.screenY;
-    float x1 = v1.screenX;
-    float y1 = v1.screenY;
-    float x2 = v2.screenX;
-    float y2 = v2.screenY;
-
-    float det = (x1 - x0) * (y2 - y0) - (x2 - x0) * (y1 - y0);
-    if (std::fabs(det) < 1e-6f) {
-        return {0.0f, 0.0f, 0.0f, 0.0f};
-    }
-
-    RasterDerivatives derivs{};
-    Vector2 uv0 = v0.attributes.texCoord;
-    Vector2 uv1 = v1.attributes.texCoord;
-    Vector2 uv2 = v2.attributes.texCoord;
-
-    derivs.dudx = ((uv1.x - uv0.x) * (y2 - y0) - (uv2.x - uv0.x) * (y1 - y0)) / det;
-    derivs.dudy = (-(uv1.x - uv0.x) * (x2 - x0) + (uv2.x - uv0.x) * (x1 - x0)) / det;
-    derivs.dvdx = ((uv1.y - uv0.y) * (y2 - y0) - (uv2.y - uv0.y) * (y1 - y0)) / det;
-    derivs.dvdy = (-(uv1.y - uv0.y) * (x2 - x0) + (uv2.y - uv0.y) * (x1 - x0)) / det;
-    return derivs;
-}
-
-bool assemblePrimitive(const SoftwareRendererSettings& settings,
-                       const ScreenVertex& v0,
-                       const ScreenVertex& v1,
-                       const ScreenVertex& v2,
-                       const Vector3& cameraPos,
-                       Vector3& faceNormal,
-                       bool applyCulling) {
-    Vector3 p0 = v0.attributes.worldPosition;
-    Vector3 p1 = v1.attributes.worldPosition;
-    Vector3 p2 = v2.attributes.worldPosition;
-    faceNormal = (p1 - p0).cross(p2 - p0);
-    if (faceNormal.lengthSquared() < 1e-8f) {
+// 模型包围盒变换到世界空间后的外接球；包围盒为空时返回 false
+bool worldBoundingSphere(const Scene::SceneObject& object, Vector3& center, float& radius) {
+    const Scene::BoundingBox& box = object.mesh->getBoundingBox();
+    if (box.min.x > box.max.x || box.min.y > box.max.y || box.min.z > box.max.z) {
         return false;
     }
-    faceNormal = faceNormal.normalize();
-
-    if (applyCulling && settings.backfaceCulling) {
-        Vector3 viewDir = (cameraPos - p0).normalize();
-        if (faceNormal.dot(viewDir) <= 0.0f) {
-            return false;
-        }
+    center = object.transform.transformPoint(box.getCenter());
+    float radiusSq = 0.0f;
+    for (int corner = 0; corner < 8; ++corner) {
+        const Vector3 local((corner & 1) ? box.max.x : box.min.x,
+                            (corner & 2) ? box.max.y : box.min.y,
+                            (corner & 4) ? box.max.z : box.min.z);
+        radiusSq = std::max(radiusSq, (object.transform.transformPoint(local) - center).lengthSquared());
     }
-
+    radius = std::sqrt(radiusSq);
     return true;
 }
 
 } // namespace
 
-SoftwareRenderer::SoftwareRenderer(const SoftwareRendererSettings& settings)
+SoftwareRendererBase::SoftwareRendererBase(const SoftwareRendererSettings& settings)
     : m_settings(settings), m_target(settings.width, settings.height) {}
 
-void SoftwareRenderer::setSettings(const SoftwareRendererSettings& settings) {
+void SoftwareRendererBase::setSettings(const SoftwareRendererSettings& settings) {
     m_settings = settings;
     m_target.resize(m_settings.width, m_settings.height);
 }
 
-void SoftwareRenderer::render(const Scene::Scene& scene) {
-    Scene::Camera* camera = scene.getCamera();
-    if (!camera) {
-        return;
+Core::Types::LightingFrequency SoftwareRendererBase::resolveLightingFrequency(const Scene::SceneObject& object,
+                                                                              const Core::Types::Material* material) const {
+    using Core::Types::LightingFrequency;
+    if (object.lightingFrequency != LightingFrequency::Inherit) {
+        return object.lightingFrequency;
     }
-
-    // 处理 SSAA：当 ssaaFactor > 1 时，临时使用更高分辨率渲染
-    const int ssaaFactor = std::max(1, m_settings.ssaaFactor);
-    const int baseWidth = m_settings.width;
-    const int baseHeight = m_settings.height;
-    if (ssaaFactor > 1) {
-        // 切换到高分辨率设置
-        m_settings.width = baseWidth * ssaaFactor;
-        m_settings.height = baseHeight * ssaaFactor;
+    if (material && material->getLightingFrequency() != LightingFrequency::Inherit) {
+        return material->getLightingFrequency();
     }
-
-    if (m_target.getWidth() != m_settings.width || m_target.getHeight() != m_settings.height) {
-        m_target.resize(m_settings.width, m_settings.height);
+    if (m_settings.lightingFrequency != LightingFrequency::Inherit) {
+        return m_settings.lightingFrequency;
     }
+    return LightingFrequency::PerPixel;
+}
 
-    m_target.clear(scene.getBackgroundColor(), 1.0f);
-
-    const Matrix4 viewMatrix = camera->getViewMatrix();
-    const Matrix4 projectionMatrix = camera->getProjectionMatrix();
-    const Vector3 cameraPosition = camera->getPosition();
-
-    const auto& objects = scene.getObjects();
-    const auto& lights = scene.getLights();
-
-    GeometryProcessor geometryProcessor(m_settings);
-    ShadingPipeline shadingPipeline(m_settings);
-    RenderQueue renderQueue;
-    TriangleRasterizer rasterizer(m_target, m_settings);
-
-    for (const auto& object : objects) {
-        if (!object.visible || !object.mesh) {
-            continue;
-        }
-
-        Scene::Mesh* mesh = object.mesh;
-        Core::Types::Material* material = object.materialOverride ? object.materialOverride : mesh->getMaterial();
-        const auto& vertices = mesh->getVertices();
-        const auto& indices = mesh->getIndices();
-        if (vertices.empty() || indices.size() < 3) {
-            continue;
+void SoftwareRendererBase::cullSpotLights(const Scene::SceneObject& object, DrawState& state) {
+    const auto& spots = m_lightBuffer.spots();
+    Vector3 boundCenter;
+    float boundRadius = 0.0f;
+    if (spots.size() == 0 || !worldBoundingSphere(object, boundCenter, boundRadius)) {
+        return;
+    }
+    uint32_t* indicesForObject = m_frameArena.allocateArray<uint32_t>(spots.size());
+    for (std::size_t k = 0; k < spots.size(); ++k) {
+        if (spots.source[k]->intersectsSphere(boundCenter, boundRadius)) {
+            indicesForObject[state.spotCount++] = static_cast<uint32_t>(k);
         }
+    }
+    state.spotsCulled = true;
+    state.spotIndices = indicesForObject;
+}
 
-        std::vector<ScreenVertex> transformed = geometryProcessor.process(object, viewMatrix, projectionMatrix);
-
-        for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
-            uint32_t i0 = indices[i];
-            uint32_t i1 = indices[i + 1];
-            uint32_t i2 = indices[i + 2];
-
-            const ScreenVertex& v0 = transformed[i0];
-            const ScreenVertex& v1 = transformed[i1];
-            const ScreenVertex& v2 = transformed[i2];
-
-            if (!v0.valid || !v1.valid || !v2.valid) {
-                continue;
-            }
+bool SoftwareRendererBase::assemblePrimitive(const ScreenVertex& v0,
+                                             const ScreenVertex& v1,
+                                             const ScreenVertex& v2,
+                                             const Vector3& cameraPosition,
+                                             bool opaque) const {
+    Vector3 p0 = v0.attributes.worldPosition;
+    Vector3 p1 = v1.attributes.worldPosition;
+    Vector3 p2 = v2.attributes.worldPosition;
+    Vector3 faceNormal = (p1 - p0).cross(p2 - p0);
+    if (faceNormal.lengthSquared() < 1e-8f) {
+        return false;
+    }
+    faceNormal = faceNormal.normalize();
 
-            Vector3 faceNormal;
-            // 先根据顶点与材质alpha判断是否透明，再决定是否进行背面剔除
-            float triVertexAlpha = (v0.attributes.color.a + v1.attributes.color.a + v2.attributes.color.a) / 3.0f;
-            float triMaterialAlpha = material ? material->getDiffuse().a : 1.0f;
-            float effectiveAlpha = triVertexAlpha * triMaterialAlpha;
+    // 只有不透明三角形做背面剔除：半透明物体的背面透过正面可见
+    if (opaque && m_settings.backfaceCulling) {
+        Vector3 viewDir = (cameraPosition - p0).normalize();
+        if (faceNormal.dot(viewDir) <= 0.0f) {
+            return false;
+        }
+    }
 
-            if (!assemblePrimitive(m_settings, v0, v1, v2, cameraPosition, faceNormal, effectiveAlpha >= 0.999f)) {
-                continue;
-            }
+    // 导数在光栅化时重新计算，这里只剔除无法计算的三角形
+    const RasterDerivatives derivs = GeometryProcessor::rasterDerivatives(v0, v1, v2);
+    return std::isfinite(derivs.dudx) && std::isfinite(derivs.dudy) &&
+           std::isfinite(derivs.dvdx) && std::isfinite(derivs.dvdy);
+}
 
-            RasterDerivatives derivs = computeRasterDerivatives(v0, v1, v2);
-            if (!std::isfinite(derivs.dudx) || !std::isfinite(derivs.dudy) ||
-                !std::isfinite(derivs.dvdx) || !std::isfinite(derivs.dvdy)) {
-                continue;
-            }
+void SoftwareRendererBase::prepareLights(const Scene::Scene& scene) {
+    m_shadowCache.update(scene.getLights(), scene.getObjects(), m_settings.shadows);
+    m_lightBuffer.build(scene.getLights(), &m_shadowCache);
+    // 环境来源不变时 getIrradiance 直接返回缓存的系数
+    Renderer::Lighting::EnvironmentLight* environment = scene.getEnvironment();
+    m_lightBuffer.setEnvironment(environment ? &environment->getIrradiance() : nullptr);
+}
 
-            float depthKey = (v0.ndcZ + v1.ndcZ + v2.ndcZ) / 3.0f;
+const Renderer::Lighting::LightCuller* SoftwareRendererBase::prepareLightCulling(const Scene::Scene& scene,
+                                                                                const Matrix4& viewMatrix,
+                                                                                const Matrix4& projectionMatrix) {
+    // 深度切片依赖裁剪坐标 w 等于视空间深度，正交投影下退回逐片元遍历全部光源
+    const bool perspective = projectionMatrix.m[14] != 0.0f;
+    if ((!m_settings.clusteredLighting && !m_settings.deferredShading) || !perspective) {
+        return nullptr;
+    }
+    const Scene::Camera* camera = scene.getCamera();
+    // 簇按当前光栅化分辨率（SSAA 时为高分辨率）划分，与片元的屏幕坐标一致
+    m_lightCuller.build(m_lightBuffer, viewMatrix, projectionMatrix,
+                        m_settings.width, m_settings.height,
+                        camera->getNear(), camera->getFar(),
+                        m_settings.lightTileSize, m_settings.lightDepthSlices);
+    return &m_lightCuller;
+}
 
-            TriangleWorkItem item{};
-            item.v0 = v0;
-            item.v1 = v1;
-            item.v2 = v2;
-            item.material = material;
-            item.derivs = derivs;
-            item.depthKey = depthKey;
+ShaderUniforms SoftwareRendererBase::frameUniforms(const Scene::Scene& scene, const ShadingPipeline& shading) const {
+    const Scene::Camera* camera = scene.getCamera();
+    ShaderUniforms uniforms;
+    uniforms.view = camera->getViewMatrix();
+    uniforms.projection = camera->getProjectionMatrix();
+    uniforms.cameraPosition = camera->getPosition();
+    uniforms.lights = &m_lightBuffer;
+    uniforms.ambientLight = scene.getAmbientLight();
+    uniforms.shading = &shading;
+    return uniforms;
+}
 
-            if (effectiveAlpha >= 0.999f) {
-                renderQueue.addOpaque(item);
-            } else {
-                renderQueue.addTransparent(item);
+void SoftwareRendererBase::shadeGBuffer(const ShadingPipeline& shading,
+                                        const Renderer::Lighting::LightCuller* culler,
+                                        const Vector3& cameraPosition,
+                                        const Color& ambientLight) {
+    const int width = m_gbuffer.width;
+    const int height = m_gbuffer.height;
+    const int tileSize = std::max(1, m_settings.lightTileSize);
+    const int tilesX = (width + tileSize - 1) / tileSize;
+    const int tilesY = (height + tileSize - 1) / tileSize;
+    const int tileCount = tilesX * tilesY;
+    // 每个 tile 都会写入自己的计数，不需要清零
+    uint64_t* tileInvocations = m_frameArena.allocateArray<uint64_t>(static_cast<std::size_t>(tileCount));
+
+    // 按光源簇的屏幕 tile 划分任务：同一 tile 内的像素大多命中同一组簇，且各 tile 写入互不重叠
+    Core::Platform::parallelFor(0, tileCount, [&](int tileBegin, int tileEnd) {
+        for (int tile = tileBegin; tile < tileEnd; ++tile) {
+            const int x0 = (tile % tilesX) * tileSize;
+            const int y0 = (tile / tilesX) * tileSize;
+            const int x1 = std::min(x0 + tileSize, width);
+            const int y1 = std::min(y0 + tileSize, height);
+            uint64_t invocations = 0;
+            for (int y = y0; y < y1; ++y) {
+                for (int x = x0; x < x1; ++x) {
+                    const std::size_t i = m_gbuffer.index(x, y);
+                    const uint8_t flags = m_gbuffer.flags[i];
+                    if (!(flags & GBuffer::kCovered)) {
+                        continue;
+                    }
+                    Color shaded(m_gbuffer.albedoR[i], m_gbuffer.albedoG[i], m_gbuffer.albedoB[i], m_gbuffer.albedoA[i]);
+                    if (!(flags & GBuffer::kPreLit)) {
+                        const Renderer::Lighting::LightSelection selection = culler
+                            ? culler->getLights(x, y, m_gbuffer.viewDepth[i])
+                            : Renderer::Lighting::LightSelection();
+                        shaded = shading.shadeSurface(shaded,
+                                                      decodeOctahedral(m_gbuffer.normalU[i], m_gbuffer.normalV[i]),
+                                                      Vector3(m_gbuffer.posX[i], m_gbuffer.posY[i], m_gbuffer.posZ[i]),
+                                                      m_gbuffer.materials[m_gbuffer.materialIndex[i]],
+                                                      m_lightBuffer,
+                                                      selection,
+                                                      cameraPosition,
+                                                      ambientLight);
+                        ++invocations;
+                    }
+                    // 与前向路径相同的预乘 alpha 合成，背景即清屏颜色
+                    const Color dst = m_target.getPixel(x, y);
+                    const float srcA = std::clamp(shaded.a, 0.0f, 1.0f);
+                    m_target.setPixel(x, y, Color(shaded.r + dst.r * (1.0f - srcA),
+                                                  shaded.g + dst.g * (1.0f - srcA),
+                                                  shaded.b + dst.b * (1.0f - srcA),
+                                                  srcA + dst.a * (1.0f - srcA)));
+                }
             }
+            tileInvocations[tile] = invocations;
         }
-    }
+    }, 1);
 
-    renderQueue.finalize();
-
-    for (const auto& tri : renderQueue.getOpaque()) {
-        rasterizer.rasterize(tri,
-                             tri.material,
-                             lights,
-                             cameraPosition,
-                             scene.getAmbientLight(),
-                             shadingPipeline);
+    for (int tile = 0; tile < tileCount; ++tile) {
+        m_stats.shadeInvocations += tileInvocations[tile];
     }
+}
 
-    for (const auto& tri : renderQueue.getTransparent()) {
-        rasterizer.rasterize(tri,
-                             tri.material,
-                             lights,
-                             cameraPosition,
-                             scene.getAmbientLight(),
-                             shadingPipeline);
+void SoftwareRendererBase::applyPostProcessing() {
+    // 后处理链不在这里就地执行，而是推迟到 encodeOutput 与量化融合成一趟
+    if (m_settings.aaMode == AntiAliasingMode::FXAA) {
+        Renderer::Effects::applyFxaa(m_target, m_settings.fxaa, m_fxaaWorkspace);
     }
+}
+
+void SoftwareRendererBase::encodeOutput(std::vector<uint8_t>& out, bool includeAlpha) const {
+    m_settings.postProcess.encode(m_target, out, includeAlpha);
+}
 
-    // 若使用了 SSAA，则在渲染后进行低通+下采样回基准分辨率
-    if (ssaaFactor > 1) {
-        Renderer::Pipeline::RenderTarget lowRes(baseWidth, baseHeight);
-        lowRes.clear(scene.getBackgroundColor(), 1.0f);
-        Renderer::Effects::resolveBox(m_target, lowRes, ssaaFactor);
-        // 覆盖为低分辨率结果
-        m_target = lowRes;
-        // 恢复设置
-        m_settings.width = baseWidth;
-        m_settings.height = baseHeight;
+bool SoftwareRendererBase::savePPM(const std::string& filename) const {
+    if (m_target.getWidth() == 0 || m_target.getHeight() == 0) {
+        return false;
     }
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::vector<uint8_t> pixels;
+    encodeOutput(pixels, false);
+    file << "P6\n" << m_target.getWidth() << " " << m_target.getHeight() << "\n255\n";
+    file.write(reinterpret_cast<const char*>(pixels.data()), static_cast<std::streamsize>(pixels.size()));
+    return static_cast<bool>(file);
 }
 
+template class BasicSoftwareRenderer<BlinnPhongVertexShader, BlinnPhongFragmentShader>;
+
 } // namespace Pipeline
 } // namespace Renderer
@@ -1,41 +1,192 @@
 #ifndef RENDERER_PIPELINE_SOFTWARE_RENDERER_H
 #define RENDERER_PIPELINE_SOFTWARE_RENDERER_H
 
+#include "gbuffer.h"
 #include "render_target.h"
+#include "screen_vertex.h"
+#include "shader_interface.h"
+#include "shading_rate.h"
+#include "../effects/fxaa.h"
+#include "../effects/post_process.h"
+#include "../lighting/light_buffer.h"
+#include "../lighting/light_culling.h"
+#include "../lighting/shadow_map.h"
 #include "../../scene/scene.h"
 #include "../../scene/camera.h"
+#include "../../core/platform/frame_arena.h"
+#include <cstdint>
+#include <string>
+#include <type_traits>
 #include <vector>
 
 namespace Renderer {
 namespace Pipeline {
 
+template <typename Varyings>
+class BasicRenderQueue;
+class ShadingPipeline;
+struct DrawState;
+
+enum class AntiAliasingMode {
+    None,
+    SSAA, // 超采样，倍数由 ssaaFactor 决定
+    FXAA  // 基于亮度的后处理抗锯齿，几乎不增加光栅化开销
+};
+
 struct SoftwareRendererSettings {
     int width = 800;
     int height = 600;
     bool perspectiveCorrect = true;
     bool backfaceCulling = true;
-    int ssaaFactor = 1; // 1表示关闭；2=2xSSAA，3=3xSSAA，4=4xSSAA
+    AntiAliasingMode aaMode = AntiAliasingMode::SSAA;
+    int ssaaFactor = 1; // 1表示关闭；2=2xSSAA，3=3xSSAA，4=4xSSAA（仅 aaMode == SSAA 时生效）
+    int ssaaTileSize = 0; // SSAA 分块边长（输出像素）；0 表示整帧渲染高分辨率缓冲，>0 时逐块渲染并立即 resolve
+    bool packetShading = true; // 光栅化按 kFragmentPacketWidth 个片元一组调用 ShadingPipeline::shadeBatch；false 时逐片元调用 shade
+    Core::Types::LightingFrequency lightingFrequency = Core::Types::LightingFrequency::PerPixel; // 物体与材质都为 Inherit 时使用
+    float vertexLightingAreaThreshold = 8.0f; // Auto：物体三角形平均投影面积（光栅化像素²）低于该值时改为逐顶点光照
+    Core::Types::ShadingRate shadingRate = Core::Types::ShadingRate::Rate1x1; // 材质为 Inherit 时的着色率
+    ShadingRateImage shadingRateImage; // 屏幕空间着色率图，为空则不使用；与材质着色率取较粗者
     bool enableFresnel = false; // 启用基于Schlick近似的菲涅尔反射
     float fresnelF0 = 0.04f; // 无材质高光时的默认法线入射反射率
+    bool clusteredLighting = false; // 分簇光源剔除：片元只遍历覆盖其 (tile, 深度切片) 的点光源，适合大量局部光源的场景
+    int lightTileSize = 32; // 光源簇的屏幕 tile 边长（光栅化分辨率下的像素）
+    int lightDepthSlices = 16; // 光源簇在 [near, far] 间按指数分布的深度切片数
+    bool deferredShading = false; // 延迟着色：不透明物体先写 G-buffer，再按屏幕 tile 并行计算光照（始终使用光源簇）；透明物体仍前向渲染，分块 SSAA 下整体退回前向
+    Renderer::Lighting::ShadowSettings shadows; // 阴影贴图尺寸、偏移与 PCF 半径；是否投射阴影由 Light::setCastShadows 控制
+    Renderer::Effects::FxaaSettings fxaa; // aaMode == FXAA 时的参数
+    Renderer::Effects::PostProcessChain postProcess; // 输出时的单趟后处理链（曝光/色调映射/伽马/LUT/暗角/抖动），与 8 位量化融合在 encodeOutput 中
 };
 
-class SoftwareRenderer {
-private:
-    SoftwareRendererSettings m_settings;
-    RenderTarget m_target;
+// 最近一帧的着色统计，用于评估逐顶点光照与可变着色率的收益
+struct RenderStats {
+    uint64_t fragments = 0;              // 通过深度测试并写入的片元数
+    uint64_t shadeInvocations = 0;       // 逐片元着色调用次数（包着色按有效通道计）
+    uint64_t vertexShadeInvocations = 0; // 逐顶点光照的顶点着色次数
+};
 
+/**
+ * @brief 渲染器中与着色器无关的部分：渲染目标、光源与阴影、分簇剔除、延迟着色的光照阶段、后处理与输出
+ *
+ * 几何与光栅化阶段由 BasicSoftwareRenderer 按着色器对实例化。
+ */
+class SoftwareRendererBase {
 public:
-    explicit SoftwareRenderer(const SoftwareRendererSettings& settings = SoftwareRendererSettings());
-
     void setSettings(const SoftwareRendererSettings& settings);
     const SoftwareRendererSettings& getSettings() const { return m_settings; }
 
     RenderTarget& getRenderTarget() { return m_target; }
     const RenderTarget& getRenderTarget() const { return m_target; }
 
+    /**
+     * @brief 把最近一帧经后处理链量化为 8 位像素（RGB 或 RGBA 交错，逐行自上而下）
+     *
+     * 后处理与量化在同一趟中完成，渲染目标保持后处理之前的浮点颜色；预览与文件输出都经由这里。
+     */
+    void encodeOutput(std::vector<uint8_t>& out, bool includeAlpha) const;
+    // encodeOutput 的 RGB 结果写成二进制 PPM (P6)
+    bool savePPM(const std::string& filename) const;
+
+    const RenderStats& getStats() const { return m_stats; }
+    // 帧内分配器：稳定后每帧只有一块、容量不再增长
+    const Core::Platform::FrameArena& getFrameArena() const { return m_frameArena; }
+
+protected:
+    explicit SoftwareRendererBase(const SoftwareRendererSettings& settings);
+
+    SoftwareRendererSettings m_settings;
+    RenderTarget m_target;
+    RenderTarget m_tileTarget; // 分块 SSAA 的高分辨率暂存缓冲，尺寸为 (tile*factor)²
+    Renderer::Effects::FxaaWorkspace m_fxaaWorkspace;
+    Renderer::Lighting::ShadowMapCache m_shadowCache; // 光源与投射体不变时跨帧复用阴影贴图
+    Renderer::Lighting::LightBuffer m_lightBuffer; // 每帧由场景光源编译的 SoA 光源数据
+    Renderer::Lighting::LightCuller m_lightCuller; // 每帧重建，复用内部缓冲
+    RenderStats m_stats;
+    Core::Platform::FrameArena m_frameArena; // 一帧内的变换顶点、渲染队列等临时数据，每帧开头整体 reset
+    GBuffer m_gbuffer; // 延迟着色的几何缓冲，跨帧复用
+
+    void prepareLights(const Scene::Scene& scene);
+    const Renderer::Lighting::LightCuller* prepareLightCulling(const Scene::Scene& scene,
+                                                               const Core::Math::Matrix4& viewMatrix,
+                                                               const Core::Math::Matrix4& projectionMatrix);
+    // 本帧各物体共用的着色器输入（相机、光源、环境光与光照模型），需在 prepareLights 之后调用
+    ShaderUniforms frameUniforms(const Scene::Scene& scene, const ShadingPipeline& shading) const;
+    // 延迟着色的光照阶段：按屏幕 tile 并行读取 m_gbuffer，着色后合成到 m_target
+    void shadeGBuffer(const ShadingPipeline& shading,
+                      const Renderer::Lighting::LightCuller* culler,
+                      const Core::Math::Vector3& cameraPosition,
+                      const Core::Types::Color& ambientLight);
+    void applyPostProcessing();
+
+    // 物体 → 材质 → 渲染器设置，取第一个非 Inherit 的光照频率
+    Core::Types::LightingFrequency resolveLightingFrequency(const Scene::SceneObject& object,
+                                                            const Core::Types::Material* material) const;
+    // 物体级聚光灯剔除：包围球与光锥不相交的聚光灯不会照到该物体的任何片元
+    void cullSpotLights(const Scene::SceneObject& object, DrawState& state);
+
+    // 图元装配：内置 varyings 按世界空间面法线做背面剔除，并剔除退化或无法计算纹理导数的三角形
+    bool assemblePrimitive(const ScreenVertex& v0, const ScreenVertex& v1, const ScreenVertex& v2,
+                           const Core::Math::Vector3& cameraPosition, bool opaque) const;
+    // 自定义 varyings 不含世界坐标，按屏幕空间有向面积剔除背面
+    template <typename Varyings>
+    bool assemblePrimitive(const BasicScreenVertex<Varyings>& v0,
+                           const BasicScreenVertex<Varyings>& v1,
+                           const BasicScreenVertex<Varyings>& v2,
+                           const Core::Math::Vector3& /*cameraPosition*/, bool opaque) const {
+        if (!opaque || !m_settings.backfaceCulling) {
+            return true;
+        }
+        // 屏幕 y 轴向下：正面（世界空间逆时针）在屏幕上为顺时针，此时有向面积为正
+        const float area = (v1.screenX - v0.screenX) * (v2.screenY - v0.screenY) -
+                           (v2.screenX - v0.screenX) * (v1.screenY - v0.screenY);
+        return area > 0.0f;
+    }
+};
+
+/**
+ * @brief 以顶点/片元着色器对为模板参数的软件渲染器
+ *
+ * VertexShader 需声明 Varyings 类型并提供
+ *     Vector4 operator()(const Core::Types::Vertex&, const ShaderUniforms&, Varyings&) const;
+ * FragmentShader 需提供
+ *     bool operator()(const Varyings&, const FragmentContext<Varyings>&, Color&) const;
+ * 着色器在实例化时直接内联进几何与光栅化循环，没有虚函数或 std::function 开销。
+ *
+ * 默认着色器对即 SoftwareRenderer。所有实例共用渲染队列、排序、覆盖规则、深度测试、可变着色率、
+ * 分块 SSAA、后处理与输出；逐顶点光照、包着色与延迟着色直接读取 GeometryVertex，只用于默认着色器对。
+ * 模板成员定义在 programmable_renderer.h 中，SoftwareRenderer 在 software_renderer.cpp 中显式实例化。
+ */
+template <typename VertexShader = BlinnPhongVertexShader, typename FragmentShader = BlinnPhongFragmentShader>
+class BasicSoftwareRenderer : public SoftwareRendererBase {
+public:
+    using Varyings = typename VertexShader::Varyings;
+
+    static constexpr bool kBuiltInShaders = std::is_same<VertexShader, BlinnPhongVertexShader>::value &&
+                                            std::is_same<FragmentShader, BlinnPhongFragmentShader>::value;
+
+    explicit BasicSoftwareRenderer(const SoftwareRendererSettings& settings = SoftwareRendererSettings(),
+                                   VertexShader vertexShader = VertexShader(),
+                                   FragmentShader fragmentShader = FragmentShader());
+
+    // 着色器可携带参数（如时间、颜色），修改后下一帧生效
+    VertexShader& getVertexShader() { return m_vertexShader; }
+    FragmentShader& getFragmentShader() { return m_fragmentShader; }
+
     void render(const Scene::Scene& scene);
+
+private:
+    VertexShader m_vertexShader;
+    FragmentShader m_fragmentShader;
+
+    // 需在 prepareLights 之后调用：逐顶点光照的物体在这里用 m_lightBuffer 完成着色；队列及其引用的数据分配在 m_frameArena 中
+    void buildRenderQueue(const Scene::Scene& scene,
+                          const ShaderUniforms& uniforms,
+                          BasicRenderQueue<Varyings>& renderQueue);
+    void renderTiled(const Scene::Scene& scene, int ssaaFactor);
 };
 
+using SoftwareRenderer = BasicSoftwareRenderer<>;
+extern template class BasicSoftwareRenderer<BlinnPhongVertexShader, BlinnPhongFragmentShader>;
+
 } // namespace Pipeline
 } // namespace Renderer
 
@@ -5,99 +5,319 @@
 
 #include "render_target.h"
 #include "shading_pipeline.h"
+#include "fragment_packet.h"
+#include "gbuffer.h"
+#include "geometry_processor.h"
 #include "geometry_stage.h"
+#include "shading_rate.h"
 #include "software_renderer.h"
+#include "../lighting/light_culling.h"
+#include "../../core/types/material.h"
 
 namespace Renderer {
 namespace Pipeline {
 
-TriangleRasterizer::TriangleRasterizer(RenderTarget& target, const SoftwareRendererSettings& settings)
-    : m_target(target), m_settings(settings) {}
-
-void TriangleRasterizer::rasterize(const TriangleWorkItem& tri,
-                                   Core::Types::Material* material,
-                                   const std::vector<Renderer::Lighting::Light*>& lights,
-                                   const Core::Math::Vector3& cameraPos,
-                                   const Core::Types::Color& ambientLight,
-                                   const ShadingPipeline& shading) const {
-    const ScreenVertex& v0 = tri.v0;
-    const ScreenVertex& v1 = tri.v1;
-    const ScreenVertex& v2 = tri.v2;
-
-    float minX = std::floor(std::min({v0.screenX, v1.screenX, v2.screenX}));
-    float maxX = std::ceil(std::max({v0.screenX, v1.screenX, v2.screenX}));
-    float minY = std::floor(std::min({v0.screenY, v1.screenY, v2.screenY}));
-    float maxY = std::ceil(std::max({v0.screenY, v1.screenY, v2.screenY}));
-
-    int xStart = std::max(0, static_cast<int>(minX));
-    int xEnd = std::min(m_settings.width - 1, static_cast<int>(maxX));
-    int yStart = std::max(0, static_cast<int>(minY));
-    int yEnd = std::min(m_settings.height - 1, static_cast<int>(maxY));
-
-    float denom = (v1.screenY - v2.screenY) * (v0.screenX - v2.screenX) +
-                  (v2.screenX - v1.screenX) * (v0.screenY - v2.screenY);
-    if (std::fabs(denom) < 1e-6f) {
-        return;
-    }
+TriangleRasterizerBase::TriangleRasterizerBase(RenderTarget& target, const SoftwareRendererSettings& settings)
+    : m_target(target),
+      m_settings(settings),
+      m_viewportX(0),
+      m_viewportY(0),
+      m_viewportWidth(settings.width),
+      m_viewportHeight(settings.height),
+      m_lightCuller(nullptr),
+      m_stats(nullptr),
+      m_coarseStamp(0) {}
+
+void TriangleRasterizerBase::setViewport(int originX, int originY, int width, int height) {
+    m_viewportX = originX;
+    m_viewportY = originY;
+    m_viewportWidth = width;
+    m_viewportHeight = height;
+}
 
-    float w0 = v0.attributes.reciprocalW;
-    float w1 = v1.attributes.reciprocalW;
-    float w2 = v2.attributes.reciprocalW;
-
-    const float dAlphaDx = (v1.screenY - v2.screenY) / denom;
-    const float dBetaDx  = (v2.screenY - v0.screenY) / denom;
-
-    for (int y = yStart; y <= yEnd; ++y) {
-        float py = static_cast<float>(y) + 0.5f;
-        float alpha = ((v1.screenY - v2.screenY) * ((static_cast<float>(xStart) + 0.5f) - v2.screenX) +
-                       (v2.screenX - v1.screenX) * (py - v2.screenY)) / denom;
-        float beta  = ((v2.screenY - v0.screenY) * ((static_cast<float>(xStart) + 0.5f) - v2.screenX) +
-                       (v0.screenX - v2.screenX) * (py - v2.screenY)) / denom;
-        float gamma = 1.0f - alpha - beta;
-
-        for (int x = xStart; x <= xEnd; ++x) {
-            bool hasNeg = (alpha < 0.0f) || (beta < 0.0f) || (gamma < 0.0f);
-            bool hasPos = (alpha > 0.0f) || (beta > 0.0f) || (gamma > 0.0f);
-            if (!(hasNeg && hasPos)) {
-                float invZ = alpha * w0 + beta * w1 + gamma * w2;
-                if (invZ > 0.0f) {
-                    float depthNDC = alpha * v0.ndcZ + beta * v1.ndcZ + gamma * v2.ndcZ;
-                    if (std::isfinite(depthNDC)) {
-                        float depth01 = depthNDC * 0.5f + 0.5f;
-                        if (m_target.depthPasses(x, y, depth01)) {
-                            GeometryVertex interpolated = GeometryVertex::interpolate(
-                                v0.attributes, v1.attributes, v2.attributes,
-                                alpha, beta, gamma, m_settings.perspectiveCorrect);
-
-                            Core::Types::Color shaded = shading.shade(interpolated,
-                                                                       material,
-                                                                       lights,
-                                                                       cameraPos,
-                                                                       ambientLight,
-                                                                       tri.derivs);
-                            Core::Types::Color dst = m_target.getPixel(x, y);
-                            float srcA = std::clamp(shaded.a, 0.0f, 1.0f);
-                            Core::Types::Color out(
-                                shaded.r + dst.r * (1.0f - srcA),
-                                shaded.g + dst.g * (1.0f - srcA),
-                                shaded.b + dst.b * (1.0f - srcA),
-                                srcA + dst.a * (1.0f - srcA)
-                            );
-                            m_target.setPixel(x, y, out);
-                            if (srcA >= 0.999f) {
-                                m_target.setDepth(x, y, depth01);
-                            }
-                        }
-                    }
-                }
+namespace {
+
+// 按通道插值三角形属性，与 GeometryVertex::interpolate 的公式一致
+void interpolatePacket(const GeometryVertex& v0,
+                       const GeometryVertex& v1,
+                       const GeometryVertex& v2,
+                       const float* alphaIn,
+                       const float* betaIn,
+                       const float* gammaIn,
+                       int count,
+                       bool perspectiveCorrect,
+                       FragmentPacket& out) {
+    constexpr int W = kFragmentPacketWidth;
+    float alpha[W], beta[W], gamma[W];
+    for (int lane = 0; lane < W; ++lane) {
+        float a = alphaIn[lane];
+        float b = betaIn[lane];
+        float c = gammaIn[lane];
+        if (perspectiveCorrect) {
+            const float denom = a * v0.reciprocalW + b * v1.reciprocalW + c * v2.reciprocalW;
+            if (std::fabs(denom) > 1e-8f) {
+                const float inv = 1.0f / denom;
+                a = a * v0.reciprocalW * inv;
+                b = b * v1.reciprocalW * inv;
+                c = c * v2.reciprocalW * inv;
             }
+        }
+        alpha[lane] = a;
+        beta[lane] = b;
+        gamma[lane] = c;
+    }
 
-            alpha += dAlphaDx;
-            beta  += dBetaDx;
-            gamma = 1.0f - alpha - beta;
+    auto lerp3 = [&](float a0, float a1, float a2, float* dst) {
+        for (int lane = 0; lane < W; ++lane) {
+            dst[lane] = a0 * alpha[lane] + a1 * beta[lane] + a2 * gamma[lane];
         }
+    };
+    auto normalize3 = [](float* x, float* y, float* z) {
+        for (int lane = 0; lane < W; ++lane) {
+            const float lenSq = x[lane] * x[lane] + y[lane] * y[lane] + z[lane] * z[lane];
+            const float inv = lenSq > 0.0f ? 1.0f / std::sqrt(lenSq) : 0.0f;
+            x[lane] *= inv;
+            y[lane] *= inv;
+            z[lane] *= inv;
+        }
+    };
+
+    lerp3(v0.worldPosition.x, v1.worldPosition.x, v2.worldPosition.x, out.posX);
+    lerp3(v0.worldPosition.y, v1.worldPosition.y, v2.worldPosition.y, out.posY);
+    lerp3(v0.worldPosition.z, v1.worldPosition.z, v2.worldPosition.z, out.posZ);
+    lerp3(v0.normal.x, v1.normal.x, v2.normal.x, out.normalX);
+    lerp3(v0.normal.y, v1.normal.y, v2.normal.y, out.normalY);
+    lerp3(v0.normal.z, v1.normal.z, v2.normal.z, out.normalZ);
+    normalize3(out.normalX, out.normalY, out.normalZ);
+    lerp3(v0.tangent.x, v1.tangent.x, v2.tangent.x, out.tangentX);
+    lerp3(v0.tangent.y, v1.tangent.y, v2.tangent.y, out.tangentY);
+    lerp3(v0.tangent.z, v1.tangent.z, v2.tangent.z, out.tangentZ);
+    normalize3(out.tangentX, out.tangentY, out.tangentZ);
+    lerp3(v0.bitangent.x, v1.bitangent.x, v2.bitangent.x, out.bitangentX);
+    lerp3(v0.bitangent.y, v1.bitangent.y, v2.bitangent.y, out.bitangentY);
+    lerp3(v0.bitangent.z, v1.bitangent.z, v2.bitangent.z, out.bitangentZ);
+    normalize3(out.bitangentX, out.bitangentY, out.bitangentZ);
+    lerp3(v0.texCoord.x, v1.texCoord.x, v2.texCoord.x, out.u);
+    lerp3(v0.texCoord.y, v1.texCoord.y, v2.texCoord.y, out.v);
+    lerp3(v0.color.r, v1.color.r, v2.color.r, out.r);
+    lerp3(v0.color.g, v1.color.g, v2.color.g, out.g);
+    lerp3(v0.color.b, v1.color.b, v2.color.b, out.b);
+    lerp3(v0.color.a, v1.color.a, v2.color.a, out.a);
+    out.activeMask = count >= 32 ? ~0u : ((1u << count) - 1u);
+}
+
+} // namespace
+
+Renderer::Lighting::LightSelection TriangleRasterizerBase::selectLights(const DrawState& state,
+                                                                      int x, int y, float invZ) const {
+    // 透视投影下 1/插值(1/w) 即视空间深度
+    Renderer::Lighting::LightSelection selection = m_lightCuller
+        ? m_lightCuller->getLights(x, y, 1.0f / invZ)
+        : Renderer::Lighting::LightSelection();
+    if (state.spotsCulled && (!selection.spotsCulled || state.spotCount < selection.spotCount)) {
+        selection.spotsCulled = true;
+        selection.spotIndices = state.spotIndices;
+        selection.spotCount = state.spotCount;
     }
+    return selection;
 }
 
+int TriangleRasterizerBase::baseShadingRate(const DrawState& state) const {
+    const Core::Types::ShadingRate materialRate = state.material ? state.material->getShadingRate()
+                                                                 : Core::Types::ShadingRate::Inherit;
+    return shadingRateSize(materialRate != Core::Types::ShadingRate::Inherit ? materialRate : m_settings.shadingRate);
+}
+
+void TriangleRasterizerBase::prepareCoarseCache() const {
+    const std::size_t blockColumns = static_cast<std::size_t>(m_settings.width / 2 + 2);
+    for (CoarseShadeCache& cache : m_coarseCache) {
+        if (cache.stamps.size() < blockColumns) {
+            cache.stamps.assign(blockColumns, 0u);
+            cache.colors.resize(blockColumns);
+            cache.kept.resize(blockColumns);
+        }
+    }
+}
+
+Core::Types::Color TriangleRasterizerBase::gouraudColor(const RasterTriangle& tri,
+                                                        Core::Types::Material* diffuseMapMaterial,
+                                                        const RasterDerivatives& derivs,
+                                                        float alpha, float beta, float gamma, float invZ) const {
+    const GeometryVertex& a0 = tri.v0->attributes;
+    const GeometryVertex& a1 = tri.v1->attributes;
+    const GeometryVertex& a2 = tri.v2->attributes;
+    if (m_settings.perspectiveCorrect) {
+        const float inv = 1.0f / invZ;
+        alpha *= a0.reciprocalW * inv;
+        beta *= a1.reciprocalW * inv;
+        gamma *= a2.reciprocalW * inv;
+    }
+    Core::Types::Color color = a0.color * alpha + a1.color * beta + a2.color * gamma;
+    if (diffuseMapMaterial) {
+        const Core::Math::Vector2 uv = a0.texCoord * alpha + a1.texCoord * beta + a2.texCoord * gamma;
+        const Core::Types::Color texel = diffuseMapMaterial->sampleAlbedo(uv, derivs.dudx, derivs.dudy,
+                                                                          derivs.dvdx, derivs.dvdy);
+        color = Core::Types::Color(color.r * texel.r * texel.a,
+                                   color.g * texel.g * texel.a,
+                                   color.b * texel.b * texel.a,
+                                   color.a * texel.a);
+    }
+    return color;
+}
+
+void TriangleRasterizerBase::rasterizeGBuffer(const RasterTriangle& tri,
+                                              uint16_t materialIndex,
+                                              const ShadingPipeline& shading,
+                                              GBuffer& gbuffer) const {
+    Core::Types::Material* material = tri.state->material;
+    const ScreenVertex& v0 = *tri.v0;
+    const ScreenVertex& v1 = *tri.v1;
+    const ScreenVertex& v2 = *tri.v2;
+    const bool textured = material && material->getDiffuseMap();
+    const RasterDerivatives derivs = GeometryProcessor::rasterDerivatives(v0, v1, v2);
+
+    // 与前向路径相同的覆盖与深度规则；后写入的更近片元整体覆盖先前的 G-buffer 内容
+    forEachCoveredPixel(v0.screenX, v0.screenY, v1.screenX, v1.screenY, v2.screenX, v2.screenY,
+                        m_viewportX, m_viewportY, maxX(), maxY(),
+                        [&](int x, int y, float alpha, float beta, float gamma) {
+        float invZ;
+        const float depth01 = depthTest(tri, x, y, alpha, beta, gamma, invZ);
+        if (depth01 < 0.0f) {
+            return;
+        }
+        const int tx = x - m_viewportX;
+        const int ty = y - m_viewportY;
+        const std::size_t i = gbuffer.index(tx, ty);
+
+        Core::Types::Color baseColor;
+        if (tri.state->vertexLit) {
+            baseColor = gouraudColor(tri, textured ? material : nullptr, derivs, alpha, beta, gamma, invZ);
+            gbuffer.flags[i] = GBuffer::kCovered | GBuffer::kPreLit;
+        } else {
+            GeometryVertex interpolated = GeometryVertex::interpolate(
+                v0.attributes, v1.attributes, v2.attributes,
+                alpha, beta, gamma, m_settings.perspectiveCorrect);
+            Core::Math::Vector3 normal;
+            shading.resolveSurface(interpolated, material, derivs, baseColor, normal);
+            encodeOctahedral(normal, gbuffer.normalU[i], gbuffer.normalV[i]);
+            gbuffer.posX[i] = interpolated.worldPosition.x;
+            gbuffer.posY[i] = interpolated.worldPosition.y;
+            gbuffer.posZ[i] = interpolated.worldPosition.z;
+            gbuffer.viewDepth[i] = 1.0f / invZ;
+            gbuffer.materialIndex[i] = materialIndex;
+            gbuffer.flags[i] = GBuffer::kCovered;
+        }
+        gbuffer.albedoR[i] = baseColor.r;
+        gbuffer.albedoG[i] = baseColor.g;
+        gbuffer.albedoB[i] = baseColor.b;
+        gbuffer.albedoA[i] = baseColor.a;
+        // 与前向路径一致：只有（近似）不透明的片元写深度
+        if (std::clamp(baseColor.a, 0.0f, 1.0f) >= 0.999f) {
+            m_target.setDepth(tx, ty, depth01);
+        }
+        if (m_stats) {
+            ++m_stats->fragments;
+        }
+    });
+}
+
+void TriangleRasterizerBase::rasterizeGouraud(const RasterTriangle& tri) const {
+    Core::Types::Material* material = tri.state->material;
+    const ScreenVertex& v0 = *tri.v0;
+    const ScreenVertex& v1 = *tri.v1;
+    const ScreenVertex& v2 = *tri.v2;
+    const bool textured = material && material->getDiffuseMap();
+    const RasterDerivatives derivs = textured ? GeometryProcessor::rasterDerivatives(v0, v1, v2) : RasterDerivatives{};
+    forEachCoveredPixel(v0.screenX, v0.screenY, v1.screenX, v1.screenY, v2.screenX, v2.screenY,
+                        m_viewportX, m_viewportY, maxX(), maxY(),
+                        [&](int x, int y, float alpha, float beta, float gamma) {
+        float invZ;
+        const float depth01 = depthTest(tri, x, y, alpha, beta, gamma, invZ);
+        if (depth01 < 0.0f) {
+            return;
+        }
+        writeFragment(x - m_viewportX, y - m_viewportY,
+                      gouraudColor(tri, textured ? material : nullptr, derivs, alpha, beta, gamma, invZ), depth01);
+    });
+}
+
+void TriangleRasterizerBase::rasterizePackets(const RasterTriangle& tri) const {
+    const DrawState& state = *tri.state;
+    const ShaderUniforms& uniforms = *state.uniforms;
+    const ScreenVertex& v0 = *tri.v0;
+    const ScreenVertex& v1 = *tri.v1;
+    const ScreenVertex& v2 = *tri.v2;
+    const RasterDerivatives derivs = GeometryProcessor::rasterDerivatives(v0, v1, v2);
+
+    // 收集通过深度测试的片元，满 kFragmentPacketWidth 个（或光源簇变化、三角形结束）时批量着色。
+    // 同一三角形内像素互不重复，延迟写回不影响深度测试结果。
+    constexpr int W = kFragmentPacketWidth;
+    int laneX[W];
+    int laneY[W];
+    float laneDepth[W];
+    float laneAlpha[W] = {};
+    float laneBeta[W] = {};
+    float laneGamma[W] = {};
+    int count = 0;
+    // 无簇剔除时整个三角形共用一个光源子集
+    Renderer::Lighting::LightSelection packetSelection = m_lightCuller
+        ? Renderer::Lighting::LightSelection()
+        : selectLights(state, 0, 0, 1.0f);
+    FragmentPacket packet;
+    ColorPacket colors;
+
+    auto flush = [&]() {
+        if (count == 0) {
+            return;
+        }
+        interpolatePacket(v0.attributes, v1.attributes, v2.attributes,
+                          laneAlpha, laneBeta, laneGamma, count,
+                          m_settings.perspectiveCorrect, packet);
+        uniforms.shading->shadeBatch(packet, state.material, *uniforms.lights, packetSelection,
+                                     uniforms.cameraPosition, uniforms.ambientLight, derivs, colors);
+        if (m_stats) {
+            m_stats->shadeInvocations += static_cast<uint64_t>(count);
+        }
+        for (int lane = 0; lane < count; ++lane) {
+            writeFragment(laneX[lane], laneY[lane],
+                          Core::Types::Color(colors.r[lane], colors.g[lane], colors.b[lane], colors.a[lane]),
+                          laneDepth[lane]);
+        }
+        count = 0;
+    };
+
+    forEachCoveredPixel(v0.screenX, v0.screenY, v1.screenX, v1.screenY, v2.screenX, v2.screenY,
+                        m_viewportX, m_viewportY, maxX(), maxY(),
+                        [&](int x, int y, float alpha, float beta, float gamma) {
+        float invZ;
+        const float depth01 = depthTest(tri, x, y, alpha, beta, gamma, invZ);
+        if (depth01 < 0.0f) {
+            return;
+        }
+        if (m_lightCuller) {
+            const Renderer::Lighting::LightSelection selection = selectLights(state, x, y, invZ);
+            if (count > 0 && (selection.pointIndices != packetSelection.pointIndices ||
+                              selection.pointCount != packetSelection.pointCount ||
+                              selection.spotIndices != packetSelection.spotIndices ||
+                              selection.spotCount != packetSelection.spotCount)) {
+                flush();
+            }
+            packetSelection = selection;
+        }
+        laneX[count] = x - m_viewportX;
+        laneY[count] = y - m_viewportY;
+        laneDepth[count] = depth01;
+        laneAlpha[count] = alpha;
+        laneBeta[count] = beta;
+        laneGamma[count] = gamma;
+        if (++count == W) {
+            flush();
+        }
+    });
+    flush();
+}
+
+template class BasicTriangleRasterizer<BlinnPhongVertexShader, BlinnPhongFragmentShader>;
+
 } // namespace Pipeline
 } // namespace Renderer
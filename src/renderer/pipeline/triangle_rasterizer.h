@@ -1,38 +1,334 @@
 #ifndef RENDERER_PIPELINE_TRIANGLE_RASTERIZER_H
 #define RENDERER_PIPELINE_TRIANGLE_RASTERIZER_H
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
 #include <vector>
 
 #include "render_queue.h"
+#include "render_target.h"
+#include "shader_interface.h"
+#include "shading_rate.h"
+#include "software_renderer.h"
+#include "../lighting/light_buffer.h"
 
 #include "../../core/types/color.h"
 
+namespace Core {
+namespace Types {
+class Material;
+}
+}
+
 namespace Renderer {
 namespace Lighting {
-class Light;
+class LightCuller;
 }
 namespace Pipeline {
 
 class ShadingPipeline;
-class RenderTarget;
-struct SoftwareRendererSettings;
+struct GBuffer;
+
+// 遍历屏幕三角形在窗口 [minX, maxX]×[minY, maxY]（含端点）内覆盖的像素中心，回调 fn(x, y, alpha, beta, gamma)。
+// 着色光栅化与纯深度光栅化（阴影贴图）共用同一套边函数与覆盖规则。
+template <typename PixelFn>
+void forEachCoveredPixel(float x0, float y0, float x1, float y1, float x2, float y2,
+                         int minX, int minY, int maxX, int maxY, PixelFn&& fn) {
+    int xStart = std::max(minX, static_cast<int>(std::floor(std::min({x0, x1, x2}))));
+    int xEnd = std::min(maxX, static_cast<int>(std::ceil(std::max({x0, x1, x2}))));
+    int yStart = std::max(minY, static_cast<int>(std::floor(std::min({y0, y1, y2}))));
+    int yEnd = std::min(maxY, static_cast<int>(std::ceil(std::max({y0, y1, y2}))));
+    if (xStart > xEnd || yStart > yEnd) {
+        return;
+    }
+
+    float denom = (y1 - y2) * (x0 - x2) + (x2 - x1) * (y0 - y2);
+    if (std::fabs(denom) < 1e-6f) {
+        return;
+    }
+
+    const float dAlphaDx = (y1 - y2) / denom;
+    const float dBetaDx  = (y2 - y0) / denom;
 
-class TriangleRasterizer {
+    for (int y = yStart; y <= yEnd; ++y) {
+        float py = static_cast<float>(y) + 0.5f;
+        // 行首取 x=0 处的边函数值，逐像素按绝对 x 求值：
+        // 重心坐标只取决于像素位置，不受窗口裁剪起点影响（分块渲染与整帧渲染结果一致）
+        float alphaRow = ((y1 - y2) * (0.0f - x2) + (x2 - x1) * (py - y2)) / denom;
+        float betaRow  = ((y2 - y0) * (0.0f - x2) + (x0 - x2) * (py - y2)) / denom;
+
+        for (int x = xStart; x <= xEnd; ++x) {
+            float px = static_cast<float>(x) + 0.5f;
+            float alpha = alphaRow + dAlphaDx * px;
+            float beta  = betaRow + dBetaDx * px;
+            float gamma = 1.0f - alpha - beta;
+
+            bool hasNeg = (alpha < 0.0f) || (beta < 0.0f) || (gamma < 0.0f);
+            bool hasPos = (alpha > 0.0f) || (beta > 0.0f) || (gamma > 0.0f);
+            if (!(hasNeg && hasPos)) {
+                fn(x, y, alpha, beta, gamma);
+            }
+        }
+    }
+}
+
+/**
+ * @brief 光栅化中与着色器无关的部分：视口、深度测试、预乘 alpha 混合与光源子集的选择
+ *
+ * 内置 Blinn-Phong 着色器对专用的固定功能路径（逐顶点光照、包着色与 G-buffer）也在这里，
+ * 它们直接读取 GeometryVertex 的属性。
+ */
+class TriangleRasterizerBase {
 public:
-    TriangleRasterizer(RenderTarget& target, const SoftwareRendererSettings& settings);
+    TriangleRasterizerBase(RenderTarget& target, const SoftwareRendererSettings& settings);
 
-    void rasterize(const TriangleWorkItem& tri,
-                   Core::Types::Material* material,
-                   const std::vector<Renderer::Lighting::Light*>& lights,
-                   const Core::Math::Vector3& cameraPos,
-                   const Core::Types::Color& ambientLight,
-                   const ShadingPipeline& shading) const;
+    // 设置光栅化窗口（屏幕像素坐标）：只处理落在窗口内的像素，
+    // 并写入目标缓冲的 (x - originX, y - originY) 位置。默认覆盖整个 settings 分辨率。
+    void setViewport(int originX, int originY, int width, int height);
 
-private:
+    // 设置分簇光源剔除结果：非空时每个片元只着色所在簇的点光源，否则遍历缓冲中的全部光源
+    void setLightCuller(const Renderer::Lighting::LightCuller* culler) { m_lightCuller = culler; }
+
+    // 可选：累计片元数与着色调用次数
+    void setStats(RenderStats* stats) { m_stats = stats; }
+
+    /**
+     * @brief 延迟着色的几何阶段：深度测试通过的片元写入 G-buffer 与深度缓冲，不做光照
+     * @param materialIndex tri.state->material 在 gbuffer.materials 中的下标
+     */
+    void rasterizeGBuffer(const RasterTriangle& tri,
+                          uint16_t materialIndex,
+                          const ShadingPipeline& shading,
+                          GBuffer& gbuffer) const;
+
+protected:
     RenderTarget& m_target;
     const SoftwareRendererSettings& m_settings;
+    int m_viewportX;
+    int m_viewportY;
+    int m_viewportWidth;
+    int m_viewportHeight;
+    const Renderer::Lighting::LightCuller* m_lightCuller;
+    RenderStats* m_stats;
+
+    // 可变着色率：2x2 与 4x4 各一组按块列索引的着色缓存；块行切换时换新时间戳即视为清空
+    struct CoarseShadeCache {
+        std::vector<uint32_t> stamps;
+        std::vector<Core::Types::Color> colors;
+        std::vector<uint8_t> kept; // 片元着色器未丢弃该块
+    };
+    mutable CoarseShadeCache m_coarseCache[2];
+    mutable uint32_t m_coarseStamp;
+
+    int maxX() const { return m_viewportX + m_viewportWidth - 1; }
+    int maxY() const { return m_viewportY + m_viewportHeight - 1; }
+
+    // 深度测试通过后返回 depth01（不写入），否则返回负值；invZ 输出插值后的 1/w
+    template <typename Varyings>
+    float depthTest(const BasicRasterTriangle<Varyings>& tri, int x, int y,
+                    float alpha, float beta, float gamma, float& invZ) const {
+        invZ = alpha * tri.v0->reciprocalW + beta * tri.v1->reciprocalW + gamma * tri.v2->reciprocalW;
+        if (invZ <= 0.0f) {
+            return -1.0f;
+        }
+        const float depthNDC = alpha * tri.v0->ndcZ + beta * tri.v1->ndcZ + gamma * tri.v2->ndcZ;
+        if (!std::isfinite(depthNDC)) {
+            return -1.0f;
+        }
+        const float depth01 = depthNDC * 0.5f + 0.5f;
+        if (!m_target.depthPasses(x - m_viewportX, y - m_viewportY, depth01)) {
+            return -1.0f;
+        }
+        return depth01;
+    }
+
+    // 预乘 alpha 混合写入目标缓冲的 (tx, ty)；只有（近似）不透明的片元写深度
+    void writeFragment(int tx, int ty, const Core::Types::Color& shaded, float depth01) const {
+        const Core::Types::Color dst = m_target.getPixel(tx, ty);
+        const float srcA = std::clamp(shaded.a, 0.0f, 1.0f);
+        m_target.setPixel(tx, ty, Core::Types::Color(shaded.r + dst.r * (1.0f - srcA),
+                                                     shaded.g + dst.g * (1.0f - srcA),
+                                                     shaded.b + dst.b * (1.0f - srcA),
+                                                     srcA + dst.a * (1.0f - srcA)));
+        if (srcA >= 0.999f) {
+            m_target.setDepth(tx, ty, depth01);
+        }
+        if (m_stats) {
+            ++m_stats->fragments;
+        }
+    }
+
+    // 片元的光源子集：簇给出 tile 级的结果，物体级聚光灯列表更短时改用后者（两者都是保守超集）
+    Renderer::Lighting::LightSelection selectLights(const DrawState& state, int x, int y, float invZ) const;
+
+    // 三角形最终使用的着色率边长：材质覆盖设置，不考虑着色率图
+    int baseShadingRate(const DrawState& state) const;
+    // 着色率大于 1 或使用着色率图时，确保粗着色缓存覆盖一行的全部块
+    void prepareCoarseCache() const;
+
+    // Gouraud：顶点颜色已是光照结果，只插值颜色；有漫反射贴图时逐像素调制
+    void rasterizeGouraud(const RasterTriangle& tri) const;
+    // 包着色：按 kFragmentPacketWidth 个片元一组调用 ShadingPipeline::shadeBatch，与逐片元调用默认片元着色器等价
+    void rasterizePackets(const RasterTriangle& tri) const;
+
+private:
+    // diffuseMapMaterial 非空时逐像素乘以漫反射贴图
+    Core::Types::Color gouraudColor(const RasterTriangle& tri,
+                                    Core::Types::Material* diffuseMapMaterial,
+                                    const RasterDerivatives& derivs,
+                                    float alpha, float beta, float gamma, float invZ) const;
 };
 
+/**
+ * @brief 以顶点/片元着色器对为模板参数的三角形光栅化
+ *
+ * 片元着色器在实例化时直接内联进光栅化循环。内置着色器对（BlinnPhongVertexShader/BlinnPhongFragmentShader）
+ * 额外使用基类中的逐顶点光照与包着色路径；其余情况逐片元（或按可变着色率逐块）调用片元着色器。
+ */
+template <typename VertexShader, typename FragmentShader>
+class BasicTriangleRasterizer : public TriangleRasterizerBase {
+public:
+    using Varyings = typename VertexShader::Varyings;
+    using Layout = VaryingLayout<Varyings>;
+    using Triangle = BasicRasterTriangle<Varyings>;
+
+    static constexpr bool kBuiltInShaders = std::is_same<VertexShader, BlinnPhongVertexShader>::value &&
+                                            std::is_same<FragmentShader, BlinnPhongFragmentShader>::value;
+
+    BasicTriangleRasterizer(RenderTarget& target, const SoftwareRendererSettings& settings,
+                            const FragmentShader& fragmentShader)
+        : TriangleRasterizerBase(target, settings), m_fragmentShader(fragmentShader) {}
+
+    // 材质、着色器输入与物体级光照设置取自 tri.state
+    void rasterize(const Triangle& tri) const;
+
+private:
+    const FragmentShader& m_fragmentShader;
+};
+
+template <typename VertexShader, typename FragmentShader>
+void BasicTriangleRasterizer<VertexShader, FragmentShader>::rasterize(const Triangle& tri) const {
+    const DrawState& state = *tri.state;
+    const int rate = baseShadingRate(state);
+    const ShadingRateImage& rateImage = m_settings.shadingRateImage;
+    if constexpr (kBuiltInShaders) {
+        if (state.vertexLit) {
+            rasterizeGouraud(tri);
+            return;
+        }
+        if (rate == 1 && rateImage.empty() && m_settings.packetShading) {
+            rasterizePackets(tri);
+            return;
+        }
+    }
+
+    const auto& v0 = *tri.v0;
+    const auto& v1 = *tri.v1;
+    const auto& v2 = *tri.v2;
+    // varyings 的屏幕空间偏导，每个三角形求一次
+    Varyings ddx;
+    Varyings ddy;
+    Layout::screenDerivatives(v0.attributes, v1.attributes, v2.attributes,
+                              v0.screenX, v0.screenY, v1.screenX, v1.screenY, v2.screenX, v2.screenY,
+                              ddx, ddy);
+
+    // 逐像素着色一次：透视校正插值 varyings、查询光源子集并调用片元着色器；返回 false 表示片元被丢弃
+    auto shadePixel = [&](int x, int y, float alpha, float beta, float gamma, float invZ, float depth01,
+                          Core::Types::Color& shaded) {
+        if (m_settings.perspectiveCorrect && std::fabs(invZ) > 1e-8f) {
+            alpha = (alpha * v0.reciprocalW) / invZ;
+            beta = (beta * v1.reciprocalW) / invZ;
+            gamma = (gamma * v2.reciprocalW) / invZ;
+        }
+        Varyings interpolated;
+        Layout::interpolate(v0.attributes, v1.attributes, v2.attributes, alpha, beta, gamma, interpolated);
+
+        const Renderer::Lighting::LightSelection selection = selectLights(state, x, y, invZ);
+        const FragmentContext<Varyings> context{*state.uniforms, x, y, depth01, ddx, ddy, selection};
+        if (m_stats) {
+            ++m_stats->shadeInvocations;
+        }
+        return m_fragmentShader(interpolated, context, shaded);
+    };
+
+    if (rate == 1 && rateImage.empty()) {
+        forEachCoveredPixel(v0.screenX, v0.screenY, v1.screenX, v1.screenY, v2.screenX, v2.screenY,
+                            m_viewportX, m_viewportY, maxX(), maxY(),
+                            [&](int x, int y, float alpha, float beta, float gamma) {
+            float invZ;
+            const float depth01 = depthTest(tri, x, y, alpha, beta, gamma, invZ);
+            if (depth01 < 0.0f) {
+                return;
+            }
+            Core::Types::Color shaded;
+            if (shadePixel(x, y, alpha, beta, gamma, invZ, depth01, shaded)) {
+                writeFragment(x - m_viewportX, y - m_viewportY, shaded, depth01);
+            }
+        });
+        return;
+    }
+
+    // 可变着色率：同一三角形内每个 N×N 块只在第一个通过深度测试的像素上着色，结果（含是否丢弃）广播给块内其余像素；
+    // 覆盖与深度仍逐像素判断。块按光栅化坐标对齐，forEachCoveredPixel 逐行遍历，块行切换即可失效缓存。
+    prepareCoarseCache();
+    int bandY[2] = {-1, -1};
+    uint32_t bandStamp[2] = {0u, 0u};
+    const float invWidth = 1.0f / static_cast<float>(std::max(1, m_settings.width));
+    const float invHeight = 1.0f / static_cast<float>(std::max(1, m_settings.height));
+
+    forEachCoveredPixel(v0.screenX, v0.screenY, v1.screenX, v1.screenY, v2.screenX, v2.screenY,
+                        m_viewportX, m_viewportY, maxX(), maxY(),
+                        [&](int x, int y, float alpha, float beta, float gamma) {
+        float invZ;
+        const float depth01 = depthTest(tri, x, y, alpha, beta, gamma, invZ);
+        if (depth01 < 0.0f) {
+            return;
+        }
+
+        int pixelRate = rate;
+        if (!rateImage.empty()) {
+            const float u = (static_cast<float>(x) + 0.5f) * invWidth;
+            const float v = (static_cast<float>(y) + 0.5f) * invHeight;
+            pixelRate = std::max(pixelRate, shadingRateSize(rateImage.rateAt(u, v)));
+        }
+        if (pixelRate == 1) {
+            Core::Types::Color shaded;
+            if (shadePixel(x, y, alpha, beta, gamma, invZ, depth01, shaded)) {
+                writeFragment(x - m_viewportX, y - m_viewportY, shaded, depth01);
+            }
+            return;
+        }
+
+        const int level = pixelRate == 2 ? 0 : 1;
+        CoarseShadeCache& cache = m_coarseCache[level];
+        const int by = y / pixelRate;
+        if (by != bandY[level]) {
+            bandY[level] = by;
+            bandStamp[level] = ++m_coarseStamp;
+            if (m_coarseStamp == 0) {
+                // 时间戳回绕：清空后重新开始
+                for (CoarseShadeCache& c : m_coarseCache) {
+                    std::fill(c.stamps.begin(), c.stamps.end(), 0u);
+                }
+                bandStamp[level] = ++m_coarseStamp;
+            }
+        }
+        const std::size_t bx = static_cast<std::size_t>(x / pixelRate);
+        if (cache.stamps[bx] != bandStamp[level]) {
+            cache.stamps[bx] = bandStamp[level];
+            cache.kept[bx] = shadePixel(x, y, alpha, beta, gamma, invZ, depth01, cache.colors[bx]) ? 1 : 0;
+        }
+        if (cache.kept[bx]) {
+            writeFragment(x - m_viewportX, y - m_viewportY, cache.colors[bx], depth01);
+        }
+    });
+}
+
+using TriangleRasterizer = BasicTriangleRasterizer<BlinnPhongVertexShader, BlinnPhongFragmentShader>;
+extern template class BasicTriangleRasterizer<BlinnPhongVertexShader, BlinnPhongFragmentShader>;
+
 } // namespace Pipeline
 } // namespace Renderer
 
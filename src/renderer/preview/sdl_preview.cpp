@@ -3,8 +3,6 @@
 #ifdef ENABLE_SDL_PREVIEW
 
 #include <SDL2/SDL.h>
-#include <vector>
-#include <algorithm>
 
 namespace Renderer {
 namespace Preview {
@@ -13,7 +11,6 @@ struct SdlPreview::SDLObjects {
     SDL_Window* window = nullptr;
     SDL_Renderer* renderer = nullptr;
     SDL_Texture* texture = nullptr;
-    SDL_PixelFormat* pixelFormat = nullptr;
 };
 
 SdlPreview::SdlPreview(int width, int height)
@@ -33,9 +30,6 @@ SdlPreview::~SdlPreview() {
     if (m_objects->window) {
         SDL_DestroyWindow(m_objects->window);
     }
-    if (m_objects->pixelFormat) {
-        SDL_FreeFormat(m_objects->pixelFormat);
-    }
 
     SDL_QuitSubSystem(SDL_INIT_VIDEO);
     delete m_objects;
@@ -66,7 +60,7 @@ bool SdlPreview::initialize() {
     }
 
     m_objects->texture = SDL_CreateTexture(m_objects->renderer,
-                                           SDL_PIXELFORMAT_RGBA8888,
+                                           SDL_PIXELFORMAT_RGBA32,
                                            SDL_TEXTUREACCESS_STREAMING,
                                            m_width,
                                            m_height);
@@ -75,43 +69,34 @@ bool SdlPreview::initialize() {
         return false;
     }
 
-    m_objects->pixelFormat = SDL_AllocFormat(SDL_PIXELFORMAT_RGBA8888);
-    return m_objects->pixelFormat != nullptr;
+    return true;
 }
 
-void SdlPreview::present(const Pipeline::RenderTarget& target, const std::string& windowTitle) {
+bool SdlPreview::upload(const std::vector<uint8_t>& rgba, const std::string& windowTitle) {
     if (!m_objects || !m_objects->renderer || !m_objects->texture) {
-        return;
+        return false;
     }
-
-    SDL_SetWindowTitle(m_objects->window, windowTitle.c_str());
-
-    void* pixels = nullptr;
-    int pitch = 0;
-    if (SDL_LockTexture(m_objects->texture, nullptr, &pixels, &pitch) != 0) {
-        SDL_Log("SDL_LockTexture failed: %s", SDL_GetError());
-        return;
+    if (rgba.size() < static_cast<std::size_t>(m_width) * static_cast<std::size_t>(m_height) * 4u) {
+        return false;
     }
 
-    const auto& colorBuffer = target.getColorBuffer();
-
-    for (int y = 0; y < m_height; ++y) {
-        auto* row = reinterpret_cast<uint32_t*>(static_cast<uint8_t*>(pixels) + y * pitch);
-        for (int x = 0; x < m_width; ++x) {
-            const auto& color = colorBuffer[y * m_width + x];
-            uint8_t r = static_cast<uint8_t>(std::clamp(color.r, 0.0f, 1.0f) * 255.0f);
-            uint8_t g = static_cast<uint8_t>(std::clamp(color.g, 0.0f, 1.0f) * 255.0f);
-            uint8_t b = static_cast<uint8_t>(std::clamp(color.b, 0.0f, 1.0f) * 255.0f);
-            uint8_t a = static_cast<uint8_t>(std::clamp(color.a, 0.0f, 1.0f) * 255.0f);
-            row[x] = SDL_MapRGBA(m_objects->pixelFormat, r, g, b, a);
-        }
+    SDL_SetWindowTitle(m_objects->window, windowTitle.c_str());
+    // 纹理格式与内存中的 RGBA 字节顺序一致，量化已在 encodeOutput 中完成，直接整帧上传
+    if (SDL_UpdateTexture(m_objects->texture, nullptr, rgba.data(), m_width * 4) != 0) {
+        SDL_Log("SDL_UpdateTexture failed: %s", SDL_GetError());
+        return false;
     }
 
-    SDL_UnlockTexture(m_objects->texture);
-
     SDL_RenderClear(m_objects->renderer);
     SDL_RenderCopy(m_objects->renderer, m_objects->texture, nullptr, nullptr);
     SDL_RenderPresent(m_objects->renderer);
+    return true;
+}
+
+void SdlPreview::present(const std::vector<uint8_t>& rgba, const std::string& windowTitle) {
+    if (!upload(rgba, windowTitle)) {
+        return;
+    }
 
     bool running = true;
     while (running) {
@@ -126,39 +111,8 @@ void SdlPreview::present(const Pipeline::RenderTarget& target, const std::string
     }
 }
 
-bool SdlPreview::presentOnce(const Pipeline::RenderTarget& target, const std::string& windowTitle) {
-    if (!m_objects || !m_objects->renderer || !m_objects->texture) {
-        return false;
-    }
-
-    SDL_SetWindowTitle(m_objects->window, windowTitle.c_str());
-
-    void* pixels = nullptr;
-    int pitch = 0;
-    if (SDL_LockTexture(m_objects->texture, nullptr, &pixels, &pitch) != 0) {
-        SDL_Log("SDL_LockTexture failed: %s", SDL_GetError());
-        return false;
-    }
-
-    const auto& colorBuffer = target.getColorBuffer();
-    for (int y = 0; y < m_height; ++y) {
-        auto* row = reinterpret_cast<uint32_t*>(static_cast<uint8_t*>(pixels) + y * pitch);
-        for (int x = 0; x < m_width; ++x) {
-            const auto& color = colorBuffer[y * m_width + x];
-            uint8_t r = static_cast<uint8_t>(std::clamp(color.r, 0.0f, 1.0f) * 255.0f);
-            uint8_t g = static_cast<uint8_t>(std::clamp(color.g, 0.0f, 1.0f) * 255.0f);
-            uint8_t b = static_cast<uint8_t>(std::clamp(color.b, 0.0f, 1.0f) * 255.0f);
-            uint8_t a = static_cast<uint8_t>(std::clamp(color.a, 0.0f, 1.0f) * 255.0f);
-            row[x] = SDL_MapRGBA(m_objects->pixelFormat, r, g, b, a);
-        }
-    }
-
-    SDL_UnlockTexture(m_objects->texture);
-
-    SDL_RenderClear(m_objects->renderer);
-    SDL_RenderCopy(m_objects->renderer, m_objects->texture, nullptr, nullptr);
-    SDL_RenderPresent(m_objects->renderer);
-    return true;
+bool SdlPreview::presentOnce(const std::vector<uint8_t>& rgba, const std::string& windowTitle) {
+    return upload(rgba, windowTitle);
 }
 
 bool SdlPreview::pollEvents() {
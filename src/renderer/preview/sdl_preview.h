@@ -1,9 +1,9 @@
 #ifndef RENDERER_PREVIEW_SDL_PREVIEW_H
 #define RENDERER_PREVIEW_SDL_PREVIEW_H
 
+#include <cstdint>
 #include <string>
-
-#include "../pipeline/render_target.h"
+#include <vector>
 
 namespace Renderer {
 namespace Preview {
@@ -14,10 +14,11 @@ public:
     ~SdlPreview();
 
     bool initialize();
-    void present(const Pipeline::RenderTarget& target, const std::string& windowTitle);
+    // rgba 为 width × height 的 8 位 RGBA 交错像素（如 SoftwareRenderer::encodeOutput(out, true) 的结果）
+    void present(const std::vector<uint8_t>& rgba, const std::string& windowTitle);
 
     // 非阻塞：上传并呈现一帧，不进入内部事件循环
-    bool presentOnce(const Pipeline::RenderTarget& target, const std::string& windowTitle);
+    bool presentOnce(const std::vector<uint8_t>& rgba, const std::string& windowTitle);
     // 轮询事件：返回false表示收到退出请求
     bool pollEvents();
 
@@ -28,6 +29,8 @@ private:
 #ifdef ENABLE_SDL_PREVIEW
     struct SDLObjects;
     SDLObjects* m_objects;
+
+    bool upload(const std::vector<uint8_t>& rgba, const std::string& windowTitle);
 #else
     void presentFallbackMessage(const std::string& windowTitle) const;
 #endif
@@ -12,7 +12,7 @@ bool SdlPreview::initialize() {
     return false;
 }
 
-void SdlPreview::present(const Pipeline::RenderTarget&, const std::string& windowTitle) {
+void SdlPreview::present(const std::vector<uint8_t>&, const std::string& windowTitle) {
     presentFallbackMessage(windowTitle);
 }
 
@@ -5,7 +5,8 @@ namespace Scene {
 Scene::Scene()
     : m_camera(nullptr),
       m_backgroundColor(0.1f, 0.1f, 0.1f, 1.0f),
-      m_ambientLight(0.1f, 0.1f, 0.1f, 1.0f) {}
+      m_ambientLight(0.1f, 0.1f, 0.1f, 1.0f),
+      m_environment(nullptr) {}
 
 int Scene::addObject(Mesh* mesh, const Matrix4& transform, Material* materialOverride) {
     SceneObject object;
@@ -32,6 +33,7 @@ void Scene::clear() {
     m_objects.clear();
     m_lights.clear();
     m_camera = nullptr;
+    m_environment = nullptr;
 }
 
 } // namespace Scene
@@ -4,11 +4,13 @@
 #include "mesh.h"
 #include "camera.h"
 #include "../core/types/color.h"
+#include "../core/types/material.h"
 #include <vector>
 
 namespace Renderer {
 namespace Lighting {
 class Light;
+class EnvironmentLight;
 }
 }
 
@@ -19,6 +21,8 @@ struct SceneObject {
     Matrix4 transform = Matrix4::identity();
     Material* materialOverride = nullptr;
     bool visible = true;
+    bool castShadows = true; // 是否写入阴影贴图
+    Core::Types::LightingFrequency lightingFrequency = Core::Types::LightingFrequency::Inherit; // 覆盖材质的光照频率
 };
 
 class Scene {
@@ -28,6 +32,7 @@ private:
     Camera* m_camera;
     Core::Types::Color m_backgroundColor;
     Core::Types::Color m_ambientLight;
+    Renderer::Lighting::EnvironmentLight* m_environment;
 
 public:
     Scene();
@@ -50,11 +55,21 @@ public:
     const Core::Types::Color& getAmbientLight() const { return m_ambientLight; }
     void setAmbientLight(const Core::Types::Color& color) { m_ambientLight = color; }
 
+    // 设置后环境光改由球谐环境光照计算，平坦环境色不再参与着色；对象由调用者持有
+    void setEnvironment(Renderer::Lighting::EnvironmentLight* environment) { m_environment = environment; }
+    Renderer::Lighting::EnvironmentLight* getEnvironment() const { return m_environment; }
+
     void setObjectTransform(int index, const Matrix4& transform) {
         if (index >= 0 && index < static_cast<int>(m_objects.size())) {
             m_objects[static_cast<std::size_t>(index)].transform = transform;
         }
     }
+
+    void setObjectLightingFrequency(int index, Core::Types::LightingFrequency frequency) {
+        if (index >= 0 && index < static_cast<int>(m_objects.size())) {
+            m_objects[static_cast<std::size_t>(index)].lightingFrequency = frequency;
+        }
+    }
 };
 
 } // namespace Scene
@@ -0,0 +1,196 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "core/types/material.h"
+#include "core/types/texture.h"
+#include "renderer/pipeline/software_renderer.h"
+#include "scene/camera.h"
+#include "scene/mesh.h"
+#include "scene/scene.h"
+
+#include "texture_test_utils.h"
+
+using Core::Types::Color;
+using Core::Types::Texture;
+using Core::Types::TextureFilter;
+using TextureTestUtils::makeLevelCodedTexture;
+using TextureTestUtils::randomPixels;
+
+namespace {
+
+// 沿 v 方向每 4 行黑白交替的条纹（u 方向不变），用于检查斜向 footprint 下的细节保留
+Texture makeStripes(int size) {
+    Texture texture(size, size, true);
+    for (int y = 0; y < size; ++y) {
+        const Color color = (y / 2) % 2 == 0 ? Color::WHITE : Color::BLACK;
+        for (int x = 0; x < size; ++x) {
+            texture.setPixel(x, y, color);
+        }
+    }
+    return texture;
+}
+
+} // namespace
+
+TEST(AnisotropicFilteringTest, IsotropicFootprintMatchesTrilinear) {
+    std::mt19937 rng(43);
+    const std::vector<uint32_t> pixels = randomPixels(rng, 64 * 64);
+    Texture trilinear(pixels, 64, 64, true);
+    trilinear.setFilter(TextureFilter::Trilinear);
+    Texture anisotropic(pixels, 64, 64, true);
+    anisotropic.setFilter(TextureFilter::Anisotropic);
+
+    // 轴对齐的各向同性导数：长短轴相等，只取一个样本，与三线性逐位相同
+    std::uniform_real_distribution<float> coord(-1.0f, 2.0f);
+    for (float footprint : {0.5f, 1.0f, 1.5f, 3.0f, 6.0f, 40.0f}) {
+        const float d = footprint / 64.0f;
+        for (int i = 0; i < 50; ++i) {
+            const float u = coord(rng);
+            const float v = coord(rng);
+            EXPECT_EQ(anisotropic.sample(u, v, d, 0.0f, 0.0f, -d).toUint32(),
+                      trilinear.sample(u, v, d, 0.0f, 0.0f, -d).toUint32())
+                << "footprint " << footprint;
+        }
+    }
+}
+
+TEST(AnisotropicFilteringTest, ObliqueFootprintKeepsMinorAxisDetail) {
+    const int size = 64;
+    Texture texture = makeStripes(size);
+    // 屏幕 x 方向跨 8 个纹素（沿条纹），y 方向跨 1 个纹素（垂直于条纹）
+    const float dudx = 8.0f / size;
+    const float dvdy = 1.0f / size;
+    const float whiteV = 0.5f / (size - 1);  // 第 0–1 行之间
+    const float blackV = 2.5f / (size - 1);  // 第 2–3 行之间
+
+    texture.setFilter(TextureFilter::Trilinear);
+    const float trilinearContrast = texture.sample(0.3f, whiteV, dudx, 0.0f, 0.0f, dvdy).r -
+                                    texture.sample(0.3f, blackV, dudx, 0.0f, 0.0f, dvdy).r;
+    // 三线性按长轴选到 level 3，条纹被平均成灰色
+    EXPECT_LT(trilinearContrast, 0.2f);
+
+    texture.setFilter(TextureFilter::Anisotropic);
+    const float white = texture.sample(0.3f, whiteV, dudx, 0.0f, 0.0f, dvdy).r;
+    const float black = texture.sample(0.3f, blackV, dudx, 0.0f, 0.0f, dvdy).r;
+    EXPECT_GT(white, 0.95f);
+    EXPECT_LT(black, 0.05f);
+
+    // 批量采样与逐个采样一致
+    float u[8], v[8];
+    for (int i = 0; i < 8; ++i) {
+        u[i] = 0.1f * i - 0.2f;
+        v[i] = 0.07f * i + 0.01f;
+    }
+    Color out[8];
+    texture.sample8(u, v, dudx, 0.3f / size, -0.5f / size, dvdy, out);
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_EQ(out[i].toUint32(), texture.sample(u[i], v[i], dudx, 0.3f / size, -0.5f / size, dvdy).toUint32());
+    }
+}
+
+TEST(AnisotropicFilteringTest, TapCountIsCappedAndRaisesMipLevel) {
+    const int size = 64;
+    Texture texture = makeLevelCodedTexture(size);
+    texture.setFilter(TextureFilter::Anisotropic);
+    auto levelAt = [&](float major, float minor) {
+        // 长轴沿屏幕 y、短轴沿屏幕 x，验证长轴方向不限于 x
+        return texture.sample(0.3f, 0.6f, minor / size, 0.0f, 0.0f, major / size).r * 255.0f / 16.0f;
+    };
+
+    // 8:1 的 footprint 在上限内：8 个 level 0 样本
+    EXPECT_EQ(texture.getMaxAnisotropy(), Texture::kMaxAnisotropy);
+    EXPECT_NEAR(levelAt(8.0f, 1.0f), 0.0f, 1e-4f);
+    // 32:1 超出 16 个样本：长轴 / 16 = 2，取 level 1
+    EXPECT_NEAR(levelAt(32.0f, 1.0f), 1.0f, 1e-4f);
+
+    // 上限为 2 时 8:1 只取 2 个样本，mip 级按 8 / 2 = 4 选到 level 2
+    texture.setMaxAnisotropy(2);
+    EXPECT_NEAR(levelAt(8.0f, 1.0f), 2.0f, 1e-4f);
+    // 上限为 1 即各向同性（按长轴长度）的三线性
+    texture.setMaxAnisotropy(0);
+    EXPECT_EQ(texture.getMaxAnisotropy(), 1);
+    EXPECT_NEAR(levelAt(8.0f, 1.0f), 3.0f, 1e-4f);
+    texture.setMaxAnisotropy(100);
+    EXPECT_EQ(texture.getMaxAnisotropy(), Texture::kMaxAnisotropy);
+
+    // 3:1 在短轴为 2 个纹素时：3 个样本，每个覆盖 2 个纹素，取 level 1
+    EXPECT_NEAR(levelAt(6.0f, 2.0f), 1.0f, 1e-4f);
+
+    // 均匀纹理上任意数量样本的平均仍是原色（整数平均不引入偏差）
+    Texture flat(std::vector<uint32_t>(32 * 32, Color(0.2f, 0.6f, 0.9f, 1.0f).toUint32()), 32, 32, true);
+    flat.setFilter(TextureFilter::Anisotropic);
+    for (float major : {2.0f, 3.0f, 5.0f, 7.0f, 11.0f, 16.0f}) {
+        EXPECT_EQ(flat.sample(0.4f, 0.2f, major / 32.0f, 0.0f, 0.0f, 1.0f / 32.0f).toUint32(),
+                  Color(0.2f, 0.6f, 0.9f, 1.0f).toUint32());
+    }
+}
+
+TEST(AnisotropicFilteringTest, DegenerateMinorAxisUsesCappedTapCount) {
+    // 近乎侧视的三角形：短轴极小时长短轴之比远超 int 范围，仍按上限取样而不是返回透明黑
+    Texture white(std::vector<uint32_t>(256 * 256, Color::WHITE.toUint32()), 256, 256, true);
+    white.setFilter(TextureFilter::Anisotropic);
+    for (float minor : {1e-11f, 1e-20f, 0.0f}) {
+        EXPECT_EQ(white.sample(0.3f, 0.4f, 0.5f, 0.0f, 0.0f, minor).toUint32(), Color::WHITE.toUint32());
+    }
+
+    // 样本数截断为上限 16：长轴 32 纹素时取 level 1，与短轴多小无关
+    const int size = 64;
+    Texture coded = makeLevelCodedTexture(size);
+    coded.setFilter(TextureFilter::Anisotropic);
+    EXPECT_NEAR(coded.sample(0.3f, 0.6f, 32.0f / size, 0.0f, 0.0f, 1e-12f).r * 255.0f / 16.0f, 1.0f, 1e-4f);
+}
+
+TEST(AnisotropicFilteringTest, GroundPlaneKeepsDistantContrast) {
+    // 贴近地面的相机看向远处的棋盘格平面：远处三线性被模糊成灰色，各向异性保留更多明暗对比
+    Scene::Camera camera;
+    camera.setPerspective(Core::Math::Constants::PI / 3.0f, 96.0f / 64.0f, 0.1f, 100.0f);
+    camera.lookAt(Core::Math::Vector3(0.0f, 0.4f, 4.0f), Core::Math::Vector3(0.0f, 0.0f, -4.0f),
+                  Core::Math::Vector3(0.0f, 1.0f, 0.0f));
+
+    Texture checker(256, 256);
+    checker.generateCheckerboard(Color::WHITE, Color::BLACK, 8);
+    std::unique_ptr<Core::Types::Material> material(Core::Types::Material::createWhiteDiffuse());
+    material->setDiffuseMap(&checker);
+    std::unique_ptr<Scene::Mesh> plane(Scene::Mesh::createPlane(10.0f, 10.0f, 8));
+    plane->setMaterial(material.get());
+
+    Scene::Scene scene;
+    scene.setCamera(&camera);
+    scene.setAmbientLight(Color::WHITE);
+    scene.setBackgroundColor(Color::BLACK);
+    scene.addObject(plane.get(), Core::Math::Matrix4::rotationX(-Core::Math::Constants::PI / 2.0f));
+
+    Renderer::Pipeline::SoftwareRendererSettings settings;
+    settings.width = 96;
+    settings.height = 64;
+    settings.aaMode = Renderer::Pipeline::AntiAliasingMode::None;
+    settings.backfaceCulling = false;
+
+    auto distantContrast = [&](TextureFilter filter) {
+        checker.setFilter(filter);
+        Renderer::Pipeline::SoftwareRenderer renderer(settings);
+        renderer.render(scene);
+        // 远处的几行：相邻像素亮度差的平均值
+        const Renderer::Pipeline::RenderTarget& target = renderer.getRenderTarget();
+        float sum = 0.0f;
+        int count = 0;
+        for (int y = 28; y < 34; ++y) {
+            for (int x = 1; x < settings.width; ++x) {
+                const float a = target.getPixel(x, y).r;
+                const float b = target.getPixel(x - 1, y).r;
+                const float c = target.getPixel(x, y + 1).r;
+                sum += std::fabs(a - b) + std::fabs(a - c);
+                count += 2;
+            }
+        }
+        return sum / count;
+    };
+    const float trilinear = distantContrast(TextureFilter::Trilinear);
+    const float anisotropic = distantContrast(TextureFilter::Anisotropic);
+    EXPECT_GT(anisotropic, trilinear * 1.5f);
+}
@@ -0,0 +1,357 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/types/block_compression.h"
+#include "core/types/texture.h"
+#include "core/types/texture_cache.h"
+
+#include "texture_test_utils.h"
+
+using Core::Types::Color;
+using Core::Types::Texture;
+using Core::Types::TextureFilter;
+using Core::Types::TextureFormat;
+using Core::Types::TextureLayout;
+using TextureTestUtils::channel;
+using TextureTestUtils::packRgba;
+
+namespace {
+
+// 每个通道的最大绝对误差
+int maxChannelError(uint32_t a, uint32_t b, int channels = 4) {
+    int error = 0;
+    for (int c = 0; c < channels; ++c) {
+        error = std::max(error, std::abs(channel(a, c) - channel(b, c)));
+    }
+    return error;
+}
+
+// 平滑的颜色场：纹理压缩的典型输入（照片、漫反射贴图）。小纹理按 64 纹素的尺度取值，梯度不会过陡；
+// opaque 时 alpha 为 255（BC1 会把 alpha < 128 的纹素编码为透明）
+std::vector<uint32_t> smoothImage(int width, int height, bool opaque = false) {
+    std::vector<uint32_t> pixels(static_cast<std::size_t>(width) * height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const float fx = static_cast<float>(x) / std::max(width, 64);
+            const float fy = static_cast<float>(y) / std::max(height, 64);
+            const auto level = [](float t) { return static_cast<uint32_t>(std::clamp(t, 0.0f, 1.0f) * 255.0f + 0.5f); };
+            pixels[static_cast<std::size_t>(y) * width + x] =
+                packRgba(level(fx), level(0.5f + 0.5f * std::sin(fy * 6.0f)), level(1.0f - 0.5f * (fx + fy)),
+                         opaque ? 255u : level(0.25f + 0.75f * fy));
+        }
+    }
+    return pixels;
+}
+
+std::size_t blockBytes(int width, int height, std::size_t bytesPerBlock) {
+    std::size_t bytes = 0;
+    while (true) {
+        bytes += static_cast<std::size_t>((width + 3) / 4) * ((height + 3) / 4) * bytesPerBlock;
+        if (width == 1 && height == 1) break;
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+    }
+    return bytes;
+}
+
+} // namespace
+
+TEST(BlockCompressionTest, DecodesBc1PaletteModes) {
+    // 四色模式：红 → 蓝，索引按纹素序号取 0..3
+    uint64_t indices = 0;
+    for (int i = 0; i < 16; ++i) {
+        indices |= static_cast<uint64_t>(i & 3) << (2 * i);
+    }
+    uint32_t texels[16];
+    Core::Types::decodeBC1Block(0xF800u | (0x001Full << 16) | (indices << 32), texels);
+    const uint32_t four[4] = {packRgba(255, 0, 0, 255), packRgba(0, 0, 255, 255), packRgba(170, 0, 85, 255),
+                              packRgba(85, 0, 170, 255)};
+    for (int i = 0; i < 16; ++i) {
+        EXPECT_EQ(texels[i], four[i & 3]) << i;
+    }
+
+    // 三色模式（c0 <= c1）：中点 + 透明黑色
+    Core::Types::decodeBC1Block(0x001Fu | (0xF800ull << 16) | (indices << 32), texels);
+    const uint32_t three[4] = {packRgba(0, 0, 255, 255), packRgba(255, 0, 0, 255), packRgba(128, 0, 128, 255), 0u};
+    for (int i = 0; i < 16; ++i) {
+        EXPECT_EQ(texels[i], three[i & 3]) << i;
+    }
+}
+
+TEST(BlockCompressionTest, DecodesBc3AlphaModes) {
+    uint64_t alphaIndices = 0;
+    for (int i = 0; i < 16; ++i) {
+        alphaIndices |= static_cast<uint64_t>(i & 7) << (16 + 3 * i);
+    }
+    const uint64_t color = 0xFFFFu | (0xFFFFull << 16); // 白色，索引全 0
+    uint32_t texels[16];
+
+    const uint64_t eight[2] = {200u | (10u << 8) | alphaIndices, color};
+    Core::Types::decodeBC3Block(eight, texels);
+    const uint32_t eightAlpha[8] = {200, 10, 173, 146, 119, 91, 64, 37};
+    for (int i = 0; i < 16; ++i) {
+        EXPECT_EQ(texels[i], packRgba(255, 255, 255, eightAlpha[i & 7])) << i;
+    }
+
+    const uint64_t six[2] = {10u | (200u << 8) | alphaIndices, color};
+    Core::Types::decodeBC3Block(six, texels);
+    const uint32_t sixAlpha[8] = {10, 200, 48, 86, 124, 162, 0, 255};
+    for (int i = 0; i < 16; ++i) {
+        EXPECT_EQ(texels[i] & 0xFFu, sixAlpha[i & 7]) << i;
+    }
+}
+
+TEST(BlockCompressionTest, EncodesSolidAndTwoColorBlocksAccurately) {
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<uint32_t> dist(0, 255);
+    for (int trial = 0; trial < 200; ++trial) {
+        uint32_t texels[16];
+        const uint32_t solid = packRgba(dist(rng), dist(rng), dist(rng), 255);
+        std::fill(texels, texels + 16, solid);
+        uint32_t decoded[16];
+        Core::Types::decodeBC1Block(Core::Types::encodeBC1Block(texels), decoded);
+        for (uint32_t texel : decoded) {
+            // RGB565 量化：红 / 蓝最多差 4，绿最多差 2
+            ASSERT_LE(std::abs(channel(texel, 0) - channel(solid, 0)), 4);
+            ASSERT_LE(std::abs(channel(texel, 1) - channel(solid, 1)), 2);
+            ASSERT_LE(std::abs(channel(texel, 2) - channel(solid, 2)), 4);
+            ASSERT_EQ(channel(texel, 3), 255);
+        }
+
+        // 两种颜色的任意排列：端点就是这两种颜色
+        const uint32_t other = packRgba(dist(rng), dist(rng), dist(rng), 255);
+        for (int i = 0; i < 16; ++i) {
+            texels[i] = (rng() & 1u) ? solid : other;
+        }
+        Core::Types::decodeBC1Block(Core::Types::encodeBC1Block(texels), decoded);
+        for (int i = 0; i < 16; ++i) {
+            ASSERT_LE(maxChannelError(decoded[i], texels[i], 3), 4) << trial << " " << i;
+        }
+    }
+}
+
+TEST(BlockCompressionTest, Bc1KeepsPunchThroughAlpha) {
+    uint32_t texels[16];
+    for (int i = 0; i < 16; ++i) {
+        texels[i] = (i % 3 == 0) ? packRgba(40, 90, 200, 20) : packRgba(200 - i * 2, 100, 50 + i, 230);
+    }
+    uint32_t decoded[16];
+    Core::Types::decodeBC1Block(Core::Types::encodeBC1Block(texels), decoded);
+    for (int i = 0; i < 16; ++i) {
+        if (i % 3 == 0) {
+            EXPECT_EQ(decoded[i], 0u) << i;
+        } else {
+            EXPECT_EQ(decoded[i] & 0xFFu, 255u) << i;
+            EXPECT_LE(maxChannelError(decoded[i], texels[i], 3), 12) << i;
+        }
+    }
+
+    std::fill(texels, texels + 16, packRgba(1, 2, 3, 0));
+    Core::Types::decodeBC1Block(Core::Types::encodeBC1Block(texels), decoded);
+    for (uint32_t texel : decoded) {
+        EXPECT_EQ(texel, 0u);
+    }
+}
+
+TEST(BlockCompressionTest, Bc3EncodesAlphaGradients) {
+    uint32_t texels[16];
+    for (int i = 0; i < 16; ++i) {
+        texels[i] = packRgba(120, 60, 30, static_cast<uint32_t>(17 + i * 13));
+    }
+    uint64_t block[2];
+    Core::Types::encodeBC3Block(texels, block);
+    uint32_t decoded[16];
+    Core::Types::decodeBC3Block(block, decoded);
+    for (int i = 0; i < 16; ++i) {
+        // 8 级插值：误差不超过相邻两级间距的一半
+        EXPECT_LE(std::abs(channel(decoded[i], 3) - channel(texels[i], 3)), (15 * 13) / 14 + 1) << i;
+        EXPECT_LE(maxChannelError(decoded[i], texels[i], 3), 4) << i;
+    }
+    EXPECT_EQ(decoded[0] & 0xFFu, 17u);
+    EXPECT_EQ(decoded[15] & 0xFFu, 17u + 15u * 13u);
+}
+
+TEST(CompressedTextureTest, ReducesMemoryFourToEightTimes) {
+    const std::vector<uint32_t> pixels = smoothImage(256, 128);
+    Texture bc1(pixels, 256, 128, true);
+    Texture bc3(pixels, 256, 128, true);
+    const std::size_t rgbaBytes = bc1.getMemoryUsage();
+
+    bc1.setFormat(TextureFormat::BC1);
+    bc3.setFormat(TextureFormat::BC3);
+    EXPECT_EQ(bc1.getFormat(), TextureFormat::BC1);
+    EXPECT_EQ(bc1.getMemoryUsage(), blockBytes(256, 128, 8));
+    EXPECT_EQ(bc3.getMemoryUsage(), blockBytes(256, 128, 16));
+    EXPECT_GT(static_cast<double>(rgbaBytes) / bc1.getMemoryUsage(), 7.9);
+    EXPECT_GT(static_cast<double>(rgbaBytes) / bc3.getMemoryUsage(), 3.95);
+    EXPECT_EQ(bc1.getPixels(), nullptr);
+
+    // 压缩纹理的 mip 不可释放
+    EXPECT_FALSE(bc1.hasResidentMipmaps());
+    EXPECT_EQ(bc1.releaseMipmaps(), 0u);
+}
+
+TEST(CompressedTextureTest, SamplesCloseToUncompressedTexture) {
+    const int width = 64, height = 48;
+    const std::vector<uint32_t> pixels = smoothImage(width, height);
+    const std::vector<uint32_t> opaquePixels = smoothImage(width, height, true);
+    for (TextureFormat format : {TextureFormat::BC1, TextureFormat::BC3}) {
+        const std::vector<uint32_t>& source = format == TextureFormat::BC1 ? opaquePixels : pixels;
+        Texture reference(source, width, height, true);
+        Texture compressed(source, width, height, true);
+        compressed.setFormat(format);
+        for (TextureFilter filter : {TextureFilter::Bilinear, TextureFilter::Trilinear, TextureFilter::Anisotropic}) {
+            reference.setFilter(filter);
+            compressed.setFilter(filter);
+            for (int i = 0; i < 500; ++i) {
+                const float u = 0.013f * i;
+                const float v = 0.0071f * i * i;
+                const float d = 0.0005f * (i % 40); // footprint 0–1.3 纹素：level 0 与 level 1
+                const Color a = reference.sample(u, v, d, 0.0f, 0.0f, d * 0.25f);
+                const Color b = compressed.sample(u, v, d, 0.0f, 0.0f, d * 0.25f);
+                // 块内颜色不共线（平面渐变）时端点连线无法覆盖，单个纹素可差十几个量化级
+                ASSERT_NEAR(a.r, b.r, 0.08f) << i;
+                ASSERT_NEAR(a.g, b.g, 0.08f) << i;
+                ASSERT_NEAR(a.b, b.b, 0.08f) << i;
+                if (format == TextureFormat::BC3) {
+                    ASSERT_NEAR(a.a, b.a, 0.08f) << i;
+                }
+            }
+        }
+    }
+}
+
+TEST(CompressedTextureTest, BatchAndConcurrentSamplingMatchScalarSampling) {
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> dist(-2.0f, 2.0f);
+    Texture first(smoothImage(96, 80, true), 96, 80, true);
+    Texture second(smoothImage(40, 40), 40, 40, true);
+    first.setFormat(TextureFormat::BC1);
+    second.setFormat(TextureFormat::BC3);
+    first.setFilter(TextureFilter::Trilinear);
+
+    std::vector<float> u(4096), v(4096);
+    for (std::size_t i = 0; i < u.size(); ++i) {
+        u[i] = dist(rng);
+        v[i] = dist(rng);
+    }
+    const float dudx = 0.02f, dvdy = 0.015f;
+    std::vector<uint32_t> expected(u.size() * 2);
+    for (std::size_t i = 0; i < u.size(); ++i) {
+        expected[2 * i] = first.sample(u[i], v[i], dudx, 0.0f, 0.0f, dvdy).toUint32();
+        expected[2 * i + 1] = second.sample(u[i], v[i]).toUint32();
+    }
+
+    Color batch[8];
+    for (std::size_t i = 0; i + 8 <= u.size(); i += 8) {
+        first.sample8(&u[i], &v[i], dudx, 0.0f, 0.0f, dvdy, batch);
+        for (int k = 0; k < 8; ++k) {
+            ASSERT_EQ(batch[k].toUint32(), expected[2 * (i + k)]) << i + k;
+        }
+    }
+
+    // 解码缓存是线程局部的：多个线程交替读取两张压缩纹理，结果与单线程一致
+    std::vector<int> mismatches(4, 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t] {
+            for (std::size_t i = static_cast<std::size_t>(t); i < u.size(); i += 2) {
+                mismatches[t] += first.sample(u[i], v[i], dudx, 0.0f, 0.0f, dvdy).toUint32() != expected[2 * i];
+                mismatches[t] += second.sample(u[i], v[i]).toUint32() != expected[2 * i + 1];
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    for (int count : mismatches) {
+        EXPECT_EQ(count, 0);
+    }
+}
+
+TEST(CompressedTextureTest, HandlesPartialBlocksAndLayouts) {
+    const int width = 13, height = 7;
+    const std::vector<uint32_t> pixels = smoothImage(width, height);
+    Texture texture(pixels, width, height, true);
+    Texture reference(pixels, width, height, true);
+    texture.setFormat(TextureFormat::BC3);
+    for (int level = 0; level < 4; ++level) {
+        for (int y = 0; y < texture.getHeight(level); ++y) {
+            for (int x = 0; x < texture.getWidth(level); ++x) {
+                ASSERT_LE(maxChannelError(texture.getPixel(x, y, level).toUint32(),
+                                          reference.getPixel(x, y, level).toUint32()),
+                          24)
+                    << level << " " << x << "," << y;
+            }
+        }
+    }
+
+    // 压缩状态下切换布局只影响解压后的存储
+    std::vector<uint32_t> decoded;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            decoded.push_back(texture.getPixel(x, y).toUint32());
+        }
+    }
+    texture.setLayout(TextureLayout::Tiled);
+    texture.setFormat(TextureFormat::RGBA8);
+    EXPECT_EQ(texture.getLayout(), TextureLayout::Tiled);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            ASSERT_EQ(texture.getPixel(x, y).toUint32(), decoded[y * width + x]) << x << "," << y;
+        }
+    }
+}
+
+TEST(CompressedTextureTest, WritesDecompressFirst) {
+    const std::vector<uint32_t> pixels = smoothImage(32, 32, true);
+    Texture texture(pixels, 32, 32, true);
+    texture.setFormat(TextureFormat::BC1);
+    const Color before = texture.getPixel(5, 9);
+
+    texture.setPixel(20, 20, Color::RED);
+    EXPECT_EQ(texture.getFormat(), TextureFormat::RGBA8);
+    ASSERT_NE(texture.getPixels(), nullptr);
+    EXPECT_EQ(texture.getPixel(20, 20).toUint32(), Color::RED.toUint32());
+    EXPECT_EQ(texture.getPixel(5, 9).toUint32(), before.toUint32());
+    EXPECT_EQ(texture.getMemoryUsage(), Texture(pixels, 32, 32, true).getMemoryUsage());
+
+    // 再次压缩时 mip 按写入后的 level 0 重建
+    texture.clear(Color::BLUE);
+    texture.setFormat(TextureFormat::BC1);
+    EXPECT_EQ(texture.getPixel(0, 0, 3).toUint32(), Color::BLUE.toUint32());
+}
+
+TEST(CompressedTextureTest, CacheCompressesAtLoadTime) {
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "block_compression_tests";
+    std::filesystem::create_directories(dir);
+    const std::filesystem::path path = dir / "compressed.ppm";
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "P6\n64 64\n255\n";
+        for (uint32_t texel : smoothImage(64, 64, true)) {
+            file.put(static_cast<char>(texel >> 24));
+            file.put(static_cast<char>(texel >> 16));
+            file.put(static_cast<char>(texel >> 8));
+        }
+    }
+
+    Core::Types::TextureCache cache;
+    cache.setCompression(TextureFormat::BC1);
+    Texture* texture = cache.load(path.string());
+    ASSERT_NE(texture, nullptr);
+    EXPECT_EQ(texture->getFormat(), TextureFormat::BC1);
+    EXPECT_EQ(cache.getMemoryUsage(), blockBytes(64, 64, 8));
+    const std::vector<Texture*> batch = cache.loadAll({path.string()});
+    EXPECT_EQ(batch[0], texture);
+}
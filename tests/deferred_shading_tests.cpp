@@ -0,0 +1,206 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "core/types/material.h"
+#include "core/types/texture.h"
+#include "renderer/lighting/light.h"
+#include "renderer/pipeline/gbuffer.h"
+#include "renderer/pipeline/software_renderer.h"
+#include "scene/camera.h"
+#include "scene/mesh.h"
+#include "scene/scene.h"
+
+#include "render_test_utils.h"
+
+using namespace Renderer::Pipeline;
+using Core::Math::Matrix4;
+using Core::Math::Vector3;
+using Core::Types::Color;
+using Renderer::Lighting::DirectionalLight;
+using Renderer::Lighting::PointLight;
+using Renderer::Lighting::SpotLight;
+
+namespace {
+constexpr float PI = Core::Math::Constants::PI;
+constexpr int W = 64;
+constexpr int H = 48;
+
+// 平面前叠放几个球，形成多层不透明重叠；点光源与聚光灯分布在平面前方
+struct ManyLightScene {
+    Scene::Camera camera;
+    std::unique_ptr<Scene::Mesh> plane{Scene::Mesh::createQuad(4.0f, 3.0f)};
+    std::vector<std::unique_ptr<Scene::Mesh>> spheres;
+    std::unique_ptr<Core::Types::Texture> checker{new Core::Types::Texture(32, 32)};
+    std::unique_ptr<Core::Types::Material> planeMaterial{new Core::Types::Material()};
+    std::unique_ptr<Core::Types::Material> sphereMaterial{Core::Types::Material::createRedPlastic()};
+    std::vector<std::unique_ptr<PointLight>> points;
+    std::vector<std::unique_ptr<SpotLight>> spots;
+    DirectionalLight sun{Vector3(-0.3f, -0.4f, -1.0f), Color::WHITE, 0.4f};
+    Scene::Scene scene;
+
+    ManyLightScene() {
+        camera.setPerspective(PI / 3.0f, static_cast<float>(W) / H, 0.1f, 100.0f);
+        camera.lookAt(Vector3(0.0f, 0.0f, 4.0f), Vector3(0.0f, 0.0f, 0.0f), Vector3(0.0f, 1.0f, 0.0f));
+        scene.setCamera(&camera);
+
+        checker->generateCheckerboard(Color::WHITE, Color(0.3f, 0.5f, 0.8f, 1.0f), 4);
+        planeMaterial->setDiffuseMap(checker.get());
+        plane->setMaterial(planeMaterial.get());
+        scene.addObject(plane.get());
+        for (int i = 0; i < 3; ++i) {
+            spheres.emplace_back(Scene::Mesh::createSphere(0.4f, 12));
+            spheres.back()->setMaterial(sphereMaterial.get());
+            scene.addObject(spheres.back().get(), Matrix4::translation(-0.8f + 0.4f * i, 0.2f * i - 0.2f, 0.3f + 0.3f * i));
+        }
+
+        std::mt19937 rng(37);
+        std::uniform_real_distribution<float> x(-2.0f, 2.0f);
+        std::uniform_real_distribution<float> y(-1.5f, 1.5f);
+        std::uniform_real_distribution<float> hue(0.2f, 1.0f);
+        for (int i = 0; i < 24; ++i) {
+            points.emplace_back(new PointLight(Vector3(x(rng), y(rng), 0.6f), Color(hue(rng), hue(rng), hue(rng), 1.0f),
+                                               0.8f, 1.2f));
+            scene.addLight(points.back().get());
+        }
+        for (int i = 0; i < 4; ++i) {
+            spots.emplace_back(new SpotLight(Vector3(-1.2f + 0.8f * i, -0.6f, 1.5f), Vector3(0.1f, 0.3f, -1.0f),
+                                             PI / 16.0f, PI / 10.0f, Color::WHITE, 1.5f, 4.0f));
+            scene.addLight(spots.back().get());
+        }
+        sun.setCastShadows(true);
+        scene.addLight(&sun);
+    }
+};
+
+SoftwareRendererSettings makeSettings() {
+    SoftwareRendererSettings settings = RenderTestUtils::makeSettings(W, H);
+    settings.lightTileSize = 8;
+    // 光照阶段逐像素调用标量 shadeSurface，以标量前向路径为参照
+    settings.packetShading = false;
+    return settings;
+}
+
+} // namespace
+
+TEST(DeferredShadingTest, OctahedralNormalRoundTrip) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    for (int i = 0; i < 1000; ++i) {
+        Vector3 n(unit(rng), unit(rng), unit(rng));
+        if (n.length() < 0.1f) {
+            continue;
+        }
+        n = n.normalize();
+        float u, v;
+        encodeOctahedral(n, u, v);
+        EXPECT_LE(std::fabs(u), 1.0f);
+        EXPECT_LE(std::fabs(v), 1.0f);
+        const Vector3 decoded = decodeOctahedral(u, v);
+        EXPECT_GT(decoded.dot(n), 1.0f - 1e-6f);
+    }
+    // 坐标轴方向（含 -z 半球的折叠边界）
+    for (const Vector3& n : {Vector3(0.0f, 0.0f, 1.0f), Vector3(0.0f, 0.0f, -1.0f), Vector3(1.0f, 0.0f, 0.0f),
+                             Vector3(0.0f, -1.0f, 0.0f)}) {
+        float u, v;
+        encodeOctahedral(n, u, v);
+        EXPECT_GT(decodeOctahedral(u, v).dot(n), 1.0f - 1e-6f);
+    }
+}
+
+TEST(DeferredShadingTest, MatchesForwardWithManyLights) {
+    ManyLightScene s;
+    SoftwareRendererSettings settings = makeSettings();
+    SoftwareRenderer forward(settings);
+    forward.render(s.scene);
+
+    settings.deferredShading = true;
+    SoftwareRenderer deferred(settings);
+    deferred.render(s.scene);
+    EXPECT_LT(RenderTestUtils::maxDifference(forward.getRenderTarget(), deferred.getRenderTarget()), 1e-5f);
+    EXPECT_EQ(deferred.getStats().fragments, forward.getStats().fragments);
+    EXPECT_LE(deferred.getStats().shadeInvocations, forward.getStats().shadeInvocations);
+}
+
+TEST(DeferredShadingTest, ShadesEachPixelOnceUnderOverdraw) {
+    // 长地面的三角形按重心深度排序，其中一个先于球绘制，球随后覆盖它的像素：前向路径在这些像素上着色两次
+    ManyLightScene s;
+    std::unique_ptr<Scene::Mesh> floor(Scene::Mesh::createQuad(8.0f, 100.0f));
+    floor->setMaterial(s.planeMaterial.get());
+    Scene::Scene scene;
+    scene.setCamera(&s.camera);
+    scene.setAmbientLight(Color(0.2f, 0.2f, 0.2f, 1.0f));
+    scene.addObject(floor.get(), Matrix4::translation(0.0f, -1.0f, -47.0f) * Matrix4::rotationX(-PI / 2.0f));
+    scene.addObject(s.spheres[0].get(), Matrix4::translation(0.0f, -0.2f, 0.0f) * Matrix4::scale(2.0f, 2.0f, 2.0f));
+    for (const auto& point : s.points) {
+        scene.addLight(point.get());
+    }
+
+    SoftwareRendererSettings settings = makeSettings();
+    settings.backfaceCulling = false;
+    SoftwareRenderer forward(settings);
+    forward.render(scene);
+
+    settings.deferredShading = true;
+    SoftwareRenderer deferred(settings);
+    deferred.render(scene);
+    EXPECT_LT(RenderTestUtils::maxDifference(forward.getRenderTarget(), deferred.getRenderTarget()), 1e-5f);
+
+    // 延迟路径每个被覆盖的像素只着色一次
+    EXPECT_LE(deferred.getStats().shadeInvocations, static_cast<uint64_t>(W * H));
+    EXPECT_GT(forward.getStats().shadeInvocations, deferred.getStats().shadeInvocations);
+}
+
+TEST(DeferredShadingTest, MatchesForwardWithSsaa) {
+    ManyLightScene s;
+    SoftwareRendererSettings settings = makeSettings();
+    settings.aaMode = AntiAliasingMode::SSAA;
+    settings.ssaaFactor = 2;
+    SoftwareRenderer forward(settings);
+    forward.render(s.scene);
+
+    settings.deferredShading = true;
+    SoftwareRenderer deferred(settings);
+    deferred.render(s.scene);
+    EXPECT_LT(RenderTestUtils::maxDifference(forward.getRenderTarget(), deferred.getRenderTarget()), 1e-5f);
+}
+
+TEST(DeferredShadingTest, VertexLitAndTransparentObjects) {
+    ManyLightScene s;
+    // 一个逐顶点光照的立方体与一个半透明球：前者以已着色颜色写入 G-buffer，后者在光照阶段之后前向混合
+    s.sphereMaterial->setLightingFrequency(Core::Types::LightingFrequency::PerVertex);
+    std::unique_ptr<Scene::Mesh> glass(Scene::Mesh::createSphere(0.5f, 12));
+    std::unique_ptr<Core::Types::Material> glassMaterial(new Core::Types::Material());
+    glassMaterial->setDiffuse(Color(0.2f, 0.9f, 0.4f, 0.5f));
+    glass->setMaterial(glassMaterial.get());
+    s.scene.addObject(glass.get(), Matrix4::translation(0.6f, -0.3f, 1.2f));
+
+    SoftwareRendererSettings settings = makeSettings();
+    SoftwareRenderer forward(settings);
+    forward.render(s.scene);
+    ASSERT_GT(forward.getStats().vertexShadeInvocations, 0u);
+
+    settings.deferredShading = true;
+    SoftwareRenderer deferred(settings);
+    deferred.render(s.scene);
+    EXPECT_LT(RenderTestUtils::maxDifference(forward.getRenderTarget(), deferred.getRenderTarget()), 1e-5f);
+    EXPECT_EQ(deferred.getStats().vertexShadeInvocations, forward.getStats().vertexShadeInvocations);
+}
+
+TEST(DeferredShadingTest, OrthographicFallsBackToAllLights) {
+    ManyLightScene s;
+    s.camera.setOrthographic(-2.0f, 2.0f, -1.5f, 1.5f, 0.1f, 100.0f);
+
+    SoftwareRendererSettings settings = makeSettings();
+    SoftwareRenderer forward(settings);
+    forward.render(s.scene);
+
+    settings.deferredShading = true;
+    SoftwareRenderer deferred(settings);
+    deferred.render(s.scene);
+    EXPECT_LT(RenderTestUtils::maxDifference(forward.getRenderTarget(), deferred.getRenderTarget()), 1e-5f);
+}
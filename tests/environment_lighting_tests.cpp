@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+#include "core/types/material.h"
+#include "core/types/texture.h"
+#include "renderer/lighting/environment_light.h"
+#include "renderer/lighting/light.h"
+#include "renderer/pipeline/software_renderer.h"
+#include "scene/camera.h"
+#include "scene/mesh.h"
+#include "scene/scene.h"
+
+#include "render_test_utils.h"
+
+using namespace Renderer::Pipeline;
+using Core::Math::Vector3;
+using Core::Types::Color;
+using Renderer::Lighting::DirectionalLight;
+using Renderer::Lighting::EnvironmentLight;
+
+namespace {
+constexpr float PI = Core::Math::Constants::PI;
+
+// 暴力积分 (1/π)∫ L(ω) max(0, n·ω) dω，作为球谐近似的参照
+Color bruteForceDiffuse(const EnvironmentLight& environment, const Vector3& n) {
+    constexpr int kTheta = 256;
+    constexpr int kPhi = 512;
+    const float dTheta = PI / kTheta;
+    const float dPhi = 2.0f * PI / kPhi;
+    float r = 0.0f, g = 0.0f, b = 0.0f;
+    for (int t = 0; t < kTheta; ++t) {
+        const float theta = (t + 0.5f) * dTheta;
+        for (int p = 0; p < kPhi; ++p) {
+            const float phi = (p + 0.5f) * dPhi;
+            const Vector3 dir(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+            const float cosine = std::max(0.0f, n.dot(dir));
+            if (cosine <= 0.0f) {
+                continue;
+            }
+            const Color L = environment.radiance(dir);
+            const float w = cosine * std::sin(theta) * dTheta * dPhi / PI;
+            r += L.r * w;
+            g += L.g * w;
+            b += L.b * w;
+        }
+    }
+    return Color(r, g, b, 1.0f);
+}
+
+struct SphereScene {
+    Scene::Camera camera;
+    std::unique_ptr<Scene::Mesh> sphere{Scene::Mesh::createSphere(1.0f, 24)};
+    std::unique_ptr<Core::Types::Material> material{Core::Types::Material::createWhiteDiffuse()};
+    Scene::Scene scene;
+
+    SphereScene() {
+        camera.setPerspective(PI / 3.0f, 1.0f, 0.1f, 100.0f);
+        camera.lookAt(Vector3(0.0f, 0.5f, 4.0f), Vector3(0.0f, 0.0f, 0.0f), Vector3(0.0f, 1.0f, 0.0f));
+        material->setSpecular(Color(0.0f, 0.0f, 0.0f, 1.0f));
+        sphere->setMaterial(material.get());
+        scene.setCamera(&camera);
+        scene.addObject(sphere.get());
+    }
+};
+
+} // namespace
+
+TEST(EnvironmentLightingTest, UniformEnvironmentEqualsFlatAmbient) {
+    const Color gray(0.3f, 0.4f, 0.5f, 1.0f);
+    EnvironmentLight environment;
+    environment.setGradientSky(gray, gray, gray);
+    const auto& sh = environment.getIrradiance();
+    for (const Vector3& n : {Vector3(0.0f, 1.0f, 0.0f), Vector3(1.0f, 0.0f, 0.0f), Vector3(0.0f, -0.6f, 0.8f)}) {
+        const Color e = sh.evaluate(n);
+        EXPECT_NEAR(e.r, gray.r, 2e-3f);
+        EXPECT_NEAR(e.g, gray.g, 2e-3f);
+        EXPECT_NEAR(e.b, gray.b, 2e-3f);
+    }
+
+    SphereScene flat;
+    flat.scene.setAmbientLight(gray);
+    SoftwareRenderer reference(RenderTestUtils::makeSettings(48, 48));
+    reference.render(flat.scene);
+
+    SphereScene sky;
+    sky.scene.setAmbientLight(Color::BLACK);
+    sky.scene.setEnvironment(&environment);
+    SoftwareRenderer renderer(RenderTestUtils::makeSettings(48, 48));
+    renderer.render(sky.scene);
+
+    EXPECT_LT(RenderTestUtils::maxDifference(reference.getRenderTarget(), renderer.getRenderTarget()), 3.0f / 255.0f);
+}
+
+TEST(EnvironmentLightingTest, GradientSkyMatchesCosineIntegral) {
+    EnvironmentLight environment;
+    environment.setGradientSky(Color(0.2f, 0.4f, 0.9f, 1.0f),
+                               Color(0.8f, 0.8f, 0.7f, 1.0f),
+                               Color(0.1f, 0.08f, 0.05f, 1.0f));
+    environment.setIntensity(1.5f);
+    const auto& sh = environment.getIrradiance();
+
+    for (const Vector3& n : {Vector3(0.0f, 1.0f, 0.0f), Vector3(0.0f, -1.0f, 0.0f), Vector3(1.0f, 0.0f, 0.0f),
+                             Vector3(0.6f, 0.8f, 0.0f).normalize(), Vector3(0.3f, -0.4f, 0.866f).normalize()}) {
+        const Color expected = bruteForceDiffuse(environment, n);
+        const Color actual = sh.evaluate(n);
+        // l ≤ 2 对余弦卷积后的环境光误差在几个百分点以内
+        EXPECT_NEAR(actual.r, expected.r, 0.03f * 1.5f);
+        EXPECT_NEAR(actual.g, expected.g, 0.03f * 1.5f);
+        EXPECT_NEAR(actual.b, expected.b, 0.03f * 1.5f);
+    }
+    EXPECT_GT(sh.evaluate(Vector3(0.0f, 1.0f, 0.0f)).b, sh.evaluate(Vector3(0.0f, -1.0f, 0.0f)).b + 0.5f);
+}
+
+TEST(EnvironmentLightingTest, ImageSourceProjectsEquirectangularMap) {
+    // 上半幅为白、下半幅为黑：朝上的法线接近 0.5 + 余弦加权的上半球，朝下几乎全黑
+    Core::Types::Texture image(64, 32, false);
+    for (int y = 0; y < 32; ++y) {
+        for (int x = 0; x < 64; ++x) {
+            image.setPixel(x, y, y < 16 ? Color::WHITE : Color::BLACK);
+        }
+    }
+    EnvironmentLight environment;
+    environment.setImage(&image);
+    const auto& sh = environment.getIrradiance();
+
+    const Color up = sh.evaluate(Vector3(0.0f, 1.0f, 0.0f));
+    const Color down = sh.evaluate(Vector3(0.0f, -1.0f, 0.0f));
+    const Color side = sh.evaluate(Vector3(0.0f, 0.0f, 1.0f));
+    EXPECT_GT(up.r, 0.85f);
+    EXPECT_LT(down.r, 0.15f);
+    EXPECT_NEAR(side.r, 0.5f, 0.05f);
+    EXPECT_NEAR(up.r, bruteForceDiffuse(environment, Vector3(0.0f, 1.0f, 0.0f)).r, 0.1f);
+}
+
+TEST(EnvironmentLightingTest, ProjectsOnlyWhenEnvironmentChanges) {
+    EnvironmentLight environment;
+    SphereScene s;
+    s.scene.setEnvironment(&environment);
+
+    SoftwareRenderer renderer(RenderTestUtils::makeSettings(48, 48));
+    renderer.render(s.scene);
+    renderer.render(s.scene);
+    EXPECT_EQ(environment.getProjectionCount(), 1u);
+
+    environment.setIntensity(1.0f); // 未变化
+    renderer.render(s.scene);
+    EXPECT_EQ(environment.getProjectionCount(), 1u);
+
+    environment.setIntensity(2.0f);
+    renderer.render(s.scene);
+    EXPECT_EQ(environment.getProjectionCount(), 2u);
+}
+
+TEST(EnvironmentLightingTest, PacketShadingMatchesScalarWithEnvironment) {
+    EnvironmentLight environment;
+    environment.setGradientSky(Color(0.2f, 0.4f, 0.9f, 1.0f),
+                               Color(0.8f, 0.8f, 0.7f, 1.0f),
+                               Color(0.1f, 0.08f, 0.05f, 1.0f));
+    SphereScene s;
+    s.scene.setEnvironment(&environment);
+    DirectionalLight sun(Vector3(-0.5f, -1.0f, -0.3f), Color::WHITE, 0.5f);
+    s.scene.addLight(&sun);
+
+    SoftwareRendererSettings settings = RenderTestUtils::makeSettings(48, 48);
+    settings.packetShading = false;
+    SoftwareRenderer scalar(settings);
+    scalar.render(s.scene);
+    settings.packetShading = true;
+    SoftwareRenderer packed(settings);
+    packed.render(s.scene);
+    EXPECT_LT(RenderTestUtils::maxDifference(scalar.getRenderTarget(), packed.getRenderTarget()), 1e-5f);
+
+    // 顶部（法线朝天）偏蓝，底部（朝地）偏暗
+    const Color top = scalar.getRenderTarget().getPixel(24, 14);
+    const Color bottom = scalar.getRenderTarget().getPixel(24, 34);
+    EXPECT_GT(top.b, bottom.b);
+}
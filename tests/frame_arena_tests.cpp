@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "core/platform/frame_arena.h"
+#include "core/types/material.h"
+#include "renderer/lighting/light.h"
+#include "renderer/pipeline/software_renderer.h"
+#include "scene/camera.h"
+#include "scene/mesh.h"
+#include "scene/scene.h"
+
+using Core::Platform::FrameArena;
+using namespace Renderer::Pipeline;
+
+namespace {
+
+struct Wide {
+    alignas(64) float values[16];
+};
+
+// 几个立方体（其中一个半透明）与一个聚光灯，覆盖不透明 / 半透明队列与聚光灯剔除下标
+void buildScene(Scene::Scene& scene, Scene::Camera& camera, std::vector<std::unique_ptr<Scene::Mesh>>& meshes,
+                Core::Types::Material* opaque, Core::Types::Material* glass) {
+    camera.setPerspective(Core::Math::Constants::PI / 3.0f, 48.0f / 32.0f, 0.1f, 100.0f);
+    camera.lookAt(Core::Math::Vector3(2.0f, 3.0f, -6.0f),
+                  Core::Math::Vector3(0.0f, 0.0f, 0.0f),
+                  Core::Math::Vector3(0.0f, 1.0f, 0.0f));
+    scene.setCamera(&camera);
+    for (int i = 0; i < 3; ++i) {
+        meshes.emplace_back(Scene::Mesh::createCube(1.0f));
+        meshes.back()->setMaterial(i == 2 ? glass : opaque);
+        scene.addObject(meshes.back().get(), Core::Math::Matrix4::translation(static_cast<float>(i - 1) * 1.5f, 0.0f, 0.0f));
+    }
+}
+
+} // namespace
+
+TEST(FrameArenaTest, AllocationsAreAlignedAndDisjoint) {
+    FrameArena arena(256);
+    char* a = static_cast<char*>(arena.allocate(3, 1));
+    Wide* wide = arena.allocateArray<Wide>(2);
+    uint32_t* words = arena.allocateArray<uint32_t>(100);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(wide) % 64, 0u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(words) % alignof(uint32_t), 0u);
+
+    std::memset(a, 0x11, 3);
+    std::memset(wide, 0x22, sizeof(Wide) * 2);
+    std::memset(words, 0x33, sizeof(uint32_t) * 100);
+    EXPECT_EQ(a[2], 0x11);
+    EXPECT_EQ(reinterpret_cast<unsigned char*>(wide)[sizeof(Wide) * 2 - 1], 0x22);
+    EXPECT_EQ(words[0], 0x33333333u);
+    EXPECT_GE(arena.getUsed(), 3 + sizeof(Wide) * 2 + sizeof(uint32_t) * 100);
+}
+
+TEST(FrameArenaTest, ResetCoalescesBlocksSoSteadyFramesDoNotGrow) {
+    FrameArena arena(256);
+    auto frame = [&arena]() {
+        arena.reset();
+        for (int i = 0; i < 40; ++i) {
+            uint32_t* block = arena.allocateArray<uint32_t>(50);
+            block[49] = static_cast<uint32_t>(i);
+        }
+    };
+
+    frame();
+    EXPECT_GT(arena.getBlockCount(), 1u);
+    const std::size_t used = arena.getUsed();
+
+    frame();
+    EXPECT_EQ(arena.getBlockCount(), 1u);
+    const std::size_t capacity = arena.getCapacity();
+    EXPECT_GE(capacity, used);
+    const void* first = arena.allocate(0);
+
+    // 与上一帧相同的用量：不再追加块，每帧从同一地址开始
+    frame();
+    EXPECT_EQ(arena.getBlockCount(), 1u);
+    EXPECT_EQ(arena.getCapacity(), capacity);
+    arena.reset();
+    EXPECT_EQ(arena.getUsed(), 0u);
+    EXPECT_LE(static_cast<const char*>(arena.allocate(0)), static_cast<const char*>(first));
+}
+
+TEST(FrameArenaTest, LargeAllocationGetsItsOwnBlock) {
+    FrameArena arena(256);
+    arena.allocate(16);
+    unsigned char* big = static_cast<unsigned char*>(arena.allocate(10000));
+    std::memset(big, 0x5A, 10000);
+    EXPECT_GE(arena.getCapacity(), 10000u + 256u);
+    arena.reset();
+    EXPECT_EQ(arena.getBlockCount(), 1u);
+    EXPECT_NE(arena.allocate(10000), nullptr);
+    EXPECT_EQ(arena.getBlockCount(), 1u);
+}
+
+TEST(FrameArenaTest, RendererReusesFrameStorage) {
+    Scene::Scene scene;
+    Scene::Camera camera;
+    std::vector<std::unique_ptr<Scene::Mesh>> meshes;
+    std::unique_ptr<Core::Types::Material> opaque(Core::Types::Material::createRedPlastic());
+    std::unique_ptr<Core::Types::Material> glass(Core::Types::Material::createRedPlastic());
+    glass->setDiffuse(Core::Types::Color(0.2f, 0.4f, 0.9f, 0.5f));
+    buildScene(scene, camera, meshes, opaque.get(), glass.get());
+    Renderer::Lighting::SpotLight spot(Core::Math::Vector3(0.0f, 4.0f, 0.0f), Core::Math::Vector3(0.0f, -1.0f, 0.0f),
+                                      Core::Math::Constants::PI / 8.0f, Core::Math::Constants::PI / 5.0f);
+    scene.addLight(&spot);
+
+    // 整帧 SSAA、分块 SSAA 与延迟着色（逐 tile 着色计数同样取自帧内分配器）
+    struct Config {
+        int ssaaTile;
+        bool deferred;
+    };
+    for (const Config config : {Config{0, false}, Config{8, false}, Config{0, true}}) {
+        SoftwareRendererSettings settings;
+        settings.width = 48;
+        settings.height = 32;
+        settings.ssaaFactor = 2;
+        settings.ssaaTileSize = config.ssaaTile;
+        settings.deferredShading = config.deferred;
+        SoftwareRenderer renderer(settings);
+
+        renderer.render(scene);
+        const RenderTarget first = renderer.getRenderTarget();
+        renderer.render(scene);
+        const std::size_t capacity = renderer.getFrameArena().getCapacity();
+        EXPECT_EQ(renderer.getFrameArena().getBlockCount(), 1u);
+        EXPECT_GT(renderer.getFrameArena().getUsed(), 0u);
+
+        for (int frame = 0; frame < 3; ++frame) {
+            renderer.render(scene);
+            EXPECT_EQ(renderer.getFrameArena().getBlockCount(), 1u);
+            EXPECT_EQ(renderer.getFrameArena().getCapacity(), capacity);
+        }
+        const RenderTarget& last = renderer.getRenderTarget();
+        for (int y = 0; y < settings.height; ++y) {
+            for (int x = 0; x < settings.width; ++x) {
+                ASSERT_EQ(first.getPixel(x, y).toUint32(), last.getPixel(x, y).toUint32()) << x << ", " << y;
+            }
+        }
+    }
+}
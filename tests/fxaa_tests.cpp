@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+
+#include "renderer/effects/fxaa.h"
+
+using namespace Renderer::Pipeline;
+using Core::Types::Color;
+
+namespace {
+constexpr int W = 32;
+constexpr int H = 32;
+}
+
+TEST(FxaaTest, FlatImageIsUntouched) {
+    RenderTarget target(W, H);
+    target.clearColor(Color(0.3f, 0.6f, 0.2f, 1.0f));
+    Renderer::Effects::applyFxaa(target);
+    for (int y = 0; y < H; ++y) {
+        for (int x = 0; x < W; ++x) {
+            Color c = target.getPixel(x, y);
+            EXPECT_FLOAT_EQ(c.r, 0.3f);
+            EXPECT_FLOAT_EQ(c.g, 0.6f);
+            EXPECT_FLOAT_EQ(c.b, 0.2f);
+        }
+    }
+}
+
+TEST(FxaaTest, StaircaseEdgeIsBlended) {
+    // 斜率约 1/4 的阶梯状边缘：上方白、下方黑
+    RenderTarget target(W, H);
+    target.clearColor(Color::BLACK);
+    for (int y = 0; y < H; ++y) {
+        for (int x = 0; x < W; ++x) {
+            if (y < 8 + x / 4) {
+                target.setPixel(x, y, Color::WHITE);
+            }
+        }
+    }
+
+    Renderer::Effects::applyFxaa(target);
+
+    int blended = 0;
+    for (int x = 4; x < W - 4; ++x) {
+        int edgeY = 8 + x / 4;
+        for (int y = edgeY - 1; y <= edgeY; ++y) {
+            float r = target.getPixel(x, y).r;
+            if (r > 0.01f && r < 0.99f) {
+                ++blended;
+            }
+        }
+    }
+    EXPECT_GT(blended, W / 2);
+
+    // 远离边缘的像素保持不变
+    EXPECT_FLOAT_EQ(target.getPixel(16, 0).r, 1.0f);
+    EXPECT_FLOAT_EQ(target.getPixel(16, H - 1).r, 0.0f);
+}
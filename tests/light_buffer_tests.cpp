@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "core/types/material.h"
+#include "renderer/lighting/light.h"
+#include "renderer/lighting/light_buffer.h"
+#include "renderer/pipeline/software_renderer.h"
+#include "scene/camera.h"
+#include "scene/mesh.h"
+#include "scene/scene.h"
+
+using namespace Renderer::Pipeline;
+using Renderer::Lighting::DirectionalLight;
+using Renderer::Lighting::Light;
+using Renderer::Lighting::LightBuffer;
+using Renderer::Lighting::PointLight;
+
+namespace {
+constexpr int W = 40;
+constexpr int H = 30;
+
+// 派生类型不会被展开到 SoA 分组，作为虚函数路径的参照
+class CustomPointLight : public PointLight {
+public:
+    using PointLight::PointLight;
+};
+
+class CustomDirectionalLight : public DirectionalLight {
+public:
+    using DirectionalLight::DirectionalLight;
+};
+}
+
+TEST(LightBufferTest, GroupsLightsByTypeWithPremultipliedColor) {
+    DirectionalLight sun(Core::Math::Vector3(0.0f, -2.0f, 0.0f), Core::Types::Color(1.0f, 0.5f, 0.25f, 1.0f), 2.0f);
+    PointLight lamp(Core::Math::Vector3(1.0f, 2.0f, 3.0f), Core::Types::Color::WHITE, 0.5f, 4.0f);
+    lamp.setAttenuation(1.0f, 0.2f, 0.3f);
+    CustomPointLight custom(Core::Math::Vector3(0.0f, 0.0f, 0.0f));
+    std::vector<Light*> lights{&lamp, nullptr, &sun, &custom};
+
+    LightBuffer buffer;
+    buffer.build(lights);
+
+    ASSERT_EQ(buffer.directional().size(), 1u);
+    EXPECT_FLOAT_EQ(buffer.directional().dirY[0], 1.0f); // 指向光源
+    EXPECT_FLOAT_EQ(buffer.directional().r[0], 2.0f);
+    EXPECT_FLOAT_EQ(buffer.directional().g[0], 1.0f);
+    EXPECT_FLOAT_EQ(buffer.directional().b[0], 0.5f);
+
+    ASSERT_EQ(buffer.points().size(), 1u);
+    EXPECT_FLOAT_EQ(buffer.points().posZ[0], 3.0f);
+    EXPECT_FLOAT_EQ(buffer.points().rangeSq[0], 16.0f);
+    EXPECT_FLOAT_EQ(buffer.points().linear[0], 0.2f);
+    EXPECT_FLOAT_EQ(buffer.points().quadratic[0], 0.3f);
+    EXPECT_FLOAT_EQ(buffer.points().r[0], 0.5f);
+
+    ASSERT_EQ(buffer.others().size(), 1u);
+    EXPECT_EQ(buffer.others()[0], &custom);
+    EXPECT_EQ(buffer.size(), 3u);
+}
+
+TEST(LightBufferTest, FlattenedShadingMatchesVirtualLights) {
+    Scene::Camera camera;
+    camera.setPerspective(Core::Math::Constants::PI / 3.0f, static_cast<float>(W) / H, 0.1f, 100.0f);
+    camera.lookAt(Core::Math::Vector3(2.0f, 2.0f, -4.0f),
+                  Core::Math::Vector3(0.0f, 0.0f, 0.0f),
+                  Core::Math::Vector3(0.0f, 1.0f, 0.0f));
+
+    std::unique_ptr<Scene::Mesh> sphere(Scene::Mesh::createSphere(1.5f, 24));
+    std::unique_ptr<Core::Types::Material> material(Core::Types::Material::createRedPlastic());
+    sphere->setMaterial(material.get());
+
+    const Core::Math::Vector3 sunDir(-1.0f, -1.0f, 1.0f);
+    const Core::Math::Vector3 lampPos(1.5f, 1.0f, -1.5f);
+    const Core::Types::Color lampColor(0.9f, 0.7f, 0.4f, 1.0f);
+
+    DirectionalLight sun(sunDir, Core::Types::Color::WHITE, 0.6f);
+    PointLight lamp(lampPos, lampColor, 2.0f, 3.0f);
+    CustomDirectionalLight customSun(sunDir, Core::Types::Color::WHITE, 0.6f);
+    CustomPointLight customLamp(lampPos, lampColor, 2.0f, 3.0f);
+
+    Scene::Scene flattened;
+    flattened.setCamera(&camera);
+    flattened.addObject(sphere.get());
+    flattened.addLight(&sun);
+    flattened.addLight(&lamp);
+
+    Scene::Scene reference;
+    reference.setCamera(&camera);
+    reference.addObject(sphere.get());
+    reference.addLight(&customSun);
+    reference.addLight(&customLamp);
+
+    SoftwareRendererSettings settings;
+    settings.width = W;
+    settings.height = H;
+    settings.aaMode = AntiAliasingMode::None;
+
+    SoftwareRenderer a(settings);
+    a.render(flattened);
+    SoftwareRenderer b(settings);
+    b.render(reference);
+
+    // 仅累加顺序与预乘方式不同，允许浮点舍入误差
+    const float kEpsilon = 1e-4f;
+    for (int y = 0; y < H; ++y) {
+        for (int x = 0; x < W; ++x) {
+            Core::Types::Color ca = a.getRenderTarget().getPixel(x, y);
+            Core::Types::Color cb = b.getRenderTarget().getPixel(x, y);
+            EXPECT_NEAR(ca.r, cb.r, kEpsilon) << "at " << x << "," << y;
+            EXPECT_NEAR(ca.g, cb.g, kEpsilon) << "at " << x << "," << y;
+            EXPECT_NEAR(ca.b, cb.b, kEpsilon) << "at " << x << "," << y;
+        }
+    }
+}
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "core/types/material.h"
+#include "renderer/lighting/light.h"
+#include "renderer/lighting/light_buffer.h"
+#include "renderer/lighting/light_culling.h"
+#include "renderer/pipeline/software_renderer.h"
+#include "scene/camera.h"
+#include "scene/mesh.h"
+#include "scene/scene.h"
+
+using namespace Renderer::Pipeline;
+using Renderer::Lighting::DirectionalLight;
+using Renderer::Lighting::Light;
+using Renderer::Lighting::LightBuffer;
+using Renderer::Lighting::LightCuller;
+using Renderer::Lighting::LightSelection;
+using Renderer::Lighting::PointLight;
+
+namespace {
+constexpr int W = 64;
+constexpr int H = 48;
+
+void setupCamera(Scene::Camera& camera) {
+    camera.setPerspective(Core::Math::Constants::PI / 3.0f, static_cast<float>(W) / H, 0.1f, 100.0f);
+    camera.lookAt(Core::Math::Vector3(0.0f, 0.0f, -6.0f),
+                  Core::Math::Vector3(0.0f, 0.0f, 0.0f),
+                  Core::Math::Vector3(0.0f, 1.0f, 0.0f));
+}
+
+bool contains(const LightSelection& selection, uint32_t pointIndex) {
+    for (std::size_t i = 0; i < selection.pointCount; ++i) {
+        if (selection.pointIndices[i] == pointIndex) {
+            return true;
+        }
+    }
+    return false;
+}
+}
+
+TEST(LightCullingTest, BinsPointLightsByScreenTileAndDepth) {
+    Scene::Camera camera;
+    setupCamera(camera);
+
+    DirectionalLight sun(Core::Math::Vector3(0.0f, -1.0f, 1.0f));
+    PointLight left(Core::Math::Vector3(-3.0f, 0.0f, 0.0f), Core::Types::Color::WHITE, 1.0f, 0.5f);
+    PointLight behind(Core::Math::Vector3(0.0f, 0.0f, -10.0f), Core::Types::Color::WHITE, 1.0f, 1.0f);
+    std::vector<Light*> lights{&sun, &left, &behind};
+
+    LightBuffer buffer;
+    buffer.build(lights);
+    ASSERT_EQ(buffer.directional().size(), 1u);
+    ASSERT_EQ(buffer.points().size(), 2u);
+    const uint32_t leftIndex = 0;
+    const uint32_t behindIndex = 1;
+
+    LightCuller culler;
+    culler.build(buffer, camera.getViewMatrix(), camera.getProjectionMatrix(), W, H,
+                 camera.getNear(), camera.getFar(), 8, 16);
+
+    // 相机后方的点光源不出现在任何簇
+    for (int y = 0; y < H; y += 8) {
+        for (int x = 0; x < W; x += 8) {
+            LightSelection selection = culler.getLights(x, y, 6.0f);
+            EXPECT_TRUE(selection.culled);
+            EXPECT_FALSE(contains(selection, behindIndex));
+        }
+    }
+
+    // 左侧点光源只影响屏幕左半部分、深度约为 6 的切片
+    EXPECT_TRUE(contains(culler.getLights(W / 4, H / 2, 6.0f), leftIndex));
+    EXPECT_FALSE(contains(culler.getLights(W - 1, H / 2, 6.0f), leftIndex));
+    EXPECT_FALSE(contains(culler.getLights(W / 4, H / 2, 40.0f), leftIndex));
+}
+
+TEST(LightCullingTest, ClusteredShadingMatchesFullLightList) {
+    Scene::Scene scene;
+    Scene::Camera camera;
+    setupCamera(camera);
+    scene.setCamera(&camera);
+
+    std::unique_ptr<Scene::Mesh> plane(Scene::Mesh::createPlane(8.0f, 6.0f, 8));
+    std::unique_ptr<Core::Types::Material> material(Core::Types::Material::createRedPlastic());
+    plane->setMaterial(material.get());
+    scene.addObject(plane.get());
+
+    DirectionalLight sun(Core::Math::Vector3(0.0f, -1.0f, 1.0f), Core::Types::Color::WHITE, 0.2f);
+    scene.addLight(&sun);
+
+    std::vector<std::unique_ptr<PointLight>> points;
+    for (int j = 0; j < 6; ++j) {
+        for (int i = 0; i < 8; ++i) {
+            Core::Types::Color color(0.2f + 0.1f * i, 0.9f - 0.1f * j, 0.5f, 1.0f);
+            points.emplace_back(new PointLight(Core::Math::Vector3(-3.5f + i, -2.5f + j, -0.4f), color, 1.5f, 0.9f));
+            scene.addLight(points.back().get());
+        }
+    }
+
+    SoftwareRendererSettings settings;
+    settings.width = W;
+    settings.height = H;
+    settings.backfaceCulling = false;
+    settings.aaMode = AntiAliasingMode::None;
+
+    SoftwareRenderer reference(settings);
+    reference.render(scene);
+
+    settings.clusteredLighting = true;
+    settings.lightTileSize = 8;
+    SoftwareRenderer clustered(settings);
+    clustered.render(scene);
+
+    const RenderTarget& a = reference.getRenderTarget();
+    const RenderTarget& b = clustered.getRenderTarget();
+    for (int y = 0; y < H; ++y) {
+        for (int x = 0; x < W; ++x) {
+            Core::Types::Color ca = a.getPixel(x, y);
+            Core::Types::Color cb = b.getPixel(x, y);
+            EXPECT_FLOAT_EQ(ca.r, cb.r) << "at " << x << "," << y;
+            EXPECT_FLOAT_EQ(ca.g, cb.g) << "at " << x << "," << y;
+            EXPECT_FLOAT_EQ(ca.b, cb.b) << "at " << x << "," << y;
+        }
+    }
+}
@@ -0,0 +1,221 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "core/types/mip_generation.h"
+#include "core/types/texture.h"
+#include "core/types/virtual_texture.h"
+
+#include "texture_test_utils.h"
+
+using Core::Types::Color;
+using Core::Types::MipFilter;
+using Core::Types::MipLevelView;
+using Core::Types::Texture;
+using Core::Types::TextureFormat;
+using Core::Types::TextureLayout;
+using TextureTestUtils::channel;
+using TextureTestUtils::expectSameMipChain;
+using TextureTestUtils::mipLevelCount;
+using TextureTestUtils::packRgba;
+using TextureTestUtils::randomPixels;
+using TextureTestUtils::texelAt;
+
+namespace {
+
+constexpr MipFilter kFilters[] = {MipFilter::Box, MipFilter::Kaiser, MipFilter::Lanczos};
+
+// level 0 为周期 period 个纹素的水平正弦条纹；返回 level 1 中一行在同一频率上的幅度（投影到 sin / cos 上）
+double stripeAmplitude(MipFilter filter, double period) {
+    constexpr int kSize = 128;
+    constexpr double kPi = 3.14159265358979323846;
+    std::vector<uint32_t> pixels(kSize * kSize);
+    for (int y = 0; y < kSize; ++y) {
+        for (int x = 0; x < kSize; ++x) {
+            const double value = 0.5 + 0.4 * std::sin(2.0 * kPi * (x + 0.5) / period);
+            const uint32_t v = static_cast<uint32_t>(std::lround(value * 255.0));
+            pixels[y * kSize + x] = packRgba(v, v, v, 255);
+        }
+    }
+    Texture texture(pixels, kSize, kSize, true);
+    texture.setMipFilter(filter);
+    // 跳过两侧受边缘截断影响的纹素，取整数个周期（level 1 的周期为 period / 2）
+    const int begin = 8;
+    const int end = begin + static_cast<int>(period * 3.0); // 6 个周期
+    double s = 0.0;
+    double c = 0.0;
+    for (int x = begin; x < end; ++x) {
+        const double r = channel(texelAt(texture, x, kSize / 4, 1), 0) / 255.0;
+        const double phase = 2.0 * kPi * (2.0 * x + 1.0) / period;
+        s += r * std::sin(phase);
+        c += r * std::cos(phase);
+    }
+    return 2.0 * std::sqrt(s * s + c * c) / (end - begin);
+}
+
+} // namespace
+
+TEST(MipGenerationTest, BoxAveragesPackedChannelsWithRounding) {
+    std::mt19937 rng(3);
+    const std::vector<uint32_t> source = randomPixels(rng, 64 * 64);
+    std::vector<uint32_t> target(32 * 32);
+    std::vector<uint32_t> sourceX(64), sourceY(64), targetX(32), targetY(32);
+    for (int i = 0; i < 64; ++i) {
+        sourceX[i] = static_cast<uint32_t>(i);
+        sourceY[i] = static_cast<uint32_t>(i * 64);
+    }
+    for (int i = 0; i < 32; ++i) {
+        targetX[i] = static_cast<uint32_t>(i);
+        targetY[i] = static_cast<uint32_t>(i * 32);
+    }
+    const MipLevelView sourceView{const_cast<uint32_t*>(source.data()), sourceX.data(), sourceY.data(), 64, 64};
+    const MipLevelView targetView{target.data(), targetX.data(), targetY.data(), 32, 32};
+    Core::Types::downsampleMipRegion(sourceView, targetView, 0, 0, 32, 32, MipFilter::Box, false);
+
+    for (int y = 0; y < 32; ++y) {
+        for (int x = 0; x < 32; ++x) {
+            const uint32_t a = source[(2 * y) * 64 + 2 * x];
+            const uint32_t b = source[(2 * y) * 64 + 2 * x + 1];
+            const uint32_t c = source[(2 * y + 1) * 64 + 2 * x];
+            const uint32_t d = source[(2 * y + 1) * 64 + 2 * x + 1];
+            for (int index = 0; index < 4; ++index) {
+                const int expected =
+                    (channel(a, index) + channel(b, index) + channel(c, index) + channel(d, index) + 2) / 4;
+                ASSERT_EQ(channel(target[y * 32 + x], index), expected) << x << ", " << y << ", channel " << index;
+            }
+        }
+    }
+}
+
+TEST(MipGenerationTest, SrgbAveragingKeepsCheckerboardBrightness) {
+    Texture gamma(8, 8, true);
+    gamma.generateCheckerboard(Color(0.0f, 0.0f, 0.0f, 1.0f), Color(1.0f, 1.0f, 1.0f, 1.0f), 1);
+    Texture linear(8, 8, true);
+    linear.generateCheckerboard(Color(0.0f, 0.0f, 0.0f, 1.0f), Color(1.0f, 1.0f, 1.0f, 1.0f), 1);
+    linear.setSrgb(true);
+    EXPECT_TRUE(linear.isSrgb());
+
+    // 伽马空间平均为 128（显示出来明显偏暗），线性空间的 0.5 编码回 sRGB 为 188
+    EXPECT_EQ(texelAt(gamma, 1, 1, 1), packRgba(128, 128, 128, 255));
+    EXPECT_EQ(texelAt(linear, 1, 1, 1), packRgba(188, 188, 188, 255));
+    EXPECT_EQ(texelAt(linear, 0, 0, 3), packRgba(188, 188, 188, 255));
+}
+
+TEST(MipGenerationTest, SolidColorSurvivesEveryFilter) {
+    const uint32_t colors[] = {packRgba(37, 200, 3, 140), packRgba(255, 255, 255, 255), packRgba(0, 1, 128, 0)};
+    for (uint32_t color : colors) {
+        for (MipFilter filter : kFilters) {
+            for (bool srgb : {false, true}) {
+                // 非 2 的幂，覆盖奇数宽高的边缘截断
+                Texture texture(std::vector<uint32_t>(37 * 23, color), 37, 23, true);
+                texture.setMipFilter(filter);
+                texture.setSrgb(srgb);
+                for (int level = 1; level < mipLevelCount(texture); ++level) {
+                    for (int y = 0; y < texture.getHeight(level); ++y) {
+                        for (int x = 0; x < texture.getWidth(level); ++x) {
+                            ASSERT_EQ(texelAt(texture, x, y, level), color)
+                                << "filter " << static_cast<int>(filter) << ", srgb " << srgb << ", level " << level;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(MipGenerationTest, WideFiltersKeepMoreDetailThanBox) {
+    // 输入幅度为 0.4；Box 在 level 1 的响应为 cos(π / period)，周期 8 时只剩约 0.37
+    for (double period : {8.0, 10.0}) {
+        const double box = stripeAmplitude(MipFilter::Box, period);
+        EXPECT_NEAR(box, 0.4 * std::cos(3.14159265358979323846 / period), 0.005);
+        for (MipFilter filter : {MipFilter::Kaiser, MipFilter::Lanczos}) {
+            const double amplitude = stripeAmplitude(filter, period);
+            EXPECT_GT(amplitude, box + 0.005) << "period " << period;
+            EXPECT_LT(amplitude, 0.41) << "period " << period;
+        }
+    }
+}
+
+TEST(MipGenerationTest, IncrementalRebuildMatchesFullRebuild) {
+    constexpr int kWidth = 96;
+    constexpr int kHeight = 80;
+    for (MipFilter filter : {MipFilter::Kaiser, MipFilter::Lanczos}) {
+        std::mt19937 rng(11);
+        std::vector<uint32_t> pixels = randomPixels(rng, kWidth * kHeight);
+        Texture texture(pixels, kWidth, kHeight, true);
+        texture.setLayout(TextureLayout::Tiled);
+        texture.setMipFilter(filter);
+        texture.setSrgb(true);
+        texture.updateMipmaps();
+
+        // 写入一小块后只重建脏区域（向下一级传播时按滤波器的覆盖范围扩展）
+        const std::vector<uint32_t> patch = randomPixels(rng, 7 * 5);
+        texture.updateRegion(30, 21, 7, 5, patch.data());
+        for (int y = 0; y < 5; ++y) {
+            std::copy(patch.begin() + y * 7, patch.begin() + (y + 1) * 7, pixels.begin() + (21 + y) * kWidth + 30);
+        }
+        Texture reference(pixels, kWidth, kHeight, true);
+        reference.setMipFilter(filter);
+        reference.setSrgb(true);
+        expectSameMipChain(texture, reference);
+    }
+}
+
+TEST(MipGenerationTest, TiledLayoutProducesSameMips) {
+    std::mt19937 rng(5);
+    const std::vector<uint32_t> pixels = randomPixels(rng, 50 * 34);
+    Texture linear(pixels, 50, 34, true);
+    Texture tiled(pixels, 50, 34, true);
+    tiled.setLayout(TextureLayout::Tiled);
+    for (Texture* texture : {&linear, &tiled}) {
+        texture->setMipFilter(MipFilter::Kaiser);
+        texture->setSrgb(true);
+    }
+    expectSameMipChain(tiled, linear);
+}
+
+TEST(MipGenerationTest, SettingsMarkChainDirtyAndDecompress) {
+    std::mt19937 rng(9);
+    Texture texture(randomPixels(rng, 32 * 32), 32, 32, true);
+    texture.updateMipmaps();
+    EXPECT_EQ(texture.getMipFilter(), MipFilter::Box);
+    EXPECT_FALSE(texture.isSrgb());
+
+    texture.setMipFilter(MipFilter::Box);
+    EXPECT_FALSE(texture.hasPendingMipmapUpdate());
+    texture.setMipFilter(MipFilter::Lanczos);
+    EXPECT_TRUE(texture.hasPendingMipmapUpdate());
+    texture.updateMipmaps();
+    texture.setSrgb(true);
+    EXPECT_TRUE(texture.hasPendingMipmapUpdate());
+
+    // 压缩纹理的 mip 是编码后的块，改变滤波器前先解压
+    texture.setFormat(TextureFormat::BC1);
+    texture.setMipFilter(MipFilter::Kaiser);
+    EXPECT_EQ(texture.getFormat(), TextureFormat::RGBA8);
+    EXPECT_EQ(texture.getMipFilter(), MipFilter::Kaiser);
+}
+
+TEST(MipGenerationTest, VirtualTexturesIgnoreMipSettings) {
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "mip_generation_tests";
+    std::filesystem::create_directories(dir);
+    const std::string path = (dir / "settings.vtex").string();
+    std::mt19937 rng(4);
+    const std::vector<uint32_t> pixels = randomPixels(rng, 64 * 64);
+    ASSERT_TRUE(Core::Types::writeVirtualTexture(path, pixels.data(), 64, 64, 32));
+
+    std::unique_ptr<Texture> texture(Texture::loadVirtual(path));
+    ASSERT_TRUE(texture);
+    texture->setMipFilter(MipFilter::Kaiser);
+    texture->setSrgb(true);
+    EXPECT_EQ(texture->getMipFilter(), MipFilter::Box);
+    EXPECT_FALSE(texture->isSrgb());
+    EXPECT_FALSE(texture->hasPendingMipmapUpdate());
+}
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "core/platform/parallel.h"
+
+using Core::Platform::parallelFor;
+
+TEST(ParallelForTest, CoversRangeExactlyOnceAcrossRepeatedCalls) {
+    // 线程池在多次调用间复用：每次调用都恰好覆盖每个下标一次
+    std::vector<std::atomic<int>> hits(1000);
+    for (int round = 0; round < 50; ++round) {
+        parallelFor(0, static_cast<int>(hits.size()), [&](int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                hits[i].fetch_add(1, std::memory_order_relaxed);
+            }
+        }, 1);
+    }
+    for (const auto& hit : hits) {
+        EXPECT_EQ(hit.load(), 50);
+    }
+
+    // 非零起点与空区间
+    int sum = 0;
+    parallelFor(10, 20, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            sum += i; // 单段（不足 2 * minChunk）在调用线程执行
+        }
+    });
+    EXPECT_EQ(sum, 145);
+    parallelFor(5, 5, [](int, int) { FAIL(); });
+}
+
+TEST(ParallelForTest, NestedCallsRunInlineOnTheCallingThread) {
+    // 外层每个分段内部再调用 parallelFor：内层整段在同一线程执行，不再派生线程
+    std::atomic<int> total{0};
+    std::atomic<int> inlineCalls{0};
+    std::atomic<int> innerCalls{0};
+    parallelFor(0, 64, [&](int outerBegin, int outerEnd) {
+        for (int i = outerBegin; i < outerEnd; ++i) {
+            const std::thread::id outer = std::this_thread::get_id();
+            parallelFor(0, 256, [&](int begin, int end) {
+                innerCalls.fetch_add(1, std::memory_order_relaxed);
+                if (begin == 0 && end == 256 && std::this_thread::get_id() == outer) {
+                    inlineCalls.fetch_add(1, std::memory_order_relaxed);
+                }
+                total.fetch_add(end - begin, std::memory_order_relaxed);
+            }, 1);
+        }
+    }, 1);
+    EXPECT_EQ(total.load(), 64 * 256);
+    EXPECT_EQ(innerCalls.load(), 64);
+    EXPECT_EQ(inlineCalls.load(), 64);
+}
+
+TEST(ParallelForTest, ConcurrentCallersBothComplete) {
+    // 两个线程同时进入并行区域：线程池被占用的一方在自身线程执行，两者都完整覆盖
+    std::vector<std::atomic<int>> a(4096), b(4096);
+    auto fill = [](std::vector<std::atomic<int>>& hits) {
+        for (int round = 0; round < 20; ++round) {
+            parallelFor(0, static_cast<int>(hits.size()), [&](int begin, int end) {
+                for (int i = begin; i < end; ++i) {
+                    hits[i].fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+        }
+    };
+    std::thread other([&]() { fill(b); });
+    fill(a);
+    other.join();
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        EXPECT_EQ(a[i].load(), 20);
+        EXPECT_EQ(b[i].load(), 20);
+    }
+}
@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "core/types/material.h"
+#include "renderer/lighting/brdf_lut.h"
+#include "renderer/lighting/light.h"
+#include "renderer/lighting/light_buffer.h"
+#include "renderer/pipeline/shading_pipeline.h"
+#include "renderer/pipeline/software_renderer.h"
+#include "scene/camera.h"
+#include "scene/mesh.h"
+#include "scene/scene.h"
+
+#include "render_test_utils.h"
+
+using namespace Renderer::Pipeline;
+using Core::Math::Matrix4;
+using Core::Math::Vector3;
+using Core::Types::Color;
+using Core::Types::Material;
+using Renderer::Lighting::BrdfLut;
+using Renderer::Lighting::DirectionalLight;
+using Renderer::Lighting::LightBuffer;
+using Renderer::Lighting::LightSelection;
+using Renderer::Lighting::PointLight;
+
+namespace {
+constexpr float PI = Core::Math::Constants::PI;
+
+// 教科书形式的 Cook-Torrance：D_GGX · G2（Λ 形式的高度相关 Smith）· F_Schlick / (4·NdotL·NdotV)
+float referenceSpecular(const Vector3& n, const Vector3& v, const Vector3& l, float roughness, float f0) {
+    const float alpha = roughness * roughness;
+    const Vector3 h = (v + l).normalize();
+    const float NdotH = n.dot(h);
+    const float NdotV = n.dot(v);
+    const float NdotL = n.dot(l);
+    const float d = NdotH * NdotH * (alpha * alpha - 1.0f) + 1.0f;
+    const float D = alpha * alpha / (PI * d * d);
+    auto lambda = [alpha](float cosTheta) {
+        const float tanSq = (1.0f - cosTheta * cosTheta) / (cosTheta * cosTheta);
+        return 0.5f * (-1.0f + std::sqrt(1.0f + alpha * alpha * tanSq));
+    };
+    const float G = 1.0f / (1.0f + lambda(NdotV) + lambda(NdotL));
+    const float F = f0 + (1.0f - f0) * std::pow(1.0f - l.dot(h), 5.0f);
+    return D * G * F / (4.0f * NdotL * NdotV);
+}
+
+} // namespace
+
+TEST(PbrShadingTest, DfgTableIsBoundedAndMatchesIntegration) {
+    const BrdfLut& lut = BrdfLut::instance();
+    float scale, bias;
+    // 光滑表面正视：镜面反射率等于 F0
+    lut.lookup(1.0f, 0.0f, scale, bias);
+    EXPECT_NEAR(scale, 1.0f, 0.02f);
+    EXPECT_NEAR(bias, 0.0f, 0.02f);
+
+    for (int i = 0; i <= 10; ++i) {
+        for (int j = 0; j <= 10; ++j) {
+            lut.lookup(0.05f + 0.095f * i, 0.1f * j, scale, bias);
+            EXPECT_GE(scale, 0.0f);
+            EXPECT_GE(bias, 0.0f);
+            EXPECT_LE(scale + bias, 1.0f + 1e-3f); // F0 = 1 时反照率不超过 1
+        }
+    }
+
+    // 表项之间的双线性插值与直接积分一致
+    float refScale, refBias;
+    BrdfLut::integrate(0.37f, 0.61f, 4096, refScale, refBias);
+    lut.lookup(0.37f, 0.61f, scale, bias);
+    EXPECT_NEAR(scale, refScale, 0.01f);
+    EXPECT_NEAR(bias, refBias, 0.01f);
+
+    // 掠射角的菲涅尔增益
+    float grazingScale, grazingBias;
+    lut.lookup(0.1f, 0.2f, grazingScale, grazingBias);
+    lut.lookup(1.0f, 0.2f, scale, bias);
+    EXPECT_GT(grazingBias, bias);
+}
+
+TEST(PbrShadingTest, DirectLightMatchesCookTorrance) {
+    SoftwareRendererSettings settings = RenderTestUtils::makeSettings(64, 48);
+    ShadingPipeline shading(settings);
+    DirectionalLight sun(Vector3(-0.3f, -0.2f, -1.0f), Color::WHITE, 0.5f);
+    LightBuffer lights;
+    lights.build({&sun});
+
+    const Vector3 n(0.0f, 0.0f, 1.0f);
+    const Vector3 position(0.0f, 0.0f, 0.0f);
+    const Vector3 viewPos(-0.8f, 0.5f, 3.0f);
+    const Vector3 v = (viewPos - position).normalize();
+    const Vector3 l = Vector3(0.3f, 0.2f, 1.0f).normalize();
+    const float NdotL = n.dot(l);
+
+    for (float metallic : {0.0f, 0.5f, 1.0f}) {
+        for (float roughness : {0.3f, 0.6f, 0.9f}) {
+            std::unique_ptr<Material> material(
+                Material::createMetallicRoughness(Color(0.9f, 0.5f, 0.2f, 1.0f), metallic, roughness));
+            const Color base = material->getDiffuse();
+            const Color result = shading.shadeSurface(base, n, position, material.get(), lights, LightSelection(),
+                                                      viewPos, Color::BLACK);
+
+            const float channels[3] = {base.r, base.g, base.b};
+            const float actual[3] = {result.r, result.g, result.b};
+            for (int c = 0; c < 3; ++c) {
+                const float f0 = settings.fresnelF0 + (channels[c] - settings.fresnelF0) * metallic;
+                // 光源强度按 π 倍辐亮度计，与朗伯项 albedo·E·NdotL 的约定一致
+                const float expected = 0.5f * NdotL * (channels[c] * (1.0f - metallic) +
+                                                       PI * referenceSpecular(n, v, l, roughness, f0));
+                EXPECT_NEAR(actual[c], expected, 1e-4f) << "metallic=" << metallic << " roughness=" << roughness;
+            }
+            EXPECT_FLOAT_EQ(result.a, 1.0f);
+        }
+    }
+}
+
+TEST(PbrShadingTest, RoughnessWidensHighlight) {
+    SoftwareRendererSettings settings = RenderTestUtils::makeSettings(64, 48);
+    ShadingPipeline shading(settings);
+    DirectionalLight sun(Vector3(0.0f, 0.0f, -1.0f), Color::WHITE, 0.2f);
+    LightBuffer lights;
+    lights.build({&sun});
+    std::unique_ptr<Material> smooth(Material::createMetallicRoughness(Color(0.5f, 0.5f, 0.5f, 1.0f), 1.0f, 0.2f));
+    std::unique_ptr<Material> rough(Material::createMetallicRoughness(Color(0.5f, 0.5f, 0.5f, 1.0f), 1.0f, 0.7f));
+
+    auto shadeAt = [&](Material* material, const Vector3& n) {
+        return shading.shadeSurface(material->getDiffuse(), n, Vector3(0.0f, 0.0f, 0.0f), material, lights,
+                                    LightSelection(), Vector3(0.0f, 0.0f, 5.0f), Color::BLACK).r;
+    };
+    // 镜面方向上光滑表面更亮，偏离镜面方向后粗糙表面更亮
+    const Vector3 mirror(0.0f, 0.0f, 1.0f);
+    const Vector3 tilted = Vector3(0.0f, std::sin(0.3f), std::cos(0.3f));
+    EXPECT_GT(shadeAt(smooth.get(), mirror), shadeAt(rough.get(), mirror));
+    EXPECT_LT(shadeAt(smooth.get(), tilted), shadeAt(rough.get(), tilted));
+}
+
+TEST(PbrShadingTest, AmbientSpecularUsesDfgTable) {
+    SoftwareRendererSettings settings = RenderTestUtils::makeSettings(64, 48);
+    ShadingPipeline shading(settings);
+    LightBuffer lights;
+    lights.build({});
+    const float roughness = 0.45f;
+    std::unique_ptr<Material> chrome(Material::createMetallicRoughness(Color::WHITE, 1.0f, roughness));
+
+    const Vector3 n = Vector3(0.0f, 0.6f, 0.8f);
+    const Vector3 viewPos(0.0f, 0.0f, 4.0f);
+    const Color ambient(0.3f, 0.3f, 0.3f, 1.0f);
+    const Color result = shading.shadeSurface(Color::WHITE, n, Vector3(0.0f, 0.0f, 0.0f), chrome.get(), lights,
+                                              LightSelection(), viewPos, ambient);
+    float scale, bias;
+    BrdfLut::instance().lookup(n.dot(viewPos.normalize()), roughness, scale, bias);
+    // F0 = 1 的金属：环境项为 ambient·(scale + bias)，没有漫反射
+    EXPECT_NEAR(result.r, 0.3f * (scale + bias), 1e-6f);
+    EXPECT_NEAR(result.g, result.r, 1e-6f);
+}
+
+TEST(PbrShadingTest, PacketAndDeferredPathsMatchScalar) {
+    Scene::Camera camera;
+    camera.setPerspective(PI / 3.0f, 64.0f / 48.0f, 0.1f, 100.0f);
+    camera.lookAt(Vector3(0.3f, 0.5f, 4.0f), Vector3(0.0f, 0.0f, 0.0f), Vector3(0.0f, 1.0f, 0.0f));
+
+    std::unique_ptr<Material> planeMaterial(Material::createMetallicRoughness(Color(0.6f, 0.6f, 0.7f, 1.0f), 0.0f, 0.8f));
+    std::unique_ptr<Material> gold(Material::createMetallicRoughness(Color(1.0f, 0.78f, 0.34f, 1.0f), 1.0f, 0.3f));
+    std::unique_ptr<Material> plastic(Material::createRedPlastic());
+    std::unique_ptr<Scene::Mesh> plane(Scene::Mesh::createQuad(4.0f, 3.0f));
+    std::unique_ptr<Scene::Mesh> sphere(Scene::Mesh::createSphere(0.6f, 16));
+    std::unique_ptr<Scene::Mesh> ball(Scene::Mesh::createSphere(0.3f, 12));
+    plane->setMaterial(planeMaterial.get());
+    sphere->setMaterial(gold.get());
+    ball->setMaterial(plastic.get());
+
+    DirectionalLight sun(Vector3(-0.3f, -0.5f, -1.0f), Color::WHITE, 0.6f);
+    PointLight lamp(Vector3(1.0f, 0.5f, 1.5f), Color(1.0f, 0.8f, 0.6f, 1.0f), 1.0f, 5.0f);
+    Scene::Scene scene;
+    scene.setCamera(&camera);
+    scene.setAmbientLight(Color(0.2f, 0.2f, 0.25f, 1.0f));
+    scene.addObject(plane.get(), Matrix4::translation(0.0f, 0.0f, -0.5f));
+    scene.addObject(sphere.get(), Matrix4::translation(-0.3f, 0.0f, 0.4f));
+    scene.addObject(ball.get(), Matrix4::translation(0.8f, -0.3f, 0.6f));
+    scene.addLight(&sun);
+    scene.addLight(&lamp);
+
+    SoftwareRendererSettings settings = RenderTestUtils::makeSettings(64, 48);
+    settings.packetShading = false;
+    SoftwareRenderer scalar(settings);
+    scalar.render(scene);
+
+    settings.packetShading = true;
+    SoftwareRenderer packet(settings);
+    packet.render(scene);
+    // PBR 材质在包内逐通道走标量路径；Blinn-Phong 小球的包着色与标量只有浮点运算顺序差异（逐分量 1e-5 量级，叠加混合后略有放大）
+    EXPECT_LT(RenderTestUtils::maxDifference(scalar.getRenderTarget(), packet.getRenderTarget()), 2e-5f);
+
+    settings.packetShading = false;
+    settings.deferredShading = true;
+    SoftwareRenderer deferred(settings);
+    deferred.render(scene);
+    EXPECT_LT(RenderTestUtils::maxDifference(scalar.getRenderTarget(), deferred.getRenderTarget()), 1e-5f);
+}
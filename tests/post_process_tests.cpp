@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "renderer/effects/post_process.h"
+#include "renderer/pipeline/software_renderer.h"
+#include "scene/camera.h"
+#include "scene/scene.h"
+
+using namespace Renderer::Effects;
+using Renderer::Pipeline::RenderTarget;
+using Core::Types::Color;
+
+TEST(PostProcessChainTest, FusedChainMatchesSequentialOperators) {
+    RenderTarget target(1, 1);
+    target.setPixel(0, 0, Color(0.5f, 1.0f, 2.0f, 1.0f));
+
+    PostProcessChain chain;
+    chain.addExposure(2.0f).addToneMap(ToneMapOperator::Reinhard).addSrgbEncode();
+    chain.apply(target);
+
+    auto expected = [](float v) {
+        v = (v * 2.0f) / (1.0f + v * 2.0f);
+        return v <= 0.0031308f ? v * 12.92f : 1.055f * std::pow(v, 1.0f / 2.4f) - 0.055f;
+    };
+    Color c = target.getPixel(0, 0);
+    EXPECT_NEAR(c.r, expected(0.5f), 1e-3f);
+    EXPECT_NEAR(c.g, expected(1.0f), 1e-3f);
+    EXPECT_NEAR(c.b, expected(2.0f), 1e-3f);
+    EXPECT_FLOAT_EQ(c.a, 1.0f);
+}
+
+TEST(PostProcessChainTest, IdentityLutPreservesColor) {
+    ColorGradingLut lut = ColorGradingLut::identity(17);
+    Color c = lut.sample(Color(0.12f, 0.57f, 0.93f, 0.4f));
+    EXPECT_NEAR(c.r, 0.12f, 1e-5f);
+    EXPECT_NEAR(c.g, 0.57f, 1e-5f);
+    EXPECT_NEAR(c.b, 0.93f, 1e-5f);
+    EXPECT_FLOAT_EQ(c.a, 0.4f);
+}
+
+TEST(PostProcessChainTest, OrderedDitherPreservesMeanAfterQuantization) {
+    // 0.3 落在两个 8 位量化级之间；抖动后 4×4 块内的量化均值应接近原值
+    RenderTarget target(4, 4);
+    target.clearColor(Color(0.3f, 0.3f, 0.3f, 1.0f));
+
+    PostProcessChain chain;
+    chain.addOrderedDither(8);
+    std::vector<uint8_t> encoded;
+    chain.encode(target, encoded, false);
+    ASSERT_EQ(encoded.size(), 4u * 4u * 3u);
+
+    float sum = 0.0f;
+    bool hasLow = false;
+    bool hasHigh = false;
+    for (std::size_t i = 0; i < encoded.size(); i += 3) {
+        sum += encoded[i];
+        hasLow = hasLow || encoded[i] == 76;
+        hasHigh = hasHigh || encoded[i] == 77;
+    }
+    EXPECT_NEAR(sum / 16.0f, 0.3f * 255.0f, 0.1f);
+    EXPECT_TRUE(hasLow);
+    EXPECT_TRUE(hasHigh);
+}
+
+TEST(PostProcessChainTest, RendererAppliesChainOnlyInOutputEncode) {
+    Scene::Camera camera;
+    Scene::Scene scene;
+    scene.setCamera(&camera);
+    scene.setBackgroundColor(Color(0.3f, 0.2f, 0.1f, 1.0f));
+
+    Renderer::Pipeline::SoftwareRendererSettings settings;
+    settings.width = 4;
+    settings.height = 2;
+    settings.aaMode = Renderer::Pipeline::AntiAliasingMode::None;
+    settings.postProcess.addExposure(2.0f);
+    Renderer::Pipeline::SoftwareRenderer renderer(settings);
+    renderer.render(scene);
+
+    // 渲染目标保持后处理之前的颜色，曝光只在输出编码时与量化一起执行
+    EXPECT_FLOAT_EQ(renderer.getRenderTarget().getPixel(1, 1).r, 0.3f);
+    std::vector<uint8_t> rgba;
+    renderer.encodeOutput(rgba, true);
+    ASSERT_EQ(rgba.size(), 4u * 2u * 4u);
+    EXPECT_EQ(rgba[0], static_cast<uint8_t>(0.6f * 255.0f));
+    EXPECT_EQ(rgba[1], static_cast<uint8_t>(0.4f * 255.0f));
+    EXPECT_EQ(rgba[2], static_cast<uint8_t>(0.2f * 255.0f));
+    EXPECT_EQ(rgba[3], 255);
+
+    // 空链只做量化
+    settings.postProcess.clear();
+    renderer.setSettings(settings);
+    renderer.render(scene);
+    std::vector<uint8_t> rgb;
+    renderer.encodeOutput(rgb, false);
+    ASSERT_EQ(rgb.size(), 4u * 2u * 3u);
+    EXPECT_EQ(rgb[3], static_cast<uint8_t>(0.3f * 255.0f));
+}
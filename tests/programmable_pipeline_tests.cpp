@@ -0,0 +1,219 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <type_traits>
+
+#include "core/types/material.h"
+#include "core/types/texture.h"
+#include "renderer/lighting/environment_light.h"
+#include "renderer/lighting/light.h"
+#include "renderer/pipeline/programmable_renderer.h"
+#include "renderer/pipeline/software_renderer.h"
+#include "scene/camera.h"
+#include "scene/mesh.h"
+#include "scene/scene.h"
+
+#include "render_test_utils.h"
+
+using namespace Renderer::Pipeline;
+using Core::Math::Matrix4;
+using Core::Math::Vector2;
+using Core::Math::Vector3;
+using Core::Math::Vector4;
+using Core::Types::Color;
+
+namespace {
+constexpr float PI = Core::Math::Constants::PI;
+constexpr int W = 64;
+constexpr int H = 48;
+
+// 只输出纹理坐标与一个标量的自定义着色器对
+struct UvVaryings {
+    Vector2 uv;
+    float shade;
+};
+
+struct UvVertexShader {
+    using Varyings = UvVaryings;
+    float shade = 1.0f;
+
+    Vector4 operator()(const Core::Types::Vertex& vertex, const ShaderUniforms& uniforms, Varyings& out) const {
+        out.uv = vertex.texCoord;
+        out.shade = shade;
+        return uniforms.projection * (uniforms.view * (uniforms.model * Vector4(vertex.position, 1.0f)));
+    }
+};
+
+// u < threshold 的片元被丢弃，其余输出 tint × shade
+struct ThresholdFragmentShader {
+    float threshold = 0.5f;
+    Color tint = Color::WHITE;
+
+    bool operator()(const UvVaryings& in, const FragmentContext<UvVaryings>&, Color& out) const {
+        if (in.uv.x < threshold) {
+            return false;
+        }
+        out = Color(tint.r * in.shade, tint.g * in.shade, tint.b * in.shade, 1.0f);
+        return true;
+    }
+};
+
+// 转发给内置着色器的自定义类型：不是默认着色器对，因此走逐片元调用着色器的通用路径
+struct ForwardingVertexShader {
+    using Varyings = BlinnPhongVaryings;
+    Vector4 operator()(const Core::Types::Vertex& vertex, const ShaderUniforms& uniforms, Varyings& out) const {
+        return BlinnPhongVertexShader()(vertex, uniforms, out);
+    }
+};
+
+struct ForwardingFragmentShader {
+    bool operator()(const BlinnPhongVaryings& in, const FragmentContext<BlinnPhongVaryings>& context, Color& out) const {
+        return BlinnPhongFragmentShader()(in, context, out);
+    }
+};
+
+SoftwareRendererSettings makeSettings() {
+    SoftwareRendererSettings settings = RenderTestUtils::makeSettings(W, H);
+    settings.packetShading = false;
+    return settings;
+}
+
+} // namespace
+
+static_assert(std::is_same<SoftwareRenderer, ProgrammableRenderer<BlinnPhongVertexShader, BlinnPhongFragmentShader>>::value,
+              "SoftwareRenderer 即默认着色器对的实例");
+
+TEST(ProgrammablePipelineTest, DefaultShadersMatchFixedFunction) {
+    Scene::Camera camera;
+    camera.setPerspective(PI / 3.0f, static_cast<float>(W) / H, 0.1f, 100.0f);
+    camera.lookAt(Vector3(0.5f, 0.8f, 4.0f), Vector3(0.0f, 0.0f, 0.0f), Vector3(0.0f, 1.0f, 0.0f));
+
+    Core::Types::Texture checker(32, 32);
+    checker.generateCheckerboard(Color::WHITE, Color(0.3f, 0.5f, 0.8f, 1.0f), 4);
+    std::unique_ptr<Core::Types::Material> planeMaterial(new Core::Types::Material());
+    planeMaterial->setDiffuseMap(&checker);
+    std::unique_ptr<Core::Types::Material> sphereMaterial(Core::Types::Material::createRedPlastic());
+    std::unique_ptr<Core::Types::Material> glassMaterial(new Core::Types::Material());
+    glassMaterial->setDiffuse(Color(0.2f, 0.9f, 0.4f, 0.5f));
+
+    std::unique_ptr<Scene::Mesh> plane(Scene::Mesh::createQuad(4.0f, 3.0f));
+    std::unique_ptr<Scene::Mesh> sphere(Scene::Mesh::createSphere(0.6f, 16));
+    std::unique_ptr<Scene::Mesh> glass(Scene::Mesh::createSphere(0.4f, 12));
+    plane->setMaterial(planeMaterial.get());
+    sphere->setMaterial(sphereMaterial.get());
+    glass->setMaterial(glassMaterial.get());
+
+    Renderer::Lighting::DirectionalLight sun(Vector3(-0.3f, -0.5f, -1.0f), Color::WHITE, 0.6f);
+    sun.setCastShadows(true);
+    Renderer::Lighting::PointLight lamp(Vector3(1.0f, 0.5f, 1.5f), Color(1.0f, 0.8f, 0.6f, 1.0f), 1.0f, 5.0f);
+    Renderer::Lighting::SpotLight spot(Vector3(-1.0f, -0.5f, 1.5f), Vector3(0.2f, 0.2f, -1.0f),
+                                       PI / 12.0f, PI / 8.0f, Color::WHITE, 1.5f, 5.0f);
+    Renderer::Lighting::EnvironmentLight sky;
+
+    Scene::Scene scene;
+    scene.setCamera(&camera);
+    scene.addObject(plane.get(), Matrix4::translation(0.0f, 0.0f, -0.5f));
+    scene.addObject(sphere.get(), Matrix4::translation(-0.4f, 0.0f, 0.4f));
+    scene.addObject(glass.get(), Matrix4::translation(0.7f, -0.2f, 0.9f));
+    scene.addLight(&sun);
+    scene.addLight(&lamp);
+    scene.addLight(&spot);
+    scene.setEnvironment(&sky);
+
+    // 转发的着色器对不走内置着色器对专用的固定功能路径，结果仍与 SoftwareRenderer 一致
+    const SoftwareRendererSettings settings = makeSettings();
+    SoftwareRenderer fixed(settings);
+    fixed.render(scene);
+
+    ProgrammableRenderer<ForwardingVertexShader, ForwardingFragmentShader> programmable(settings);
+    programmable.render(scene);
+    EXPECT_LT(RenderTestUtils::maxDifference(fixed.getRenderTarget(), programmable.getRenderTarget()), 1e-5f);
+    EXPECT_EQ(programmable.getStats().fragments, fixed.getStats().fragments);
+}
+
+TEST(ProgrammablePipelineTest, CustomVaryingsArePerspectiveCorrectAndDiscardSkipsWrites) {
+    // 绕 y 轴倾斜的平面：u = 0.5 的分界线应落在平面中心的投影处，而不是屏幕上两端的中点
+    Scene::Camera camera;
+    camera.setPerspective(PI / 3.0f, static_cast<float>(W) / H, 0.1f, 100.0f);
+    camera.lookAt(Vector3(0.0f, 0.0f, 3.0f), Vector3(0.0f, 0.0f, 0.0f), Vector3(0.0f, 1.0f, 0.0f));
+    std::unique_ptr<Scene::Mesh> quad(Scene::Mesh::createQuad(3.0f, 2.0f));
+    const Matrix4 model = Matrix4::rotationY(PI / 3.0f);
+    Scene::Scene scene;
+    scene.setCamera(&camera);
+    scene.setBackgroundColor(Color::BLACK);
+    scene.addObject(quad.get(), model);
+
+    SoftwareRendererSettings settings = makeSettings();
+    settings.backfaceCulling = false;
+    ProgrammableRenderer<UvVertexShader, ThresholdFragmentShader> renderer(settings);
+    renderer.getFragmentShader().tint = Color(0.2f, 0.6f, 1.0f, 1.0f);
+    renderer.getVertexShader().shade = 0.5f;
+    renderer.render(scene);
+
+    auto screenX = [&](float localX) {
+        const Vector4 clip = camera.getProjectionMatrix() * (camera.getViewMatrix() * (model * Vector4(localX, 0.0f, 0.0f, 1.0f)));
+        return (clip.x / clip.w * 0.5f + 0.5f) * (W - 1);
+    };
+    const float centerX = screenX(0.0f);
+    const float midX = 0.5f * (screenX(-1.5f) + screenX(1.5f));
+    ASSERT_GT(std::fabs(centerX - midX), 3.0f); // 透视足够明显
+
+    const int row = H / 2;
+    const RenderTarget& target = renderer.getRenderTarget();
+    const int keptX = static_cast<int>(std::lround(screenX(0.5f)));    // u ≈ 0.67
+    const int droppedX = static_cast<int>(std::lround(screenX(-0.5f))); // u ≈ 0.33
+    const Color kept = target.getPixel(keptX, row);
+    EXPECT_NEAR(kept.r, 0.1f, 1e-6f);
+    EXPECT_NEAR(kept.g, 0.3f, 1e-6f);
+    EXPECT_NEAR(kept.b, 0.5f, 1e-6f);
+    EXPECT_LT(target.getDepth(keptX, row), 1.0f);
+    // 丢弃的片元既不写颜色也不写深度
+    EXPECT_EQ(target.getPixel(droppedX, row).b, 0.0f);
+    EXPECT_EQ(target.getDepth(droppedX, row), 1.0f);
+    EXPECT_LT(renderer.getStats().fragments, renderer.getStats().shadeInvocations);
+
+    // 中心投影与屏幕中点之间的像素：透视校正时与 midX 同侧的半边一致，屏幕空间线性插值则相反
+    const int probeX = static_cast<int>(std::lround(0.5f * (centerX + midX)));
+    const bool probeKept = (midX - centerX) * (screenX(0.5f) - centerX) > 0.0f;
+    EXPECT_EQ(target.getPixel(probeX, row).b > 0.0f, probeKept);
+
+    // 着色器参数在下一帧生效
+    renderer.getFragmentShader().threshold = -1.0f;
+    renderer.render(scene);
+    EXPECT_GT(renderer.getRenderTarget().getPixel(droppedX, row).b, 0.0f);
+    EXPECT_EQ(renderer.getStats().fragments, renderer.getStats().shadeInvocations);
+}
+
+TEST(ProgrammablePipelineTest, VaryingDerivativesFollowScreenSpaceGradient) {
+    // 与像平面平行的平面上各点 w 相同，u 在屏幕上线性变化：|ddx.u| 等于 1 / 平面的屏幕宽度，ddy.u 为 0
+    struct GradientFragmentShader {
+        mutable float maxError = 0.0f;
+        mutable float expected = 0.0f;
+        bool operator()(const UvVaryings&, const FragmentContext<UvVaryings>& context, Color& out) const {
+            maxError = std::max({maxError, std::fabs(std::fabs(context.ddx.uv.x) - expected), std::fabs(context.ddy.uv.x)});
+            out = Color::WHITE;
+            return true;
+        }
+    };
+
+    Scene::Camera camera;
+    camera.setPerspective(PI / 3.0f, static_cast<float>(W) / H, 0.1f, 100.0f);
+    camera.lookAt(Vector3(0.0f, 0.0f, 3.0f), Vector3(0.0f, 0.0f, 0.0f), Vector3(0.0f, 1.0f, 0.0f));
+    std::unique_ptr<Scene::Mesh> quad(Scene::Mesh::createQuad(2.0f, 2.0f));
+    Scene::Scene scene;
+    scene.setCamera(&camera);
+    scene.addObject(quad.get());
+
+    auto screenX = [&](float x) {
+        const Vector4 clip = camera.getProjectionMatrix() * (camera.getViewMatrix() * Vector4(x, 0.0f, 0.0f, 1.0f));
+        return (clip.x / clip.w * 0.5f + 0.5f) * (W - 1);
+    };
+    ProgrammableRenderer<UvVertexShader, GradientFragmentShader> renderer(makeSettings());
+    // u 从平面一端到另一端增加 1
+    renderer.getFragmentShader().expected = 1.0f / std::fabs(screenX(1.0f) - screenX(-1.0f));
+    renderer.render(scene);
+    ASSERT_GT(renderer.getStats().fragments, 0u);
+    EXPECT_LT(renderer.getFragmentShader().maxError, 1e-5f);
+}
@@ -0,0 +1,262 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "core/platform/frame_arena.h"
+#include "core/types/material.h"
+#include "renderer/pipeline/geometry_processor.h"
+#include "renderer/pipeline/render_queue.h"
+
+using Core::Platform::FrameArena;
+using namespace Renderer::Pipeline;
+
+namespace {
+
+ScreenVertex makeVertex(float x, float y, float u, float v, float ndcZ) {
+    ScreenVertex vertex{};
+    vertex.screenX = x;
+    vertex.screenY = y;
+    vertex.ndcZ = ndcZ;
+    vertex.attributes.texCoord = Core::Math::Vector2(u, v);
+    vertex.valid = true;
+    return vertex;
+}
+
+TriangleWorkItem makeItem(uint32_t i0, uint32_t i1, uint32_t i2, uint32_t state, float depthKey) {
+    TriangleWorkItem item;
+    item.i0 = i0;
+    item.i1 = i1;
+    item.i2 = i2;
+    item.state = state;
+    item.depthKey = depthKey;
+    return item;
+}
+
+} // namespace
+
+TEST(RenderQueueTest, ItemsAreCompactIndicesIntoSharedVertices) {
+    // 队列项不再内嵌顶点：比三个 ScreenVertex 小一个数量级
+    EXPECT_LE(sizeof(TriangleWorkItem), 24u);
+    EXPECT_GE(3 * sizeof(ScreenVertex), 10 * sizeof(TriangleWorkItem));
+
+    FrameArena arena;
+    RenderQueue queue;
+    queue.reset(arena, 2, 4, 1);
+    uint32_t base = 99;
+    ScreenVertex* vertices = queue.allocateVertices(4, base);
+    ASSERT_NE(vertices, nullptr);
+    EXPECT_EQ(base, 0u);
+    vertices[0] = makeVertex(0.0f, 0.0f, 0.0f, 0.0f, 0.1f);
+    vertices[1] = makeVertex(10.0f, 0.0f, 1.0f, 0.0f, 0.1f);
+    vertices[2] = makeVertex(0.0f, 20.0f, 0.0f, 1.0f, 0.1f);
+    vertices[3] = makeVertex(10.0f, 20.0f, 1.0f, 1.0f, 0.1f);
+    DrawState state;
+    state.vertexLit = true;
+    const uint32_t stateIndex = queue.addState(state);
+
+    // 两个三角形共用对角线上的两个顶点
+    queue.addOpaque(makeItem(0, 1, 2, stateIndex, 0.1f));
+    queue.addOpaque(makeItem(1, 3, 2, stateIndex, 0.2f));
+    queue.finalize();
+    ASSERT_EQ(queue.getOpaque().size(), 2u);
+
+    const RasterTriangle first = queue.resolve(queue.getOpaque()[0]);
+    const RasterTriangle second = queue.resolve(queue.getOpaque()[1]);
+    EXPECT_EQ(first.v1, second.v0);
+    EXPECT_EQ(first.v2, second.v2);
+    EXPECT_EQ(first.v0, queue.getVertices());
+    EXPECT_TRUE(first.state->vertexLit);
+    // u 沿 x 每 10 像素增加 1，v 沿 y 每 20 像素增加 1
+    const RasterDerivatives derivs = GeometryProcessor::rasterDerivatives(*first.v0, *first.v1, *first.v2);
+    EXPECT_FLOAT_EQ(derivs.dudx, 0.1f);
+    EXPECT_FLOAT_EQ(derivs.dvdy, 0.05f);
+    EXPECT_FLOAT_EQ(derivs.dudy, 0.0f);
+    EXPECT_FLOAT_EQ(derivs.dvdx, 0.0f);
+}
+
+TEST(RenderQueueTest, SortsOpaqueFrontToBackAndTransparentBackToFront) {
+    FrameArena arena;
+    RenderQueue queue;
+    queue.reset(arena, 6, 3, 1);
+    uint32_t base = 0;
+    ScreenVertex* vertices = queue.allocateVertices(3, base);
+    for (int i = 0; i < 3; ++i) {
+        vertices[i] = makeVertex(static_cast<float>(i), 0.0f, 0.0f, 0.0f, 0.0f);
+    }
+    queue.addState(DrawState());
+
+    const float opaqueDepths[] = {0.5f, -0.2f, 0.9f};
+    const float transparentDepths[] = {0.1f, 0.7f, 0.3f};
+    for (int i = 0; i < 3; ++i) {
+        queue.addOpaque(makeItem(0, 1, 2, 0, opaqueDepths[i]));
+        queue.addTransparent(makeItem(0, 1, 2, 0, transparentDepths[i]));
+    }
+    // 容量用完后加入的三角形被丢弃
+    queue.addOpaque(makeItem(0, 1, 2, 0, 0.0f));
+    queue.finalize();
+
+    ASSERT_EQ(queue.getOpaque().size(), 3u);
+    ASSERT_EQ(queue.getTransparent().size(), 3u);
+    EXPECT_FLOAT_EQ(queue.getOpaque()[0].depthKey, -0.2f);
+    EXPECT_FLOAT_EQ(queue.getOpaque()[1].depthKey, 0.5f);
+    EXPECT_FLOAT_EQ(queue.getOpaque()[2].depthKey, 0.9f);
+    EXPECT_FLOAT_EQ(queue.getTransparent()[0].depthKey, 0.7f);
+    EXPECT_FLOAT_EQ(queue.getTransparent()[1].depthKey, 0.3f);
+    EXPECT_FLOAT_EQ(queue.getTransparent()[2].depthKey, 0.1f);
+}
+
+TEST(RenderQueueTest, VertexAndStateCapacityIsBounded) {
+    FrameArena arena;
+    RenderQueue queue;
+    queue.reset(arena, 1, 5, 1);
+    uint32_t base = 0;
+    ASSERT_NE(queue.allocateVertices(3, base), nullptr);
+    EXPECT_EQ(base, 0u);
+    ASSERT_NE(queue.allocateVertices(2, base), nullptr);
+    EXPECT_EQ(base, 3u);
+    EXPECT_EQ(queue.getVertexCount(), 5u);
+    EXPECT_EQ(queue.allocateVertices(1, base), nullptr);
+
+    EXPECT_EQ(queue.addState(DrawState()), 0u);
+    EXPECT_EQ(queue.addState(DrawState()), UINT32_MAX);
+}
+
+TEST(RenderQueueTest, SortKeyPacksLayerDepthAndMaterial) {
+    // 层位：任何半透明键都排在不透明键之后
+    EXPECT_LT(RenderQueue::sortKey(false, 1.0f, 0xFFFFu), RenderQueue::sortKey(true, 1.0f, 0u));
+    EXPECT_EQ(RenderQueue::sortKey(false, 0.3f, 7u) >> 63, 0u);
+    EXPECT_EQ(RenderQueue::sortKey(true, 0.3f, 7u) >> 63, 1u);
+
+    // 不透明：粗分桶不同时由近到远优先于材质（含负深度）
+    EXPECT_LT(RenderQueue::sortKey(false, -0.5f, 9u), RenderQueue::sortKey(false, 0.1f, 0u));
+    EXPECT_LT(RenderQueue::sortKey(false, 0.25f, 9u), RenderQueue::sortKey(false, 0.5f, 0u));
+    // 同一粗分桶内材质优先，同材质再由近到远
+    EXPECT_LT(RenderQueue::sortKey(false, 0.5004f, 1u), RenderQueue::sortKey(false, 0.5001f, 2u));
+    EXPECT_LT(RenderQueue::sortKey(false, 0.5001f, 2u), RenderQueue::sortKey(false, 0.5004f, 2u));
+
+    // 半透明：完整深度由远到近，材质只在深度相同时起作用
+    EXPECT_LT(RenderQueue::sortKey(true, 0.5004f, 9u), RenderQueue::sortKey(true, 0.5001f, 0u));
+    EXPECT_LT(RenderQueue::sortKey(true, 0.5f, 1u), RenderQueue::sortKey(true, 0.5f, 2u));
+}
+
+TEST(RenderQueueTest, SameMaterialSharesIdAcrossStates) {
+    Core::Types::Material first;
+    Core::Types::Material second;
+    FrameArena arena;
+    RenderQueue queue;
+    queue.reset(arena, 1, 1, 4);
+    DrawState state;
+    state.material = &first;
+    const uint32_t a = queue.addState(state);
+    state.material = &second;
+    const uint32_t b = queue.addState(state);
+    state.material = &first;
+    state.vertexLit = true;
+    const uint32_t c = queue.addState(state);
+
+    EXPECT_EQ(queue.getState(a).materialId, 0u);
+    EXPECT_EQ(queue.getState(b).materialId, 1u);
+    EXPECT_EQ(queue.getState(c).materialId, queue.getState(a).materialId);
+}
+
+TEST(RenderQueueTest, OpaqueGroupsByMaterialWithinDepthBucketTransparentStaysBackToFront) {
+    Core::Types::Material first;
+    Core::Types::Material second;
+    FrameArena arena;
+    RenderQueue queue;
+    queue.reset(arena, 8, 3, 2);
+    uint32_t base = 0;
+    ScreenVertex* vertices = queue.allocateVertices(3, base);
+    for (int i = 0; i < 3; ++i) {
+        vertices[i] = makeVertex(static_cast<float>(i), 0.0f, 0.0f, 0.0f, 0.5f);
+    }
+    DrawState state;
+    state.material = &first;
+    const uint32_t firstState = queue.addState(state);
+    state.material = &second;
+    const uint32_t secondState = queue.addState(state);
+
+    // 深度相差不到一个粗分桶，两种材质交替加入
+    const float depths[] = {0.5001f, 0.5002f, 0.5003f, 0.5004f};
+    for (int i = 0; i < 4; ++i) {
+        const uint32_t s = (i % 2 == 0) ? secondState : firstState;
+        queue.addOpaque(makeItem(0, 1, 2, s, depths[i]));
+        queue.addTransparent(makeItem(0, 1, 2, s, depths[i]));
+    }
+    queue.finalize();
+
+    const TriangleRange opaque = queue.getOpaque();
+    ASSERT_EQ(opaque.size(), 4u);
+    EXPECT_EQ(opaque[0].state, firstState);
+    EXPECT_FLOAT_EQ(opaque[0].depthKey, 0.5002f);
+    EXPECT_EQ(opaque[1].state, firstState);
+    EXPECT_FLOAT_EQ(opaque[1].depthKey, 0.5004f);
+    EXPECT_EQ(opaque[2].state, secondState);
+    EXPECT_FLOAT_EQ(opaque[2].depthKey, 0.5001f);
+    EXPECT_EQ(opaque[3].state, secondState);
+    EXPECT_FLOAT_EQ(opaque[3].depthKey, 0.5003f);
+
+    const TriangleRange transparent = queue.getTransparent();
+    ASSERT_EQ(transparent.size(), 4u);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_FLOAT_EQ(transparent[i].depthKey, depths[3 - i]);
+    }
+}
+
+TEST(RenderQueueTest, RadixOrderMatchesStableSortOfKeys) {
+    constexpr int kMaterials = 5;
+    constexpr int kTriangles = 3000;
+    Core::Types::Material materials[kMaterials];
+    FrameArena arena;
+    RenderQueue queue;
+    queue.reset(arena, kTriangles, 3, 2 * kMaterials);
+    uint32_t base = 0;
+    queue.allocateVertices(3, base);
+    for (int i = 0; i < 2 * kMaterials; ++i) {
+        DrawState state;
+        state.material = &materials[i % kMaterials];
+        queue.addState(state);
+    }
+
+    // 深度取少量离散值以产生大量相同的键，检验每趟的稳定性
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<int> depthStep(-40, 200);
+    std::uniform_int_distribution<int> stateIndex(0, 2 * kMaterials - 1);
+    std::bernoulli_distribution isTransparent(0.3);
+    struct Expected {
+        uint64_t key;
+        TriangleWorkItem item;
+    };
+    std::vector<Expected> opaque;
+    std::vector<Expected> transparent;
+    for (int i = 0; i < kTriangles; ++i) {
+        const TriangleWorkItem item = makeItem(0, 1, 2, static_cast<uint32_t>(stateIndex(rng)), depthStep(rng) * 0.005f);
+        const bool blend = isTransparent(rng);
+        const uint64_t key = RenderQueue::sortKey(blend, item.depthKey, queue.getState(item.state).materialId);
+        if (blend) {
+            queue.addTransparent(item);
+            transparent.push_back({key, item});
+        } else {
+            queue.addOpaque(item);
+            opaque.push_back({key, item});
+        }
+    }
+    queue.finalize();
+
+    const auto byKey = [](const Expected& a, const Expected& b) { return a.key < b.key; };
+    std::stable_sort(opaque.begin(), opaque.end(), byKey);
+    std::stable_sort(transparent.begin(), transparent.end(), byKey);
+    ASSERT_EQ(queue.getOpaque().size(), opaque.size());
+    ASSERT_EQ(queue.getTransparent().size(), transparent.size());
+    for (std::size_t i = 0; i < opaque.size(); ++i) {
+        EXPECT_EQ(queue.getOpaque()[i].state, opaque[i].item.state);
+        EXPECT_EQ(queue.getOpaque()[i].depthKey, opaque[i].item.depthKey);
+    }
+    for (std::size_t i = 0; i < transparent.size(); ++i) {
+        EXPECT_EQ(queue.getTransparent()[i].state, transparent[i].item.state);
+        EXPECT_EQ(queue.getTransparent()[i].depthKey, transparent[i].item.depthKey);
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef TESTS_RENDER_TEST_UTILS_H
+#define TESTS_RENDER_TEST_UTILS_H
+
+#include <algorithm>
+#include <cmath>
+
+#include "renderer/pipeline/render_target.h"
+#include "renderer/pipeline/software_renderer.h"
+
+// 整帧渲染测试共用的设置与图像比较
+namespace RenderTestUtils {
+
+// 关闭抗锯齿的渲染设置，其余为默认值；各测试在此基础上修改需要对比的选项
+inline Renderer::Pipeline::SoftwareRendererSettings makeSettings(int width, int height) {
+    Renderer::Pipeline::SoftwareRendererSettings settings;
+    settings.width = width;
+    settings.height = height;
+    settings.aaMode = Renderer::Pipeline::AntiAliasingMode::None;
+    return settings;
+}
+
+// 两幅图像 RGB 分量的最大绝对差，只比较 [x0, x1) 列；x1 < 0 表示到最右一列
+inline float maxDifference(const Renderer::Pipeline::RenderTarget& a, const Renderer::Pipeline::RenderTarget& b,
+                           int x0 = 0, int x1 = -1) {
+    if (x1 < 0) {
+        x1 = a.getWidth();
+    }
+    float maxDiff = 0.0f;
+    for (int y = 0; y < a.getHeight(); ++y) {
+        for (int x = x0; x < x1; ++x) {
+            const Core::Types::Color ca = a.getPixel(x, y);
+            const Core::Types::Color cb = b.getPixel(x, y);
+            maxDiff = std::max({maxDiff, std::fabs(ca.r - cb.r), std::fabs(ca.g - cb.g), std::fabs(ca.b - cb.b)});
+        }
+    }
+    return maxDiff;
+}
+
+} // namespace RenderTestUtils
+
+#endif // TESTS_RENDER_TEST_UTILS_H
@@ -0,0 +1,219 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "core/types/material.h"
+#include "renderer/lighting/light.h"
+#include "renderer/lighting/light_buffer.h"
+#include "renderer/pipeline/fragment_packet.h"
+#include "renderer/pipeline/shading_pipeline.h"
+#include "renderer/pipeline/software_renderer.h"
+#include "scene/camera.h"
+#include "scene/mesh.h"
+#include "scene/scene.h"
+
+using namespace Renderer::Pipeline;
+using Core::Math::Matrix4;
+using Core::Math::Vector3;
+using Renderer::Lighting::DirectionalLight;
+using Renderer::Lighting::Light;
+using Renderer::Lighting::LightBuffer;
+using Renderer::Lighting::LightSelection;
+using Renderer::Lighting::PointLight;
+
+namespace {
+
+// 与 shadeBatch 文档中承诺的误差上限一致
+constexpr float kBatchTolerance = 1e-5f;
+
+// 派生类型走 LightBuffer 的虚函数分组
+class CustomPointLight : public PointLight {
+public:
+    using PointLight::PointLight;
+};
+
+Vector3 randomUnit(std::mt19937& rng) {
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    Vector3 v;
+    do {
+        v = Vector3(dist(rng), dist(rng), dist(rng));
+    } while (v.length() < 0.1f);
+    return v.normalize();
+}
+
+GeometryVertex randomFragment(std::mt19937& rng) {
+    std::uniform_real_distribution<float> pos(-2.0f, 2.0f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    GeometryVertex v{};
+    v.worldPosition = Vector3(pos(rng), pos(rng), pos(rng));
+    v.normal = randomUnit(rng);
+    v.tangent = randomUnit(rng);
+    v.bitangent = v.normal.cross(v.tangent).normalize();
+    v.texCoord = Core::Math::Vector2(unit(rng), unit(rng));
+    v.color = Core::Types::Color(unit(rng), unit(rng), unit(rng), 1.0f);
+    v.reciprocalW = 1.0f;
+    return v;
+}
+
+void expectLanesMatchScalar(const ShadingPipeline& shading,
+                            Core::Types::Material* material,
+                            const LightBuffer& lights,
+                            const LightSelection& selection,
+                            std::mt19937& rng,
+                            uint32_t mask) {
+    const Vector3 viewPos(0.5f, 3.0f, -6.0f);
+    const Core::Types::Color ambient(0.2f, 0.2f, 0.25f, 1.0f);
+    const RasterDerivatives derivs{0.01f, 0.0f, 0.0f, 0.01f};
+
+    FragmentPacket packet;
+    GeometryVertex fragments[kFragmentPacketWidth];
+    for (int lane = 0; lane < kFragmentPacketWidth; ++lane) {
+        fragments[lane] = randomFragment(rng);
+        if ((mask >> lane) & 1u) {
+            packet.setLane(lane, fragments[lane]);
+        }
+    }
+    ASSERT_EQ(packet.activeMask, mask);
+
+    ColorPacket colors;
+    shading.shadeBatch(packet, material, lights, selection, viewPos, ambient, derivs, colors);
+
+    for (int lane = 0; lane < kFragmentPacketWidth; ++lane) {
+        if (!packet.isActive(lane)) {
+            continue;
+        }
+        Core::Types::Color expected = shading.shade(fragments[lane], material, lights, selection,
+                                                    viewPos, ambient, derivs);
+        EXPECT_NEAR(colors.r[lane], expected.r, kBatchTolerance) << "lane " << lane;
+        EXPECT_NEAR(colors.g[lane], expected.g, kBatchTolerance) << "lane " << lane;
+        EXPECT_NEAR(colors.b[lane], expected.b, kBatchTolerance) << "lane " << lane;
+        EXPECT_NEAR(colors.a[lane], expected.a, kBatchTolerance) << "lane " << lane;
+    }
+}
+
+} // namespace
+
+TEST(ShadeBatchTest, MatchesScalarShadeOnRandomLanes) {
+    DirectionalLight sun(Vector3(-1.0f, -1.0f, 0.5f), Core::Types::Color(1.0f, 0.9f, 0.8f, 1.0f), 0.7f);
+    PointLight lamp(Vector3(0.5f, 1.0f, -0.5f), Core::Types::Color(0.9f, 0.7f, 0.4f, 1.0f), 2.0f, 3.0f);
+    PointLight far(Vector3(8.0f, 0.0f, 0.0f), Core::Types::Color::WHITE, 1.0f, 1.0f); // 整包都在范围外
+    CustomPointLight custom(Vector3(-1.0f, 0.5f, 1.0f), Core::Types::Color(0.3f, 0.6f, 1.0f, 1.0f), 1.5f, 4.0f);
+    std::vector<Light*> sceneLights{&sun, &lamp, &far, &custom};
+    LightBuffer lights;
+    lights.build(sceneLights);
+
+    std::unique_ptr<Core::Types::Material> material(Core::Types::Material::createRedPlastic());
+    std::mt19937 rng(1234);
+
+    for (bool fresnel : {false, true}) {
+        SoftwareRendererSettings settings;
+        settings.enableFresnel = fresnel;
+        ShadingPipeline shading(settings);
+
+        for (uint32_t mask : {0xFFu, 0x01u, 0x80u, 0x5Au, 0x3Cu}) {
+            expectLanesMatchScalar(shading, material.get(), lights, LightSelection(), rng, mask);
+            expectLanesMatchScalar(shading, nullptr, lights, LightSelection(), rng, mask);
+        }
+
+        // 聚类剔除给出的子集：只保留第一个点光源
+        const uint32_t subset[] = {0u};
+        LightSelection selection;
+        selection.culled = true;
+        selection.pointIndices = subset;
+        selection.pointCount = 1;
+        expectLanesMatchScalar(shading, material.get(), lights, selection, rng, 0xFFu);
+    }
+}
+
+TEST(ShadeBatchTest, InactiveLanesStayFinite) {
+    DirectionalLight sun(Vector3(0.0f, -1.0f, 0.0f));
+    std::vector<Light*> sceneLights{&sun};
+    LightBuffer lights;
+    lights.build(sceneLights);
+
+    SoftwareRendererSettings settings;
+    ShadingPipeline shading(settings);
+
+    std::mt19937 rng(7);
+    FragmentPacket packet;
+    packet.setLane(2, randomFragment(rng));
+
+    ColorPacket colors;
+    for (int lane = 0; lane < kFragmentPacketWidth; ++lane) {
+        colors.r[lane] = colors.g[lane] = colors.b[lane] = colors.a[lane] = -1.0f;
+    }
+    shading.shadeBatch(packet, nullptr, lights, LightSelection(), Vector3(0.0f, 0.0f, -5.0f),
+                       Core::Types::Color::BLACK, RasterDerivatives{0.0f, 0.0f, 0.0f, 0.0f}, colors);
+
+    // 无效通道的输出内容未定义，但不能出现 NaN/Inf
+    for (int lane = 0; lane < kFragmentPacketWidth; ++lane) {
+        EXPECT_TRUE(std::isfinite(colors.r[lane])) << "lane " << lane;
+        EXPECT_TRUE(std::isfinite(colors.g[lane])) << "lane " << lane;
+        EXPECT_TRUE(std::isfinite(colors.b[lane])) << "lane " << lane;
+        EXPECT_TRUE(std::isfinite(colors.a[lane])) << "lane " << lane;
+    }
+    EXPECT_FLOAT_EQ(colors.a[2], 1.0f);
+}
+
+TEST(ShadeBatchTest, PacketRasterizationMatchesScalarPath) {
+    constexpr int W = 64;
+    constexpr int H = 48;
+    Scene::Camera camera;
+    camera.setPerspective(Core::Math::Constants::PI / 3.0f, static_cast<float>(W) / H, 0.1f, 100.0f);
+    camera.lookAt(Vector3(3.0f, 4.0f, -6.0f), Vector3(0.0f, 0.5f, 0.0f), Vector3(0.0f, 1.0f, 0.0f));
+
+    std::unique_ptr<Scene::Mesh> floor(Scene::Mesh::createPlane(10.0f, 10.0f, 4));
+    std::unique_ptr<Scene::Mesh> box(Scene::Mesh::createCube(1.0f));
+    std::unique_ptr<Core::Types::Material> material(Core::Types::Material::createRedPlastic());
+    floor->setMaterial(material.get());
+    box->setMaterial(material.get());
+
+    Scene::Scene scene;
+    scene.setCamera(&camera);
+    scene.addObject(floor.get(), Matrix4::rotationX(Core::Math::Constants::PI * 0.5f));
+    scene.addObject(box.get(), Matrix4::translation(0.0f, 1.5f, 0.0f));
+
+    DirectionalLight sun(Vector3(1.0f, -1.0f, 0.3f), Core::Types::Color::WHITE, 0.6f);
+    sun.setCastShadows(true);
+    scene.addLight(&sun);
+    std::vector<std::unique_ptr<PointLight>> lamps;
+    for (int i = 0; i < 12; ++i) {
+        const float x = -3.0f + 0.5f * i;
+        lamps.emplace_back(new PointLight(Vector3(x, 0.4f, (i % 3) - 1.0f),
+                                          Core::Types::Color(0.5f + 0.04f * i, 0.6f, 0.9f - 0.05f * i, 1.0f),
+                                          0.8f, 1.5f));
+        scene.addLight(lamps.back().get());
+    }
+
+    SoftwareRendererSettings settings;
+    settings.width = W;
+    settings.height = H;
+    settings.aaMode = AntiAliasingMode::None;
+    settings.backfaceCulling = false;
+    settings.clusteredLighting = true;
+    settings.lightTileSize = 16;
+    settings.enableFresnel = true;
+    settings.shadows.mapSize = 256;
+
+    settings.packetShading = false;
+    SoftwareRenderer scalar(settings);
+    scalar.render(scene);
+
+    settings.packetShading = true;
+    SoftwareRenderer packed(settings);
+    packed.render(scene);
+
+    for (int y = 0; y < H; ++y) {
+        for (int x = 0; x < W; ++x) {
+            Core::Types::Color a = scalar.getRenderTarget().getPixel(x, y);
+            Core::Types::Color b = packed.getRenderTarget().getPixel(x, y);
+            EXPECT_NEAR(a.r, b.r, kBatchTolerance) << "at " << x << "," << y;
+            EXPECT_NEAR(a.g, b.g, kBatchTolerance) << "at " << x << "," << y;
+            EXPECT_NEAR(a.b, b.b, kBatchTolerance) << "at " << x << "," << y;
+            EXPECT_FLOAT_EQ(a.a, b.a) << "at " << x << "," << y;
+        }
+    }
+}
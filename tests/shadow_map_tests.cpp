@@ -0,0 +1,220 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "core/types/material.h"
+#include "renderer/lighting/light.h"
+#include "renderer/lighting/shadow_map.h"
+#include "renderer/pipeline/software_renderer.h"
+#include "scene/camera.h"
+#include "scene/mesh.h"
+#include "scene/scene.h"
+
+using namespace Renderer::Pipeline;
+using Core::Math::Matrix4;
+using Core::Math::Vector3;
+using Renderer::Lighting::DirectionalLight;
+using Renderer::Lighting::Light;
+using Renderer::Lighting::PointLight;
+using Renderer::Lighting::ShadowMapCache;
+using Renderer::Lighting::ShadowSettings;
+
+namespace {
+
+// 地面（y = 0 的 XZ 平面）上方 y = 1.5 处悬浮一个单位立方体
+struct ShadowScene {
+    std::unique_ptr<Scene::Mesh> floor{Scene::Mesh::createPlane(10.0f, 10.0f, 4)};
+    std::unique_ptr<Scene::Mesh> box{Scene::Mesh::createCube(1.0f)};
+    Scene::Scene scene;
+    int boxIndex;
+
+    ShadowScene() {
+        scene.addObject(floor.get(), Matrix4::rotationX(Core::Math::Constants::PI * 0.5f));
+        boxIndex = scene.addObject(box.get(), Matrix4::translation(0.0f, 1.5f, 0.0f));
+    }
+};
+
+ShadowSettings smallMaps() {
+    ShadowSettings settings;
+    settings.mapSize = 256;
+    settings.cubeMapSize = 128;
+    settings.pcfRadius = 0;
+    return settings;
+}
+
+const Vector3 kUp(0.0f, 1.0f, 0.0f);
+
+} // namespace
+
+TEST(ShadowMapTest, DirectionalLightShadowsFloorUnderOccluder) {
+    ShadowScene s;
+    DirectionalLight sun(Vector3(0.0f, -1.0f, 0.0f));
+    sun.setCastShadows(true);
+    std::vector<Light*> lights{&sun};
+
+    ShadowMapCache cache;
+    cache.update(lights, s.scene.getObjects(), smallMaps());
+    const auto* shadow = cache.findDirectional(&sun);
+    ASSERT_NE(shadow, nullptr);
+
+    EXPECT_FLOAT_EQ(shadow->visibility(Vector3(0.0f, 0.0f, 0.0f), kUp), 0.0f);
+    EXPECT_FLOAT_EQ(shadow->visibility(Vector3(3.0f, 0.0f, 3.0f), kUp), 1.0f);
+    // 遮挡体顶面朝向光源，不应自阴影
+    EXPECT_FLOAT_EQ(shadow->visibility(Vector3(0.1f, 2.0f, 0.1f), kUp), 1.0f);
+}
+
+TEST(ShadowMapTest, PointLightCubeMapShadowsFloorUnderOccluder) {
+    ShadowScene s;
+    PointLight lamp(Vector3(0.0f, 3.0f, 0.0f), Core::Types::Color::WHITE, 1.0f, 10.0f);
+    lamp.setCastShadows(true);
+    std::vector<Light*> lights{&lamp};
+
+    ShadowMapCache cache;
+    cache.update(lights, s.scene.getObjects(), smallMaps());
+    const auto* shadow = cache.findCube(&lamp);
+    ASSERT_NE(shadow, nullptr);
+
+    EXPECT_FLOAT_EQ(shadow->visibility(Vector3(0.0f, 0.0f, 0.0f), kUp), 0.0f);
+    EXPECT_FLOAT_EQ(shadow->visibility(Vector3(3.0f, 0.0f, 0.0f), kUp), 1.0f);
+    EXPECT_FLOAT_EQ(shadow->visibility(Vector3(-3.0f, 0.0f, 2.0f), kUp), 1.0f);
+}
+
+TEST(ShadowMapTest, CubeMapKeepsLargeCasterCrossingNearPlane) {
+    // 只有四个角顶点的大地面紧贴点光源下方：对侧面方向的立方体面而言，每个三角形都有顶点在光源背后（w < 0），
+    // 必须在近平面上裁剪而不是整个丢弃，否则地面下方的点会漏光
+    std::unique_ptr<Scene::Mesh> floor(Scene::Mesh::createQuad(20.0f, 20.0f));
+    Scene::Scene scene;
+    scene.addObject(floor.get(), Matrix4::rotationX(Core::Math::Constants::PI * 0.5f));
+    PointLight lamp(Vector3(0.0f, 0.5f, 0.0f), Core::Types::Color::WHITE, 1.0f, 20.0f);
+    lamp.setCastShadows(true);
+    std::vector<Light*> lights{&lamp};
+
+    ShadowMapCache cache;
+    cache.update(lights, scene.getObjects(), smallMaps());
+    const auto* shadow = cache.findCube(&lamp);
+    ASSERT_NE(shadow, nullptr);
+
+    // 依次落在 -Y、+X、-X、+Z、-Z 面
+    EXPECT_FLOAT_EQ(shadow->visibility(Vector3(0.2f, -1.0f, 0.1f), kUp), 0.0f);
+    EXPECT_FLOAT_EQ(shadow->visibility(Vector3(4.0f, -1.0f, 1.0f), kUp), 0.0f);
+    EXPECT_FLOAT_EQ(shadow->visibility(Vector3(-4.0f, -1.0f, -2.0f), kUp), 0.0f);
+    EXPECT_FLOAT_EQ(shadow->visibility(Vector3(1.0f, -1.0f, 5.0f), kUp), 0.0f);
+    EXPECT_FLOAT_EQ(shadow->visibility(Vector3(-2.0f, -1.0f, -6.0f), kUp), 0.0f);
+    // 地面上方不受影响
+    EXPECT_FLOAT_EQ(shadow->visibility(Vector3(4.0f, 0.2f, 1.0f), kUp), 1.0f);
+}
+
+TEST(ShadowMapTest, PcfProducesPartialVisibilityAtShadowEdge) {
+    ShadowScene s;
+    DirectionalLight sun(Vector3(0.0f, -1.0f, 0.0f));
+    sun.setCastShadows(true);
+    std::vector<Light*> lights{&sun};
+
+    ShadowSettings settings = smallMaps();
+    settings.pcfRadius = 2;
+    ShadowMapCache cache;
+    cache.update(lights, s.scene.getObjects(), settings);
+    const auto* shadow = cache.findDirectional(&sun);
+    ASSERT_NE(shadow, nullptr);
+
+    // 立方体边缘 x = 0.5 正下方：核内一部分纹素被遮挡
+    float edge = shadow->visibility(Vector3(0.5f, 0.0f, 0.0f), kUp);
+    EXPECT_GT(edge, 0.0f);
+    EXPECT_LT(edge, 1.0f);
+}
+
+TEST(ShadowMapTest, CacheRerendersOnlyWhenLightOrCasterChanges) {
+    ShadowScene s;
+    DirectionalLight sun(Vector3(0.0f, -1.0f, 0.0f));
+    DirectionalLight fill(Vector3(1.0f, -1.0f, 0.0f)); // 不投射阴影
+    sun.setCastShadows(true);
+    std::vector<Light*> lights{&sun, &fill};
+
+    ShadowMapCache cache;
+    cache.update(lights, s.scene.getObjects(), smallMaps());
+    EXPECT_EQ(cache.getLastRenderCount(), 1);
+    EXPECT_EQ(cache.findDirectional(&fill), nullptr);
+
+    cache.update(lights, s.scene.getObjects(), smallMaps());
+    EXPECT_EQ(cache.getLastRenderCount(), 0);
+
+    s.scene.setObjectTransform(s.boxIndex, Matrix4::translation(2.0f, 1.5f, 0.0f));
+    cache.update(lights, s.scene.getObjects(), smallMaps());
+    EXPECT_EQ(cache.getLastRenderCount(), 1);
+    EXPECT_FLOAT_EQ(cache.findDirectional(&sun)->visibility(Vector3(0.0f, 0.0f, 0.0f), kUp), 1.0f);
+    EXPECT_FLOAT_EQ(cache.findDirectional(&sun)->visibility(Vector3(2.0f, 0.0f, 0.0f), kUp), 0.0f);
+
+    sun.setLightDirection(Vector3(0.2f, -1.0f, 0.0f));
+    cache.update(lights, s.scene.getObjects(), smallMaps());
+    EXPECT_EQ(cache.getLastRenderCount(), 1);
+
+    sun.setCastShadows(false);
+    cache.update(lights, s.scene.getObjects(), smallMaps());
+    EXPECT_EQ(cache.findDirectional(&sun), nullptr);
+}
+
+TEST(ShadowMapTest, CacheSkipsDerivedLightTypes) {
+    // 派生类在 LightBuffer 中走不带阴影的通用路径，缓存不应为它们渲染永远不会被采样的贴图
+    struct CustomSun : DirectionalLight {
+        using DirectionalLight::DirectionalLight;
+    };
+    struct CustomLamp : PointLight {
+        using PointLight::PointLight;
+    };
+    ShadowScene s;
+    CustomSun sun(Vector3(0.0f, -1.0f, 0.0f));
+    CustomLamp lamp(Vector3(0.0f, 4.0f, 0.0f));
+    sun.setCastShadows(true);
+    lamp.setCastShadows(true);
+    std::vector<Light*> lights{&sun, &lamp};
+
+    ShadowMapCache cache;
+    cache.update(lights, s.scene.getObjects(), smallMaps());
+    EXPECT_EQ(cache.getLastRenderCount(), 0);
+    EXPECT_EQ(cache.findDirectional(&sun), nullptr);
+    EXPECT_EQ(cache.findCube(&lamp), nullptr);
+}
+
+TEST(ShadowMapTest, RendererDarkensShadowedFloor) {
+    ShadowScene s;
+    Scene::Camera camera;
+    camera.setPerspective(Core::Math::Constants::PI / 3.0f, 1.0f, 0.1f, 100.0f);
+    camera.lookAt(Vector3(0.0f, 8.0f, 0.0f), Vector3(0.0f, 0.0f, 0.0f), Vector3(0.0f, 0.0f, 1.0f));
+    s.scene.setCamera(&camera);
+    s.scene.setAmbientLight(Core::Types::Color(0.1f, 0.1f, 0.1f, 1.0f));
+    std::unique_ptr<Core::Types::Material> material(Core::Types::Material::createWhiteDiffuse());
+    s.floor->setMaterial(material.get());
+    s.box->setMaterial(material.get());
+
+    // 斜射光把阴影投到立方体旁边的地面上
+    DirectionalLight sun(Vector3(1.0f, -1.0f, 0.0f));
+    s.scene.addLight(&sun);
+
+    SoftwareRendererSettings settings;
+    settings.width = 48;
+    settings.height = 48;
+    settings.backfaceCulling = false;
+    settings.aaMode = AntiAliasingMode::None;
+    settings.shadows = smallMaps();
+
+    SoftwareRenderer unshadowed(settings);
+    unshadowed.render(s.scene);
+
+    sun.setCastShadows(true);
+    SoftwareRenderer shadowed(settings);
+    shadowed.render(s.scene);
+
+    int darkened = 0;
+    for (int y = 0; y < settings.height; ++y) {
+        for (int x = 0; x < settings.width; ++x) {
+            float a = unshadowed.getRenderTarget().getPixel(x, y).r;
+            float b = shadowed.getRenderTarget().getPixel(x, y).r;
+            EXPECT_LE(b, a + 1e-5f) << "at " << x << "," << y;
+            if (b < a - 0.2f) {
+                ++darkened;
+            }
+        }
+    }
+    EXPECT_GT(darkened, 20);
+}
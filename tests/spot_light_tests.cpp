@@ -0,0 +1,268 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "core/types/material.h"
+#include "renderer/lighting/light.h"
+#include "renderer/lighting/light_buffer.h"
+#include "renderer/lighting/light_culling.h"
+#include "renderer/pipeline/fragment_packet.h"
+#include "renderer/pipeline/shading_pipeline.h"
+#include "renderer/pipeline/software_renderer.h"
+#include "scene/camera.h"
+#include "scene/mesh.h"
+#include "scene/scene.h"
+
+#include "render_test_utils.h"
+
+using namespace Renderer::Pipeline;
+using Core::Math::Matrix4;
+using Core::Math::Vector3;
+using Renderer::Lighting::Light;
+using Renderer::Lighting::LightBuffer;
+using Renderer::Lighting::LightCuller;
+using Renderer::Lighting::LightSelection;
+using Renderer::Lighting::SpotLight;
+
+namespace {
+constexpr float PI = Core::Math::Constants::PI;
+
+// 派生类型走 LightBuffer 的虚函数分组，作为 SoA 路径的参照
+class CustomSpotLight : public SpotLight {
+public:
+    using SpotLight::SpotLight;
+};
+
+GeometryVertex randomFragment(std::mt19937& rng) {
+    std::uniform_real_distribution<float> pos(-2.0f, 2.0f);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    GeometryVertex v{};
+    v.worldPosition = Vector3(pos(rng), pos(rng), pos(rng) - 1.0f);
+    Vector3 n;
+    do {
+        n = Vector3(unit(rng), unit(rng), unit(rng));
+    } while (n.length() < 0.1f);
+    v.normal = n.normalize();
+    v.color = Core::Types::Color::WHITE;
+    v.reciprocalW = 1.0f;
+    return v;
+}
+
+} // namespace
+
+TEST(SpotLightTest, ConeFalloffIsSmoothAndBounded) {
+    SpotLight spot(Vector3(0.0f, 0.0f, 0.0f), Vector3(0.0f, 0.0f, -2.0f), PI / 12.0f, PI / 6.0f,
+                   Core::Types::Color::WHITE, 1.0f, 10.0f);
+    EXPECT_NEAR(spot.getCosInner(), std::cos(PI / 12.0f), 1e-6f);
+    EXPECT_NEAR(spot.getCosOuter(), std::cos(PI / 6.0f), 1e-6f);
+    EXPECT_NEAR(spot.getSpotDirection().z, -1.0f, 1e-6f);
+
+    auto atAngle = [&](float angle, float distance) {
+        return spot.getAttenuation(Vector3(std::sin(angle) * distance, 0.0f, -std::cos(angle) * distance));
+    };
+
+    // 内锥内只有距离衰减，外锥外为 0，之间单调下降
+    const float axis = atAngle(0.0f, 2.0f);
+    EXPECT_GT(axis, 0.0f);
+    EXPECT_FLOAT_EQ(atAngle(PI / 14.0f, 2.0f), axis);
+    float previous = axis;
+    for (int i = 1; i <= 8; ++i) {
+        const float angle = PI / 12.0f + (PI / 6.0f - PI / 12.0f) * static_cast<float>(i) / 9.0f;
+        const float value = atAngle(angle, 2.0f);
+        EXPECT_LT(value, previous);
+        EXPECT_GT(value, 0.0f);
+        previous = value;
+    }
+    EXPECT_EQ(atAngle(PI / 5.0f, 2.0f), 0.0f);
+    EXPECT_EQ(spot.getAttenuation(Vector3(0.0f, 0.0f, 1.0f)), 0.0f);  // 光源背后
+    EXPECT_EQ(atAngle(0.0f, 10.5f), 0.0f);                              // 超出范围
+    EXPECT_FALSE(spot.isVisible(Vector3(0.0f, 2.0f, -2.0f)));
+    EXPECT_TRUE(spot.isVisible(Vector3(0.0f, 0.1f, -2.0f)));
+
+    // 外锥角不超过 90°，内锥角不超过外锥角
+    spot.setConeAngles(PI * 0.8f, PI);
+    EXPECT_GT(spot.getCosOuter(), 0.0f);
+    EXPECT_LE(spot.getInnerAngle(), spot.getOuterAngle());
+}
+
+TEST(SpotLightTest, BoundsEncloseConeAndRejectOutsideSpheres) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    for (float outer : {PI / 16.0f, PI / 5.0f, PI / 3.0f, PI * 0.45f}) {
+        SpotLight spot(Vector3(1.0f, -0.5f, 2.0f), Vector3(0.3f, -1.0f, 0.2f), outer * 0.5f, outer,
+                       Core::Types::Color::WHITE, 1.0f, 4.0f);
+        Vector3 center;
+        float radius = 0.0f;
+        spot.getBoundingSphere(center, radius);
+        EXPECT_LE(radius, spot.getRange() + 1e-4f);
+
+        // 随机采样锥内的点：都在包围球内，且以其为中心的小球与锥体相交
+        for (int i = 0; i < 500; ++i) {
+            const Vector3 p(spot.getPosition().x + (unit(rng) * 2.0f - 1.0f) * 4.0f,
+                            spot.getPosition().y + (unit(rng) * 2.0f - 1.0f) * 4.0f,
+                            spot.getPosition().z + (unit(rng) * 2.0f - 1.0f) * 4.0f);
+            if (spot.getAttenuation(p) > 0.0f) {
+                EXPECT_LE((p - center).length(), radius * (1.0f + 1e-4f));
+                EXPECT_TRUE(spot.intersectsSphere(p, 0.01f));
+            }
+        }
+
+        // 光源背后、侧面远处与范围之外的球
+        const Vector3 axis = spot.getSpotDirection();
+        Vector3 side = axis.cross(Vector3(0.0f, 0.0f, 1.0f)).normalize();
+        EXPECT_FALSE(spot.intersectsSphere(spot.getPosition() - axis * 2.0f, 0.5f));
+        EXPECT_FALSE(spot.intersectsSphere(spot.getPosition() + axis * 6.0f, 1.0f));
+        if (outer < PI / 4.0f) {
+            EXPECT_FALSE(spot.intersectsSphere(spot.getPosition() + axis * 0.5f + side * 3.0f, 0.5f));
+        }
+        EXPECT_TRUE(spot.intersectsSphere(spot.getPosition() + axis * 2.0f, 0.1f));
+    }
+}
+
+TEST(SpotLightTest, SoAPathMatchesVirtualLight) {
+    SpotLight spot(Vector3(0.2f, 1.5f, 0.5f), Vector3(-0.1f, -1.0f, -0.4f), PI / 8.0f, PI / 4.0f,
+                   Core::Types::Color(1.0f, 0.8f, 0.6f, 1.0f), 2.0f, 6.0f);
+    CustomSpotLight custom(Vector3(0.2f, 1.5f, 0.5f), Vector3(-0.1f, -1.0f, -0.4f), PI / 8.0f, PI / 4.0f,
+                           Core::Types::Color(1.0f, 0.8f, 0.6f, 1.0f), 2.0f, 6.0f);
+
+    std::vector<Light*> soaLights{&spot};
+    LightBuffer soa;
+    soa.build(soaLights);
+    ASSERT_EQ(soa.spots().size(), 1u);
+    ASSERT_TRUE(soa.others().empty());
+
+    std::vector<Light*> virtualLights{&custom};
+    LightBuffer reference;
+    reference.build(virtualLights);
+    ASSERT_EQ(reference.spots().size(), 0u);
+    ASSERT_EQ(reference.others().size(), 1u);
+
+    SoftwareRendererSettings settings;
+    ShadingPipeline shading(settings);
+    std::unique_ptr<Core::Types::Material> material(Core::Types::Material::createRedPlastic());
+    const Vector3 viewPos(0.0f, 2.0f, 5.0f);
+    const Core::Types::Color ambient(0.1f, 0.1f, 0.1f, 1.0f);
+    const RasterDerivatives derivs{0.0f, 0.0f, 0.0f, 0.0f};
+
+    // 被剔除为空的选择不应留下任何聚光灯贡献
+    LightSelection none;
+    none.spotsCulled = true;
+
+    std::mt19937 rng(99);
+    int lit = 0;
+    for (int packetIndex = 0; packetIndex < 64; ++packetIndex) {
+        FragmentPacket packet;
+        GeometryVertex fragments[kFragmentPacketWidth];
+        for (int lane = 0; lane < kFragmentPacketWidth; ++lane) {
+            fragments[lane] = randomFragment(rng);
+            packet.setLane(lane, fragments[lane]);
+        }
+        ColorPacket colors;
+        shading.shadeBatch(packet, material.get(), soa, LightSelection(), viewPos, ambient, derivs, colors);
+
+        for (int lane = 0; lane < kFragmentPacketWidth; ++lane) {
+            const Core::Types::Color expected = shading.shade(fragments[lane], material.get(), reference,
+                                                              LightSelection(), viewPos, ambient, derivs);
+            const Core::Types::Color scalar = shading.shade(fragments[lane], material.get(), soa,
+                                                            LightSelection(), viewPos, ambient, derivs);
+            const Core::Types::Color unlit = shading.shade(fragments[lane], material.get(), soa,
+                                                           none, viewPos, ambient, derivs);
+            const Core::Types::Color ambientOnly = shading.shade(fragments[lane], material.get(), LightBuffer(),
+                                                                 LightSelection(), viewPos, ambient, derivs);
+            EXPECT_NEAR(scalar.r, expected.r, 1e-5f);
+            EXPECT_NEAR(scalar.g, expected.g, 1e-5f);
+            EXPECT_NEAR(scalar.b, expected.b, 1e-5f);
+            EXPECT_NEAR(colors.r[lane], expected.r, 1e-5f);
+            EXPECT_NEAR(colors.g[lane], expected.g, 1e-5f);
+            EXPECT_NEAR(colors.b[lane], expected.b, 1e-5f);
+            EXPECT_EQ(unlit.r, ambientOnly.r);
+            lit += expected.r > ambientOnly.r + 1e-3f ? 1 : 0;
+        }
+    }
+    EXPECT_GT(lit, 20);
+}
+
+TEST(SpotLightTest, ClustersSkipTilesOutsideCone) {
+    constexpr int W = 64;
+    constexpr int H = 64;
+    Scene::Camera camera;
+    camera.setPerspective(PI / 3.0f, 1.0f, 0.1f, 100.0f);
+    camera.lookAt(Vector3(0.0f, 0.0f, 4.0f), Vector3(0.0f, 0.0f, 0.0f), Vector3(0.0f, 1.0f, 0.0f));
+
+    // 窄光束照向平面中心
+    SpotLight spot(Vector3(0.0f, 0.0f, 1.5f), Vector3(0.0f, 0.0f, -1.0f), PI / 36.0f, PI / 18.0f,
+                   Core::Types::Color::WHITE, 1.0f, 2.0f);
+    std::vector<Light*> lights{&spot};
+    LightBuffer buffer;
+    buffer.build(lights);
+
+    LightCuller culler;
+    culler.build(buffer, camera.getViewMatrix(), camera.getProjectionMatrix(), W, H,
+                 camera.getNear(), camera.getFar(), 8, 16);
+
+    const LightSelection center = culler.getLights(W / 2, H / 2, 4.0f);
+    EXPECT_TRUE(center.spotsCulled);
+    ASSERT_EQ(center.spotCount, 1u);
+    EXPECT_EQ(center.spotIndices[0], 0u);
+    EXPECT_EQ(culler.getLights(0, 0, 4.0f).spotCount, 0u);
+    EXPECT_EQ(culler.getLights(W - 1, H / 2, 4.0f).spotCount, 0u);
+    EXPECT_EQ(culler.getLights(W / 2, H / 2, 30.0f).spotCount, 0u);
+}
+
+TEST(SpotLightTest, RenderingMatchesAcrossCullingAndShadingPaths) {
+    constexpr int W = 64;
+    constexpr int H = 48;
+    Scene::Camera camera;
+    camera.setPerspective(PI / 3.0f, static_cast<float>(W) / H, 0.1f, 100.0f);
+    camera.lookAt(Vector3(0.0f, 0.0f, 4.0f), Vector3(0.0f, 0.0f, 0.0f), Vector3(0.0f, 1.0f, 0.0f));
+
+    std::unique_ptr<Scene::Mesh> quad(Scene::Mesh::createQuad(4.0f, 3.0f));
+    std::unique_ptr<Scene::Mesh> box(Scene::Mesh::createCube(0.5f));
+    std::unique_ptr<Core::Types::Material> material(new Core::Types::Material());
+    quad->setMaterial(material.get());
+    box->setMaterial(material.get());
+
+    Scene::Scene scene;
+    scene.setCamera(&camera);
+    scene.addObject(quad.get());
+    scene.addObject(box.get(), Matrix4::translation(-1.5f, 1.0f, 0.5f)); // 在所有光锥之外
+
+    // 一排斜照的聚光灯在平面上形成椭圆光斑
+    std::vector<std::unique_ptr<SpotLight>> spots;
+    for (int i = 0; i < 4; ++i) {
+        const float x = -1.2f + 0.8f * i;
+        spots.emplace_back(new SpotLight(Vector3(x, -0.6f, 1.0f), Vector3(0.1f, 0.3f, -1.0f),
+                                         PI / 16.0f, PI / 10.0f,
+                                         Core::Types::Color(0.4f + 0.2f * i, 0.8f, 1.0f - 0.2f * i, 1.0f),
+                                         1.5f, 3.0f));
+        scene.addLight(spots.back().get());
+    }
+
+    SoftwareRendererSettings settings = RenderTestUtils::makeSettings(W, H);
+    settings.backfaceCulling = false;
+    settings.packetShading = false;
+    SoftwareRenderer reference(settings);
+    reference.render(scene);
+
+    settings.packetShading = true;
+    SoftwareRenderer packed(settings);
+    packed.render(scene);
+    EXPECT_LT(RenderTestUtils::maxDifference(reference.getRenderTarget(), packed.getRenderTarget()), 1e-5f);
+
+    settings.clusteredLighting = true;
+    settings.lightTileSize = 8;
+    SoftwareRenderer clustered(settings);
+    clustered.render(scene);
+    EXPECT_LT(RenderTestUtils::maxDifference(reference.getRenderTarget(), clustered.getRenderTarget()), 1e-5f);
+
+    // 光斑内明显亮于光斑外
+    float brightest = 0.0f;
+    for (int x = 0; x < W; ++x) {
+        brightest = std::max(brightest, reference.getRenderTarget().getPixel(x, H / 2 + 4).r);
+    }
+    EXPECT_GT(brightest, reference.getRenderTarget().getPixel(W / 2, 1).r + 0.2f);
+}
@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "core/types/material.h"
+#include "renderer/lighting/light.h"
+#include "renderer/pipeline/software_renderer.h"
+#include "scene/camera.h"
+#include "scene/mesh.h"
+#include "scene/scene.h"
+
+using namespace Renderer::Pipeline;
+
+namespace {
+constexpr int W = 37;
+constexpr int H = 23;
+}
+
+TEST(TiledSsaaTest, MatchesFullFramebufferResolve) {
+    Scene::Scene scene;
+    Scene::Camera camera;
+    camera.setPerspective(Core::Math::Constants::PI / 3.0f, static_cast<float>(W) / H, 0.1f, 100.0f);
+    camera.lookAt(Core::Math::Vector3(2.0f, 2.0f, -4.0f),
+                  Core::Math::Vector3(0.0f, 0.0f, 0.0f),
+                  Core::Math::Vector3(0.0f, 1.0f, 0.0f));
+    scene.setCamera(&camera);
+
+    std::unique_ptr<Scene::Mesh> cube(Scene::Mesh::createCube(1.5f));
+    std::unique_ptr<Core::Types::Material> material(Core::Types::Material::createRedPlastic());
+    cube->setMaterial(material.get());
+    scene.addObject(cube.get(), Core::Math::Matrix4::rotationY(0.4f));
+
+    Renderer::Lighting::DirectionalLight light(Core::Math::Vector3(-1.0f, -1.0f, 1.0f));
+    scene.addLight(&light);
+
+    SoftwareRendererSettings settings;
+    settings.width = W;
+    settings.height = H;
+    settings.ssaaFactor = 3;
+
+    SoftwareRenderer full(settings);
+    full.render(scene);
+
+    settings.ssaaTileSize = 8; // 不整除输出尺寸，覆盖边缘 tile
+    SoftwareRenderer tiled(settings);
+    tiled.render(scene);
+
+    const RenderTarget& a = full.getRenderTarget();
+    const RenderTarget& b = tiled.getRenderTarget();
+    ASSERT_EQ(a.getWidth(), b.getWidth());
+    ASSERT_EQ(a.getHeight(), b.getHeight());
+    for (int y = 0; y < H; ++y) {
+        for (int x = 0; x < W; ++x) {
+            Core::Types::Color ca = a.getPixel(x, y);
+            Core::Types::Color cb = b.getPixel(x, y);
+            EXPECT_FLOAT_EQ(ca.r, cb.r) << "at " << x << "," << y;
+            EXPECT_FLOAT_EQ(ca.g, cb.g) << "at " << x << "," << y;
+            EXPECT_FLOAT_EQ(ca.b, cb.b) << "at " << x << "," << y;
+        }
+    }
+}
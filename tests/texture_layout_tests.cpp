@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "core/types/texture.h"
+
+#include "texture_test_utils.h"
+
+using Core::Types::Color;
+using Core::Types::Texture;
+using Core::Types::TextureLayout;
+using TextureTestUtils::mipLevelCount;
+using TextureTestUtils::randomPixels;
+
+TEST(TextureLayoutTest, TiledAddressingIsZOrder) {
+    // 64×16：低 4 位交错，x 的高 2 位接在最后
+    Texture texture(64, 16, false);
+    texture.setLayout(TextureLayout::Tiled);
+    std::vector<uint32_t> data(64 * 16);
+    for (int i = 0; i < 64 * 16; ++i) {
+        data[i] = static_cast<uint32_t>(i);
+    }
+    texture.updateRegion(0, 0, 64, 16, data.data());
+
+    const uint32_t* storage = texture.getPixels(0);
+    // 每个 4×4 对齐块占连续 16 个纹素，块内按 Z 序
+    const int blockX = 8;
+    const int blockY = 4;
+    const uint32_t expectedZ[16] = {0, 1, 64, 65, 2, 3, 66, 67, 128, 129, 192, 193, 130, 131, 194, 195};
+    std::vector<uint32_t> block;
+    for (int y = blockY; y < blockY + 4; ++y) {
+        for (int x = blockX; x < blockX + 4; ++x) {
+            block.push_back(data[y * 64 + x]);
+        }
+    }
+    std::vector<uint32_t> stored(storage, storage + 64 * 16);
+    const auto first = std::find(stored.begin(), stored.end(), data[blockY * 64 + blockX]);
+    ASSERT_NE(first, stored.end());
+    EXPECT_EQ((first - stored.begin()) % 16, 0);
+    for (int i = 0; i < 16; ++i) {
+        EXPECT_EQ(first[i] - data[blockY * 64 + blockX], expectedZ[i]) << i;
+    }
+    // 没有填充的 2 的幂纹理，存储是纹素的一个排列
+    std::sort(stored.begin(), stored.end());
+    EXPECT_EQ(stored, data);
+}
+
+TEST(TextureLayoutTest, TiledSamplingMatchesLinear) {
+    std::mt19937 rng(41);
+    // 非 2 的幂尺寸：Tiled 布局有填充，但读到的纹素必须一致
+    for (const auto& size : {std::pair<int, int>(128, 128), std::pair<int, int>(75, 33)}) {
+        const std::vector<uint32_t> pixels = randomPixels(rng, static_cast<std::size_t>(size.first * size.second));
+        Texture linear(pixels, size.first, size.second, true);
+        Texture tiled(pixels, size.first, size.second, true);
+        tiled.setLayout(TextureLayout::Tiled);
+        EXPECT_EQ(tiled.getLayout(), TextureLayout::Tiled);
+
+        const int levels = mipLevelCount(linear);
+        for (int level = 0; level < levels; ++level) {
+            for (int y = 0; y < linear.getHeight(level); ++y) {
+                for (int x = 0; x < linear.getWidth(level); ++x) {
+                    ASSERT_EQ(tiled.getPixel(x, y, level).toUint32(), linear.getPixel(x, y, level).toUint32());
+                }
+            }
+        }
+        std::uniform_real_distribution<float> uv(-2.0f, 2.0f);
+        std::uniform_real_distribution<float> deriv(0.0f, 0.1f);
+        for (int i = 0; i < 2000; ++i) {
+            const float u = uv(rng);
+            const float v = uv(rng);
+            const float dudx = deriv(rng);
+            const float dvdy = deriv(rng);
+            const Color a = tiled.sample(u, v, dudx, 0.0f, 0.0f, dvdy);
+            const Color b = linear.sample(u, v, dudx, 0.0f, 0.0f, dvdy);
+            ASSERT_EQ(a.toUint32(), b.toUint32());
+        }
+    }
+}
+
+TEST(TextureLayoutTest, TiledWritesAndMipRebuildMatchLinear) {
+    std::mt19937 rng(5);
+    const int w = 90;
+    const int h = 70;
+    const std::vector<uint32_t> pixels = randomPixels(rng, w * h);
+    Texture linear(pixels, w, h, true);
+    Texture tiled(pixels, w, h, true);
+    tiled.setLayout(TextureLayout::Tiled);
+
+    std::uniform_int_distribution<int> pos(-5, 95);
+    std::uniform_int_distribution<int> size(1, 20);
+    for (int i = 0; i < 30; ++i) {
+        const int x = pos(rng);
+        const int y = pos(rng);
+        const int rw = size(rng);
+        const int rh = size(rng);
+        const std::vector<uint32_t> data = randomPixels(rng, static_cast<std::size_t>(rw * rh));
+        linear.updateRegion(x, y, rw, rh, data.data());
+        tiled.updateRegion(x, y, rw, rh, data.data());
+        const Color c(0.1f * (i % 10), 0.2f, 0.9f, 1.0f);
+        linear.setPixel(y, x, c);
+        tiled.setPixel(y, x, c);
+    }
+    const int levels = mipLevelCount(linear);
+    for (int level = 0; level < levels; ++level) {
+        for (int y = 0; y < linear.getHeight(level); ++y) {
+            for (int x = 0; x < linear.getWidth(level); ++x) {
+                ASSERT_EQ(tiled.getPixel(x, y, level).toUint32(), linear.getPixel(x, y, level).toUint32())
+                    << "level " << level;
+            }
+        }
+    }
+
+    // 切回行主序后存储与从未切换过的纹理相同
+    tiled.setLayout(TextureLayout::Linear);
+    EXPECT_TRUE(std::equal(tiled.getPixels(0), tiled.getPixels(0) + w * h, linear.getPixels(0)));
+}
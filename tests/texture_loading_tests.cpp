@@ -0,0 +1,744 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/types/image_loader.h"
+#include "core/types/texture.h"
+#include "core/types/texture_cache.h"
+
+#include "texture_test_utils.h"
+
+using Core::Types::Image;
+using Core::Types::Texture;
+using Core::Types::TextureCache;
+using TextureTestUtils::packRgba;
+
+namespace {
+
+using Bytes = std::vector<uint8_t>;
+
+uint32_t scaleTo8(uint32_t value, uint32_t maxValue) {
+    return (value * 255u + maxValue / 2) / maxValue;
+}
+
+void appendBigEndian32(Bytes& out, uint32_t v) {
+    out.push_back(static_cast<uint8_t>(v >> 24));
+    out.push_back(static_cast<uint8_t>(v >> 16));
+    out.push_back(static_cast<uint8_t>(v >> 8));
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+void appendLittleEndian16(Bytes& out, uint32_t v) {
+    out.push_back(static_cast<uint8_t>(v));
+    out.push_back(static_cast<uint8_t>(v >> 8));
+}
+
+uint32_t crc32(const uint8_t* data, std::size_t size) {
+    uint32_t crc = 0xFFFFFFFFu;
+    for (std::size_t i = 0; i < size; ++i) {
+        crc ^= data[i];
+        for (int k = 0; k < 8; ++k) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
+
+// 只用存储块（不压缩）包装成 zlib 流：测试 PNG 解码时不依赖压缩器
+Bytes storedZlib(const Bytes& data) {
+    Bytes out = {0x78, 0x01};
+    std::size_t pos = 0;
+    do {
+        const std::size_t length = std::min<std::size_t>(data.size() - pos, 65535);
+        const bool last = pos + length == data.size();
+        out.push_back(last ? 1 : 0);
+        appendLittleEndian16(out, static_cast<uint32_t>(length));
+        appendLittleEndian16(out, static_cast<uint32_t>(~length & 0xFFFF));
+        out.insert(out.end(), data.begin() + pos, data.begin() + pos + length);
+        pos += length;
+    } while (pos < data.size());
+    uint32_t a = 1, b = 0;
+    for (uint8_t byte : data) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    appendBigEndian32(out, (b << 16) | a);
+    return out;
+}
+
+void appendChunk(Bytes& png, const char* type, const Bytes& body) {
+    appendBigEndian32(png, static_cast<uint32_t>(body.size()));
+    const std::size_t start = png.size();
+    png.insert(png.end(), type, type + 4);
+    png.insert(png.end(), body.begin(), body.end());
+    appendBigEndian32(png, crc32(png.data() + start, png.size() - start));
+}
+
+int channelCount(int colorType) {
+    switch (colorType) {
+    case 2: return 3;
+    case 4: return 2;
+    case 6: return 4;
+    default: return 1;
+    }
+}
+
+// 每个样本由坐标决定，期望像素据此独立计算
+uint32_t sampleValue(int x, int y, int c, int bitDepth) {
+    const uint32_t v = static_cast<uint32_t>(x * 37 + y * 59 + c * 101 + x * y * 7);
+    return bitDepth == 16 ? (v * 2654435761u) >> 16 : v & ((1u << bitDepth) - 1u);
+}
+
+struct PngSpec {
+    PngSpec(int width, int height, int bitDepth, int colorType, bool interlaced = false)
+        : width(width), height(height), bitDepth(bitDepth), colorType(colorType), interlaced(interlaced) {}
+
+    int width;
+    int height;
+    int bitDepth;
+    int colorType;
+    bool interlaced;
+    Bytes palette; // RGB 三元组
+    Bytes trns;
+};
+
+uint8_t paeth(int a, int b, int c) {
+    const int p = a + b - c;
+    const int pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc) return static_cast<uint8_t>(a);
+    return static_cast<uint8_t>(pb <= pc ? b : c);
+}
+
+// 子图（隔行的一趟或整幅图）按行打包并滤波，滤波类型逐行在 0–4 之间轮换
+void appendFilteredRows(Bytes& out, const PngSpec& spec, int x0, int y0, int dx, int dy) {
+    const int w = (spec.width - x0 + dx - 1) / dx;
+    const int h = (spec.height - y0 + dy - 1) / dy;
+    if (w <= 0 || h <= 0) return;
+    const int channels = channelCount(spec.colorType);
+    const std::size_t stride = (static_cast<std::size_t>(w) * channels * spec.bitDepth + 7) / 8;
+    const std::size_t bpp = std::max(1, channels * spec.bitDepth / 8);
+    Bytes previous(stride, 0);
+    for (int row = 0; row < h; ++row) {
+        Bytes raw(stride, 0);
+        for (int col = 0; col < w; ++col) {
+            for (int c = 0; c < channels; ++c) {
+                const uint32_t v = sampleValue(x0 + col * dx, y0 + row * dy, c, spec.bitDepth);
+                const std::size_t index = static_cast<std::size_t>(col) * channels + c;
+                if (spec.bitDepth == 16) {
+                    raw[index * 2] = static_cast<uint8_t>(v >> 8);
+                    raw[index * 2 + 1] = static_cast<uint8_t>(v);
+                } else if (spec.bitDepth == 8) {
+                    raw[index] = static_cast<uint8_t>(v);
+                } else {
+                    const std::size_t bit = index * spec.bitDepth;
+                    raw[bit / 8] |= static_cast<uint8_t>(v << (8 - spec.bitDepth - bit % 8));
+                }
+            }
+        }
+        const int filter = row % 5;
+        out.push_back(static_cast<uint8_t>(filter));
+        for (std::size_t i = 0; i < stride; ++i) {
+            const int a = i >= bpp ? raw[i - bpp] : 0;
+            const int b = previous[i];
+            const int c = i >= bpp ? previous[i - bpp] : 0;
+            int predictor = 0;
+            switch (filter) {
+            case 1: predictor = a; break;
+            case 2: predictor = b; break;
+            case 3: predictor = (a + b) / 2; break;
+            case 4: predictor = paeth(a, b, c); break;
+            default: break;
+            }
+            out.push_back(static_cast<uint8_t>(raw[i] - predictor));
+        }
+        previous = raw;
+    }
+}
+
+Bytes buildPng(const PngSpec& spec) {
+    Bytes png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    Bytes header;
+    appendBigEndian32(header, static_cast<uint32_t>(spec.width));
+    appendBigEndian32(header, static_cast<uint32_t>(spec.height));
+    header.push_back(static_cast<uint8_t>(spec.bitDepth));
+    header.push_back(static_cast<uint8_t>(spec.colorType));
+    header.push_back(0);
+    header.push_back(0);
+    header.push_back(spec.interlaced ? 1 : 0);
+    appendChunk(png, "IHDR", header);
+    if (!spec.palette.empty()) appendChunk(png, "PLTE", spec.palette);
+    if (!spec.trns.empty()) appendChunk(png, "tRNS", spec.trns);
+
+    Bytes filtered;
+    if (spec.interlaced) {
+        static const int passes[7][4] = {{0, 0, 8, 8}, {4, 0, 8, 8}, {0, 4, 4, 8}, {2, 0, 4, 4},
+                                         {0, 2, 2, 4}, {1, 0, 2, 2}, {0, 1, 1, 2}};
+        for (const auto& p : passes) {
+            appendFilteredRows(filtered, spec, p[0], p[1], p[2], p[3]);
+        }
+    } else {
+        appendFilteredRows(filtered, spec, 0, 0, 1, 1);
+    }
+    // 拆成两个 IDAT 块，验证按顺序拼接
+    const Bytes compressed = storedZlib(filtered);
+    const std::size_t half = compressed.size() / 2;
+    appendChunk(png, "IDAT", Bytes(compressed.begin(), compressed.begin() + half));
+    appendChunk(png, "IDAT", Bytes(compressed.begin() + half, compressed.end()));
+    appendChunk(png, "IEND", {});
+    return png;
+}
+
+uint32_t expectedPngPixel(const PngSpec& spec, int x, int y) {
+    const uint32_t maxValue = (1u << spec.bitDepth) - 1u;
+    auto s = [&](int c) { return sampleValue(x, y, c, spec.bitDepth); };
+    switch (spec.colorType) {
+    case 0: {
+        const uint32_t g = scaleTo8(s(0), maxValue);
+        return packRgba(g, g, g, 255);
+    }
+    case 2:
+        return packRgba(scaleTo8(s(0), maxValue), scaleTo8(s(1), maxValue), scaleTo8(s(2), maxValue), 255);
+    case 3: {
+        const uint32_t i = s(0);
+        const uint32_t a = i < spec.trns.size() ? spec.trns[i] : 255u;
+        return packRgba(spec.palette[i * 3], spec.palette[i * 3 + 1], spec.palette[i * 3 + 2], a);
+    }
+    case 4: {
+        const uint32_t g = scaleTo8(s(0), maxValue);
+        return packRgba(g, g, g, scaleTo8(s(1), maxValue));
+    }
+    default:
+        return packRgba(scaleTo8(s(0), maxValue), scaleTo8(s(1), maxValue), scaleTo8(s(2), maxValue),
+                        scaleTo8(s(3), maxValue));
+    }
+}
+
+void expectPngDecodes(const PngSpec& spec) {
+    const Bytes png = buildPng(spec);
+    Image image;
+    std::string error;
+    ASSERT_TRUE(Core::Types::decodeImage(png.data(), png.size(), image, &error)) << error;
+    ASSERT_EQ(image.width, spec.width);
+    ASSERT_EQ(image.height, spec.height);
+    for (int y = 0; y < spec.height; ++y) {
+        for (int x = 0; x < spec.width; ++x) {
+            ASSERT_EQ(image.pixels[y * spec.width + x], expectedPngPixel(spec, x, y))
+                << "color type " << spec.colorType << " depth " << spec.bitDepth << " at " << x << "," << y;
+        }
+    }
+}
+
+Bytes toBytes(const std::string& s) {
+    return Bytes(s.begin(), s.end());
+}
+
+std::filesystem::path tempDirectory() {
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "texture_loading_tests";
+    std::filesystem::create_directories(dir);
+    return dir;
+}
+
+void writeFile(const std::filesystem::path& path, const Bytes& bytes) {
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+}
+
+// width × height 的 P6 文件，颜色由坐标与 seed 决定
+Bytes makePpm(int width, int height, int seed) {
+    Bytes ppm = toBytes("P6\n" + std::to_string(width) + " " + std::to_string(height) + "\n255\n");
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            ppm.push_back(static_cast<uint8_t>(x * 5 + seed));
+            ppm.push_back(static_cast<uint8_t>(y * 3 + seed * 7));
+            ppm.push_back(static_cast<uint8_t>((x ^ y) + seed * 13));
+        }
+    }
+    return ppm;
+}
+
+} // namespace
+
+TEST(ZlibInflateTest, DecodesFixedHuffmanStream) {
+    // zlib.compressobj(9, DEFLATED, 15, 9, Z_FIXED)
+    const uint8_t stream[] = {0x78, 0x01, 0x4b, 0x4c, 0x2a, 0x4a, 0x4c, 0x4e, 0x4c, 0x49, 0x04,
+                              0x52, 0x0a, 0x89, 0xd8, 0xd9, 0x00, 0xee, 0x28, 0x0d, 0x3d};
+    Bytes out;
+    std::string error;
+    ASSERT_TRUE(Core::Types::inflateZlib(stream, sizeof(stream), out, &error)) << error;
+    EXPECT_EQ(std::string(out.begin(), out.end()), "abracadabra abracadabra abracadabra");
+}
+
+TEST(ZlibInflateTest, DecodesDynamicHuffmanStreamWithLongMatches) {
+    // zlib.compress(bytes((i * 7 + i // 13) % 31 + 65 for i in range(600)), 9)，动态 Huffman 块
+    const uint8_t stream[] = {
+        0x78, 0xda, 0xdd, 0xd1, 0x4b, 0x12, 0x40, 0x30, 0x10, 0x45, 0xd1, 0xb5, 0xc5, 0x9f, 0x88, 0x3f,
+        0x09, 0x82, 0xfd, 0xef, 0x82, 0x9e, 0x74, 0xdd, 0x35, 0x98, 0xde, 0xea, 0x3a, 0x83, 0xd7, 0xa6,
+        0xea, 0xb7, 0x2b, 0x6f, 0xe7, 0x23, 0xa9, 0x07, 0xff, 0x94, 0xdd, 0x1a, 0x33, 0x3b, 0xed, 0xe6,
+        0xab, 0x77, 0xe1, 0x96, 0x33, 0x6d, 0xc6, 0x20, 0x55, 0x4f, 0xa4, 0xea, 0x89, 0x54, 0x3d, 0x91,
+        0xaa, 0x27, 0x52, 0xf5, 0x44, 0x6a, 0xa0, 0xed, 0x69, 0x6f, 0xb4, 0x57, 0xda, 0x0b, 0xed, 0x99,
+        0xf6, 0x44, 0x7b, 0xa4, 0x3d, 0xd0, 0xee, 0x69, 0x77, 0xb4, 0x1d, 0xed, 0x96, 0xb6, 0xa5, 0xdd,
+        0xd0, 0xae, 0x69, 0x73, 0xb6, 0x9b, 0xb3, 0x5d, 0x9c, 0x2d, 0x72, 0xb6, 0x93, 0xb3, 0x1d, 0x9c,
+        0x6d, 0xe7, 0x6c, 0xc1, 0xfc, 0xe1, 0x25, 0x2f, 0x05, 0x8f, 0xbb, 0x65};
+    Bytes out;
+    std::string error;
+    ASSERT_TRUE(Core::Types::inflateZlib(stream, sizeof(stream), out, &error)) << error;
+    ASSERT_EQ(out.size(), 600u);
+    for (int i = 0; i < 600; ++i) {
+        ASSERT_EQ(out[i], (i * 7 + i / 13) % 31 + 65) << i;
+    }
+}
+
+TEST(ZlibInflateTest, DecodesMultipleStoredBlocks) {
+    Bytes data(70000);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i * 31 + (i >> 9));
+    }
+    const Bytes stream = storedZlib(data);
+    Bytes out;
+    ASSERT_TRUE(Core::Types::inflateZlib(stream.data(), stream.size(), out));
+    EXPECT_EQ(out, data);
+}
+
+TEST(ZlibInflateTest, RejectsCorruptStreams) {
+    const Bytes valid = storedZlib(toBytes("texture cache"));
+    Bytes out;
+
+    Bytes badChecksum = valid;
+    badChecksum.back() ^= 0x01;
+    EXPECT_FALSE(Core::Types::inflateZlib(badChecksum.data(), badChecksum.size(), out));
+
+    Bytes badHeader = valid;
+    badHeader[1] ^= 0x01; // 头部校验不再是 31 的倍数
+    EXPECT_FALSE(Core::Types::inflateZlib(badHeader.data(), badHeader.size(), out));
+
+    std::string error;
+    for (std::size_t length = 0; length + 1 < valid.size(); ++length) {
+        EXPECT_FALSE(Core::Types::inflateZlib(valid.data(), length, out, &error)) << length;
+    }
+    EXPECT_FALSE(error.empty());
+
+    // 保留块类型 3
+    const uint8_t reserved[] = {0x78, 0x01, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00};
+    EXPECT_FALSE(Core::Types::inflateZlib(reserved, sizeof(reserved), out));
+}
+
+TEST(ZlibInflateTest, StopsAtOutputLimit) {
+    // 35 字节的输出，其中大部分来自回溯复制
+    const uint8_t stream[] = {0x78, 0x01, 0x4b, 0x4c, 0x2a, 0x4a, 0x4c, 0x4e, 0x4c, 0x49, 0x04,
+                              0x52, 0x0a, 0x89, 0xd8, 0xd9, 0x00, 0xee, 0x28, 0x0d, 0x3d};
+    Bytes out;
+    std::string error;
+    EXPECT_FALSE(Core::Types::inflateZlib(stream, sizeof(stream), out, &error, 34));
+    EXPECT_FALSE(error.empty());
+    out.clear();
+    EXPECT_TRUE(Core::Types::inflateZlib(stream, sizeof(stream), out, nullptr, 35));
+
+    const Bytes stored = storedZlib(Bytes(70000, 7));
+    out.clear();
+    EXPECT_FALSE(Core::Types::inflateZlib(stored.data(), stored.size(), out, nullptr, 69999));
+    out.clear();
+    EXPECT_TRUE(Core::Types::inflateZlib(stored.data(), stored.size(), out, nullptr, 70000));
+}
+
+TEST(PngDecodeTest, DecodesEveryColorTypeAndFilter) {
+    expectPngDecodes({13, 7, 1, 0});
+    expectPngDecodes({11, 6, 2, 0});
+    expectPngDecodes({9, 5, 4, 0});
+    expectPngDecodes({10, 10, 8, 0});
+    expectPngDecodes({7, 9, 16, 0});
+    expectPngDecodes({12, 8, 8, 2});
+    expectPngDecodes({5, 11, 16, 2});
+    expectPngDecodes({9, 7, 8, 4});
+    expectPngDecodes({6, 6, 16, 4});
+    expectPngDecodes({8, 12, 8, 6});
+    expectPngDecodes({7, 5, 16, 6});
+}
+
+TEST(PngDecodeTest, DecodesPalettedImagesWithTransparency) {
+    for (int depth : {1, 2, 4, 8}) {
+        PngSpec spec{15, 9, depth, 3};
+        const int entries = 1 << depth;
+        for (int i = 0; i < entries; ++i) {
+            spec.palette.push_back(static_cast<uint8_t>(i * 37));
+            spec.palette.push_back(static_cast<uint8_t>(255 - i * 11));
+            spec.palette.push_back(static_cast<uint8_t>(i * 73 + 5));
+        }
+        // tRNS 只覆盖前半部分条目，其余不透明
+        for (int i = 0; i < (entries + 1) / 2; ++i) {
+            spec.trns.push_back(static_cast<uint8_t>(i * 29));
+        }
+        expectPngDecodes(spec);
+    }
+}
+
+TEST(PngDecodeTest, ColorKeyTransparencyMatchesExactSamples) {
+    PngSpec spec{8, 8, 8, 2};
+    // 8 位真彩色的色键：每通道一个 16 位大端值
+    spec.trns = {0, static_cast<uint8_t>(sampleValue(3, 2, 0, 8)), 0, static_cast<uint8_t>(sampleValue(3, 2, 1, 8)),
+                 0, static_cast<uint8_t>(sampleValue(3, 2, 2, 8))};
+    const Bytes png = buildPng(spec);
+    Image image;
+    ASSERT_TRUE(Core::Types::decodeImage(png.data(), png.size(), image));
+    for (int y = 0; y < 8; ++y) {
+        for (int x = 0; x < 8; ++x) {
+            const bool keyed = sampleValue(x, y, 0, 8) == sampleValue(3, 2, 0, 8) &&
+                               sampleValue(x, y, 1, 8) == sampleValue(3, 2, 1, 8) &&
+                               sampleValue(x, y, 2, 8) == sampleValue(3, 2, 2, 8);
+            EXPECT_EQ(image.pixels[y * 8 + x] & 0xFFu, keyed ? 0u : 255u) << x << "," << y;
+        }
+    }
+    EXPECT_EQ(image.pixels[2 * 8 + 3] & 0xFFu, 0u);
+}
+
+TEST(PngDecodeTest, DecodesAdam7Interlacing) {
+    // 尺寸覆盖某些趟为空的情况
+    expectPngDecodes({1, 1, 8, 6, true});
+    expectPngDecodes({3, 2, 8, 2, true});
+    expectPngDecodes({13, 11, 8, 6, true});
+    expectPngDecodes({17, 9, 1, 0, true});
+    expectPngDecodes({10, 14, 16, 2, true});
+}
+
+TEST(PngDecodeTest, RejectsCorruptFiles) {
+    const Bytes valid = buildPng({6, 6, 8, 2});
+    Image image;
+    ASSERT_TRUE(Core::Types::decodeImage(valid.data(), valid.size(), image));
+
+    Bytes badCrc = valid;
+    badCrc[30] ^= 0x40; // IHDR CRC
+    EXPECT_FALSE(Core::Types::decodeImage(badCrc.data(), badCrc.size(), image));
+
+    std::string error;
+    EXPECT_FALSE(Core::Types::decodeImage(valid.data(), valid.size() - 20, image, &error));
+    EXPECT_FALSE(error.empty());
+
+    PngSpec badDepth{4, 4, 4, 2}; // 真彩色不允许 4 位
+    const Bytes invalid = buildPng(badDepth);
+    EXPECT_FALSE(Core::Types::decodeImage(invalid.data(), invalid.size(), image));
+
+    PngSpec noPalette{4, 4, 8, 3};
+    const Bytes missing = buildPng(noPalette);
+    EXPECT_FALSE(Core::Types::decodeImage(missing.data(), missing.size(), image));
+
+    const Bytes garbage = toBytes("not an image at all");
+    EXPECT_FALSE(Core::Types::decodeImage(garbage.data(), garbage.size(), image));
+}
+
+TEST(PngDecodeTest, RejectsOversizedDimensionsAndExcessImageData) {
+    Image image;
+    // IHDR 声明 20000×20000：超过像素数上限，分配之前即拒绝
+    Bytes huge = buildPng({4, 4, 8, 0});
+    const uint8_t dimensions[] = {0, 0, 0x4E, 0x20, 0, 0, 0x4E, 0x20};
+    std::copy(dimensions, dimensions + 8, huge.begin() + 16);
+    const uint32_t crc = crc32(huge.data() + 12, 17);
+    for (int i = 0; i < 4; ++i) {
+        huge[29 + i] = static_cast<uint8_t>(crc >> (24 - 8 * i));
+    }
+    std::string error;
+    EXPECT_FALSE(Core::Types::decodeImage(huge.data(), huge.size(), image, &error));
+    EXPECT_NE(error.find("dimensions"), std::string::npos) << error;
+
+    // IDAT 解压后比 IHDR 决定的 4 × (1 + 4) 字节多：超出部分不再解压
+    Bytes png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    Bytes header;
+    appendBigEndian32(header, 4);
+    appendBigEndian32(header, 4);
+    header.insert(header.end(), {8, 0, 0, 0, 0});
+    appendChunk(png, "IHDR", header);
+    appendChunk(png, "IDAT", storedZlib(Bytes(20 + 100000, 0)));
+    appendChunk(png, "IEND", {});
+    error.clear();
+    EXPECT_FALSE(Core::Types::decodeImage(png.data(), png.size(), image, &error));
+    EXPECT_NE(error.find("limit"), std::string::npos) << error;
+}
+
+TEST(PnmDecodeTest, DecodesBinaryAndAsciiVariants) {
+    Image image;
+    Bytes binary = toBytes("P6\n# comment\n2 1\n255\n");
+    binary.insert(binary.end(), {10, 20, 30, 200, 100, 50});
+    ASSERT_TRUE(Core::Types::decodeImage(binary.data(), binary.size(), image));
+    ASSERT_EQ(image.width, 2);
+    ASSERT_EQ(image.height, 1);
+    EXPECT_EQ(image.pixels[0], packRgba(10, 20, 30, 255));
+    EXPECT_EQ(image.pixels[1], packRgba(200, 100, 50, 255));
+
+    const Bytes p3 = toBytes("P3 2 2 # size\n15\n15 0 0  0 15 0\n0 0 15 # blue\n 5 10 15\n");
+    ASSERT_TRUE(Core::Types::decodeImage(p3.data(), p3.size(), image));
+    ASSERT_EQ(image.width, 2);
+    ASSERT_EQ(image.height, 2);
+    EXPECT_EQ(image.pixels[0], packRgba(255, 0, 0, 255));
+    EXPECT_EQ(image.pixels[1], packRgba(0, 255, 0, 255));
+    EXPECT_EQ(image.pixels[2], packRgba(0, 0, 255, 255));
+    EXPECT_EQ(image.pixels[3], packRgba(85, 170, 255, 255));
+
+    Bytes p5 = toBytes("P5\n3 1\n65535\n");
+    for (uint32_t v : {0u, 0x8080u, 0xFFFFu}) {
+        p5.push_back(static_cast<uint8_t>(v >> 8));
+        p5.push_back(static_cast<uint8_t>(v));
+    }
+    ASSERT_TRUE(Core::Types::decodeImage(p5.data(), p5.size(), image));
+    EXPECT_EQ(image.pixels[0], packRgba(0, 0, 0, 255));
+    EXPECT_EQ(image.pixels[1], packRgba(128, 128, 128, 255));
+    EXPECT_EQ(image.pixels[2], packRgba(255, 255, 255, 255));
+
+    const Bytes p2 = toBytes("P2\n2 1\n1\n0 1\n");
+    ASSERT_TRUE(Core::Types::decodeImage(p2.data(), p2.size(), image));
+    EXPECT_EQ(image.pixels[0], packRgba(0, 0, 0, 255));
+    EXPECT_EQ(image.pixels[1], packRgba(255, 255, 255, 255));
+
+    Bytes truncated = toBytes("P6\n4 4\n255\n");
+    truncated.resize(truncated.size() + 20);
+    EXPECT_FALSE(Core::Types::decodeImage(truncated.data(), truncated.size(), image));
+}
+
+TEST(PnmDecodeTest, RejectsLargeHeadersWithoutPixelData) {
+    Image image;
+    // 尺寸在上限之内，但数据远远不够：在分配像素之前拒绝
+    for (const char* header : {"P6\n8000 8000\n255\n", "P5\n8000 8000\n65535\n", "P3\n8000 8000\n255\n1 2 3\n"}) {
+        Bytes bytes = toBytes(header);
+        bytes.resize(bytes.size() + 64, '7');
+        EXPECT_FALSE(Core::Types::decodeImage(bytes.data(), bytes.size(), image)) << header;
+        EXPECT_TRUE(image.pixels.empty()) << header;
+    }
+    // 超过像素数上限
+    const Bytes huge = toBytes("P6\n30000 30000\n255\n");
+    std::string error;
+    EXPECT_FALSE(Core::Types::decodeImage(huge.data(), huge.size(), image, &error));
+    EXPECT_NE(error.find("dimensions"), std::string::npos) << error;
+}
+
+namespace {
+
+Bytes tgaHeader(int imageType, int width, int height, int bits, int descriptor, int colorMapLength = 0,
+                int colorMapBits = 0) {
+    Bytes h = {0, static_cast<uint8_t>(colorMapLength > 0 ? 1 : 0), static_cast<uint8_t>(imageType)};
+    appendLittleEndian16(h, 0);
+    appendLittleEndian16(h, static_cast<uint32_t>(colorMapLength));
+    h.push_back(static_cast<uint8_t>(colorMapBits));
+    appendLittleEndian16(h, 0);
+    appendLittleEndian16(h, 0);
+    appendLittleEndian16(h, static_cast<uint32_t>(width));
+    appendLittleEndian16(h, static_cast<uint32_t>(height));
+    h.push_back(static_cast<uint8_t>(bits));
+    h.push_back(static_cast<uint8_t>(descriptor));
+    return h;
+}
+
+uint32_t tgaColor(int x, int y) {
+    return packRgba(static_cast<uint32_t>(x * 40), static_cast<uint32_t>(y * 60), static_cast<uint32_t>(x + y * 3),
+                    static_cast<uint32_t>(255 - x * 10));
+}
+
+void appendBgra(Bytes& out, uint32_t rgba) {
+    out.push_back(static_cast<uint8_t>(rgba >> 8));
+    out.push_back(static_cast<uint8_t>(rgba >> 16));
+    out.push_back(static_cast<uint8_t>(rgba >> 24));
+    out.push_back(static_cast<uint8_t>(rgba));
+}
+
+} // namespace
+
+TEST(TgaDecodeTest, HonoursOriginFlags) {
+    const int width = 4, height = 3;
+    Image image;
+    // descriptor 位 5：从上到下；位 4：从右到左；低 4 位为 alpha 位数
+    for (int descriptor : {0x08, 0x28, 0x18, 0x38}) {
+        const bool topDown = descriptor & 0x20;
+        const bool rightToLeft = descriptor & 0x10;
+        Bytes tga = tgaHeader(2, width, height, 32, descriptor);
+        for (int row = 0; row < height; ++row) {
+            for (int col = 0; col < width; ++col) {
+                const int x = rightToLeft ? width - 1 - col : col;
+                const int y = topDown ? row : height - 1 - row;
+                appendBgra(tga, tgaColor(x, y));
+            }
+        }
+        ASSERT_TRUE(Core::Types::decodeImage(tga.data(), tga.size(), image)) << descriptor;
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                EXPECT_EQ(image.pixels[y * width + x], tgaColor(x, y)) << descriptor << " " << x << "," << y;
+            }
+        }
+    }
+}
+
+TEST(TgaDecodeTest, DecodesRunLengthAndColorMappedImages) {
+    Image image;
+    // 真彩色 RLE：一个跨行的重复包 + 一个原始包
+    Bytes rle = tgaHeader(10, 3, 2, 32, 0x28);
+    rle.push_back(0x80 | 3); // 4 个相同像素
+    appendBgra(rle, packRgba(1, 2, 3, 4));
+    rle.push_back(1); // 2 个原始像素
+    appendBgra(rle, packRgba(10, 20, 30, 40));
+    appendBgra(rle, packRgba(50, 60, 70, 80));
+    ASSERT_TRUE(Core::Types::decodeImage(rle.data(), rle.size(), image));
+    const uint32_t expected[6] = {packRgba(1, 2, 3, 4), packRgba(1, 2, 3, 4), packRgba(1, 2, 3, 4),
+                                  packRgba(1, 2, 3, 4), packRgba(10, 20, 30, 40), packRgba(50, 60, 70, 80)};
+    for (int i = 0; i < 6; ++i) {
+        EXPECT_EQ(image.pixels[i], expected[i]) << i;
+    }
+
+    // 24 位调色板 + 8 位索引，RLE
+    Bytes mapped = tgaHeader(9, 4, 1, 8, 0x20, 3, 24);
+    for (uint32_t color : {packRgba(255, 0, 0, 255), packRgba(0, 255, 0, 255), packRgba(0, 0, 255, 255)}) {
+        mapped.push_back(static_cast<uint8_t>(color >> 8));
+        mapped.push_back(static_cast<uint8_t>(color >> 16));
+        mapped.push_back(static_cast<uint8_t>(color >> 24));
+    }
+    mapped.insert(mapped.end(), {0x81, 2, 0x01, 0, 1});
+    ASSERT_TRUE(Core::Types::decodeImage(mapped.data(), mapped.size(), image));
+    EXPECT_EQ(image.pixels[0], packRgba(0, 0, 255, 255));
+    EXPECT_EQ(image.pixels[1], packRgba(0, 0, 255, 255));
+    EXPECT_EQ(image.pixels[2], packRgba(255, 0, 0, 255));
+    EXPECT_EQ(image.pixels[3], packRgba(0, 255, 0, 255));
+
+    // 灰度与 16 位 ARGB1555
+    Bytes gray = tgaHeader(3, 2, 1, 8, 0x20);
+    gray.insert(gray.end(), {0, 200});
+    ASSERT_TRUE(Core::Types::decodeImage(gray.data(), gray.size(), image));
+    EXPECT_EQ(image.pixels[1], packRgba(200, 200, 200, 255));
+
+    Bytes argb = tgaHeader(2, 1, 1, 16, 0x21);
+    appendLittleEndian16(argb, 0x8000u | (31u << 10) | (0u << 5) | 16u);
+    ASSERT_TRUE(Core::Types::decodeImage(argb.data(), argb.size(), image));
+    EXPECT_EQ(image.pixels[0], packRgba(255, 0, scaleTo8(16, 31), 255));
+
+    // 超出图像末尾的包截断到剩余像素数（部分编码器会这样写）
+    Bytes overrun = tgaHeader(10, 2, 2, 32, 0x20);
+    overrun.push_back(0x80 | 9);
+    appendBgra(overrun, packRgba(1, 2, 3, 4));
+    ASSERT_TRUE(Core::Types::decodeImage(overrun.data(), overrun.size(), image));
+    EXPECT_EQ(image.pixels[3], packRgba(1, 2, 3, 4));
+
+    Bytes truncated = tgaHeader(10, 2, 2, 32, 0x20);
+    truncated.push_back(3); // 4 个原始像素只给出 1 个
+    appendBgra(truncated, packRgba(1, 2, 3, 4));
+    EXPECT_FALSE(Core::Types::decodeImage(truncated.data(), truncated.size(), image));
+}
+
+TEST(TextureLoadingTest, LoadFromFileBuildsMipmappedTexture) {
+    const std::filesystem::path dir = tempDirectory();
+    const std::filesystem::path path = dir / "load_from_file.png";
+    const PngSpec spec{16, 8, 8, 6};
+    writeFile(path, buildPng(spec));
+
+    std::string error;
+    std::unique_ptr<Texture> texture(Texture::loadFromFile(path.string(), &error));
+    ASSERT_NE(texture, nullptr) << error;
+    ASSERT_EQ(texture->getWidth(), 16);
+    ASSERT_EQ(texture->getHeight(), 8);
+    for (int y = 0; y < 8; ++y) {
+        for (int x = 0; x < 16; ++x) {
+            ASSERT_EQ(texture->getPixels(0)[y * 16 + x], expectedPngPixel(spec, x, y));
+        }
+    }
+    EXPECT_EQ(texture->getWidth(4), 1);
+    EXPECT_TRUE(texture->hasResidentMipmaps());
+
+    error.clear();
+    EXPECT_EQ(Texture::loadFromFile((dir / "missing.png").string(), &error), nullptr);
+    EXPECT_FALSE(error.empty());
+
+    writeFile(dir / "corrupt.png", Bytes{0x89, 'P', 'N', 'G', 1, 2, 3});
+    EXPECT_EQ(Texture::loadFromFile((dir / "corrupt.png").string()), nullptr);
+}
+
+TEST(TextureCacheTest, SharesTexturesByNormalizedPath) {
+    const std::filesystem::path dir = tempDirectory();
+    writeFile(dir / "shared.ppm", makePpm(8, 8, 1));
+
+    TextureCache cache;
+    Texture* first = cache.load((dir / "shared.ppm").string());
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(cache.load((dir / "." / "shared.ppm").string()), first);
+    EXPECT_EQ(cache.load((dir / ".." / dir.filename() / "shared.ppm").string()), first);
+    EXPECT_EQ(cache.find((dir / "shared.ppm").string()), first);
+    EXPECT_EQ(cache.size(), 1u);
+
+    std::string error;
+    EXPECT_EQ(cache.load((dir / "absent.ppm").string(), &error), nullptr);
+    EXPECT_FALSE(error.empty());
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT_EQ(cache.find((dir / "absent.ppm").string()), nullptr);
+}
+
+TEST(TextureCacheTest, LoadAllDecodesInParallelAndDeduplicates) {
+    const std::filesystem::path dir = tempDirectory();
+    std::vector<std::string> files;
+    for (int i = 0; i < 12; ++i) {
+        const std::filesystem::path path = dir / ("batch_" + std::to_string(i) + ".ppm");
+        writeFile(path, makePpm(16 + i, 8 + i * 2, i));
+        files.push_back(path.string());
+    }
+    files.push_back(files[3]);
+    files.push_back((dir / "batch_missing.ppm").string());
+
+    TextureCache cache;
+    Texture* preloaded = cache.load(files[5]);
+    const std::vector<Texture*> textures = cache.loadAll(files);
+    ASSERT_EQ(textures.size(), files.size());
+    EXPECT_EQ(cache.size(), 12u);
+    EXPECT_EQ(textures[5], preloaded);
+    EXPECT_EQ(textures[12], textures[3]);
+    EXPECT_EQ(textures[13], nullptr);
+    for (int i = 0; i < 12; ++i) {
+        ASSERT_NE(textures[i], nullptr);
+        EXPECT_EQ(textures[i]->getWidth(), 16 + i);
+        EXPECT_EQ(textures[i]->getHeight(), 8 + i * 2);
+        EXPECT_EQ(textures[i]->getPixel(2, 1).toUint32(), packRgba(10 + i, 3 + i * 7, (2 ^ 1) + i * 13, 255));
+        EXPECT_EQ(cache.find(files[i]), textures[i]);
+    }
+}
+
+TEST(TextureCacheTest, BudgetReleasesLeastRecentlyUsedMipmaps) {
+    const std::filesystem::path dir = tempDirectory();
+    for (const char* name : {"lru_a.ppm", "lru_b.ppm", "lru_c.ppm"}) {
+        writeFile(dir / name, makePpm(32, 32, name[4]));
+    }
+    TextureCache cache;
+    Texture* a = cache.load((dir / "lru_a.ppm").string());
+    Texture* b = cache.load((dir / "lru_b.ppm").string());
+    Texture* c = cache.load((dir / "lru_c.ppm").string());
+    ASSERT_TRUE(a && b && c);
+
+    const std::size_t baseBytes = 3 * 32 * 32 * sizeof(uint32_t);
+    const std::size_t fullBytes = cache.getMemoryUsage();
+    ASSERT_GT(fullBytes, baseBytes);
+    const std::vector<uint32_t> mipBefore(a->getPixels(1), a->getPixels(1) + 16 * 16);
+
+    // a 最久未用，c 次之，b 在当前帧读取过 mip
+    cache.endFrame();
+    c->getPixel(0, 0, 1);
+    cache.endFrame();
+    b->getPixel(0, 0, 1);
+
+    cache.setMemoryBudget(fullBytes - 1);
+    EXPECT_FALSE(a->hasResidentMipmaps());
+    EXPECT_TRUE(b->hasResidentMipmaps());
+    EXPECT_TRUE(c->hasResidentMipmaps());
+    EXPECT_LT(cache.getMemoryUsage(), fullBytes);
+
+    // 预算只够 level 0：c 被释放，当前帧用过的 b 保留到下一次 endFrame
+    cache.setMemoryBudget(baseBytes);
+    EXPECT_FALSE(c->hasResidentMipmaps());
+    EXPECT_TRUE(b->hasResidentMipmaps());
+    cache.endFrame();
+    EXPECT_TRUE(b->hasResidentMipmaps());
+    cache.endFrame();
+    EXPECT_FALSE(b->hasResidentMipmaps());
+    EXPECT_EQ(cache.getMemoryUsage(), baseBytes);
+
+    // 释放的 mip 在下一次读取时原样重建
+    for (int i = 0; i < 16 * 16; ++i) {
+        ASSERT_EQ(a->getPixels(1)[i], mipBefore[i]) << i;
+    }
+    EXPECT_TRUE(a->hasResidentMipmaps());
+    EXPECT_EQ(a->getMemoryUsage() * 3, fullBytes);
+}
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "core/types/texture.h"
+
+#include "texture_test_utils.h"
+
+using Core::Types::Color;
+using Core::Types::Texture;
+using TextureTestUtils::expectSamePyramid;
+using TextureTestUtils::randomPixels;
+
+TEST(TextureMipmapTest, IncrementalRebuildMatchesFullRebuild) {
+    std::mt19937 rng(40);
+    // 非 2 的幂尺寸，覆盖奇数宽高的截断读取
+    const int w = 97;
+    const int h = 61;
+    Texture texture(randomPixels(rng, w * h), w, h, true);
+
+    std::uniform_int_distribution<int> px(-10, w + 10);
+    std::uniform_int_distribution<int> py(-10, h + 10);
+    std::uniform_int_distribution<int> size(1, 24);
+    for (int round = 0; round < 20; ++round) {
+        // 每轮若干次区域写入与单像素写入，然后读取 mip
+        for (int i = 0; i < 5; ++i) {
+            const int rw = size(rng);
+            const int rh = size(rng);
+            const std::vector<uint32_t> data = randomPixels(rng, static_cast<std::size_t>(rw * rh));
+            texture.updateRegion(px(rng), py(rng), rw, rh, data.data());
+        }
+        for (int i = 0; i < 30; ++i) {
+            texture.setPixel(px(rng), py(rng), Color(0.1f * (i % 10), 0.5f, 1.0f, 1.0f));
+        }
+        expectSamePyramid(texture);
+    }
+}
+
+TEST(TextureMipmapTest, RebuildIsDeferredUntilMipIsRead) {
+    Texture texture(64, 64, true);
+    EXPECT_FALSE(texture.hasPendingMipmapUpdate());
+
+    for (int y = 0; y < 16; ++y) {
+        for (int x = 0; x < 16; ++x) {
+            texture.setPixel(x, y, Color::WHITE);
+        }
+    }
+    EXPECT_TRUE(texture.hasPendingMipmapUpdate());
+    // 读取 level 0 不触发重建
+    EXPECT_EQ(texture.getPixel(3, 3).toUint32(), Color::WHITE.toUint32());
+    texture.sample(0.1f, 0.1f);
+    EXPECT_TRUE(texture.hasPendingMipmapUpdate());
+
+    // 读取 mip 时重建一次：左上 8×8 的 level 1 变白，其余保持黑色
+    EXPECT_EQ(texture.getPixel(7, 7, 1).toUint32(), Color::WHITE.toUint32());
+    EXPECT_FALSE(texture.hasPendingMipmapUpdate());
+    EXPECT_EQ(texture.getPixel(8, 8, 1).toUint32(), Color::BLACK.toUint32());
+    EXPECT_EQ(texture.getPixel(1, 1, 3).toUint32(), Color::WHITE.toUint32());
+    EXPECT_EQ(texture.getPixel(2, 2, 3).toUint32(), Color::BLACK.toUint32());
+
+    // 构造时不建 mip 的纹理在第一次读取 mip 时整体生成
+    std::vector<uint32_t> pixels(32 * 32, Color::WHITE.toUint32());
+    Texture lazy(pixels, 32, 32, false);
+    EXPECT_TRUE(lazy.hasPendingMipmapUpdate());
+    EXPECT_EQ(lazy.getPixel(0, 0, 5).toUint32(), Color::WHITE.toUint32());
+}
+
+TEST(TextureMipmapTest, UpdateRegionClipsToTexture) {
+    Texture texture(8, 8, true);
+    std::vector<uint32_t> data(4 * 4);
+    for (int i = 0; i < 16; ++i) {
+        data[i] = static_cast<uint32_t>(i + 1);
+    }
+    // 左上角越界两行两列，只写入源数据的右下 2×2
+    texture.updateRegion(-2, -2, 4, 4, data.data());
+    EXPECT_EQ(texture.getPixels(0)[0], 11u);
+    EXPECT_EQ(texture.getPixels(0)[1], 12u);
+    EXPECT_EQ(texture.getPixels(0)[8], 15u);
+    EXPECT_EQ(texture.getPixels(0)[9], 16u);
+    EXPECT_EQ(texture.getPixels(0)[2], Color::BLACK.toUint32());
+    // 完全在纹理外的区域不产生脏矩形
+    texture.updateMipmaps();
+    texture.updateRegion(20, 20, 4, 4, data.data());
+    EXPECT_FALSE(texture.hasPendingMipmapUpdate());
+}
+
+TEST(TextureMipmapTest, ConcurrentReadersResolveOnce) {
+    std::mt19937 rng(7);
+    const int w = 256;
+    const int h = 256;
+    Texture texture(randomPixels(rng, w * h), w, h, true);
+    const std::vector<uint32_t> patch = randomPixels(rng, 100 * 80);
+    texture.updateRegion(30, 50, 100, 80, patch.data());
+
+    std::vector<uint32_t> base(texture.getPixels(0), texture.getPixels(0) + w * h);
+    Texture reference(base, w, h, true);
+
+    // 多个线程同时采样 mip：只有一个线程重建，其余等待后读到完整结果
+    std::vector<std::thread> readers;
+    std::vector<int> mismatches(4, 0);
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&, t]() {
+            for (int i = 0; i < 200; ++i) {
+                const float u = (i % 20) / 20.0f;
+                const float v = (i / 20) / 10.0f;
+                const int level = 1 + (i + t) % 4;
+                if (texture.sampleLevel(u, v, level).toUint32() != reference.sampleLevel(u, v, level).toUint32()) {
+                    ++mismatches[t];
+                }
+            }
+        });
+    }
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    for (int count : mismatches) {
+        EXPECT_EQ(count, 0);
+    }
+    EXPECT_FALSE(texture.hasPendingMipmapUpdate());
+}
@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "core/types/texture.h"
+
+#include "texture_test_utils.h"
+
+using Core::Types::Color;
+using Core::Types::Texture;
+using Core::Types::TextureFilter;
+using TextureTestUtils::makeLevelCodedTexture;
+using TextureTestUtils::randomPixels;
+
+namespace {
+
+// 浮点参照：小数坐标映射到 [0, size - 1]，相邻纹素在边缘截断
+Color referenceBilinear(const Texture& texture, float u, float v, int level) {
+    const int w = texture.getWidth(level);
+    const int h = texture.getHeight(level);
+    const float x = (u - std::floor(u)) * (w - 1);
+    const float y = (v - std::floor(v)) * (h - 1);
+    const int x0 = static_cast<int>(x);
+    const int y0 = static_cast<int>(y);
+    const int x1 = std::min(x0 + 1, w - 1);
+    const int y1 = std::min(y0 + 1, h - 1);
+    const float fx = x - x0;
+    const float fy = y - y0;
+    const Color top = texture.getPixel(x0, y0, level) * (1.0f - fx) + texture.getPixel(x1, y0, level) * fx;
+    const Color bottom = texture.getPixel(x0, y1, level) * (1.0f - fx) + texture.getPixel(x1, y1, level) * fx;
+    return top * (1.0f - fy) + bottom * fy;
+}
+
+float maxChannelDifference(const Color& a, const Color& b) {
+    return std::max({std::fabs(a.r - b.r), std::fabs(a.g - b.g), std::fabs(a.b - b.b), std::fabs(a.a - b.a)});
+}
+
+} // namespace
+
+TEST(TextureSamplerTest, PackedBilinearMatchesFloatReference) {
+    std::mt19937 rng(42);
+    // 非 2 的幂尺寸，映射到 [0, w - 1] 时步长不是整数
+    const int w = 23;
+    const int h = 17;
+    Texture texture(randomPixels(rng, w * h), w, h, false);
+
+    std::uniform_real_distribution<float> coord(-3.0f, 3.0f);
+    float maxDiff = 0.0f;
+    for (int i = 0; i < 5000; ++i) {
+        const float u = coord(rng);
+        const float v = coord(rng);
+        maxDiff = std::max(maxDiff, maxChannelDifference(texture.sampleLevel(u, v, 0), referenceBilinear(texture, u, v, 0)));
+    }
+    // 8 位权重与三次逐步舍入：每通道误差不超过约 2 个量化级
+    EXPECT_LT(maxDiff, 2.5f / 255.0f);
+
+    // 纹素中心精确命中原值
+    EXPECT_EQ(texture.sampleLevel(0.0f, 0.0f, 0).toUint32(), texture.getPixel(0, 0).toUint32());
+    EXPECT_EQ(texture.sampleLevel(0.5f, 0.5f, 0).toUint32(), texture.getPixel(11, 8).toUint32());
+}
+
+TEST(TextureSamplerTest, RepeatAddressingIgnoresIntegerPart) {
+    std::mt19937 rng(3);
+    Texture texture(randomPixels(rng, 32 * 32), 32, 32, true);
+    std::uniform_real_distribution<float> coord(0.0f, 1.0f);
+    for (int i = 0; i < 500; ++i) {
+        // 取 2^-10 的整数倍，保证加减整数后浮点表示的小数部分不变
+        const float u = std::floor(coord(rng) * 1024.0f) / 1024.0f;
+        const float v = std::floor(coord(rng) * 1024.0f) / 1024.0f;
+        const uint32_t expected = texture.sample(u, v, 0.01f, 0.0f, 0.0f, 0.01f).toUint32();
+        EXPECT_EQ(texture.sample(u + 1.0f, v - 3.0f, 0.01f, 0.0f, 0.0f, 0.01f).toUint32(), expected);
+        EXPECT_EQ(texture.sample(u - 2.0f, v + 5.0f, 0.01f, 0.0f, 0.0f, 0.01f).toUint32(), expected);
+    }
+}
+
+TEST(TextureSamplerTest, LargeTextureKeepsSubTexelPrecision) {
+    // 16k 宽的黑白相间列：放大时一个纹素内的插值应随 u 平滑变化，不出现按若干分之一纹素的阶梯
+    const int w = 16384;
+    const int h = 2;
+    std::vector<uint32_t> pixels(w * h);
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            pixels[y * w + x] = (x % 2 == 0 ? Color::BLACK : Color::WHITE).toUint32();
+        }
+    }
+    Texture texture(std::move(pixels), w, h, false);
+
+    const int texel = 8190; // 黑色列，右侧为白色
+    std::vector<uint32_t> reds;
+    for (int step = 0; step < 32; ++step) {
+        const float u = (texel + step / 32.0f) / static_cast<float>(w - 1);
+        const Color color = texture.sampleLevel(u, 0.0f, 0);
+        EXPECT_LT(maxChannelDifference(color, referenceBilinear(texture, u, 0.0f, 0)), 2.5f / 255.0f);
+        reds.push_back(color.toUint32() >> 24);
+    }
+    // 相邻 1/32 纹素步长的结果单调递增且各不相同
+    for (std::size_t i = 1; i < reds.size(); ++i) {
+        EXPECT_GT(reds[i], reds[i - 1]);
+    }
+}
+
+TEST(TextureSamplerTest, BatchedSamplingMatchesScalar) {
+    std::mt19937 rng(11);
+    Texture texture(randomPixels(rng, 64 * 48), 64, 48, true);
+    std::uniform_real_distribution<float> coord(-1.5f, 2.5f);
+    std::uniform_real_distribution<float> deriv(-0.2f, 0.2f);
+
+    for (TextureFilter filter : {TextureFilter::Bilinear, TextureFilter::Trilinear}) {
+        texture.setFilter(filter);
+        for (int batch = 0; batch < 200; ++batch) {
+            const float dudx = deriv(rng), dudy = deriv(rng), dvdx = deriv(rng), dvdy = deriv(rng);
+            float u[8], v[8];
+            for (int i = 0; i < 8; ++i) {
+                u[i] = coord(rng);
+                v[i] = coord(rng);
+            }
+            Color out8[8], out4[4];
+            texture.sample8(u, v, dudx, dudy, dvdx, dvdy, out8);
+            texture.sample4(u, v, dudx, dudy, dvdx, dvdy, out4);
+            for (int i = 0; i < 8; ++i) {
+                const uint32_t expected = texture.sample(u[i], v[i], dudx, dudy, dvdx, dvdy).toUint32();
+                EXPECT_EQ(out8[i].toUint32(), expected);
+                if (i < 4) {
+                    EXPECT_EQ(out4[i].toUint32(), expected);
+                }
+            }
+        }
+    }
+}
+
+TEST(TextureSamplerTest, MipSelectionFollowsFootprint) {
+    const int size = 64;
+    Texture texture = makeLevelCodedTexture(size);
+    auto levelAt = [&](float footprint) {
+        // 各向同性的导数：每个屏幕像素覆盖 footprint 个 level 0 纹素
+        const float d = footprint / size;
+        return texture.sample(0.3f, 0.6f, d, 0.0f, 0.0f, d).r * 255.0f / 16.0f;
+    };
+
+    // 双线性：取 floor(log2(footprint))，放大时为 level 0，超过金字塔高度时取最后一级
+    EXPECT_FLOAT_EQ(levelAt(0.5f), 0.0f);
+    for (float footprint : {1.0f, 1.9f, 2.0f, 3.0f, 7.9f, 8.0f, 12.0f, 33.0f}) {
+        EXPECT_NEAR(levelAt(footprint), std::floor(std::log2(footprint)), 1e-4f) << "footprint " << footprint;
+    }
+    EXPECT_NEAR(levelAt(1000.0f), 6.0f, 1e-4f);
+    // 导数取绝对值最大的分量
+    EXPECT_NEAR(texture.sample(0.3f, 0.6f, 0.0f, -4.0f / size, 1.0f / size, 0.0f).r * 255.0f / 16.0f, 2.0f, 1e-4f);
+
+    // 三线性：2 的幂处权重为 0，中间按 LOD 的小数部分单调混合到下一级
+    texture.setFilter(TextureFilter::Trilinear);
+    for (float footprint : {1.0f, 2.0f, 4.0f, 16.0f}) {
+        EXPECT_NEAR(levelAt(footprint), std::log2(footprint), 1e-4f);
+    }
+    float previous = levelAt(2.0f);
+    for (float footprint = 2.25f; footprint < 4.0f; footprint += 0.25f) {
+        const float level = levelAt(footprint);
+        EXPECT_GT(level, previous);
+        EXPECT_LT(level, 2.0f);
+        // 尾数线性近似 log2 的小数部分，误差不超过约 0.09 级
+        EXPECT_NEAR(level, std::log2(footprint), 0.1f);
+        previous = level;
+    }
+    EXPECT_NEAR(levelAt(1000.0f), 6.0f, 1e-4f);
+}
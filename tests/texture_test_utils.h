@@ -0,0 +1,99 @@
+#ifndef TESTS_TEXTURE_TEST_UTILS_H
+#define TESTS_TEXTURE_TEST_UTILS_H
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "core/types/texture.h"
+
+// 纹理测试共用的纹素打包、随机图像与 mip 链比较
+namespace TextureTestUtils {
+
+// 与 Texture 存储相同的 RGBA8 打包（R 在最高字节）
+inline uint32_t packRgba(uint32_t r, uint32_t g, uint32_t b, uint32_t a) {
+    return (r << 24) | (g << 16) | (b << 8) | a;
+}
+
+// 取打包纹素的一个通道，index 0..3 依次为 R、G、B、A
+inline int channel(uint32_t texel, int index) {
+    return static_cast<int>((texel >> (24 - 8 * index)) & 0xFFu);
+}
+
+inline std::vector<uint32_t> randomPixels(std::mt19937& rng, std::size_t count) {
+    std::uniform_int_distribution<uint32_t> dist;
+    std::vector<uint32_t> pixels(count);
+    for (uint32_t& p : pixels) {
+        p = dist(rng);
+    }
+    return pixels;
+}
+
+// 每级填充不同的灰度（level k 为 k·16/255），便于从采样结果反推所取的 mip 级；
+// level 0 保持构造时的黑色，只直接写 mip，不产生脏区域
+inline Core::Types::Texture makeLevelCodedTexture(int size) {
+    Core::Types::Texture texture(size, size, true);
+    for (int level = 1;; ++level) {
+        const int w = texture.getWidth(level);
+        const int h = texture.getHeight(level);
+        const float gray = level * 16.0f / 255.0f;
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                texture.setPixel(x, y, Core::Types::Color(gray, gray, gray, 1.0f), level);
+            }
+        }
+        if (w == 1 && h == 1) {
+            break;
+        }
+    }
+    return texture;
+}
+
+// 包括 level 0 在内的 mip 级数
+inline int mipLevelCount(const Core::Types::Texture& texture) {
+    int count = 1;
+    while (texture.getWidth(count - 1) > 1 || texture.getHeight(count - 1) > 1) {
+        ++count;
+    }
+    return count;
+}
+
+// 按四舍五入读回打包值，避免 Color::toUint32 的截断掩盖差异；与存储格式和布局无关
+inline uint32_t texelAt(const Core::Types::Texture& texture, int x, int y, int level) {
+    const Core::Types::Color c = texture.getPixel(x, y, level);
+    return packRgba(static_cast<uint32_t>(std::lround(c.r * 255.0f)), static_cast<uint32_t>(std::lround(c.g * 255.0f)),
+                    static_cast<uint32_t>(std::lround(c.b * 255.0f)), static_cast<uint32_t>(std::lround(c.a * 255.0f)));
+}
+
+// level 1 起逐级比较尺寸与每个纹素
+inline void expectSameMipChain(const Core::Types::Texture& actual, const Core::Types::Texture& expected) {
+    const int levels = mipLevelCount(expected);
+    ASSERT_EQ(mipLevelCount(actual), levels);
+    for (int level = 1; level < levels; ++level) {
+        ASSERT_EQ(actual.getWidth(level), expected.getWidth(level));
+        ASSERT_EQ(actual.getHeight(level), expected.getHeight(level));
+        for (int y = 0; y < expected.getHeight(level); ++y) {
+            for (int x = 0; x < expected.getWidth(level); ++x) {
+                ASSERT_EQ(texelAt(actual, x, y, level), texelAt(expected, x, y, level))
+                    << "level " << level << " texel (" << x << ", " << y << ")";
+            }
+        }
+    }
+}
+
+// 用 level 0 的当前内容整体重建一张参照纹理（线性布局），与 actual 的 mip 链比较
+inline void expectSamePyramid(const Core::Types::Texture& actual) {
+    const int w = actual.getWidth();
+    const int h = actual.getHeight();
+    const std::vector<uint32_t> base(actual.getPixels(0), actual.getPixels(0) + w * h);
+    const Core::Types::Texture reference(base, w, h, true);
+    expectSameMipChain(actual, reference);
+}
+
+} // namespace TextureTestUtils
+
+#endif // TESTS_TEXTURE_TEST_UTILS_H
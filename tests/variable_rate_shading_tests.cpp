@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+#include "core/types/material.h"
+#include "renderer/lighting/light.h"
+#include "renderer/pipeline/software_renderer.h"
+#include "scene/camera.h"
+#include "scene/mesh.h"
+#include "scene/scene.h"
+
+#include "render_test_utils.h"
+
+using namespace Renderer::Pipeline;
+using Core::Math::Vector3;
+using Core::Types::ShadingRate;
+using Renderer::Lighting::DirectionalLight;
+using Renderer::Lighting::PointLight;
+
+namespace {
+constexpr int W = 64;
+constexpr int H = 64;
+
+// 正对相机、几乎铺满画面的平面，方向光照明且无高光：各像素光照相同
+struct FlatScene {
+    Scene::Camera camera;
+    std::unique_ptr<Scene::Mesh> quad{Scene::Mesh::createQuad(4.0f, 4.0f)};
+    std::unique_ptr<Core::Types::Material> material{new Core::Types::Material()};
+    DirectionalLight sun{Vector3(0.2f, -0.3f, -1.0f), Core::Types::Color::WHITE, 0.8f};
+    Scene::Scene scene;
+
+    FlatScene() {
+        camera.setPerspective(Core::Math::Constants::PI / 3.0f, 1.0f, 0.1f, 100.0f);
+        camera.lookAt(Vector3(0.0f, 0.0f, 4.0f), Vector3(0.0f, 0.0f, 0.0f), Vector3(0.0f, 1.0f, 0.0f));
+        material->setSpecular(Core::Types::Color(0.0f, 0.0f, 0.0f, 1.0f));
+        quad->setMaterial(material.get());
+        scene.setCamera(&camera);
+        scene.addObject(quad.get());
+        scene.addLight(&sun);
+    }
+};
+
+SoftwareRendererSettings makeSettings(ShadingRate rate) {
+    SoftwareRendererSettings settings = RenderTestUtils::makeSettings(W, H);
+    settings.backfaceCulling = false;
+    settings.shadingRate = rate;
+    return settings;
+}
+
+} // namespace
+
+TEST(VariableRateShadingTest, CoarseRatesCutShadeInvocations) {
+    FlatScene s;
+
+    SoftwareRenderer full(makeSettings(ShadingRate::Rate1x1));
+    full.render(s.scene);
+    SoftwareRenderer half(makeSettings(ShadingRate::Rate2x2));
+    half.render(s.scene);
+    SoftwareRenderer quarter(makeSettings(ShadingRate::Rate4x4));
+    quarter.render(s.scene);
+
+    // 覆盖与深度仍逐像素：写入的片元数不变
+    const RenderStats& fullStats = full.getStats();
+    ASSERT_GT(fullStats.fragments, 1000u);
+    EXPECT_EQ(fullStats.shadeInvocations, fullStats.fragments);
+    EXPECT_EQ(half.getStats().fragments, fullStats.fragments);
+    EXPECT_EQ(quarter.getStats().fragments, fullStats.fragments);
+
+    EXPECT_LE(half.getStats().shadeInvocations * 3, fullStats.shadeInvocations);
+    EXPECT_LE(quarter.getStats().shadeInvocations * 10, fullStats.shadeInvocations);
+
+    // 低频表面上粗粒度着色没有可见差异
+    EXPECT_LT(RenderTestUtils::maxDifference(full.getRenderTarget(), half.getRenderTarget(), 0, W), 1e-4f);
+    EXPECT_LT(RenderTestUtils::maxDifference(full.getRenderTarget(), quarter.getRenderTarget(), 0, W), 1e-4f);
+}
+
+TEST(VariableRateShadingTest, MaterialRateOverridesRenderer) {
+    FlatScene s;
+
+    SoftwareRenderer full(makeSettings(ShadingRate::Rate1x1));
+    full.render(s.scene);
+
+    s.material->setShadingRate(ShadingRate::Rate2x2);
+    SoftwareRenderer fromMaterial(makeSettings(ShadingRate::Rate1x1));
+    fromMaterial.render(s.scene);
+    EXPECT_LE(fromMaterial.getStats().shadeInvocations * 3, full.getStats().shadeInvocations);
+
+    s.material->setShadingRate(ShadingRate::Rate1x1);
+    SoftwareRenderer forcedFull(makeSettings(ShadingRate::Rate4x4));
+    forcedFull.render(s.scene);
+    EXPECT_EQ(forcedFull.getStats().shadeInvocations, full.getStats().shadeInvocations);
+}
+
+TEST(VariableRateShadingTest, RateImageAppliesPerScreenRegion) {
+    FlatScene s;
+    // 点光源让平面亮度随位置变化，粗粒度区域会出现块状差异
+    PointLight lamp(Vector3(0.0f, 0.0f, 0.5f), Core::Types::Color::WHITE, 2.0f, 4.0f);
+    s.scene.addLight(&lamp);
+
+    SoftwareRenderer full(makeSettings(ShadingRate::Rate1x1));
+    full.render(s.scene);
+
+    // 左半屏 4x4，右半屏保持逐像素
+    SoftwareRendererSettings settings = makeSettings(ShadingRate::Rate1x1);
+    settings.shadingRateImage.resize(2, 1);
+    settings.shadingRateImage.set(0, 0, ShadingRate::Rate4x4);
+    SoftwareRenderer mixed(settings);
+    mixed.render(s.scene);
+
+    EXPECT_EQ(RenderTestUtils::maxDifference(full.getRenderTarget(), mixed.getRenderTarget(), W / 2, W), 0.0f);
+    EXPECT_GT(RenderTestUtils::maxDifference(full.getRenderTarget(), mixed.getRenderTarget(), 0, W / 2), 0.0f);
+    EXPECT_LT(mixed.getStats().shadeInvocations, full.getStats().shadeInvocations * 3 / 4);
+    EXPECT_GT(mixed.getStats().shadeInvocations, full.getStats().shadeInvocations / 2);
+}
+
+TEST(VariableRateShadingTest, VertexLightingCountsVertexInvocations) {
+    FlatScene s;
+    SoftwareRendererSettings settings = makeSettings(ShadingRate::Rate1x1);
+    settings.lightingFrequency = Core::Types::LightingFrequency::PerVertex;
+    SoftwareRenderer renderer(settings);
+    renderer.render(s.scene);
+
+    EXPECT_EQ(renderer.getStats().shadeInvocations, 0u);
+    EXPECT_EQ(renderer.getStats().vertexShadeInvocations, 4u);
+    EXPECT_GT(renderer.getStats().fragments, 1000u);
+}
@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+#include "core/types/material.h"
+#include "renderer/lighting/light.h"
+#include "renderer/pipeline/software_renderer.h"
+#include "scene/camera.h"
+#include "scene/mesh.h"
+#include "scene/scene.h"
+
+#include "render_test_utils.h"
+
+using namespace Renderer::Pipeline;
+using Core::Math::Matrix4;
+using Core::Math::Vector3;
+using Core::Types::LightingFrequency;
+using Renderer::Lighting::DirectionalLight;
+using Renderer::Lighting::PointLight;
+
+namespace {
+constexpr int W = 48;
+constexpr int H = 48;
+
+SoftwareRendererSettings makeSettings(LightingFrequency frequency) {
+    SoftwareRendererSettings settings = RenderTestUtils::makeSettings(W, H);
+    settings.backfaceCulling = false;
+    settings.lightingFrequency = frequency;
+    return settings;
+}
+
+// 正对相机的大平面，近处点光源在中心形成逐像素才能表现的亮斑
+struct QuadScene {
+    Scene::Camera camera;
+    std::unique_ptr<Scene::Mesh> quad{Scene::Mesh::createQuad(4.0f, 4.0f)};
+    std::unique_ptr<Core::Types::Material> material{new Core::Types::Material()};
+    PointLight lamp{Vector3(0.0f, 0.0f, 0.3f), Core::Types::Color::WHITE, 2.0f, 3.0f};
+    Scene::Scene scene;
+    int quadIndex;
+
+    QuadScene() {
+        camera.setPerspective(Core::Math::Constants::PI / 3.0f, 1.0f, 0.1f, 100.0f);
+        camera.lookAt(Vector3(0.0f, 0.0f, 4.0f), Vector3(0.0f, 0.0f, 0.0f), Vector3(0.0f, 1.0f, 0.0f));
+        material->setSpecular(Core::Types::Color(0.0f, 0.0f, 0.0f, 1.0f));
+        quad->setMaterial(material.get());
+        scene.setCamera(&camera);
+        quadIndex = scene.addObject(quad.get());
+        scene.addLight(&lamp);
+    }
+};
+
+} // namespace
+
+TEST(VertexLightingTest, MatchesPerPixelForUniformLighting) {
+    // 方向光 + 无高光：平面上各处光照相同，逐顶点与逐像素结果一致
+    Scene::Camera camera;
+    camera.setPerspective(Core::Math::Constants::PI / 3.0f, 1.0f, 0.1f, 100.0f);
+    camera.lookAt(Vector3(0.0f, 0.0f, 4.0f), Vector3(0.0f, 0.0f, 0.0f), Vector3(0.0f, 1.0f, 0.0f));
+    std::unique_ptr<Scene::Mesh> quad(Scene::Mesh::createQuad(3.0f, 3.0f));
+    std::unique_ptr<Core::Types::Material> material(new Core::Types::Material());
+    material->setSpecular(Core::Types::Color(0.0f, 0.0f, 0.0f, 1.0f));
+    quad->setMaterial(material.get());
+    DirectionalLight sun(Vector3(0.3f, -0.2f, -1.0f), Core::Types::Color::WHITE, 0.8f);
+
+    Scene::Scene scene;
+    scene.setCamera(&camera);
+    scene.addObject(quad.get());
+    scene.addLight(&sun);
+
+    SoftwareRenderer perPixel(makeSettings(LightingFrequency::PerPixel));
+    perPixel.render(scene);
+    SoftwareRenderer perVertex(makeSettings(LightingFrequency::PerVertex));
+    perVertex.render(scene);
+
+    EXPECT_LT(RenderTestUtils::maxDifference(perPixel.getRenderTarget(), perVertex.getRenderTarget()), 1e-4f);
+    EXPECT_GT(perVertex.getRenderTarget().getPixel(W / 2, H / 2).r, 0.1f);
+}
+
+TEST(VertexLightingTest, PerVertexLosesInteriorHighlight) {
+    QuadScene s;
+
+    SoftwareRenderer perPixel(makeSettings(LightingFrequency::PerPixel));
+    perPixel.render(s.scene);
+    SoftwareRenderer perVertex(makeSettings(LightingFrequency::PerVertex));
+    perVertex.render(s.scene);
+
+    // 点光源只照亮平面中心，四个角顶点都在范围外，Gouraud 插值得不到中心亮斑
+    const float center = perPixel.getRenderTarget().getPixel(W / 2, H / 2).r;
+    const float centerGouraud = perVertex.getRenderTarget().getPixel(W / 2, H / 2).r;
+    EXPECT_GT(center, centerGouraud + 0.2f);
+}
+
+TEST(VertexLightingTest, ObjectOverridesMaterialAndRenderer) {
+    QuadScene s;
+
+    SoftwareRenderer reference(makeSettings(LightingFrequency::PerVertex));
+    reference.render(s.scene);
+
+    // 材质要求逐顶点，渲染器默认逐像素
+    s.material->setLightingFrequency(LightingFrequency::PerVertex);
+    SoftwareRenderer fromMaterial(makeSettings(LightingFrequency::PerPixel));
+    fromMaterial.render(s.scene);
+    EXPECT_EQ(RenderTestUtils::maxDifference(reference.getRenderTarget(), fromMaterial.getRenderTarget()), 0.0f);
+
+    // 物体设置优先于材质
+    s.scene.setObjectLightingFrequency(s.quadIndex, LightingFrequency::PerPixel);
+    SoftwareRenderer fromObject(makeSettings(LightingFrequency::PerVertex));
+    fromObject.render(s.scene);
+    SoftwareRenderer perPixel(makeSettings(LightingFrequency::PerPixel));
+    s.scene.setObjectLightingFrequency(s.quadIndex, LightingFrequency::Inherit);
+    s.material->setLightingFrequency(LightingFrequency::Inherit);
+    perPixel.render(s.scene);
+    EXPECT_EQ(RenderTestUtils::maxDifference(perPixel.getRenderTarget(), fromObject.getRenderTarget()), 0.0f);
+}
+
+TEST(VertexLightingTest, AutoSelectsByProjectedTriangleArea) {
+    QuadScene s;
+
+    // 两个三角形覆盖大半个屏幕：Auto 保持逐像素
+    SoftwareRenderer perPixel(makeSettings(LightingFrequency::PerPixel));
+    perPixel.render(s.scene);
+    SoftwareRenderer autoLarge(makeSettings(LightingFrequency::Auto));
+    autoLarge.render(s.scene);
+    EXPECT_EQ(RenderTestUtils::maxDifference(perPixel.getRenderTarget(), autoLarge.getRenderTarget()), 0.0f);
+
+    // 阈值高于平均面积时，Auto 退化为逐顶点
+    SoftwareRendererSettings settings = makeSettings(LightingFrequency::Auto);
+    settings.vertexLightingAreaThreshold = static_cast<float>(W * H);
+    SoftwareRenderer autoSmall(settings);
+    autoSmall.render(s.scene);
+    SoftwareRenderer perVertex(makeSettings(LightingFrequency::PerVertex));
+    perVertex.render(s.scene);
+    EXPECT_EQ(RenderTestUtils::maxDifference(perVertex.getRenderTarget(), autoSmall.getRenderTarget()), 0.0f);
+}
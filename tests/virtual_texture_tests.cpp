@@ -0,0 +1,359 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/types/texture.h"
+#include "core/types/texture_cache.h"
+#include "core/types/virtual_texture.h"
+
+using Core::Types::Color;
+using Core::Types::Texture;
+using Core::Types::TextureCache;
+using Core::Types::TextureFilter;
+using Core::Types::TextureFormat;
+using Core::Types::TextureLayout;
+using Core::Types::VirtualPageCache;
+
+namespace {
+
+// 200 × 120、页大小 32：level 0–2 分页（7×4、4×2、2×1 页），level 3（25 × 15）起为 mip 尾
+constexpr int kWidth = 200;
+constexpr int kHeight = 120;
+constexpr int kPageSize = 32;
+constexpr int kTotalPages = 7 * 4 + 4 * 2 + 2 * 1;
+
+std::vector<uint32_t> makeImage(int width, int height) {
+    std::vector<uint32_t> pixels(static_cast<std::size_t>(width) * height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const uint32_t r = static_cast<uint32_t>(x * 7 + y) & 0xFFu;
+            const uint32_t g = static_cast<uint32_t>(y * 5 + (x >> 2)) & 0xFFu;
+            const uint32_t b = static_cast<uint32_t>((x ^ y) * 3) & 0xFFu;
+            const uint32_t a = 128u + static_cast<uint32_t>((x + y) & 127);
+            pixels[static_cast<std::size_t>(y) * width + x] = (r << 24) | (g << 16) | (b << 8) | a;
+        }
+    }
+    return pixels;
+}
+
+std::string tempFile(const std::string& name) {
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "virtual_texture_tests";
+    std::filesystem::create_directories(dir);
+    return (dir / name).string();
+}
+
+// 写出测试图像的分页文件，同时返回由同一份像素构建的普通纹理作为参照
+std::string writeTestTexture(const std::string& name, std::unique_ptr<Texture>& reference) {
+    const std::vector<uint32_t> pixels = makeImage(kWidth, kHeight);
+    const std::string path = tempFile(name);
+    std::string error;
+    EXPECT_TRUE(Core::Types::writeVirtualTexture(path, pixels.data(), kWidth, kHeight, kPageSize, &error)) << error;
+    reference.reset(new Texture(pixels, kWidth, kHeight, true));
+    return path;
+}
+
+void expectSameColor(const Color& actual, const Color& expected) {
+    EXPECT_EQ(actual.r, expected.r);
+    EXPECT_EQ(actual.g, expected.g);
+    EXPECT_EQ(actual.b, expected.b);
+    EXPECT_EQ(actual.a, expected.a);
+}
+
+// level 0 纹素 (x, y) 中心的纹理坐标
+float texelU(int x) { return (static_cast<float>(x) + 0.25f) / static_cast<float>(kWidth - 1); }
+float texelV(int y) { return (static_cast<float>(y) + 0.25f) / static_cast<float>(kHeight - 1); }
+
+} // namespace
+
+TEST(VirtualTextureTest, OpensPagedFileWithResidentMipTail) {
+    std::unique_ptr<Texture> reference;
+    const std::string path = writeTestTexture("tail.vtex", reference);
+    std::unique_ptr<Texture> texture(Texture::loadVirtual(path, 8));
+    ASSERT_TRUE(texture);
+    ASSERT_TRUE(texture->isVirtual());
+    const VirtualPageCache* pages = texture->getVirtualPages();
+    EXPECT_EQ(pages->getPagedLevels(), 3);
+    EXPECT_EQ(pages->getPagesX(0), 7);
+    EXPECT_EQ(pages->getPagesY(0), 4);
+    EXPECT_EQ(pages->getPagesX(2), 2);
+    EXPECT_EQ(pages->getPagesY(2), 1);
+    EXPECT_EQ(pages->getResidentPages(), 0);
+
+    EXPECT_EQ(texture->getWidth(), kWidth);
+    EXPECT_EQ(texture->getHeight(), kHeight);
+    EXPECT_EQ(texture->getWidth(3), 25);
+    EXPECT_EQ(texture->getHeight(3), 15);
+    for (int level = 3; level < 8; ++level) {
+        const int count = texture->getWidth(level) * texture->getHeight(level);
+        const uint32_t* tail = texture->getPixels(level);
+        ASSERT_NE(tail, nullptr);
+        for (int i = 0; i < count; ++i) {
+            ASSERT_EQ(tail[i], reference->getPixels(level)[i]) << level << ":" << i;
+        }
+    }
+    EXPECT_EQ(texture->getPixels(0), nullptr);
+    EXPECT_EQ(texture->getPixels(2), nullptr);
+}
+
+TEST(VirtualTextureTest, MissingPagesFallBackToCoarserLevels) {
+    std::unique_ptr<Texture> reference;
+    const std::string path = writeTestTexture("fallback.vtex", reference);
+    std::unique_ptr<Texture> texture(Texture::loadVirtual(path, 16));
+    ASSERT_TRUE(texture);
+    VirtualPageCache* pages = texture->getVirtualPages();
+
+    // 没有页驻留：level 0 的采样落到 mip 尾的第一级
+    const float u = texelU(70), v = texelV(40);
+    expectSameColor(texture->sampleLevel(u, v, 0), reference->sampleLevel(u, v, 3));
+    expectSameColor(texture->getPixel(70, 40), reference->getPixel(70 >> 3, 40 >> 3, 3));
+
+    // 反馈包含退回过程中经过的每一级，较粗的级先读入
+    EXPECT_EQ(pages->update(1), 1);
+    EXPECT_TRUE(pages->isResident(2, 0, 0));
+    EXPECT_FALSE(pages->isResident(1, 1, 0));
+    EXPECT_FALSE(pages->isResident(0, 2, 1));
+    expectSameColor(texture->sampleLevel(u, v, 0), reference->sampleLevel(u, v, 2));
+
+    EXPECT_EQ(pages->update(1), 1);
+    EXPECT_TRUE(pages->isResident(1, 1, 0));
+    expectSameColor(texture->sampleLevel(u, v, 0), reference->sampleLevel(u, v, 1));
+
+    EXPECT_EQ(pages->update(), 1);
+    EXPECT_TRUE(pages->isResident(0, 2, 1));
+    expectSameColor(texture->sampleLevel(u, v, 0), reference->sampleLevel(u, v, 0));
+    expectSameColor(texture->getPixel(70, 40), reference->getPixel(70, 40));
+    EXPECT_EQ(pages->getResidentPages(), 3);
+    EXPECT_EQ(pages->getLoadedPages(), 3u);
+
+    // 没有新的反馈时不读入任何页
+    EXPECT_EQ(pages->update(), 0);
+}
+
+TEST(VirtualTextureTest, BilinearFootprintAcrossPagesRequestsEveryPage) {
+    std::unique_ptr<Texture> reference;
+    const std::string path = writeTestTexture("border.vtex", reference);
+    std::unique_ptr<Texture> texture(Texture::loadVirtual(path, 16));
+    ASSERT_TRUE(texture);
+    VirtualPageCache* pages = texture->getVirtualPages();
+
+    // (31, 31) 的 2×2 邻域跨越四页
+    const float u = texelU(31), v = texelV(31);
+    texture->sampleLevel(u, v, 0);
+    pages->update();
+    for (int py = 0; py < 2; ++py) {
+        for (int px = 0; px < 2; ++px) {
+            EXPECT_TRUE(pages->isResident(0, px, py)) << px << "," << py;
+        }
+    }
+    expectSameColor(texture->sampleLevel(u, v, 0), reference->sampleLevel(u, v, 0));
+}
+
+TEST(VirtualTextureTest, FullyResidentSamplingMatchesRegularTexture) {
+    std::unique_ptr<Texture> reference;
+    const std::string path = writeTestTexture("resident.vtex", reference);
+    std::unique_ptr<Texture> texture(Texture::loadVirtual(path, kTotalPages));
+    ASSERT_TRUE(texture);
+    VirtualPageCache* pages = texture->getVirtualPages();
+
+    struct Derivs {
+        float dudx, dudy, dvdx, dvdy;
+    };
+    const Derivs derivs[] = {
+        {0.001f, 0.0f, 0.0f, 0.001f},
+        {0.012f, 0.0f, 0.0f, 0.015f},
+        {0.03f, 0.004f, -0.002f, 0.025f},
+        {0.02f, 0.0f, 0.0f, 0.002f}, // 各向异性
+    };
+    const TextureFilter filters[] = {TextureFilter::Bilinear, TextureFilter::Trilinear, TextureFilter::Anisotropic};
+
+    auto sweep = [&](bool compare) {
+        for (TextureFilter filter : filters) {
+            texture->setFilter(filter);
+            reference->setFilter(filter);
+            for (const Derivs& d : derivs) {
+                for (int i = 0; i < 64; ++i) {
+                    const float u = 0.013f + 0.0157f * static_cast<float>(i);
+                    const float v = 0.91f - 0.0139f * static_cast<float>(i);
+                    const Color actual = texture->sample(u, v, d.dudx, d.dudy, d.dvdx, d.dvdy);
+                    if (compare) {
+                        expectSameColor(actual, reference->sample(u, v, d.dudx, d.dudy, d.dvdx, d.dvdy));
+                    }
+                }
+            }
+        }
+    };
+    // 容量足够时反馈驱动的读入收敛到所有用到的页驻留
+    int rounds = 0;
+    do {
+        sweep(false);
+        ++rounds;
+    } while (pages->update(kTotalPages) > 0 && rounds < 8);
+    EXPECT_LE(rounds, 2);
+    sweep(true);
+
+    float u[8], v[8];
+    for (int i = 0; i < 8; ++i) {
+        u[i] = 0.2f + 0.031f * static_cast<float>(i);
+        v[i] = 0.7f - 0.027f * static_cast<float>(i);
+    }
+    texture->setFilter(TextureFilter::Trilinear);
+    reference->setFilter(TextureFilter::Trilinear);
+    Color batch[8], expected[8];
+    for (int pass = 0; pass < 2; ++pass) {
+        texture->sample8(u, v, 0.004f, 0.0f, 0.0f, 0.004f, batch);
+        pages->update(kTotalPages);
+    }
+    reference->sample8(u, v, 0.004f, 0.0f, 0.0f, 0.004f, expected);
+    for (int i = 0; i < 8; ++i) {
+        expectSameColor(batch[i], expected[i]);
+    }
+}
+
+TEST(VirtualTextureTest, PoolCapacityBoundsMemoryAndKeepsPagesUsedThisFrame) {
+    std::unique_ptr<Texture> reference;
+    const std::string path = writeTestTexture("pool.vtex", reference);
+    std::unique_ptr<Texture> texture(Texture::loadVirtual(path, 4));
+    ASSERT_TRUE(texture);
+    VirtualPageCache* pages = texture->getVirtualPages();
+    const std::size_t memory = texture->getMemoryUsage();
+
+    // 第 1 帧：页 A = level 0 (0, 0) 连同 level 1 (0, 0)、level 2 (0, 0) 一起读入
+    texture->sampleLevel(texelU(10), texelV(10), 0);
+    EXPECT_EQ(pages->update(), 3);
+    EXPECT_TRUE(pages->isResident(0, 0, 0));
+
+    // 第 2 帧：A 命中；页 B = level 0 (3, 0) 缺失，退到 level 1 (1, 0)（缺失）与 level 2 (0, 0)
+    texture->sampleLevel(texelU(10), texelV(10), 0);
+    texture->sampleLevel(texelU(100), texelV(10), 0);
+    EXPECT_EQ(pages->update(), 2);
+    EXPECT_EQ(pages->getResidentPages(), 4);
+    EXPECT_TRUE(pages->isResident(0, 0, 0));  // 本帧用过，保留
+    EXPECT_TRUE(pages->isResident(2, 0, 0));  // 本帧用过，保留
+    EXPECT_TRUE(pages->isResident(1, 1, 0));  // 空闲页
+    EXPECT_TRUE(pages->isResident(0, 3, 0));  // 淘汰上一帧才用过的 level 1 (0, 0)
+    EXPECT_FALSE(pages->isResident(1, 0, 0));
+    expectSameColor(texture->sampleLevel(texelU(100), texelV(10), 0), reference->sampleLevel(texelU(100), texelV(10), 0));
+
+    // 扫过整张纹理：驻留页数与内存不超过容量
+    for (int frame = 0; frame < 6; ++frame) {
+        for (int y = 0; y < kHeight; y += 16) {
+            for (int x = 0; x < kWidth; x += 16) {
+                texture->sampleLevel(texelU(x), texelV(y), 0);
+            }
+        }
+        pages->update();
+        EXPECT_LE(pages->getResidentPages(), 4);
+    }
+    EXPECT_EQ(texture->getMemoryUsage(), memory);
+}
+
+TEST(VirtualTextureTest, ConcurrentSamplingRecordsFeedbackFromEveryThread) {
+    std::unique_ptr<Texture> reference;
+    const std::string path = writeTestTexture("threads.vtex", reference);
+    std::unique_ptr<Texture> texture(Texture::loadVirtual(path, kTotalPages));
+    ASSERT_TRUE(texture);
+
+    // 每个线程采样 level 0 的一行页
+    std::vector<std::thread> threads;
+    for (int row = 0; row < 4; ++row) {
+        threads.emplace_back([&texture, row]() {
+            for (int x = 0; x < kWidth; x += 8) {
+                texture->sampleLevel(texelU(x), texelV(row * kPageSize + 5), 0);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    const VirtualPageCache* pages = texture->getVirtualPages();
+    EXPECT_EQ(texture->getVirtualPages()->update(kTotalPages), 7 * 4 + 4 * 2 + 2);
+    for (int py = 0; py < 4; ++py) {
+        for (int px = 0; px < 7; ++px) {
+            EXPECT_TRUE(pages->isResident(0, px, py)) << px << "," << py;
+        }
+    }
+}
+
+TEST(VirtualTextureTest, VirtualTexturesAreReadOnly) {
+    std::unique_ptr<Texture> reference;
+    const std::string path = writeTestTexture("readonly.vtex", reference);
+    std::unique_ptr<Texture> texture(Texture::loadVirtual(path, 4));
+    ASSERT_TRUE(texture);
+    const Color before = texture->getPixel(2, 2, 3);
+
+    texture->setPixel(2, 2, Color::RED, 3);
+    texture->clear(Color::BLUE);
+    texture->setFormat(TextureFormat::BC1);
+    texture->setLayout(TextureLayout::Tiled);
+    expectSameColor(texture->getPixel(2, 2, 3), before);
+    EXPECT_EQ(texture->getFormat(), TextureFormat::RGBA8);
+    EXPECT_EQ(texture->getLayout(), TextureLayout::Linear);
+    EXPECT_FALSE(texture->hasResidentMipmaps());
+    EXPECT_EQ(texture->releaseMipmaps(), 0u);
+    EXPECT_FALSE(texture->hasPendingMipmapUpdate());
+}
+
+TEST(VirtualTextureTest, RejectsInvalidFiles) {
+    const std::vector<uint32_t> pixels = makeImage(64, 64);
+    std::string error;
+    EXPECT_FALSE(Core::Types::writeVirtualTexture(tempFile("bad.vtex"), pixels.data(), 64, 64, 48, &error));
+    EXPECT_FALSE(error.empty());
+
+    error.clear();
+    EXPECT_EQ(Texture::loadVirtual(tempFile("missing.vtex"), 4, &error), nullptr);
+    EXPECT_FALSE(error.empty());
+
+    const std::string path = tempFile("valid.vtex");
+    ASSERT_TRUE(Core::Types::writeVirtualTexture(path, pixels.data(), 64, 64, 16));
+    std::ifstream in(path, std::ios::binary);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    auto writeVariant = [](const std::string& name, const std::vector<char>& data) {
+        std::ofstream out(tempFile(name), std::ios::binary);
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+        return tempFile(name);
+    };
+
+    std::vector<char> badMagic = bytes;
+    badMagic[0] = 'X';
+    std::vector<char> truncated(bytes.begin(), bytes.end() - 1);
+    std::vector<char> badLevels = bytes;
+    badLevels[20] = 3; // 64×64 应有 7 级
+    std::vector<char> badPageSize = bytes;
+    badPageSize[16] = 12;
+    for (const auto& variant : {std::make_pair("magic.vtex", badMagic), std::make_pair("truncated.vtex", truncated),
+                                std::make_pair("levels.vtex", badLevels), std::make_pair("page.vtex", badPageSize)}) {
+        error.clear();
+        EXPECT_EQ(Texture::loadVirtual(writeVariant(variant.first, variant.second), 4, &error), nullptr) << variant.first;
+        EXPECT_FALSE(error.empty()) << variant.first;
+    }
+    std::unique_ptr<Texture> valid(Texture::loadVirtual(path, 4));
+    EXPECT_TRUE(valid);
+}
+
+TEST(VirtualTextureTest, TextureCacheStreamsPagesAtEndOfFrame) {
+    std::unique_ptr<Texture> reference;
+    const std::string path = writeTestTexture("cached.vtex", reference);
+    TextureCache cache;
+    Texture* texture = cache.load(path);
+    ASSERT_TRUE(texture);
+    ASSERT_TRUE(texture->isVirtual());
+    EXPECT_EQ(cache.load(path), texture);
+
+    const float u = texelU(150), v = texelV(90);
+    expectSameColor(texture->sampleLevel(u, v, 0), reference->sampleLevel(u, v, 3));
+    cache.endFrame();
+    expectSameColor(texture->sampleLevel(u, v, 0), reference->sampleLevel(u, v, 0));
+
+    // 页缓存容量固定，预算不足时也不释放
+    const std::size_t usage = cache.getMemoryUsage();
+    cache.setMemoryBudget(1);
+    cache.endFrame();
+    EXPECT_EQ(cache.getMemoryUsage(), usage);
+    expectSameColor(texture->sampleLevel(u, v, 0), reference->sampleLevel(u, v, 0));
+}